@@ -7,7 +7,9 @@
 #include "gpu.h"
 #include "audio.h"
 #include "input.h"
+#include "os.h"
 #include "kernel/types/KProcess.h"
+#include "hle/guest_profiler.h"
 
 namespace skyline {
     DeviceState::DeviceState(kernel::OS *os, std::shared_ptr<JvmManager> jvmManager, std::shared_ptr<Settings> settings)
@@ -15,10 +17,16 @@ namespace skyline {
         // We assign these later as they use the state in their constructor and we don't want null pointers
         gpu = std::make_shared<gpu::GPU>(*this);
         soc = std::make_shared<soc::SOC>(*this);
+        if (*this->settings->captureGpfifo)
+            soc->gpfifoCapture = std::make_unique<soc::gm20b::GpfifoCapture>(os->publicAppFilesPath + "gpfifo_trace.bin");
+        if (*this->settings->gpfifoWorkerCount)
+            soc->gpfifoScheduler = std::make_unique<soc::gm20b::GpfifoScheduler>(*this, *this->settings->gpfifoWorkerCount);
         audio = std::make_shared<audio::Audio>(*this);
         nce = std::make_shared<nce::NCE>(*this);
         scheduler = std::make_shared<kernel::Scheduler>(*this);
         input = std::make_shared<input::Input>(*this);
+        if (*this->settings->enableGuestProfiler)
+            profiler = std::make_shared<hle::GuestProfiler>(*this->settings->guestProfilerSymbols);
     }
 
     DeviceState::~DeviceState() {
@@ -52,6 +52,9 @@ namespace skyline {
     namespace loader {
         class Loader;
     }
+    namespace hle {
+        class GuestProfiler;
+    }
 
     /**
      * @brief The state of the entire emulator is contained within this class, all objects related to emulation are tied into it
@@ -74,5 +77,6 @@ namespace skyline {
         std::shared_ptr<audio::Audio> audio;
         std::shared_ptr<kernel::Scheduler> scheduler;
         std::shared_ptr<input::Input> input;
+        std::shared_ptr<hle::GuestProfiler> profiler; //!< The guest function profiler, this is only present if it's enabled in the settings
     };
 }
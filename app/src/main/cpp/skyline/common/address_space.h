@@ -126,6 +126,14 @@ namespace skyline {
         }
 
       public:
+        /**
+         * @brief A function which is called with the range of an access before it's performed, a size of 0 denotes an access of unknown size
+         */
+        using AccessObserver = void (*)(void *context, VaType virt, VaType size);
+
+        AccessObserver accessObserver{}; //!< An optional observer of every access through LookupBlock, TranslateRange, Read and ReadTill, this is a plain function pointer so the check is a single load and comparison when it isn't set
+        void *accessObserverContext{}; //!< The context that is supplied to the access observer
+
         FlatMemoryManager();
 
         ~FlatMemoryManager();
@@ -142,6 +150,9 @@ namespace skyline {
          * @return A span of the mapped region and the offset of the input VA in the region
          */
         __attribute__((always_inline)) std::pair<span<u8>, VaType> LookupBlock(VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+            if (accessObserver) [[unlikely]]
+                accessObserver(accessObserverContext, virt, 0);
+
             std::shared_lock lock{this->blockMutex};
             return LookupBlockLocked(virt, cpuAccessCallback);
         }
@@ -150,6 +161,9 @@ namespace skyline {
          * @brief Translates a region in the VA space to a corresponding set of regions in the PA space
          */
         TranslatedAddressRange TranslateRange(VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+            if (accessObserver) [[unlikely]]
+                accessObserver(accessObserverContext, virt, size);
+
             std::shared_lock lock{this->blockMutex};
 
             // Fast path for when the range is mapped in a single block
@@ -189,6 +203,9 @@ namespace skyline {
         span<u8> ReadTill(Container& destination, VaType virt, Function function, std::function<void(span<u8>)> cpuAccessCallback = {}) {
             //TRACE_EVENT("containers", "FlatMemoryManager::ReadTill");
 
+            if (accessObserver) [[unlikely]]
+                accessObserver(accessObserverContext, virt, destination.size());
+
             std::shared_lock lock(this->blockMutex);
 
             auto successor{std::upper_bound(this->blocks.begin(), this->blocks.end(), virt, [](auto virt, const auto &block) {
@@ -39,20 +39,34 @@ namespace skyline {
             isInternetEnabled = ktSettings.GetBool("isInternetEnabled");
             forceTripleBuffering = ktSettings.GetBool("forceTripleBuffering");
             disableFrameThrottling = ktSettings.GetBool("disableFrameThrottling");
+            headlessPresentation = ktSettings.GetBool("headlessPresentation");
             gpuDriver = ktSettings.GetString("gpuDriver");
             gpuDriverLibraryName = ktSettings.GetString("gpuDriverLibraryName");
             executorSlotCountScale = ktSettings.GetInt<u32>("executorSlotCountScale");
             executorFlushThreshold = ktSettings.GetInt<u32>("executorFlushThreshold");
+            gpfifoWorkerCount = ktSettings.GetInt<u32>("gpfifoWorkerCount");
             useDirectMemoryImport = ktSettings.GetBool("useDirectMemoryImport");
             forceMaxGpuClocks = ktSettings.GetBool("forceMaxGpuClocks");
             disableShaderCache = ktSettings.GetBool("disableShaderCache");
             freeGuestTextureMemory = ktSettings.GetBool("freeGuestTextureMemory");
+            useDescriptorBuffers = ktSettings.GetBool("useDescriptorBuffers");
+            useTimelineSemaphores = ktSettings.GetBool("useTimelineSemaphores");
+            useDynamicRendering = ktSettings.GetBool("useDynamicRendering");
+            useTransferQueue = ktSettings.GetBool("useTransferQueue");
+            useSparseBuffers = ktSettings.GetBool("useSparseBuffers");
+            parallelCommandRecording = ktSettings.GetBool("parallelCommandRecording");
+            enableExecutableCache = ktSettings.GetBool("enableExecutableCache");
             enableFastGpuReadbackHack = ktSettings.GetBool("enableFastGpuReadbackHack");
             enableFastReadbackWrites = ktSettings.GetBool("enableFastReadbackWrites");
             disableSubgroupShuffle = ktSettings.GetBool("disableSubgroupShuffle");
             disableGetVaRegions = ktSettings.GetBool("disableGetVaRegions");
             isAudioOutputDisabled = ktSettings.GetBool("isAudioOutputDisabled");
             validationLayer = ktSettings.GetBool("validationLayer");
+            enableGuestProfiler = ktSettings.GetBool("enableGuestProfiler");
+            guestProfilerSymbols = ktSettings.GetString("guestProfilerSymbols");
+            writeFrameTimeReport = ktSettings.GetBool("writeFrameTimeReport");
+            captureGpfifo = ktSettings.GetBool("captureGpfifo");
+            replayGpfifoTrace = ktSettings.GetBool("replayGpfifoTrace");
         };
     };
 }
@@ -77,6 +77,45 @@ namespace skyline {
             }
         }
 
+        /**
+         * @brief A non-blocking variant of Process that runs on the items which are currently queued
+         * @param maxItems The maximum amount of items to process, any further items are left in the queue
+         * @return The amount of items that were processed
+         */
+        template<typename F>
+        size_t ProcessAvailable(F function, size_t maxItems) {
+            std::scoped_lock comsumptionLock{consumptionMutex};
+            size_t count{};
+            while (start != end && count < maxItems) {
+                auto next{start + 1};
+                next = (next == reinterpret_cast<Type *>(vector.end().base())) ? reinterpret_cast<Type *>(vector.begin().base()) : next;
+                function(*next);
+                start = next;
+                count++;
+            }
+
+            if (count)
+                consumeCondition.notify_one();
+
+            return count;
+        }
+
+        /**
+         * @return The amount of items in the queue, this is only a snapshot as the queue may be concurrently modified
+         */
+        size_t Size() {
+            Type *currentStart{start}, *currentEnd{end};
+            auto capacity{static_cast<ptrdiff_t>(vector.size() / sizeof(Type))};
+            return static_cast<size_t>(((currentEnd - currentStart) + capacity) % capacity);
+        }
+
+        /**
+         * @return The maximum amount of items that can be in the queue at once
+         */
+        size_t Capacity() {
+            return (vector.size() / sizeof(Type)) - 1;
+        }
+
         Type Pop() {
             {
                 std::unique_lock productionLock{productionMutex};
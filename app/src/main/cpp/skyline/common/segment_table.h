@@ -30,7 +30,7 @@ namespace skyline {
             SegmentType segment; //!< The segment associated with the entry, this is 0'd out if the entry is unset
         };
 
-        static constexpr size_t L2Size{1 << L2Bits}, L2Entries{util::DivideCeil(Size, L2Size)}, L1inL2Count{L1Size / L2Size};
+        static constexpr size_t L2Size{1 << L2Bits}, L2Entries{util::DivideCeil(Size, L2Size)}, L1inL2Count{L2Size / L1Size};
         span<RangeEntry, L2Entries> level2Table; //!< The second level of the segment table, this is the lowest granularity of the table
 
         template<typename Type, size_t Amount>
@@ -143,6 +143,34 @@ namespace skyline {
             }
         }
 
+        /**
+         * @return The range of units surrounding the supplied index which have the same segment as it, the range is clamped to the supplied limits which must contain the index
+         * @note Valid L2 entries are traversed at L2 granularity, this makes finding the bounds of a segment that was set over a large range efficient
+         */
+        std::pair<size_t, size_t> GetRange(size_t index, size_t lowerLimit, size_t upperLimit) const requires std::equality_comparable<SegmentType> {
+            SegmentType segment{(*this)[index]};
+
+            size_t start{util::AlignDown(index, L1Size)};
+            while (start > lowerLimit) {
+                size_t previous{start - 1};
+                const auto &l2Entry{level2Table[previous >> L2Bits]};
+                if (l2Entry.valid ? l2Entry.segment != segment : level1Table[previous >> L1Bits] != segment)
+                    break;
+                start = util::AlignDown(previous, l2Entry.valid ? L2Size : L1Size);
+            }
+
+            size_t end{util::AlignDown(index, L1Size)};
+            while (end < upperLimit) {
+                const auto &l2Entry{level2Table[end >> L2Bits]};
+                if (l2Entry.valid ? l2Entry.segment != segment : level1Table[end >> L1Bits] != segment)
+                    break;
+                size_t step{l2Entry.valid ? L2Size : L1Size};
+                end = util::AlignDown(end, step) + step;
+            }
+
+            return {std::max(start, lowerLimit), std::min(end, upperLimit)};
+        }
+
         /* Helpers for pointer-based access */
 
         template<typename T>
@@ -163,6 +191,13 @@ namespace skyline {
             Set(reinterpret_cast<size_t>(start), reinterpret_cast<size_t>(end), segment);
         }
 
+        template<typename T>
+        requires std::is_pointer_v<T>
+        std::pair<T, T> GetRange(T pointer, T lowerLimit, T upperLimit) const {
+            auto [start, end]{GetRange(reinterpret_cast<size_t>(pointer), reinterpret_cast<size_t>(lowerLimit), reinterpret_cast<size_t>(upperLimit))};
+            return {reinterpret_cast<T>(start), reinterpret_cast<T>(end)};
+        }
+
         void Set(span<u8> span, SegmentType segment) {
             Set(reinterpret_cast<size_t>(span.begin().base()), reinterpret_cast<size_t>(span.end().base()));
         }
@@ -69,6 +69,7 @@ namespace skyline {
         // Display
         Setting<bool> forceTripleBuffering; //!< If the presentation engine should always triple buffer even if the swapchain supports double buffering
         Setting<bool> disableFrameThrottling; //!< Allow the guest to submit frames without any blocking calls
+        Setting<bool> headlessPresentation; //!< If frames should be consumed without being presented to a surface, this allows running without a display
         Setting<bool> disableShaderCache;  //!< Prevents cached shaders from being loaded and disables caching of new shaders
 
         // GPU
@@ -76,9 +77,17 @@ namespace skyline {
         Setting<std::string> gpuDriverLibraryName; //!< The name of the GPU driver library to use
         Setting<u32> executorSlotCountScale; //!< Number of GPU executor slots that can be used concurrently
         Setting<u32> executorFlushThreshold; //!< Number of commands that need to accumulate before they're flushed to the GPU
+        Setting<u32> gpfifoWorkerCount; //!< Number of shared worker threads to process GPFIFO channels on, each channel has a dedicated thread if this is 0
         Setting<bool> useDirectMemoryImport; //!< If buffer emulation should be done by importing guest buffer mappings
         Setting<bool> forceMaxGpuClocks; //!< If the GPU should be forced to run at maximum clocks
         Setting<bool> freeGuestTextureMemory; //!< If guest textrue memory should be freed when the owning texture is GPU dirty
+        Setting<bool> useDescriptorBuffers; //!< If descriptors should be written into descriptor buffers rather than allocated from pools or pushed when the host GPU supports it
+        Setting<bool> useTimelineSemaphores; //!< If GPU submissions should be tracked with a timeline semaphore rather than a fence per command buffer when the host GPU supports it
+        Setting<bool> useDynamicRendering; //!< If render passes should be recorded with dynamic rendering rather than render pass and framebuffer objects when the host GPU supports it
+        Setting<bool> useTransferQueue; //!< If texture uploads should be submitted to a dedicated transfer queue when the host GPU has one, this requires the timeline backend
+        Setting<bool> useSparseBuffers; //!< If large guest buffers should be backed by sparse buffers which share pages by guest address, allowing them to be coalesced without copying their contents
+        Setting<bool> parallelCommandRecording; //!< If render passes should be recorded into secondary command buffers on multiple threads
+        Setting<bool> enableExecutableCache; //!< If the decrypted and decompressed executables of titles should be cached on disk to speed up subsequent boots
 
         // Hacks
         Setting<bool> enableFastGpuReadbackHack; //!< If the CPU texture readback skipping hack should be used
@@ -91,6 +100,11 @@ namespace skyline {
 
         // Debug
         Setting<bool> validationLayer; //!< If the vulkan validation layer is enabled
+        Setting<bool> enableGuestProfiler; //!< If guest functions should be instrumented with the guest profiler
+        Setting<std::string> guestProfilerSymbols; //!< A comma separated list of mangled guest symbols to profile, all exported symbols are profiled if this is empty
+        Setting<bool> writeFrameTimeReport; //!< If a histogram of all frame times in the session should be written out when emulation ends
+        Setting<bool> captureGpfifo; //!< If all GPFIFO submissions and the GPU memory they access should be captured into a trace for offline replay
+        Setting<bool> replayGpfifoTrace; //!< If a previously captured GPFIFO trace should be replayed instead of running the guest
 
         Settings() = default;
 
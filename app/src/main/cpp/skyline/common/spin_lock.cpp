@@ -3,6 +3,9 @@
 
 #include <chrono>
 #include <thread>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include "spin_lock.h"
 #include "utils.h"
 
@@ -42,17 +45,40 @@ namespace skyline {
         });
     }
 
-    static constexpr size_t AdaptiveWaitIters{1024}; //!< Number of wait iterations before waiting should fallback to a regular condition variable
+    static constexpr size_t AdaptiveWaitIters{1024}; //!< Number of wait iterations before waiting should fallback to sleeping on the futex
 
     void __attribute__ ((noinline)) AdaptiveSingleWaiterConditionVariable::SpinWait() {
         FalloffLock([this] (size_t i) {
-            return !unsignalled.test_and_set() || i >= AdaptiveWaitIters;
+            return wakeWord.load(std::memory_order_acquire) == Signalled || i >= AdaptiveWaitIters;
         });
     }
 
     void __attribute__ ((noinline)) AdaptiveSingleWaiterConditionVariable::SpinWait(i64 maxEndTimeNs) {
         FalloffLock([maxEndTimeNs, this] (size_t i) {
-            return util::GetTimeNs() > maxEndTimeNs  || !unsignalled.test_and_set() || i >= AdaptiveWaitIters;
+            return util::GetTimeNs() > maxEndTimeNs || wakeWord.load(std::memory_order_acquire) == Signalled || i >= AdaptiveWaitIters;
         });
     }
+
+    void AdaptiveSingleWaiterConditionVariable::FutexWait() {
+        // If the waiter was signalled after its predicate was checked then the exchange will fail and we can skip sleeping entirely
+        u32 expected{Unsignalled};
+        if (wakeWord.compare_exchange_strong(expected, Sleeping) || expected == Sleeping)
+            syscall(SYS_futex, &wakeWord, FUTEX_WAIT_PRIVATE, Sleeping, nullptr, nullptr, 0); // Any failures (EAGAIN/EINTR) are handled by the caller rechecking its predicate
+    }
+
+    void AdaptiveSingleWaiterConditionVariable::FutexWait(i64 endTimeNs) {
+        u32 expected{Unsignalled};
+        if (wakeWord.compare_exchange_strong(expected, Sleeping) || expected == Sleeping) {
+            auto timeoutNs{std::max<i64>(endTimeNs - util::GetTimeNs(), 0)};
+            timespec timeout{
+                .tv_sec = static_cast<time_t>(timeoutNs / constant::NsInSecond),
+                .tv_nsec = static_cast<long>(timeoutNs % constant::NsInSecond),
+            };
+            syscall(SYS_futex, &wakeWord, FUTEX_WAIT_PRIVATE, Sleeping, &timeout, nullptr, 0);
+        }
+    }
+
+    void AdaptiveSingleWaiterConditionVariable::FutexWake() {
+        syscall(SYS_futex, &wakeWord, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
 }
@@ -135,36 +135,51 @@ namespace skyline {
     };
 
     /**
-     * @brief A condition variable that spins for a bit before falling back to a regular condition variable, for cases where only a single thread can wait at the same time
+     * @brief A condition variable that spins for a bit before falling back to sleeping on a futex, for cases where only a single thread can wait at the same time
+     * @note The waiter sleeps directly on its own wake word so a notify is a single atomic exchange which only results in a FUTEX_WAKE syscall when the waiter is asleep, there's no mutex handoff between the notifier and the waiter
      */
     class AdaptiveSingleWaiterConditionVariable {
       private:
+        static constexpr u32 Unsignalled{0}; //!< The waiter hasn't been signalled since it last checked its predicate
+        static constexpr u32 Signalled{1}; //!< The waiter has been signalled and should recheck its predicate
+        static constexpr u32 Sleeping{2}; //!< The waiter is sleeping on the futex and must be woken by the notifier
+
+        std::atomic<u32> wakeWord{Unsignalled}; //!< The futex word which is used to signal the waiter
+
         /**
-         * @brief Spins either until the condition variable is signalled or the spin wait times out (to fall back to a regular condition variable)
+         * @brief Spins either until the condition variable is signalled or the spin wait times out (to fall back to sleeping on the futex)
          */
         void SpinWait();
 
         /**
-         * @brief Spins either until the condition variable is signalled or the spin wait times out (to fall back to a regular condition variable, or until the given time is reached)
+         * @brief Spins either until the condition variable is signalled or the spin wait times out (to fall back to sleeping on the futex, or until the given time is reached)
          * @param maxEndTimeNs The maximum time to spin for
          */
         void SpinWait(i64 maxEndTimeNs);
 
-        std::condition_variable fallback; //<! Fallback condition variable for when the spin wait times out
-        std::mutex fallbackMutex; //!< Used to allow taking in arbitrary mutex types and to synchronise access to fallbackWaiter
-        std::atomic_flag unsignalled{true}; //!< Set to false when the condition variable is signalled
-        bool fallbackWaiter{}; //!< True if the waiter is waiting on the fallback condition variable
+        /**
+         * @brief Sleeps on the futex until the condition variable is signalled, this may return spuriously (such as due to a signal interrupting the wait)
+         */
+        void FutexWait();
+
+        /**
+         * @brief Sleeps on the futex until the condition variable is signalled or the given time is reached, this may return spuriously
+         * @param endTimeNs The time at which the wait should be abandoned
+         */
+        void FutexWait(i64 endTimeNs);
+
+        /**
+         * @brief Wakes the waiter sleeping on the futex
+         */
+        void FutexWake();
 
       public:
         /**
          * @brief Signals the condition variable
          */
         void notify() {
-            unsignalled.clear();
-
-            std::scoped_lock fallbackLock{fallbackMutex};
-            if (fallbackWaiter)
-                fallback.notify_one();
+            if (wakeWord.exchange(Signalled) == Sleeping)
+                FutexWake();
         }
 
         /**
@@ -174,10 +189,10 @@ namespace skyline {
          */
         void wait(auto &lock, auto pred) {
             // 'notify' calls should only wake the condition variable when called during waiting
-            unsignalled.test_and_set();
+            wakeWord.store(Unsignalled);
 
             if (!pred()) {
-                // First spin wait for a bit, to hopefully avoid the costs of condition variables under heavy thrashing
+                // First spin wait for a bit, to hopefully avoid the costs of sleeping under heavy thrashing
                 lock.unlock();
                 SpinWait();
                 lock.lock();
@@ -185,25 +200,14 @@ namespace skyline {
                 return;
             }
 
-            // The spin wait has either timed out or succeeded, check the predicate to confirm which is the case
-            if (pred())
-                return;
-
-            // If the spin wait timed out then fallback to a regular condition variable
+            // The spin wait has either timed out or succeeded, the wake word is reset prior to checking the predicate so any notify after the check will be observed by the futex wait
+            wakeWord.store(Unsignalled);
             while (!pred()) {
-                std::unique_lock fallbackLock{fallbackMutex};
-
-                // Store that we are currently waiting on the fallback condition variable, `notify()` can check this when `fallbackLock` ends up being unlocked by `fallback.wait()` to avoid redundantly performing futex wakes (on older bionic versions)
-                fallbackWaiter = true;
-
                 lock.unlock();
-                fallback.wait(fallbackLock);
-
-                // The predicate has been satisfied, we're done here
-                fallbackWaiter = false;
-                fallbackMutex.unlock();
-
+                FutexWait();
                 lock.lock();
+
+                wakeWord.store(Unsignalled);
             }
         }
 
@@ -216,12 +220,12 @@ namespace skyline {
          */
         bool wait_for(auto &lock, const auto &duration, auto pred) {
             // 'notify' calls should only wake the condition variable when called during waiting
-            unsignalled.test_and_set();
+            wakeWord.store(Unsignalled);
 
             auto endTimeNs{util::GetTimeNs() + std::chrono::nanoseconds(duration).count()};
 
             if (!pred()) {
-                // First spin wait for a bit, to hopefully avoid the costs of condition variables under heavy thrashing
+                // First spin wait for a bit, to hopefully avoid the costs of sleeping under heavy thrashing
                 lock.unlock();
                 SpinWait(endTimeNs);
                 lock.lock();
@@ -230,34 +234,19 @@ namespace skyline {
             }
 
             // The spin wait has either timed out (due to wanting to fallback), timed out (due to the duration being exceeded) or succeeded, check the predicate and current time to confirm which is the case
-            if (pred())
-                return true;
-            else if (util::GetTimeNs() > endTimeNs)
-                return false;
-
-
-            // If the spin wait timed out (due to wanting to fallback), then fallback to a regular condition variable
-
-            // Calculate chrono-based end time only in the fallback path to avoid polluting the fast past
-            auto endTime{std::chrono::system_clock::now() + std::chrono::nanoseconds(endTimeNs - util::GetTimeNs())};
-            std::cv_status status{std::cv_status::no_timeout};
-            while (status == std::cv_status::no_timeout && !pred()) {
-                std::unique_lock fallbackLock{fallbackMutex};
-
-                // Store that we are currently waiting on the fallback condition variable, `notify()` can check this when `fallbackLock` ends up being unlocked by `fallback.wait()` to avoid redundantly performing futex wakes (on older bionic versions)
-                fallbackWaiter = true;
+            wakeWord.store(Unsignalled);
+            while (!pred()) {
+                if (util::GetTimeNs() > endTimeNs)
+                    return false;
 
                 lock.unlock();
-                status = fallback.wait_until(fallbackLock, endTime);
-
-                fallbackWaiter = false;
-                fallbackLock.unlock();
-
+                FutexWait(endTimeNs);
                 lock.lock();
+
+                wakeWord.store(Unsignalled);
             }
 
-            // The predicate has been satisfied, we're done here
-            return pred();
+            return true;
         }
     };
 }
@@ -222,8 +222,14 @@ namespace skyline::gpu {
     static vk::raii::Device CreateDevice(const vk::raii::Context &context,
                                          const vk::raii::PhysicalDevice &physicalDevice,
                                          decltype(vk::DeviceQueueCreateInfo::queueCount) &vkQueueFamilyIndex,
+                                         std::optional<u32> &vkTransferQueueFamilyIndex,
                                          TraitManager &traits,
-                                         adrenotools_gpu_mapping *mapping) {
+                                         adrenotools_gpu_mapping *mapping,
+                                         bool enableDescriptorBuffers,
+                                         bool enableTimelineSemaphores,
+                                         bool enableDynamicRendering,
+                                         bool enableTransferQueue,
+                                         bool enableSparseBuffers) {
         auto deviceFeatures2{physicalDevice.getFeatures2<
             vk::PhysicalDeviceFeatures2,
             vk::PhysicalDeviceCustomBorderColorFeaturesEXT,
@@ -239,7 +245,11 @@ namespace skyline::gpu {
             vk::PhysicalDeviceTransformFeedbackFeaturesEXT,
             vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-            vk::PhysicalDeviceRobustness2FeaturesEXT>()};
+            vk::PhysicalDeviceRobustness2FeaturesEXT,
+            vk::PhysicalDeviceBufferDeviceAddressFeatures,
+            vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+            vk::PhysicalDeviceTimelineSemaphoreFeatures,
+            vk::PhysicalDeviceDynamicRenderingFeatures>()};
         decltype(deviceFeatures2) enabledFeatures2{}; // We only want to enable features we required due to potential overhead from unused features
 
         #define FEAT_REQ(structName, feature)                                            \
@@ -275,9 +285,11 @@ namespace skyline::gpu {
             vk::PhysicalDeviceDriverProperties,
             vk::PhysicalDeviceFloatControlsProperties,
             vk::PhysicalDeviceTransformFeedbackPropertiesEXT,
-            vk::PhysicalDeviceSubgroupProperties>()};
+            vk::PhysicalDeviceSubgroupProperties,
+            vk::PhysicalDeviceDescriptorBufferPropertiesEXT,
+            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>()};
 
-        traits = TraitManager{deviceFeatures2, enabledFeatures2, deviceExtensions, enabledExtensions, deviceProperties2, physicalDevice};
+        traits = TraitManager{deviceFeatures2, enabledFeatures2, deviceExtensions, enabledExtensions, deviceProperties2, physicalDevice, enableDescriptorBuffers, enableTimelineSemaphores, enableDynamicRendering, enableSparseBuffers};
         traits.ApplyDriverPatches(context, mapping);
 
         std::vector<const char *> pEnabledExtensions;
@@ -286,7 +298,7 @@ namespace skyline::gpu {
             pEnabledExtensions.push_back(extension.data());
 
         auto queueFamilies{physicalDevice.getQueueFamilyProperties()};
-        float queuePriority{1.0f}; //!< The priority of the only queue we use, it's set to the maximum of 1.0
+        float queuePriority{1.0f}; //!< The priority of all queues we use, it's set to the maximum of 1.0
         vk::StructureChain<vk::DeviceQueueCreateInfo, vk::DeviceQueueGlobalPriorityCreateInfoEXT> queueCreateInfo{
             [&]() -> vk::DeviceQueueCreateInfo {
                 decltype(vk::DeviceQueueCreateInfo::queueFamilyIndex) index{};
@@ -311,6 +323,35 @@ namespace skyline::gpu {
         if (!traits.supportsGlobalPriority)
             queueCreateInfo.unlink<vk::DeviceQueueGlobalPriorityCreateInfoEXT>();
 
+        // Sparse memory is bound on the graphics queue as binds are rare and this avoids any cross-queue synchronization
+        if (traits.supportsSparseBuffers && !(queueFamilies[vkQueueFamilyIndex].queueFlags & vk::QueueFlagBits::eSparseBinding)) {
+            Logger::Info("Vulkan graphics queue family doesn't support sparse binding, sparse buffers will not be used");
+            traits.supportsSparseBuffers = false;
+        }
+
+        std::array<vk::DeviceQueueCreateInfo, 2> queueCreateInfos{queueCreateInfo.get<vk::DeviceQueueCreateInfo>()};
+        u32 queueCreateInfoCount{1};
+
+        // Work on the transfer queue is ordered against the graphics queue by waiting on the timeline semaphore of the other queue, so it's only used alongside the timeline backend
+        if (enableTransferQueue && traits.supportsTimelineSemaphores) {
+            for (u32 index{}; index < queueFamilies.size(); index++) {
+                const auto &queueFamily{queueFamilies[index]};
+                // Texture uploads aren't aligned to the image transfer granularity, queue families which don't support arbitrary copy regions can't be used for them
+                if ((queueFamily.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eTransfer)) == vk::QueueFlagBits::eTransfer && queueFamily.minImageTransferGranularity == vk::Extent3D{1, 1, 1}) {
+                    vkTransferQueueFamilyIndex = index;
+                    queueCreateInfos[queueCreateInfoCount++] = vk::DeviceQueueCreateInfo{
+                        .queueFamilyIndex = index,
+                        .queueCount = 1,
+                        .pQueuePriorities = &queuePriority,
+                    };
+                    break;
+                }
+            }
+
+            if (!vkTransferQueueFamilyIndex)
+                Logger::Info("Vulkan device has no dedicated transfer queue family, texture uploads will be submitted to the graphics queue");
+        }
+
         if (Logger::configLevel >= Logger::LogLevel::Info) {
             std::string extensionString;
             for (const auto &extension : deviceExtensions)
@@ -318,8 +359,10 @@ namespace skyline::gpu {
 
             std::string queueString;
             u32 familyIndex{};
-            for (const auto &queueFamily : queueFamilies)
-                queueString += util::Format("\n* {}x{}{}{}{}{}: TSB{} MIG({}x{}x{}){}", queueFamily.queueCount, queueFamily.queueFlags & vk::QueueFlagBits::eGraphics ? 'G' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eCompute ? 'C' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eTransfer ? 'T' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eSparseBinding ? 'S' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eProtected ? 'P' : '-', queueFamily.timestampValidBits, queueFamily.minImageTransferGranularity.width, queueFamily.minImageTransferGranularity.height, queueFamily.minImageTransferGranularity.depth, familyIndex++ == vkQueueFamilyIndex ? " <--" : "");
+            for (const auto &queueFamily : queueFamilies) {
+                queueString += util::Format("\n* {}x{}{}{}{}{}: TSB{} MIG({}x{}x{}){}", queueFamily.queueCount, queueFamily.queueFlags & vk::QueueFlagBits::eGraphics ? 'G' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eCompute ? 'C' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eTransfer ? 'T' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eSparseBinding ? 'S' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eProtected ? 'P' : '-', queueFamily.timestampValidBits, queueFamily.minImageTransferGranularity.width, queueFamily.minImageTransferGranularity.height, queueFamily.minImageTransferGranularity.depth, familyIndex == vkQueueFamilyIndex ? " <--" : familyIndex == vkTransferQueueFamilyIndex ? " <-- (Transfer)" : "");
+                familyIndex++;
+            }
 
             auto properties{deviceProperties2.get<vk::PhysicalDeviceProperties2>().properties};
             Logger::Info("Vulkan Device:\nName: {}\nType: {}\nDriver ID: {}\nVulkan Version: {}.{}.{}\nDriver Version: {}.{}.{}\nQueues:{}\nExtensions:{}\nTraits:{}\nQuirks:{}",
@@ -332,8 +375,8 @@ namespace skyline::gpu {
 
         return vk::raii::Device(physicalDevice, vk::DeviceCreateInfo{
             .pNext = &enabledFeatures2,
-            .queueCreateInfoCount = 1,
-            .pQueueCreateInfos = &queueCreateInfo.get<vk::DeviceQueueCreateInfo>(),
+            .queueCreateInfoCount = queueCreateInfoCount,
+            .pQueueCreateInfos = queueCreateInfos.data(),
             .enabledExtensionCount = static_cast<uint32_t>(pEnabledExtensions.size()),
             .ppEnabledExtensionNames = pEnabledExtensions.data(),
         });
@@ -391,8 +434,10 @@ namespace skyline::gpu {
           vkInstance(CreateInstance(state, vkContext)),
           vkDebugReportCallback(CreateDebugReportCallback(this, vkInstance)),
           vkPhysicalDevice(CreatePhysicalDevice(vkInstance)),
-          vkDevice(CreateDevice(vkContext, vkPhysicalDevice, vkQueueFamilyIndex, traits, &adrenotoolsImportMapping)),
+          vkDevice(CreateDevice(vkContext, vkPhysicalDevice, vkQueueFamilyIndex, vkTransferQueueFamilyIndex, traits, &adrenotoolsImportMapping, *state.settings->useDescriptorBuffers, *state.settings->useTimelineSemaphores, *state.settings->useDynamicRendering, *state.settings->useTransferQueue, *state.settings->useSparseBuffers)),
           vkQueue(vkDevice, vkQueueFamilyIndex, 0),
+          vkTransferQueue(vkTransferQueueFamilyIndex ? vk::raii::Queue{vkDevice, *vkTransferQueueFamilyIndex, 0} : vk::raii::Queue{nullptr}),
+          transferQueueFamilyIndices{vkQueueFamilyIndex, vkTransferQueueFamilyIndex.value_or(vkQueueFamilyIndex)},
           memory(*this),
           scheduler(state, *this),
           presentation(state, *this),
@@ -400,10 +445,19 @@ namespace skyline::gpu {
           buffer(*this),
           megaBufferAllocator(*this),
           descriptor(*this),
+          descriptorBuffer(*this),
           helperShaders(*this, state.os->assetFileSystem),
           renderPassCache(*this),
           framebufferCache(*this),
-          debugTracingBuffer(memory.AllocateBuffer(DebugTracingBufferSize)) {}
+          debugTracingBuffer(memory.AllocateBuffer(DebugTracingBufferSize)) {
+        if (traits.supportsSparseBuffers) {
+            try {
+                sparseBufferHeap.emplace(*this);
+            } catch (const std::exception &e) {
+                Logger::Warn("Failed to create the sparse buffer heap, falling back to regular buffers: {}", e.what());
+            }
+        }
+    }
 
     void GPU::Initialise() {
         std::string titleId{state.loader->nacp->GetSaveDataOwnerId()};
@@ -6,12 +6,14 @@
 #include <adrenotools/driver.h>
 #include "gpu/trait_manager.h"
 #include "gpu/memory_manager.h"
+#include "gpu/sparse_buffer_heap.h"
 #include "gpu/command_scheduler.h"
 #include "gpu/presentation_engine.h"
 #include "gpu/texture_manager.h"
 #include "gpu/buffer_manager.h"
 #include "gpu/megabuffer.h"
 #include "gpu/descriptor_allocator.h"
+#include "gpu/descriptor_buffer.h"
 #include "gpu/shader_manager.h"
 #include "gpu/pipeline_cache_manager.h"
 #include "gpu/graphics_pipeline_assembler.h"
@@ -41,12 +43,17 @@ namespace skyline::gpu {
         vk::raii::DebugReportCallbackEXT vkDebugReportCallback; //!< An RAII Vulkan debug report manager which calls into 'GPU::DebugCallback'
         vk::raii::PhysicalDevice vkPhysicalDevice;
         u32 vkQueueFamilyIndex{};
+        std::optional<u32> vkTransferQueueFamilyIndex; //!< The index of a queue family which only supports transfer operations, this is only set when a dedicated transfer queue is in use
         TraitManager traits;
         vk::raii::Device vkDevice;
         std::mutex queueMutex; //!< Synchronizes access to the queue as it is externally synchronized
         vk::raii::Queue vkQueue; //!< A Vulkan Queue supporting graphics and compute operations
+        std::mutex transferQueueMutex; //!< Synchronizes access to the transfer queue as it is externally synchronized
+        vk::raii::Queue vkTransferQueue; //!< A Vulkan Queue dedicated to transfer operations, this is null if no dedicated transfer queue is in use
+        std::array<u32, 2> transferQueueFamilyIndices; //!< The graphics queue family index followed by the transfer queue family index, only the first is valid if no dedicated transfer queue is in use
 
         memory::MemoryManager memory;
+        std::optional<SparseBufferHeap> sparseBufferHeap; //!< The heap backing large guest buffers with sparse buffers, this is only present when they're enabled and supported by the device
         CommandScheduler scheduler;
         PresentationEngine presentation;
 
@@ -55,6 +62,7 @@ namespace skyline::gpu {
         MegaBufferAllocator megaBufferAllocator;
 
         DescriptorAllocator descriptor;
+        DescriptorBufferAllocator descriptorBuffer;
         std::optional<ShaderManager> shader;
 
         HelperShaders helperShaders;
@@ -73,6 +81,14 @@ namespace skyline::gpu {
 
         GPU(const DeviceState &state);
 
+        /**
+         * @return The queue family indices that any resource which is accessed by the transfer queue must be shared between
+         * @note Resources shared between multiple queue families must be created with VK_SHARING_MODE_CONCURRENT
+         */
+        span<const u32> GetTransferQueueFamilyIndices() const {
+            return span<const u32>{transferQueueFamilyIndices}.first(vkTransferQueueFamilyIndex ? 2 : 1);
+        }
+
         /**
          * @brief Should be called after loader population to initialize the per-title caches
          */
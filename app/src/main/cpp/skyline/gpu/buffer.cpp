@@ -374,10 +374,16 @@ namespace skyline::gpu {
           isDirect{direct},
           id{id},
           megaBufferTableShift{std::max(std::bit_width(guest.size() / MegaBufferTableMaxEntries - 1), MegaBufferTableShiftMin)} {
-        if (isDirect)
+        if (isDirect) {
             directBacking = gpu.memory.ImportBuffer(mirror);
-        else
+        } else if (gpu.sparseBufferHeap && mirror.size() >= SparseBackingThreshold) {
+            auto &sparse{sparseBacking.emplace(*gpu.sparseBufferHeap, guest)};
+            backing.emplace(sparse.data(), mirror.size(), nullptr, *sparse.vkBuffer, nullptr);
+            backingOffset = sparse.offset;
+        } else {
             backing = gpu.memory.AllocateBuffer(mirror.size());
+            residentMemory = gpu.memory.TrackResidency(memory::ResidencyCategory::Buffer, backing->vmaAllocation);
+        }
 
         megaBufferTable.resize(guest.size() / (1 << megaBufferTableShift));
     }
@@ -387,6 +393,7 @@ namespace skyline::gpu {
           backing{gpu.memory.AllocateBuffer(size)},
           delegate{delegateAllocator.EmplaceUntracked<BufferDelegate>(this)},
           id{id} {
+        residentMemory = gpu.memory.TrackResidency(memory::ResidencyCategory::Buffer, backing->vmaAllocation);
         dirtyState = DirtyState::Clean; // Since this is a host-only buffer it's always going to be clean
     }
 
@@ -438,7 +445,7 @@ namespace skyline::gpu {
         guest = {};
     }
 
-    void Buffer::SynchronizeHost(bool skipTrap) {
+    void Buffer::SynchronizeHost(bool skipTrap, span<const GuestBuffer> excludedRanges) {
         if (!guest || isDirect)
             return;
 
@@ -458,7 +465,13 @@ namespace skyline::gpu {
                 gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this buffer, must be done before the memcpy so that any modifications during the copy are tracked
         }
 
-        std::memcpy(backing->data(), mirror.data(), mirror.size());
+        size_t offset{};
+        for (auto range : excludedRanges) {
+            auto rangeOffset{static_cast<size_t>(range.data() - guest->data())};
+            std::memcpy(backing->data() + offset, mirror.data() + offset, rangeOffset - offset);
+            offset = rangeOffset + range.size();
+        }
+        std::memcpy(backing->data() + offset, mirror.data() + offset, mirror.size() - offset);
     }
 
     bool Buffer::SynchronizeGuest(bool skipTrap, bool nonBlocking) {
@@ -684,7 +697,8 @@ namespace skyline::gpu {
 
     BufferBinding BufferView::GetBinding(GPU &gpu) const {
         std::scoped_lock lock{gpu.buffer.recreationMutex};
-        return {delegate->GetBuffer()->GetBacking(), offset + delegate->GetOffset(), size};
+        auto buffer{delegate->GetBuffer()};
+        return {buffer->GetBacking(), offset + delegate->GetOffset() + buffer->backingOffset, size};
     }
 
     vk::DeviceSize BufferView::GetOffset() const {
@@ -11,6 +11,7 @@
 #include "usage_tracker.h"
 #include "megabuffer.h"
 #include "memory_manager.h"
+#include "sparse_buffer_heap.h"
 
 namespace skyline::gpu {
     using GuestBuffer = span<u8>; //!< The CPU mapping for the guest buffer, multiple mappings for buffers aren't supported since overlaps cannot be reconciled
@@ -57,7 +58,10 @@ namespace skyline::gpu {
         bool directTrackedShadowActive{}; //!< (Direct) If `directTrackedShadow` is currently being used to track writes
 
         span<u8> mirror{}; //!< A contiguous mirror of all the guest mappings to allow linear access on the CPU
+        std::optional<SparseBufferHeap::Backing> sparseBacking; //!< (Staged) A sparse buffer which shares its memory with all other sparse buffers covering the same guest memory, `backing` is a non-owning view of it when present
         std::optional<memory::Buffer> backing;
+        memory::ResidentMemory residentMemory; //!< The resident memory of the backing when it's owned by the buffer
+        vk::DeviceSize backingOffset{}; //!< The offset of the buffer contents into the Vulkan buffer, this is only non-zero for sparse buffers as they cover entire sparse blocks
         std::optional<memory::ImportedBuffer> directBacking;
 
         std::optional<nce::NCE::TrapHandle> trapHandle{}; //!< (Staged) The handle of the traps for the guest mappings
@@ -83,6 +87,7 @@ namespace skyline::gpu {
         u32 sequenceNumber{InitialSequenceNumber}; //!< Sequence number that is incremented after all modifications to the host side `backing` buffer, used to prevent redundant copies of the buffer being stored in the megabuffer by views
 
         constexpr static vk::DeviceSize MegaBufferingDisableThreshold{1024 * 256}; //!< The threshold at which a view is considered to be too large to be megabuffered (256KiB)
+        constexpr static size_t SparseBackingThreshold{1024 * 1024}; //!< The size at which a buffer will be backed by a sparse buffer when they are in use (1MiB), smaller buffers are cheap enough to copy when coalescing
 
         static constexpr int MegaBufferTableShiftMin{std::countr_zero(0x100U)}; //!< The minimum shift for megabuffer table entries, giving an alignment of at least 256 bytes
         static constexpr size_t MegaBufferTableMaxEntries{0x500U}; //!< Maximum number of entries in the megabuffer table, `megaBufferTableShift` is set based on this and the total buffer size
@@ -342,9 +347,10 @@ namespace skyline::gpu {
         /**
          * @brief Synchronizes the host buffer with the guest
          * @param skipTrap If true, setting up a CPU trap will be skipped
+         * @param excludedRanges Sorted guest ranges within the buffer which shouldn't be synchronized, this is used when coalescing sparse buffers as the backing of ranges covered by prior sparse buffers is shared with them and may be newer than the guest
          * @note The buffer **must** be locked prior to calling this
          */
-        void SynchronizeHost(bool skipTrap = false);
+        void SynchronizeHost(bool skipTrap = false, span<const GuestBuffer> excludedRanges = {});
 
         /**
          * @brief Synchronizes the guest buffer with the host buffer
@@ -44,11 +44,14 @@ namespace skyline::gpu {
     void BufferManager::InsertBuffer(std::shared_ptr<Buffer> buffer) {
         auto bufferStart{buffer->guest->begin().base()}, bufferEnd{buffer->guest->end().base()};
         bufferTable.Set(bufferStart, bufferEnd, buffer.get());
+        mappedSize += buffer->guest->size();
+        TRACE_COUNTER("gpu", "Buffer Mapped Size", static_cast<i64>(mappedSize));
         bufferMappings.insert(std::lower_bound(bufferMappings.begin(), bufferMappings.end(), bufferEnd, BufferLessThan), std::move(buffer));
     }
 
     void BufferManager::DeleteBuffer(const std::shared_ptr<Buffer> &buffer) {
         bufferTable.Set(buffer->guest->begin().base(), buffer->guest->end().base(), nullptr);
+        mappedSize -= buffer->guest->size();
         bufferMappings.erase(std::find(bufferMappings.begin(), bufferMappings.end(), buffer));
     }
 
@@ -57,7 +60,8 @@ namespace skyline::gpu {
         std::shared_ptr<FenceCycle> newBufferCycle{};
         for (auto &srcBuffer : srcBuffers) {
             // Since new direct buffers will share the underlying backing of source buffers we don't need to wait for the GPU if they're dirty, for non direct buffers we do though as otherwise we won't be able to migrate their contents to the new backing
-            if (!*gpu.state.settings->useDirectMemoryImport && (srcBuffer->dirtyState == Buffer::DirtyState::GpuDirty || srcBuffer->AllCpuBackingWritesBlocked()))
+            // Sparse buffers also share their backing with the new buffer, CPU dirty contents will be synchronized into it so any GPU reads of it must be complete
+            if (!*gpu.state.settings->useDirectMemoryImport && (srcBuffer->dirtyState == Buffer::DirtyState::GpuDirty || srcBuffer->AllCpuBackingWritesBlocked() || (srcBuffer->sparseBacking && srcBuffer->dirtyState == Buffer::DirtyState::CpuDirty)))
                 srcBuffer->WaitOnFence();
 
             // We can't chain cycles here as that may also introduce a deadlock since we have no way to determine what order to chain them in right now
@@ -69,6 +73,7 @@ namespace skyline::gpu {
         }
 
         std::scoped_lock lock{recreationMutex};
+        auto coalesceStartNs{util::GetTimeNs()};
         if (!range.valid())
             range = span<u8>{srcBuffers.front().buffer->guest->begin(), srcBuffers.back().buffer->guest->end()};
 
@@ -84,19 +89,32 @@ namespace skyline::gpu {
 
         LockedBuffer newBuffer{std::make_shared<Buffer>(delegateAllocatorState, gpu, span<u8>{lowestAddress, highestAddress}, nextBufferId++, *gpu.state.settings->useDirectMemoryImport), tag}; // If we don't lock the buffer prior to trapping it during synchronization, a race could occur with a guest trap acquiring the lock before we do and mutating the buffer prior to it being ready
 
+        // Sparse source buffers share their backing with the new buffer, unless the guest is newer than it the contents of their ranges are already in place and may be newer than the guest
+        boost::container::small_vector<GuestBuffer, 4> sharedRanges;
+        for (const auto &srcBuffer : srcBuffers)
+            if (srcBuffer->sparseBacking && srcBuffer->dirtyState != Buffer::DirtyState::CpuDirty)
+                sharedRanges.push_back(*srcBuffer->guest);
+        std::sort(sharedRanges.begin(), sharedRanges.end(), [](const GuestBuffer &a, const GuestBuffer &b) { return a.data() < b.data(); });
+
+        size_t copiedSize{newBuffer->mirror.size()};
+        for (const auto &sharedRange : sharedRanges)
+            copiedSize -= sharedRange.size();
+
         newBuffer->SetupStagedTraps();
-        newBuffer->SynchronizeHost(false); // Overlaps don't necessarily fully cover the buffer so we have to perform a sync here to prevent any gaps
+        newBuffer->SynchronizeHost(false, span<const GuestBuffer>{sharedRanges.data(), sharedRanges.size()}); // Overlaps don't necessarily fully cover the buffer so we have to perform a sync here to prevent any gaps
         newBuffer->cycle = newBufferCycle;
 
-        auto copyBuffer{[](auto dstGuest, auto srcGuest, auto dstPtr, auto srcPtr) {
+        auto copyBuffer{[&copiedSize](auto dstGuest, auto srcGuest, auto dstPtr, auto srcPtr) {
             if (dstGuest.begin().base() <= srcGuest.begin().base()) {
                 size_t dstOffset{static_cast<size_t>(srcGuest.begin().base() - dstGuest.begin().base())};
                 size_t copySize{std::min(dstGuest.size() - dstOffset, srcGuest.size())};
                 std::memcpy(dstPtr + dstOffset, srcPtr, copySize);
+                copiedSize += copySize;
             } else if (dstGuest.begin().base() > srcGuest.begin().base()) {
                 size_t srcOffset{static_cast<size_t>(dstGuest.begin().base() - srcGuest.begin().base())};
                 size_t copySize{std::min(dstGuest.size(), srcGuest.size() - srcOffset)};
                 std::memcpy(dstPtr, srcPtr + srcOffset, copySize);
+                copiedSize += copySize;
             }
         }}; //!< Copies between two buffers based off of their mappings in guest memory
 
@@ -117,13 +135,15 @@ namespace skyline::gpu {
                         newBuffer->MarkGpuDirtyImpl();
 
                     // Since we don't synchost source buffers and the source buffers here are GPU dirty their mirrors will be out of date, meaning the backing contents of this source buffer's region in the new buffer from the initial synchost call will be incorrect. By copying backings directly here we can ensure that no writes are lost and that if the newly created buffer needs to turn GPU dirty during recreation no copies need to be done since the backing is as up to date as the mirror at a minimum.
-                    copyBuffer(*newBuffer->guest, *srcBuffer->guest, newBuffer->backing->data(), srcBuffer->backing->data());
+                    if (!srcBuffer->sparseBacking)
+                        copyBuffer(*newBuffer->guest, *srcBuffer->guest, newBuffer->backing->data(), srcBuffer->backing->data());
                 } else if (srcBuffer->AllCpuBackingWritesBlocked()) {
                     if (srcBuffer->dirtyState == Buffer::DirtyState::CpuDirty)
                         Logger::Error("Buffer (0x{}-0x{}) is marked as CPU dirty while CPU backing writes are blocked, this is not valid", srcBuffer->guest->begin().base(), srcBuffer->guest->end().base());
 
                     // We need the backing to be stable so that any writes within this context are sequenced correctly, we can't use the source mirror here either since buffer writes within this context will update the mirror on CPU and backing on GPU
-                    copyBuffer(*newBuffer->guest, *srcBuffer->guest, newBuffer->backing->data(), srcBuffer->backing->data());
+                    if (!srcBuffer->sparseBacking)
+                        copyBuffer(*newBuffer->guest, *srcBuffer->guest, newBuffer->backing->data(), srcBuffer->backing->data());
                 }
             } else {
                 if (srcBuffer->RefreshGpuWritesActiveDirect(false, {})) {
@@ -140,6 +160,8 @@ namespace skyline::gpu {
             srcBuffer->delegate->Link(newBuffer->delegate, overlapOffset);
         }
 
+        TRACE_COUNTER("gpu", "Buffer Coalesce Time", util::GetTimeNs() - coalesceStartNs);
+        TRACE_COUNTER("gpu", "Buffer Coalesce Copy Size", static_cast<i64>(copiedSize));
         return newBuffer;
     }
 
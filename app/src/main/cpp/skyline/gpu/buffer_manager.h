@@ -19,6 +19,7 @@ namespace skyline::gpu {
         std::vector<std::shared_ptr<Buffer>> bufferMappings; //!< A sorted vector of all buffer mappings
         LinearAllocatorState<> delegateAllocatorState; //!< Linear allocator used to allocate buffer delegates
         size_t nextBufferId{}; //!< The next unique buffer id to be assigned
+        size_t mappedSize{}; //!< The total size of all buffer mappings, regular buffers have a backing of the same size while sparse buffers share the backing of guest blocks they cover
 
         static constexpr size_t L2EntryGranularity{19}; //!< The amount of AS (in bytes) a single L2 PTE covers (512 KiB == 1 << 19)
         SegmentTable<Buffer *, constant::AddressSpaceSize, constant::PageSizeBits, L2EntryGranularity> bufferTable; //!< A page table of all buffer mappings for O(1) lookups on full matches
@@ -3,6 +3,7 @@
 
 #include <gpu.h>
 #include <loader/loader.h>
+#include <common/trace.h>
 #include <vulkan/vulkan.hpp>
 #include "command_scheduler.h"
 #include "common/exception.h"
@@ -17,7 +18,18 @@ namespace skyline::gpu {
 
             cycleQueue.Process([](const std::shared_ptr<FenceCycle> &cycle) {
                 cycle->Wait(true);
-            }, [] {});
+            }, [this] {
+                // The CPU time of this thread and the average submission time are sampled whenever all queued cycles are signalled, this allows comparing the overhead of the fence and timeline backends
+                timespec cpuTime{};
+                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+                TRACE_COUNTER("gpu", "Cycle Waiter CPU Time", static_cast<i64>(cpuTime.tv_sec) * constant::NsInSecond + cpuTime.tv_nsec);
+
+                if (u64 count{submitCount.load(std::memory_order_relaxed)}) {
+                    TRACE_COUNTER("gpu", "Average Submit Time", submitTime.load(std::memory_order_relaxed) / static_cast<i64>(count));
+                    if (transfer)
+                        TRACE_COUNTER("gpu", "Transfer Queue Submit Share", static_cast<double>(transfer->submitCount.load(std::memory_order_relaxed)) / static_cast<double>(count));
+                }
+            });
         } catch (const signal::SignalException &e) {
             Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
             if (state.process)
@@ -33,28 +45,51 @@ namespace skyline::gpu {
         }
     }
 
-    CommandScheduler::CommandBufferSlot::CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool)
+    CommandScheduler::CommandBufferSlot::CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool, TimelineSemaphore *timeline)
         : device{device},
           commandBuffer{device, static_cast<VkCommandBuffer>(commandBuffer), static_cast<VkCommandPool>(*pool)},
-          fence{device, vk::FenceCreateInfo{}},
-          semaphore{device, vk::SemaphoreCreateInfo{}},
-          cycle{std::make_shared<FenceCycle>(device, *fence, *semaphore)} {}
+          fence{timeline ? vk::raii::Fence{nullptr} : vk::raii::Fence{device, vk::FenceCreateInfo{}}},
+          semaphore{timeline ? vk::raii::Semaphore{nullptr} : vk::raii::Semaphore{device, vk::SemaphoreCreateInfo{}}},
+          cycle{timeline ? std::make_shared<FenceCycle>(device, *timeline) : std::make_shared<FenceCycle>(device, *fence, *semaphore)} {}
+
+    static std::optional<TimelineSemaphore> CreateTimeline(GPU &gpu) {
+        if (!gpu.traits.supportsTimelineSemaphores)
+            return std::nullopt;
+
+        Logger::Info("Using timeline semaphores for tracking GPU submissions");
+        return std::optional<TimelineSemaphore>{std::in_place, gpu.vkDevice};
+    }
+
+    CommandScheduler::TransferQueue::TransferQueue(GPU &gpu)
+        : timeline{gpu.vkDevice},
+          pool{std::ref(gpu.vkDevice), vk::CommandPoolCreateInfo{
+              .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+              .queueFamilyIndex = *gpu.vkTransferQueueFamilyIndex,
+          }} {
+        Logger::Info("Using a dedicated transfer queue for texture uploads");
+    }
 
     CommandScheduler::CommandScheduler(const DeviceState &state, GPU &pGpu)
         : state{state},
           gpu{pGpu},
-          waiterThread{&CommandScheduler::WaiterThread, this},
+          timeline{CreateTimeline(pGpu)},
           pool{std::ref(pGpu.vkDevice), vk::CommandPoolCreateInfo{
               .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
               .queueFamilyIndex = pGpu.vkQueueFamilyIndex,
-          }} {}
+          }},
+          transfer{pGpu.vkTransferQueueFamilyIndex ? std::optional<TransferQueue>{std::in_place, pGpu} : std::nullopt},
+          waiterThread{&CommandScheduler::WaiterThread, this} {}
 
     CommandScheduler::~CommandScheduler() {
         waiterThread.join();
     }
 
     CommandScheduler::ActiveCommandBuffer CommandScheduler::AllocateCommandBuffer() {
-        for (auto &slot : pool->buffers) {
+        return AllocateCommandBuffer(*pool, GetTimeline());
+    }
+
+    CommandScheduler::ActiveCommandBuffer CommandScheduler::AllocateCommandBuffer(CommandPool &commandPool, TimelineSemaphore *commandTimeline) {
+        for (auto &slot : commandPool.buffers) {
             if (!slot.active.test_and_set(std::memory_order_acq_rel)) {
                 if (slot.cycle->Poll()) {
                     slot.commandBuffer.reset();
@@ -68,7 +103,7 @@ namespace skyline::gpu {
 
         vk::CommandBuffer commandBuffer;
         vk::CommandBufferAllocateInfo commandBufferAllocateInfo{
-            .commandPool = *pool->vkCommandPool,
+            .commandPool = *commandPool.vkCommandPool,
             .level = vk::CommandBufferLevel::ePrimary,
             .commandBufferCount = 1,
         };
@@ -76,10 +111,10 @@ namespace skyline::gpu {
         auto result{(*gpu.vkDevice).allocateCommandBuffers(&commandBufferAllocateInfo, &commandBuffer, *gpu.vkDevice.getDispatcher())};
         if (result != vk::Result::eSuccess)
             vk::throwResultException(result, __builtin_FUNCTION());
-        return {pool->buffers.emplace_back(gpu.vkDevice, commandBuffer, pool->vkCommandPool)};
+        return {commandPool.buffers.emplace_back(gpu.vkDevice, commandBuffer, commandPool.vkCommandPool, commandTimeline)};
     }
 
-    void CommandScheduler::SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores) {
+    void CommandScheduler::SubmitFenceCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores) {
         boost::container::small_vector<vk::Semaphore, 3> fullWaitSemaphores{waitSemaphores.begin(), waitSemaphores.end()};
         boost::container::small_vector<vk::PipelineStageFlags, 3> fullWaitStages{waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands};
 
@@ -110,6 +145,137 @@ namespace skyline::gpu {
                 throw exception("Vulkan device lost!");
             }
         }
+    }
+
+    void CommandScheduler::SubmitTimelineCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores) {
+        boost::container::small_vector<vk::Semaphore, 3> fullWaitSemaphores{waitSemaphores.begin(), waitSemaphores.end()};
+        boost::container::small_vector<u64, 3> waitValues(waitSemaphores.size()); // Values for binary semaphores are ignored
+        boost::container::small_vector<vk::Semaphore, 2> fullSignalSemaphores{signalSemaphores.begin(), signalSemaphores.end()};
+        fullSignalSemaphores.push_back(**timeline);
+        boost::container::small_vector<u64, 2> signalValues(fullSignalSemaphores.size());
+
+        try {
+            std::scoped_lock lock{gpu.queueMutex};
+            // A wait on a timeline (from FenceCycle::RecordSemaphoreWaitUsage) is done on the latest value submitted to its queue, this orders the submission after all prior ones on that queue which includes the cycle being waited on
+            bool waitsOnTransfer{};
+            for (size_t i{}; i < waitSemaphores.size(); i++) {
+                if (waitSemaphores[i] == **timeline) {
+                    waitValues[i] = timeline->LastSubmittedValue();
+                } else if (transfer && waitSemaphores[i] == *transfer->timeline) {
+                    waitValues[i] = transfer->timeline.LastSubmittedValue();
+                    waitsOnTransfer = true;
+                }
+            }
+
+            // All work submitted to the transfer queue prior to this is waited on, this retains the ordering of uploads before their consumers which a single queue would provide
+            if (transfer && !waitsOnTransfer) {
+                u64 transferValue{transfer->timeline.LastSubmittedValue()};
+                if (!transfer->timeline.IsSignalled(transferValue, true)) {
+                    fullWaitSemaphores.push_back(*transfer->timeline);
+                    waitValues.push_back(transferValue);
+                }
+            }
+            boost::container::small_vector<vk::PipelineStageFlags, 3> waitStages{fullWaitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands};
+
+            u64 value{timeline->NextValue()};
+            signalValues.back() = value;
+
+            vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo{
+                .waitSemaphoreValueCount = static_cast<u32>(waitValues.size()),
+                .pWaitSemaphoreValues = waitValues.data(),
+                .signalSemaphoreValueCount = static_cast<u32>(signalValues.size()),
+                .pSignalSemaphoreValues = signalValues.data(),
+            };
+
+            gpu.vkQueue.submit(vk::SubmitInfo{
+                .pNext = &timelineSubmitInfo,
+                .waitSemaphoreCount = static_cast<u32>(fullWaitSemaphores.size()),
+                .pWaitSemaphores = fullWaitSemaphores.data(),
+                .pWaitDstStageMask = waitStages.data(),
+                .commandBufferCount = 1,
+                .pCommandBuffers = &*commandBuffer,
+                .signalSemaphoreCount = static_cast<u32>(fullSignalSemaphores.size()),
+                .pSignalSemaphores = fullSignalSemaphores.data(),
+            });
+
+            timeline->Submitted();
+            cycle->timelineValue.store(value, std::memory_order_release);
+        } catch (const vk::DeviceLostError &e) {
+            // Wait 5 seconds to give traces etc. time to settle
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            throw exception("Vulkan device lost!");
+        }
+
+        TRACE_COUNTER("gpu", "Graphics Queue In-Flight", timeline->LastSubmittedValue() - std::min(timeline->LastCompletedValue(), timeline->LastSubmittedValue()));
+    }
+
+    void CommandScheduler::SubmitTransferCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const std::shared_ptr<FenceCycle> &waitCycle) {
+        i64 submitStart{util::GetTimeNs()};
+
+        vk::Semaphore waitSemaphore{};
+        u64 waitValue{};
+        vk::PipelineStageFlags waitStage{vk::PipelineStageFlagBits::eAllCommands};
+        if (waitCycle && !waitCycle->Poll()) {
+            // The value of the cycle is only known after it has been submitted
+            waitCycle->WaitSubmit();
+            if (waitCycle->timeline == &*timeline) {
+                waitSemaphore = **timeline;
+                waitValue = waitCycle->timelineValue.load(std::memory_order_acquire);
+            } else if (waitCycle->timeline != &transfer->timeline) {
+                waitCycle->Wait(); // Cycles which aren't on either timeline can't be waited on by the GPU, prior work on the transfer queue itself is ordered by the queue
+            }
+        }
+
+        try {
+            std::scoped_lock lock{gpu.transferQueueMutex};
+            u64 value{transfer->timeline.NextValue()};
+            vk::Semaphore signalSemaphore{*transfer->timeline};
+
+            vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo{
+                .waitSemaphoreValueCount = waitSemaphore ? 1U : 0U,
+                .pWaitSemaphoreValues = &waitValue,
+                .signalSemaphoreValueCount = 1,
+                .pSignalSemaphoreValues = &value,
+            };
+
+            gpu.vkTransferQueue.submit(vk::SubmitInfo{
+                .pNext = &timelineSubmitInfo,
+                .waitSemaphoreCount = waitSemaphore ? 1U : 0U,
+                .pWaitSemaphores = &waitSemaphore,
+                .pWaitDstStageMask = &waitStage,
+                .commandBufferCount = 1,
+                .pCommandBuffers = &*commandBuffer,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &signalSemaphore,
+            });
+
+            transfer->timeline.Submitted();
+            cycle->timelineValue.store(value, std::memory_order_release);
+        } catch (const vk::DeviceLostError &e) {
+            // Wait 5 seconds to give traces etc. time to settle
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            throw exception("Vulkan device lost!");
+        }
+
+        TRACE_COUNTER("gpu", "Transfer Queue In-Flight", transfer->timeline.LastSubmittedValue() - std::min(transfer->timeline.LastCompletedValue(), transfer->timeline.LastSubmittedValue()));
+
+        submitTime.fetch_add(util::GetTimeNs() - submitStart, std::memory_order_relaxed);
+        submitCount.fetch_add(1, std::memory_order_relaxed);
+        transfer->submitCount.fetch_add(1, std::memory_order_relaxed);
+
+        cycle->NotifySubmitted();
+        cycleQueue.Push(cycle);
+    }
+
+    void CommandScheduler::SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores) {
+        i64 submitStart{util::GetTimeNs()};
+        if (timeline)
+            SubmitTimelineCommandBuffer(commandBuffer, cycle, waitSemaphores, signalSemaphores);
+        else
+            SubmitFenceCommandBuffer(commandBuffer, cycle, waitSemaphores, signalSemaphores);
+
+        submitTime.fetch_add(util::GetTimeNs() - submitStart, std::memory_order_relaxed);
+        submitCount.fetch_add(1, std::memory_order_relaxed);
 
         cycle->NotifySubmitted();
         cycleQueue.Push(cycle);
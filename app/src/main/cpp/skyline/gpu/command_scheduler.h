@@ -20,15 +20,16 @@ namespace skyline::gpu {
             std::atomic_flag active{true}; //!< If the command buffer is currently being recorded to
             const vk::raii::Device &device;
             vk::raii::CommandBuffer commandBuffer;
-            vk::raii::Fence fence; //!< A fence used for tracking all submits of a buffer
-            vk::raii::Semaphore semaphore; //!< A semaphore used for tracking work status on the GPU
+            vk::raii::Fence fence; //!< A fence used for tracking all submits of a buffer, this is null when the timeline backend is in use
+            vk::raii::Semaphore semaphore; //!< A semaphore used for tracking work status on the GPU, this is null when the timeline backend is in use
             std::shared_ptr<FenceCycle> cycle; //!< The latest cycle on the fence, all waits must be performed through this
 
-            CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool);
+            CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool, TimelineSemaphore *timeline);
         };
 
         const DeviceState &state;
         GPU &gpu;
+        std::optional<TimelineSemaphore> timeline; //!< The timeline semaphore signalled by all submissions to the queue, this is only present when the timeline backend is in use
 
         /**
          * @brief A command pool designed to be thread-local to respect external synchronization for all command buffers and the associated pool
@@ -43,12 +44,42 @@ namespace skyline::gpu {
         };
         ThreadLocal<CommandPool> pool;
 
+        /**
+         * @brief The state of the dedicated transfer queue, submissions to it are tracked on a separate timeline semaphore which is used to order them against the graphics queue
+         */
+        struct TransferQueue {
+            TimelineSemaphore timeline;
+            ThreadLocal<CommandPool> pool;
+            std::atomic<u64> submitCount{}; //!< The amount of command buffers that have been submitted to the transfer queue, used for profiling
+
+            TransferQueue(GPU &gpu);
+        };
+        std::optional<TransferQueue> transfer; //!< The dedicated transfer queue, this is only present when the GPU has a dedicated transfer queue
+
         std::thread waiterThread; //!< A thread that waits on and signals FenceCycle(s) then clears any associated resources
         static constexpr size_t FenceCycleWaitCount{256}; //!< The amount of fence cycles the cycle queue can hold
         CircularQueue<std::shared_ptr<FenceCycle>> cycleQueue{FenceCycleWaitCount}; //!< A circular queue containing all the active cycles that can be waited on
 
+        std::atomic<u64> submitCount{}; //!< The amount of command buffers that have been submitted, used for profiling
+        std::atomic<i64> submitTime{}; //!< The total host time spent submitting command buffers in nanoseconds, used for profiling
+
         void WaiterThread();
 
+        /**
+         * @brief Submits a command buffer which signals the cycle's fence and binary semaphore
+         */
+        void SubmitFenceCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores);
+
+        /**
+         * @brief Submits a command buffer which signals the next value of the queue's timeline semaphore and assigns that value to the cycle
+         */
+        void SubmitTimelineCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores);
+
+        /**
+         * @brief Submits a command buffer to the transfer queue which waits on the supplied cycle on the GPU and signals the next value of the transfer timeline
+         */
+        void SubmitTransferCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const std::shared_ptr<FenceCycle> &waitCycle);
+
       public:
         /**
          * @brief An active command buffer occupies a slot and ensures that its status is updated correctly
@@ -73,6 +104,9 @@ namespace skyline::gpu {
                     slot->active.clear(std::memory_order_release);
             }
 
+            /**
+             * @note This will be a null handle when the timeline backend is in use
+             */
             vk::Fence GetFence() {
                 return *slot->fence;
             }
@@ -101,10 +135,25 @@ namespace skyline::gpu {
             }
         };
 
+      private:
+        /**
+         * @brief Allocates an existing or new primary command buffer from the supplied pool with cycles on the supplied timeline
+         */
+        ActiveCommandBuffer AllocateCommandBuffer(CommandPool &commandPool, TimelineSemaphore *commandTimeline);
+
+      public:
         CommandScheduler(const DeviceState &state, GPU &gpu);
 
         ~CommandScheduler();
 
+        /**
+         * @return The timeline semaphore of the queue if the timeline backend is in use, otherwise nullptr
+         * @note Any FenceCycle(s) submitted through this scheduler must be created on this timeline if it's present
+         */
+        TimelineSemaphore *GetTimeline() {
+            return timeline ? &*timeline : nullptr;
+        }
+
         /**
          * @brief Allocates an existing or new primary command buffer from the pool
          */
@@ -140,5 +189,33 @@ namespace skyline::gpu {
                 std::rethrow_exception(std::current_exception());
             }
         }
+
+        /**
+         * @brief Submits a command buffer recorded with the supplied function to the dedicated transfer queue if there is one, otherwise this is equivalent to Submit()
+         * @param waitCycle A cycle which the GPU must complete prior to executing the command buffer, it's waited on with the timeline semaphore of its queue
+         * @note The command buffer must only contain commands that are supported on a queue without graphics or compute support
+         * @note All submissions to the graphics queue after this wait on it on the GPU, consumers of the transferred data don't need to synchronize with it explicitly
+         */
+        template<typename RecordFunction>
+        std::shared_ptr<FenceCycle> SubmitTransfer(RecordFunction recordFunction, const std::shared_ptr<FenceCycle> &waitCycle = {}) {
+            if (!transfer)
+                return Submit(std::move(recordFunction));
+
+            auto commandBuffer{AllocateCommandBuffer(*transfer->pool, &transfer->timeline)};
+            try {
+                commandBuffer->begin(vk::CommandBufferBeginInfo{
+                    .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+                });
+                recordFunction(*commandBuffer);
+                commandBuffer->end();
+
+                auto cycle{commandBuffer.GetFenceCycle()};
+                SubmitTransferCommandBuffer(*commandBuffer, cycle, waitCycle);
+                return cycle;
+            } catch (...) {
+                commandBuffer.GetFenceCycle()->Cancel();
+                std::rethrow_exception(std::current_exception());
+            }
+        }
     };
 }
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gpu.h>
+#include "descriptor_buffer.h"
+
+namespace skyline::gpu {
+    DescriptorBufferChunk::DescriptorBufferChunk(GPU &gpu, vk::DeviceSize size)
+        : backing{gpu.memory.AllocateBuffer(size, DescriptorBufferAllocator::DescriptorBufferUsage)},
+          address{gpu.memory.GetBufferDeviceAddress(backing.vkBuffer)},
+          freeRegion{backing} {}
+
+    bool DescriptorBufferChunk::TryReset() {
+        if (cycle && cycle->Poll(true)) {
+            freeRegion = backing;
+            cycle = nullptr;
+            return true;
+        }
+
+        return cycle == nullptr;
+    }
+
+    vk::DeviceAddress DescriptorBufferChunk::GetAddress() const {
+        return address;
+    }
+
+    std::pair<vk::DeviceSize, span<u8>> DescriptorBufferChunk::Allocate(const std::shared_ptr<FenceCycle> &newCycle, vk::DeviceSize size, vk::DeviceSize alignment) {
+        auto alignedFreeBase{util::AlignUp(static_cast<vk::DeviceSize>(freeRegion.data() - backing.data()), alignment)};
+        if (alignedFreeBase + size > backing.size())
+            return {0, {}};
+
+        freeRegion = backing.subspan(alignedFreeBase);
+
+        if (cycle != newCycle) {
+            newCycle->ChainCycle(cycle);
+            cycle = newCycle;
+        }
+
+        // Allocate space for the descriptor set from the free region and move the free region along
+        auto resultSpan{freeRegion.subspan(0, size)};
+        freeRegion = freeRegion.subspan(size);
+
+        return {alignedFreeBase, resultSpan};
+    }
+
+    DescriptorBufferAllocator::DescriptorBufferAllocator(GPU &gpu) : gpu{gpu}, activeChunk{chunks.end()} {
+        if (gpu.traits.descriptorBackend != TraitManager::DescriptorBackend::Buffer)
+            return;
+
+        // Combined image samplers require the buffer to be bound as a sampler descriptor buffer, which has a separate (typically lower) range limit
+        const auto &properties{gpu.traits.descriptorBufferProperties};
+        chunkSize = std::min({DescriptorBufferChunkSize, properties.maxResourceDescriptorBufferRange, properties.maxSamplerDescriptorBufferRange});
+    }
+
+    size_t DescriptorBufferAllocator::GetDescriptorSize(vk::DescriptorType type) const {
+        const auto &properties{gpu.traits.descriptorBufferProperties};
+        bool robust{gpu.traits.supportsRobustBufferAccess};
+        switch (type) {
+            case vk::DescriptorType::eUniformBuffer:
+                return robust ? properties.robustUniformBufferDescriptorSize : properties.uniformBufferDescriptorSize;
+            case vk::DescriptorType::eStorageBuffer:
+                return robust ? properties.robustStorageBufferDescriptorSize : properties.storageBufferDescriptorSize;
+            case vk::DescriptorType::eCombinedImageSampler:
+                return properties.combinedImageSamplerDescriptorSize;
+            case vk::DescriptorType::eSampledImage:
+                return properties.sampledImageDescriptorSize;
+            case vk::DescriptorType::eStorageImage:
+                return properties.storageImageDescriptorSize;
+            case vk::DescriptorType::eSampler:
+                return properties.samplerDescriptorSize;
+            default:
+                throw exception("Unsupported descriptor type in descriptor buffer: {}", vk::to_string(type));
+        }
+    }
+
+    DescriptorBufferAllocator::Allocation DescriptorBufferAllocator::Allocate(const std::shared_ptr<FenceCycle> &cycle, vk::DescriptorSetLayout layout) {
+        std::scoped_lock lock{mutex};
+
+        auto sizeIt{layoutSizes.find(static_cast<VkDescriptorSetLayout>(layout))};
+        if (sizeIt == layoutSizes.end())
+            sizeIt = layoutSizes.emplace(static_cast<VkDescriptorSetLayout>(layout), (*gpu.vkDevice).getDescriptorSetLayoutSizeEXT(layout, *gpu.vkDevice.getDispatcher())).first;
+
+        vk::DeviceSize size{sizeIt->second};
+        vk::DeviceSize alignment{gpu.traits.descriptorBufferProperties.descriptorBufferOffsetAlignment};
+
+        if (activeChunk != chunks.end())
+            if (auto allocation{activeChunk->Allocate(cycle, size, alignment)}; !allocation.second.empty())
+                return {activeChunk->GetAddress(), allocation.first, allocation.second};
+
+        activeChunk = ranges::find_if(chunks, [&](auto &chunk) { return chunk.TryReset(); });
+        if (activeChunk == chunks.end()) // If there are no chunks available, allocate a new one
+            activeChunk = chunks.emplace(chunks.end(), gpu, chunkSize);
+
+        if (auto allocation{activeChunk->Allocate(cycle, size, alignment)}; !allocation.second.empty())
+            return {activeChunk->GetAddress(), allocation.first, allocation.second};
+        else
+            throw exception("Failed to to allocate descriptor buffer space for size: 0x{:X}", size);
+    }
+
+    void DescriptorBufferAllocator::Write(const Allocation &allocation, vk::DescriptorSetLayout layout, span<const vk::WriteDescriptorSet> writes) {
+        auto &dispatcher{*gpu.vkDevice.getDispatcher()};
+        for (const auto &write : writes) {
+            vk::DeviceSize bindingOffset{(*gpu.vkDevice).getDescriptorSetLayoutBindingOffsetEXT(layout, write.dstBinding, dispatcher)};
+            size_t descriptorSize{GetDescriptorSize(write.descriptorType)};
+
+            for (u32 i{}; i < write.descriptorCount; i++) {
+                vk::DescriptorGetInfoEXT getInfo{
+                    .type = write.descriptorType,
+                };
+                vk::DescriptorAddressInfoEXT addressInfo{};
+
+                switch (write.descriptorType) {
+                    case vk::DescriptorType::eUniformBuffer:
+                    case vk::DescriptorType::eStorageBuffer: {
+                        const auto &bufferInfo{write.pBufferInfo[i]};
+                        if (bufferInfo.buffer) {
+                            addressInfo.address = gpu.memory.GetBufferDeviceAddress(bufferInfo.buffer) + bufferInfo.offset;
+                            addressInfo.range = bufferInfo.range;
+                            if (write.descriptorType == vk::DescriptorType::eUniformBuffer)
+                                getInfo.data.pUniformBuffer = &addressInfo;
+                            else
+                                getInfo.data.pStorageBuffer = &addressInfo;
+                        } // A null pointer results in a null descriptor being written
+                        break;
+                    }
+
+                    case vk::DescriptorType::eCombinedImageSampler:
+                        getInfo.data.pCombinedImageSampler = &write.pImageInfo[i];
+                        break;
+
+                    case vk::DescriptorType::eSampledImage:
+                        getInfo.data.pSampledImage = &write.pImageInfo[i];
+                        break;
+
+                    case vk::DescriptorType::eStorageImage:
+                        getInfo.data.pStorageImage = &write.pImageInfo[i];
+                        break;
+
+                    case vk::DescriptorType::eSampler:
+                        getInfo.data.pSampler = &write.pImageInfo[i].sampler;
+                        break;
+
+                    default:
+                        throw exception("Unsupported descriptor type in descriptor buffer: {}", vk::to_string(write.descriptorType));
+                }
+
+                auto descriptor{allocation.region.subspan(bindingOffset + (write.dstArrayElement + i) * descriptorSize, descriptorSize)};
+                (*gpu.vkDevice).getDescriptorEXT(&getInfo, descriptorSize, descriptor.data(), dispatcher);
+            }
+        }
+    }
+
+    void DescriptorBufferAllocator::Bind(vk::raii::CommandBuffer &commandBuffer, const Allocation &allocation, vk::PipelineBindPoint bindPoint, vk::PipelineLayout pipelineLayout, u32 setIndex) {
+        // Descriptor buffer bindings are invalidated by any non-descriptor-buffer set binds (e.g. from helper shaders) so we always rebind the chunk
+        commandBuffer.bindDescriptorBuffersEXT(vk::DescriptorBufferBindingInfoEXT{
+            .address = allocation.bufferAddress,
+            .usage = DescriptorBufferUsage,
+        });
+
+        u32 bufferIndex{};
+        commandBuffer.setDescriptorBufferOffsetsEXT(bindPoint, pipelineLayout, setIndex, bufferIndex, allocation.offset);
+    }
+}
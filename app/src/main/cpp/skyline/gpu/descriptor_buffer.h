@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <tsl/robin_map.h>
+#include <common/spin_lock.h>
+#include "memory_manager.h"
+
+namespace skyline::gpu {
+    constexpr static vk::DeviceSize DescriptorBufferChunkSize{4 * 1024 * 1024}; //!< Size in bytes of a single descriptor buffer chunk (4MiB), this may be lowered to fit within the device's descriptor buffer range limits
+
+    /**
+     * @brief A linearly allocated descriptor buffer which descriptors are directly written into, this follows the same reuse scheme as MegaBufferChunk
+     * @note This class is **not** thread-safe and any calls must be externally synchronized
+     */
+    class DescriptorBufferChunk {
+      private:
+        std::shared_ptr<FenceCycle> cycle; //!< Latest cycle this chunk has had allocations in
+        memory::Buffer backing; //!< The GPU buffer as the backing storage for the chunk
+        vk::DeviceAddress address; //!< The device address of the backing buffer
+        span<u8> freeRegion; //!< The unallocated space in the chunk
+
+      public:
+        DescriptorBufferChunk(GPU &gpu, vk::DeviceSize size);
+
+        /**
+         * @brief If the chunk's cycle is is signalled, resets the free region of the chunk to its initial state, if it's not signalled the chunk must not be used
+         * @returns True if the chunk can be reused, false otherwise
+         */
+        bool TryReset();
+
+        vk::DeviceAddress GetAddress() const;
+
+        /**
+         * @return The offset and CPU mapping of the allocation, a zero-sized span is returned if the chunk has insufficient space
+         */
+        std::pair<vk::DeviceSize, span<u8>> Allocate(const std::shared_ptr<FenceCycle> &newCycle, vk::DeviceSize size, vk::DeviceSize alignment);
+    };
+
+    /**
+     * @brief A ring allocator for descriptor buffer chunks (with VK_EXT_descriptor_buffer), descriptor sets are written directly into chunk memory at record time which avoids any pool management and vkUpdateDescriptorSets calls
+     * @note All functions are thread-safe, allocation is internally synchronized as it may be called from the GPFIFO threads of multiple channels concurrently
+     */
+    class DescriptorBufferAllocator {
+      private:
+        GPU &gpu;
+        SpinLock mutex; //!< Synchronizes allocation across channels
+        vk::DeviceSize chunkSize{}; //!< The size of every chunk, clamped to the device limits
+        std::list<DescriptorBufferChunk> chunks; //!< A pool of all allocated descriptor buffer chunks, these are lazily allocated on the first allocation
+        decltype(chunks)::iterator activeChunk; //!< Currently active chunk which is being allocated into
+        tsl::robin_map<VkDescriptorSetLayout, vk::DeviceSize> layoutSizes; //!< A cache of the sizes of descriptor set layouts that have been allocated
+
+        /**
+         * @return The size of a single descriptor of the supplied type inside a descriptor buffer
+         */
+        size_t GetDescriptorSize(vk::DescriptorType type) const;
+
+      public:
+        static constexpr vk::BufferUsageFlags DescriptorBufferUsage{vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT | vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT};
+
+        /**
+         * @brief A descriptor set allocated inside a descriptor buffer chunk
+         */
+        struct Allocation {
+            vk::DeviceAddress bufferAddress; //!< The device address of the chunk that the allocation was made within
+            vk::DeviceSize offset; //!< The offset of the allocation in the chunk
+            span<u8> region; //!< The CPU mapped region of the allocation in the chunk
+        };
+
+        DescriptorBufferAllocator(GPU &gpu);
+
+        /**
+         * @brief Allocates space for a descriptor set with the supplied layout in a descriptor buffer chunk
+         * @note The layout **must** have been created with VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+         */
+        Allocation Allocate(const std::shared_ptr<FenceCycle> &cycle, vk::DescriptorSetLayout layout);
+
+        /**
+         * @brief Writes the supplied descriptor writes into the allocation, the `dstSet` member of the writes is ignored
+         * @note Only buffer and image descriptors are supported, texel buffer descriptors will result in an exception
+         */
+        void Write(const Allocation &allocation, vk::DescriptorSetLayout layout, span<const vk::WriteDescriptorSet> writes);
+
+        /**
+         * @brief Binds the chunk containing the allocation and sets the offset of the allocation for the specified set index
+         */
+        void Bind(vk::raii::CommandBuffer &commandBuffer, const Allocation &allocation, vk::PipelineBindPoint bindPoint, vk::PipelineLayout pipelineLayout, u32 setIndex);
+    };
+}
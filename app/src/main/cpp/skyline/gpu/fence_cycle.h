@@ -8,12 +8,14 @@
 #include <common.h>
 #include <common/spin_lock.h>
 #include <common/atomic_forward_list.h>
+#include "timeline_semaphore.h"
 
 namespace skyline::gpu {
     class CommandScheduler;
 
     /**
      * @brief A wrapper around a Vulkan Fence which only tracks a single reset -> signal cycle with the ability to attach lifetimes of objects to it
+     * @note If the cycle is created on a timeline semaphore then it has no fence or binary semaphore, it's instead signalled when the timeline reaches the value assigned to it at submission
      * @note This provides the guarantee that the fence must be signalled prior to destruction when objects are to be destroyed
      * @note All waits to the fence **must** be done through the same instance of this, the state of the fence changing externally will lead to UB
      */
@@ -30,6 +32,8 @@ namespace skyline::gpu {
         bool semaphoreSubmitWait{}; //!< If the semaphore needs to be waited on (on GPU) before the fence's command buffer begins. Used to ensure fences that wouldn't otherwise be unsignalled are unsignalled
         bool nextSemaphoreSubmitWait{true}; //!< If the next fence cycle created from this one after it's signalled should wait on the semaphore to unsignal it
         std::shared_ptr<FenceCycle> semaphoreUnsignalCycle{}; //!< If the semaphore is used on the GPU, the cycle for the submission that uses it, so it can be waited on before the fence is signalled to ensure the semaphore is unsignalled
+        TimelineSemaphore *timeline{}; //!< The timeline semaphore of the queue this cycle is submitted to, this is null if the cycle uses a binary fence and semaphore
+        std::atomic<u64> timelineValue{}; //!< The value that the timeline will reach once the cycle's command buffer has completed, this is zero till the cycle is submitted
 
         friend CommandScheduler;
 
@@ -55,8 +59,11 @@ namespace skyline::gpu {
                 device.resetFences(fence);
         }
 
-        explicit FenceCycle(const FenceCycle &cycle) : signalled{false}, device{cycle.device}, fence{cycle.fence}, semaphore{cycle.semaphore}, semaphoreSubmitWait{cycle.nextSemaphoreSubmitWait} {
-            device.resetFences(fence);
+        FenceCycle(const vk::raii::Device &device, TimelineSemaphore &timeline, bool signalled = false) : signalled{signalled}, device{device}, nextSemaphoreSubmitWait{false}, timeline{&timeline} {}
+
+        explicit FenceCycle(const FenceCycle &cycle) : signalled{false}, device{cycle.device}, fence{cycle.fence}, semaphore{cycle.semaphore}, semaphoreSubmitWait{!cycle.timeline && cycle.nextSemaphoreSubmitWait}, nextSemaphoreSubmitWait{!cycle.timeline}, timeline{cycle.timeline} {
+            if (!timeline)
+                device.resetFences(fence);
         }
 
         ~FenceCycle() {
@@ -78,6 +85,13 @@ namespace skyline::gpu {
             // We can't submit any semaphore waits until the signal has been submitted, so do that first
             WaitSubmit();
 
+            if (timeline) {
+                // Timeline semaphores can be waited on by any amount of submissions and never need to be unsignalled, the scheduler waits on the value of the latest submission which this cycle's value can't exceed
+                if (signalled.test(std::memory_order_consume) || timeline->IsSignalled(timelineValue.load(std::memory_order_acquire), true))
+                    return func({});
+                return func(**timeline);
+            }
+
             std::unique_lock lock{mutex};
 
             // If we already have a semaphore usage, just wait on the fence since we can't wait on it twice and have no way to add one after the fact
@@ -138,10 +152,16 @@ namespace skyline::gpu {
                 return;
             }
 
+            u64 chainedValue{}; // The highest value of any chained cycles on the same timeline, these are all resolved with a single wait alongside this cycle
             {
                 std::shared_lock lock{chainMutex};
-                chainedCycles.Iterate([shouldDestroy](auto &cycle) {
-                    cycle->Wait(shouldDestroy);
+                chainedCycles.Iterate([&](auto &cycle) {
+                    if (timeline && cycle->timeline == timeline) {
+                        cycle->WaitSubmit();
+                        chainedValue = std::max(chainedValue, cycle->timelineValue.load(std::memory_order_acquire));
+                    } else {
+                        cycle->Wait(shouldDestroy);
+                    }
                 });
             }
 
@@ -155,6 +175,15 @@ namespace skyline::gpu {
                 return;
             }
 
+            if (timeline) {
+                timeline->Wait(std::max(timelineValue.load(std::memory_order_relaxed), chainedValue));
+
+                signalled.test_and_set(std::memory_order_relaxed);
+                if (shouldDestroy)
+                    DestroyDependencies();
+                return;
+            }
+
             vk::Result waitResult;
             while ((waitResult = (*device).waitForFences(1, &fence, false, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
                 if (waitResult == vk::Result::eTimeout)
@@ -177,7 +206,7 @@ namespace skyline::gpu {
         }
 
         /**
-         * @param quick Skips the call to check the fence's status, just checking the signalled flag
+         * @param quick Skips the call to check the fence's status, just checking the signalled flag or the last known completed value of the timeline
          * @return If the fence is signalled currently or not
          */
         bool Poll(bool quick = true, bool shouldDestroy = false) {
@@ -192,8 +221,15 @@ namespace skyline::gpu {
                 return true;
             }
 
-            if (quick)
-                return false; // We need to return early if we're not waiting on the fence
+            if (quick) {
+                // Checking a timeline value against the last known completed value is cheap enough to be done even for quick polls, the checks below won't query the device in that case
+                if (!timeline)
+                    return false;
+
+                u64 value{timelineValue.load(std::memory_order_acquire)};
+                if (!value || !timeline->IsSignalled(value, true))
+                    return false;
+            }
 
             {
                 std::shared_lock lock{chainMutex, std::try_to_lock};
@@ -217,6 +253,16 @@ namespace skyline::gpu {
             if (!submitted)
                 return false;
 
+            if (timeline) {
+                if (!timeline->IsSignalled(timelineValue.load(std::memory_order_relaxed), quick))
+                    return false;
+
+                signalled.test_and_set(std::memory_order_relaxed);
+                if (shouldDestroy)
+                    DestroyDependencies();
+                return true;
+            }
+
             auto status{(*device).getFenceStatus(fence, *device.getDispatcher())};
             if (status == vk::Result::eSuccess) {
                 if (semaphoreUnsignalCycle && !semaphoreUnsignalCycle->Poll())
@@ -254,6 +300,9 @@ namespace skyline::gpu {
          */
         void ChainCycle(const std::shared_ptr<FenceCycle> &cycle) {
             if (cycle && !signalled.test(std::memory_order_consume) && cycle.get() != this && !cycle->Poll()) {
+                if (timeline && cycle->timeline == timeline && !timelineValue.load(std::memory_order_acquire) && cycle->timelineValue.load(std::memory_order_acquire))
+                    return; // A cycle that's already been submitted on the same timeline has a lower value than this cycle will get, so it's implicitly signalled before this cycle
+
                 std::shared_lock lock{chainMutex};
                 chainedCycles.Append(cycle); // If the cycle isn't the current cycle or already signalled, we need to chain it
             }
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include "frame_time_histogram.h"
+
+namespace skyline::gpu {
+    u64 FrameTimeHistogram::Record(i64 frameTimeNs) {
+        std::scoped_lock lock{mutex};
+        auto bucket{std::min(static_cast<size_t>(std::max<i64>(frameTimeNs, 0) / BucketWidthNs), BucketCount - 1)};
+        buckets[bucket]++;
+        if (bucket == BucketCount - 1)
+            overflowFrameTimeNs += frameTimeNs;
+        totalFrameTimeNs += frameTimeNs;
+        return ++frameCount;
+    }
+
+    FrameTimeHistogram::Summary FrameTimeHistogram::GetSummary() const {
+        std::scoped_lock lock{mutex};
+        Summary summary{.frameCount = frameCount};
+        if (!frameCount)
+            return summary;
+
+        constexpr double NsInMillisecond{constant::NsInMillisecond};
+        auto bucketMs{[](size_t bucket) {
+            return (static_cast<double>(bucket) + 0.5) * BucketWidthNs / NsInMillisecond; // The midpoint of a bucket is used as the estimate for all frames in it
+        }};
+
+        auto percentileMs{[&](double percentile) {
+            auto target{static_cast<u64>(std::ceil(percentile * static_cast<double>(frameCount)))};
+            u64 count{};
+            for (size_t bucket{}; bucket < BucketCount; bucket++)
+                if ((count += buckets[bucket]) >= target)
+                    return bucketMs(bucket);
+            return bucketMs(BucketCount - 1);
+        }};
+
+        summary.averageMs = static_cast<double>(totalFrameTimeNs) / static_cast<double>(frameCount) / NsInMillisecond;
+        summary.p50Ms = percentileMs(0.50);
+        summary.p95Ms = percentileMs(0.95);
+        summary.p99Ms = percentileMs(0.99);
+
+        // The slowest 1% of frames are accumulated from the highest bucket downwards
+        u64 lowCount{std::max<u64>(frameCount / 100, 1)}, counted{};
+        double lowTotalMs{};
+        for (size_t bucket{BucketCount}; bucket-- > 0 && counted < lowCount;) {
+            u64 taken{std::min<u64>(buckets[bucket], lowCount - counted)};
+            if (!taken)
+                continue;
+
+            if (bucket == BucketCount - 1)
+                lowTotalMs += static_cast<double>(overflowFrameTimeNs) / static_cast<double>(buckets[bucket]) * static_cast<double>(taken) / NsInMillisecond;
+            else
+                lowTotalMs += bucketMs(bucket) * static_cast<double>(taken);
+            counted += taken;
+        }
+        summary.onePercentLowFps = 1000.0 / (lowTotalMs / static_cast<double>(counted));
+
+        return summary;
+    }
+
+    void FrameTimeHistogram::WriteReport(const std::string &path) const {
+        auto summary{GetSummary()};
+        auto summaryLine{fmt::format("Frames: {}, Average: {:.2f}ms, P50: {:.2f}ms, P95: {:.2f}ms, P99: {:.2f}ms, 1% Low: {:.1f} FPS", summary.frameCount, summary.averageMs, summary.p50Ms, summary.p95Ms, summary.p99Ms, summary.onePercentLowFps)};
+        Logger::Info("{}", summaryLine);
+
+        std::ofstream stream{path, std::ios::trunc};
+        if (stream.fail()) {
+            Logger::Warn("Failed to open frame time report: {}", path);
+            return;
+        }
+
+        stream << summaryLine << '\n' << fmt::format("{:>12} {:>12}\n", "Bucket (ms)", "Frames");
+        std::scoped_lock lock{mutex};
+        for (size_t bucket{}; bucket < BucketCount; bucket++)
+            if (buckets[bucket])
+                stream << fmt::format("{:>12.1f} {:>12}\n", static_cast<double>(bucket * BucketWidthNs) / constant::NsInMillisecond, buckets[bucket]);
+
+        Logger::Info("Wrote frame time report to {}", path);
+    }
+}
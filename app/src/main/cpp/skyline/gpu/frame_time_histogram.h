@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::gpu {
+    /**
+     * @brief A histogram of frame times with fixed-width buckets which allows computing percentiles over an entire session in constant memory
+     */
+    class FrameTimeHistogram {
+      private:
+        static constexpr i64 BucketWidthNs{100'000}; //!< The width of a single bucket, this bounds the precision of all percentiles
+        static constexpr size_t BucketCount{1000}; //!< The amount of buckets, frame times past the last bucket are accumulated in it
+
+        mutable std::mutex mutex; //!< Synchronizes access to all members
+        std::array<u32, BucketCount> buckets{};
+        u64 frameCount{};
+        i64 totalFrameTimeNs{};
+        i64 overflowFrameTimeNs{}; //!< The sum of all frame times accumulated in the last bucket, this allows exact averages of outliers
+
+      public:
+        struct Summary {
+            u64 frameCount;
+            double averageMs;
+            double p50Ms;
+            double p95Ms;
+            double p99Ms;
+            double onePercentLowFps; //!< The framerate corresponding to the average of the slowest 1% of frames
+        };
+
+        /**
+         * @return The amount of frames that have been recorded including this one
+         */
+        u64 Record(i64 frameTimeNs);
+
+        Summary GetSummary() const;
+
+        /**
+         * @brief Writes a summary alongside all non-empty buckets to a file at the supplied path and logs the summary
+         */
+        void WriteReport(const std::string &path) const;
+    };
+}
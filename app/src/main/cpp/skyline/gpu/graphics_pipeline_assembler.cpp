@@ -137,7 +137,76 @@ namespace skyline::gpu {
 
     #undef VEC_CPY
 
-    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout) {
+    /**
+     * @return The aspects of a depth/stencil format
+     */
+    static vk::ImageAspectFlags GetDepthStencilAspect(vk::Format format) {
+        switch (format) {
+            case vk::Format::eD16Unorm:
+            case vk::Format::eX8D24UnormPack32:
+            case vk::Format::eD32Sfloat:
+                return vk::ImageAspectFlagBits::eDepth;
+
+            case vk::Format::eS8Uint:
+                return vk::ImageAspectFlagBits::eStencil;
+
+            default:
+                return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+        }
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout, vk::PipelineCreateFlags flags) {
+        vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> pipelineCreateInfo{
+            vk::GraphicsPipelineCreateInfo{
+                .flags = flags,
+                .pStages = pipelineDescIt->shaderStages.data(),
+                .stageCount = static_cast<u32>(pipelineDescIt->shaderStages.size()),
+                .pVertexInputState = &pipelineDescIt->vertexState.get<vk::PipelineVertexInputStateCreateInfo>(),
+                .pInputAssemblyState = &pipelineDescIt->inputAssemblyState,
+                .pTessellationState = &pipelineDescIt->tessellationState,
+                .pViewportState = &pipelineDescIt->viewportState,
+                .pRasterizationState = &pipelineDescIt->rasterizationState.get<vk::PipelineRasterizationStateCreateInfo>(),
+                .pMultisampleState = &pipelineDescIt->multisampleState,
+                .pDepthStencilState = &pipelineDescIt->depthStencilState,
+                .pColorBlendState = &pipelineDescIt->colorBlendState,
+                .pDynamicState = &pipelineDescIt->dynamicState,
+                .layout = pipelineLayout,
+                .subpass = 0,
+            },
+            vk::PipelineRenderingCreateInfo{}
+        };
+
+        std::optional<vk::raii::RenderPass> renderPass;
+        if (gpu.traits.supportsDynamicRendering) {
+            // Pipelines used inside dynamic rendering instances only need the attachment formats rather than a compatible render pass
+            auto depthStencilAspect{GetDepthStencilAspect(pipelineDescIt->depthStencilFormat)};
+            pipelineCreateInfo.get<vk::PipelineRenderingCreateInfo>() = vk::PipelineRenderingCreateInfo{
+                .colorAttachmentCount = static_cast<u32>(pipelineDescIt->colorFormats.size()),
+                .pColorAttachmentFormats = pipelineDescIt->colorFormats.data(),
+                .depthAttachmentFormat = depthStencilAspect & vk::ImageAspectFlagBits::eDepth ? pipelineDescIt->depthStencilFormat : vk::Format::eUndefined,
+                .stencilAttachmentFormat = depthStencilAspect & vk::ImageAspectFlagBits::eStencil ? pipelineDescIt->depthStencilFormat : vk::Format::eUndefined,
+            };
+        } else {
+            renderPass.emplace(CreateCompatibleRenderPass(*pipelineDescIt));
+            pipelineCreateInfo.get<vk::GraphicsPipelineCreateInfo>().renderPass = **renderPass;
+            pipelineCreateInfo.unlink<vk::PipelineRenderingCreateInfo>();
+        }
+
+        auto pipeline{gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, pipelineCreateInfo.get<vk::GraphicsPipelineCreateInfo>())};
+
+        if (pipelineDescIt->destroyShaderModules)
+            for (auto &shaderStage : pipelineDescIt->shaderStages)
+                (*gpu.vkDevice).destroyShaderModule(shaderStage.module, nullptr,  *gpu.vkDevice.getDispatcher());
+
+        std::scoped_lock lock{mutex};
+        compilePendingDescs.erase(pipelineDescIt);
+        if (compilationCallback)
+            compilationCallback();
+
+        return pipeline;
+    }
+
+    vk::raii::RenderPass GraphicsPipelineAssembler::CreateCompatibleRenderPass(const PipelineDescription &pipelineDesc) {
         boost::container::small_vector<vk::AttachmentDescription, 8> attachmentDescriptions;
         boost::container::small_vector<vk::AttachmentReference, 8> attachmentReferences;
 
@@ -145,7 +214,7 @@ namespace skyline::gpu {
             if (format != vk::Format::eUndefined) {
                 attachmentDescriptions.push_back(vk::AttachmentDescription{
                     .format = format,
-                    .samples = pipelineDescIt->sampleCount,
+                    .samples = pipelineDesc.sampleCount,
                     .loadOp = vk::AttachmentLoadOp::eLoad,
                     .storeOp = vk::AttachmentStoreOp::eStore,
                     .stencilLoadOp = vk::AttachmentLoadOp::eLoad,
@@ -170,11 +239,11 @@ namespace skyline::gpu {
             .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
         };
 
-        for (auto &colorAttachment : pipelineDescIt->colorFormats)
+        for (auto &colorAttachment : pipelineDesc.colorFormats)
             pushAttachment(colorAttachment);
 
-        if (pipelineDescIt->depthStencilFormat != vk::Format::eUndefined) {
-            pushAttachment(pipelineDescIt->depthStencilFormat);
+        if (pipelineDesc.depthStencilFormat != vk::Format::eUndefined) {
+            pushAttachment(pipelineDesc.depthStencilFormat);
 
             subpassDescription.pColorAttachments = attachmentReferences.data();
             subpassDescription.colorAttachmentCount = static_cast<u32>(attachmentReferences.size() - 1);
@@ -184,46 +253,29 @@ namespace skyline::gpu {
             subpassDescription.colorAttachmentCount = static_cast<u32>(attachmentReferences.size());
         }
 
-        vk::raii::RenderPass renderPass{gpu.vkDevice, vk::RenderPassCreateInfo{
+        return vk::raii::RenderPass{gpu.vkDevice, vk::RenderPassCreateInfo{
             .attachmentCount = static_cast<u32>(attachmentDescriptions.size()),
             .pAttachments = attachmentDescriptions.data(),
             .subpassCount = 1,
             .pSubpasses = &subpassDescription,
         }};
-
-        auto pipeline{gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, vk::GraphicsPipelineCreateInfo{
-            .pStages = pipelineDescIt->shaderStages.data(),
-            .stageCount = static_cast<u32>(pipelineDescIt->shaderStages.size()),
-            .pVertexInputState = &pipelineDescIt->vertexState.get<vk::PipelineVertexInputStateCreateInfo>(),
-            .pInputAssemblyState = &pipelineDescIt->inputAssemblyState,
-            .pTessellationState = &pipelineDescIt->tessellationState,
-            .pViewportState = &pipelineDescIt->viewportState,
-            .pRasterizationState = &pipelineDescIt->rasterizationState.get<vk::PipelineRasterizationStateCreateInfo>(),
-            .pMultisampleState = &pipelineDescIt->multisampleState,
-            .pDepthStencilState = &pipelineDescIt->depthStencilState,
-            .pColorBlendState = &pipelineDescIt->colorBlendState,
-            .pDynamicState = &pipelineDescIt->dynamicState,
-            .layout = pipelineLayout,
-            .renderPass = *renderPass,
-            .subpass = 0,
-        })};
-
-        if (pipelineDescIt->destroyShaderModules)
-            for (auto &shaderStage : pipelineDescIt->shaderStages)
-                (*gpu.vkDevice).destroyShaderModule(shaderStage.module, nullptr,  *gpu.vkDevice.getDispatcher());
-
-        std::scoped_lock lock{mutex};
-        compilePendingDescs.erase(pipelineDescIt);
-        if (compilationCallback)
-            compilationCallback();
-
-        return pipeline;
     }
 
 
     GraphicsPipelineAssembler::CompiledPipeline GraphicsPipelineAssembler::AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors) {
+        // Pipelines which opt out of push descriptors (e.g. helper shaders) always use descriptor sets from the DescriptorAllocator
+        auto descriptorBackend{noPushDescriptors ? TraitManager::DescriptorBackend::Pool : gpu.traits.descriptorBackend};
         vk::raii::DescriptorSetLayout descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
-            .flags = vk::DescriptorSetLayoutCreateFlags{(!noPushDescriptors && gpu.traits.supportsPushDescriptors) ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
+            .flags = [descriptorBackend]() -> vk::DescriptorSetLayoutCreateFlags {
+                switch (descriptorBackend) {
+                    case TraitManager::DescriptorBackend::Push:
+                        return vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+                    case TraitManager::DescriptorBackend::Buffer:
+                        return vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT;
+                    default:
+                        return {};
+                }
+            }(),
             .pBindings = layoutBindings.data(),
             .bindingCount = static_cast<u32>(layoutBindings.size()),
         }};
@@ -241,7 +293,8 @@ namespace skyline::gpu {
             return std::prev(compilePendingDescs.end());
         }()};
 
-        auto pipelineFuture{pool.submit(&GraphicsPipelineAssembler::AssemblePipeline, this, descIt, *pipelineLayout)};
+        vk::PipelineCreateFlags pipelineFlags{descriptorBackend == TraitManager::DescriptorBackend::Buffer ? vk::PipelineCreateFlagBits::eDescriptorBufferEXT : vk::PipelineCreateFlags{}};
+        auto pipelineFuture{pool.submit(&GraphicsPipelineAssembler::AssemblePipeline, this, descIt, *pipelineLayout, pipelineFlags)};
         return CompiledPipeline{std::move(descriptorSetLayout), std::move(pipelineLayout), std::move(pipelineFuture)};
     }
 
@@ -124,7 +124,12 @@ namespace skyline::gpu {
         /**
          * @brief Synchronously compiles a pipeline with the state from the given description
          */
-        vk::raii::Pipeline AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout);
+        vk::raii::Pipeline AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout, vk::PipelineCreateFlags flags);
+
+        /**
+         * @return A single subpass render pass which is compatible with the attachments of the pipeline, this isn't used with dynamic rendering
+         */
+        vk::raii::RenderPass CreateCompatibleRenderPass(const PipelineDescription &pipelineDesc);
 
       public:
         GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir);
@@ -148,6 +153,7 @@ namespace skyline::gpu {
          * @note All attachments in the PipelineState **must** be locked prior to calling this function
          * @note Shader specializiation constants are **not** supported and will result in UB
          * @note Input/Resolve attachments are **not** supported and using them with the supplied pipeline will result in UB
+         * @param noPushDescriptors If the pipeline should use descriptor sets from the DescriptorAllocator regardless of the active descriptor backend
          */
         CompiledPipeline AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges = {}, bool noPushDescriptors = false);
 
@@ -27,6 +27,9 @@ namespace skyline::gpu::interconnect {
         : state{state},
           incoming{1U << *state.settings->executorSlotCountScale},
           outgoing{1U << *state.settings->executorSlotCountScale},
+          // Occlusion queries may be active across render passes so inherited queries are required to record them into secondaries
+          secondaryWorkerCount{*state.settings->parallelCommandRecording && state.gpu->traits.supportsInheritedQueries ? std::clamp(std::thread::hardware_concurrency() / 2, 1U, MaxSecondaryWorkerCount) : 0U},
+          secondaryWorkers{secondaryWorkerCount ? std::optional<BS::thread_pool>{std::in_place, secondaryWorkerCount} : std::optional<BS::thread_pool>{}},
           thread{&CommandRecordThread::Run, this} {}
 
     CommandRecordThread::Slot::ScopedBegin::ScopedBegin(CommandRecordThread::Slot &slot) : slot{slot} {}
@@ -35,16 +38,36 @@ namespace skyline::gpu::interconnect {
         slot.Begin();
     }
 
-    static vk::raii::CommandBuffer AllocateRaiiCommandBuffer(GPU &gpu, vk::raii::CommandPool &pool) {
+    static vk::raii::CommandBuffer AllocateRaiiCommandBuffer(GPU &gpu, vk::raii::CommandPool &pool, vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary) {
         return {gpu.vkDevice, (*gpu.vkDevice).allocateCommandBuffers(
                     {
                         .commandPool = *pool,
-                        .level = vk::CommandBufferLevel::ePrimary,
+                        .level = level,
                         .commandBufferCount = 1
                     }, *gpu.vkDevice.getDispatcher()).front(),
                 *pool};
     }
 
+    CommandRecordThread::SecondaryCommandPool::SecondaryCommandPool(GPU &gpu)
+        : commandPool{gpu.vkDevice,
+                      vk::CommandPoolCreateInfo{
+                          .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                          .queueFamilyIndex = gpu.vkQueueFamilyIndex
+                      }
+          } {}
+
+    vk::raii::CommandBuffer &CommandRecordThread::SecondaryCommandPool::Acquire(GPU &gpu) {
+        if (usedCount == commandBuffers.size())
+            commandBuffers.emplace_back(AllocateRaiiCommandBuffer(gpu, commandPool, vk::CommandBufferLevel::eSecondary));
+
+        return commandBuffers[usedCount++];
+    }
+
+    void CommandRecordThread::SecondaryCommandPool::Reset() {
+        commandPool.reset();
+        usedCount = 0;
+    }
+
     CommandRecordThread::Slot::Slot(GPU &gpu)
         : commandPool{gpu.vkDevice,
                       vk::CommandPoolCreateInfo{
@@ -53,9 +76,9 @@ namespace skyline::gpu::interconnect {
                       }
           },
           commandBuffer{AllocateRaiiCommandBuffer(gpu, commandPool)},
-          fence{gpu.vkDevice, vk::FenceCreateInfo{ .flags = vk::FenceCreateFlagBits::eSignaled }},
-          semaphore{gpu.vkDevice, vk::SemaphoreCreateInfo{}},
-          cycle{std::make_shared<FenceCycle>(gpu.vkDevice, *fence, *semaphore, true)},
+          fence{gpu.scheduler.GetTimeline() ? vk::raii::Fence{nullptr} : vk::raii::Fence{gpu.vkDevice, vk::FenceCreateInfo{ .flags = vk::FenceCreateFlagBits::eSignaled }}},
+          semaphore{gpu.scheduler.GetTimeline() ? vk::raii::Semaphore{nullptr} : vk::raii::Semaphore{gpu.vkDevice, vk::SemaphoreCreateInfo{}}},
+          cycle{gpu.scheduler.GetTimeline() ? std::make_shared<FenceCycle>(gpu.vkDevice, *gpu.scheduler.GetTimeline(), true) : std::make_shared<FenceCycle>(gpu.vkDevice, *fence, *semaphore, true)},
           nodes{allocator},
           pendingPostRenderPassNodes{allocator} {
         Begin();
@@ -70,6 +93,7 @@ namespace skyline::gpu::interconnect {
           allocator{std::move(other.allocator)},
           nodes{std::move(other.nodes)},
           pendingPostRenderPassNodes{std::move(other.pendingPostRenderPassNodes)},
+          secondaryPools{std::move(other.secondaryPools)},
           ready{other.ready} {}
 
     std::shared_ptr<FenceCycle> CommandRecordThread::Slot::Reset(GPU &gpu) {
@@ -99,76 +123,298 @@ namespace skyline::gpu::interconnect {
         beginCondition.notify_all();
     }
 
+    void CommandRecordThread::RecordNode(Slot *slot, node::NodeHeader *header, node::RenderPassNode *&renderPass, u32 &subpassIndex) {
+        auto &gpu{*state.gpu};
+
+        using namespace node;
+        switch (header->type) {
+            case NodeType::Function:
+                TRACE_EVENT_INSTANT("gpu", "FunctionNode");
+                header->Get<FunctionNode>()(slot->commandBuffer, slot->cycle, gpu);
+                break;
+
+            case NodeType::Checkpoint: {
+                auto &node{header->Get<CheckpointNode>()};
+                RecordFullBarrier(slot->commandBuffer);
+
+                TRACE_EVENT_INSTANT("gpu", "CheckpointNode", "id", node.id, [&](perfetto::EventContext ctx) {
+                    ctx.event()->add_flow_ids(node.id);
+                });
+
+                std::array<vk::BufferCopy, 1> copy{vk::BufferCopy{
+                    .size = node.binding.size,
+                    .srcOffset = node.binding.offset,
+                    .dstOffset = 0,
+                }};
+
+                slot->commandBuffer.copyBuffer(node.binding.buffer, gpu.debugTracingBuffer.vkBuffer, copy);
+
+                RecordFullBarrier(slot->commandBuffer);
+                break;
+            }
+
+            case NodeType::RenderPass: {
+                TRACE_EVENT_INSTANT("gpu", "RenderPassNode");
+                auto beginStartTime{util::GetTimeNs()};
+                renderPass = &header->Get<RenderPassNode>();
+                (*renderPass)(slot->commandBuffer, slot->cycle, gpu);
+                renderPassBeginTimeNs += util::GetTimeNs() - beginStartTime;
+                renderPassBeginCount++;
+                subpassIndex = 0;
+                break;
+            }
+
+            case NodeType::NextSubpass:
+                TRACE_EVENT_INSTANT("gpu", "NextSubpassNode");
+                renderPass->NextSubpass(slot->commandBuffer, vk::SubpassContents::eInline);
+                ++subpassIndex;
+                break;
+
+            case NodeType::SubpassFunction:
+                TRACE_EVENT_INSTANT("gpu", "SubpassFunctionNode");
+                header->Get<SubpassFunctionNode>()(slot->commandBuffer, slot->cycle, gpu, renderPass->renderPass, subpassIndex);
+                break;
+
+            case NodeType::NextSubpassFunction:
+                TRACE_EVENT_INSTANT("gpu", "NextSubpassFunctionNode");
+                renderPass->NextSubpass(slot->commandBuffer, vk::SubpassContents::eInline);
+                header->Get<NextSubpassFunctionNode>()(slot->commandBuffer, slot->cycle, gpu, renderPass->renderPass, ++subpassIndex);
+                break;
+
+            case NodeType::RenderPassEnd:
+                TRACE_EVENT_INSTANT("gpu", "RenderPassEndNode");
+                renderPass->End(slot->commandBuffer);
+                break;
+        }
+    }
+
+    bool CommandRecordThread::PrepareSecondaryJobs(Slot *slot) {
+        auto &gpu{*state.gpu};
+        secondaryJobs.clear();
+        secondaryRenderPasses.clear();
+
+        using namespace node;
+        for (auto it{slot->nodes.Front()}; it; it = it->next) {
+            if (it->type != NodeType::RenderPass)
+                continue;
+
+            auto *renderPassNode{&it->Get<RenderPassNode>()};
+
+            size_t nodeCount{};
+            auto endIt{it->next};
+            for (; endIt && endIt->type != NodeType::RenderPassEnd; endIt = endIt->next)
+                nodeCount++;
+
+            if (!endIt)
+                break;
+
+            if (nodeCount < SecondaryRenderPassThreshold) {
+                it = endIt;
+                continue;
+            }
+
+            // The render pass and framebuffer need to be known ahead of time for the inheritance info of the secondaries
+            auto prepareStartTime{util::GetTimeNs()};
+            renderPassNode->Prepare(gpu);
+            renderPassBeginTimeNs += util::GetTimeNs() - prepareStartTime;
+
+            SecondaryRenderPass secondaryRenderPass{
+                .node = renderPassNode,
+                .endNode = endIt,
+                .firstJob = secondaryJobs.size(),
+            };
+
+            // Every subpass is recorded into its own secondary, as a secondary can only ever continue a single subpass
+            auto subpassBegin{it->next};
+            u32 subpassIndex{};
+            for (auto nodeIt{it->next};; nodeIt = nodeIt->next) {
+                if (nodeIt == endIt || nodeIt->type == NodeType::NextSubpass || nodeIt->type == NodeType::NextSubpassFunction) {
+                    secondaryJobs.push_back(SecondaryJob{
+                        .begin = subpassBegin,
+                        .end = nodeIt,
+                        .renderPass = renderPassNode,
+                        .subpassIndex = subpassIndex++,
+                    });
+
+                    if (nodeIt == endIt)
+                        break;
+
+                    subpassBegin = nodeIt;
+                }
+            }
+
+            secondaryRenderPass.jobCount = secondaryJobs.size() - secondaryRenderPass.firstJob;
+            secondaryRenderPasses.push_back(secondaryRenderPass);
+            it = endIt;
+        }
+
+        return !secondaryJobs.empty();
+    }
+
+    void CommandRecordThread::RecordSecondary(Slot *slot, SecondaryCommandPool &pool, SecondaryJob &job) {
+        TRACE_EVENT("gpu", "CommandRecordThread::RecordSecondary", "subpass", job.subpassIndex);
+        auto &gpu{*state.gpu};
+        auto &commandBuffer{pool.Acquire(gpu)};
+
+        vk::StructureChain<vk::CommandBufferInheritanceInfo, vk::CommandBufferInheritanceRenderingInfo> inheritanceInfo{
+            vk::CommandBufferInheritanceInfo{
+                .renderPass = job.renderPass->renderPass,
+                .subpass = job.subpassIndex,
+                .framebuffer = job.renderPass->framebuffer,
+                .occlusionQueryEnable = true,
+                .queryFlags = vk::QueryControlFlagBits::ePrecise, // This must match the flags that occlusion queries are begun with
+            },
+            vk::CommandBufferInheritanceRenderingInfo{}
+        };
+
+        // A render pass object is only created when dynamic rendering isn't used, otherwise the attachment formats of the subpass need to be inherited instead
+        if (job.renderPass->renderPass)
+            inheritanceInfo.unlink<vk::CommandBufferInheritanceRenderingInfo>();
+        else
+            inheritanceInfo.get<vk::CommandBufferInheritanceRenderingInfo>() = job.renderPass->GetInheritanceRenderingInfo(job.subpassIndex);
+
+        commandBuffer.begin(vk::CommandBufferBeginInfo{
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+            .pInheritanceInfo = &inheritanceInfo.get<vk::CommandBufferInheritanceInfo>(),
+        });
+
+        using namespace node;
+        for (auto it{job.begin}; it != job.end; it = it->next) {
+            switch (it->type) {
+                case NodeType::Function:
+                    it->Get<FunctionNode>()(commandBuffer, slot->cycle, gpu);
+                    break;
+
+                case NodeType::SubpassFunction:
+                    it->Get<SubpassFunctionNode>()(commandBuffer, slot->cycle, gpu, job.renderPass->renderPass, job.subpassIndex);
+                    break;
+
+                // Subpass transitions are recorded into the primary command buffer
+                case NodeType::NextSubpass:
+                    break;
+
+                case NodeType::NextSubpassFunction:
+                    it->Get<NextSubpassFunctionNode>()(commandBuffer, slot->cycle, gpu, job.renderPass->renderPass, job.subpassIndex);
+                    break;
+
+                default:
+                    throw exception("Unexpected node inside a secondary command buffer subpass");
+            }
+        }
+
+        commandBuffer.end();
+        job.commandBuffer = &commandBuffer;
+    }
+
+    vk::CommandBuffer CommandRecordThread::WaitSecondary(SecondaryJob &job) {
+        auto startTime{util::GetTimeNs()};
+
+        std::unique_lock lock{secondaryMutex};
+        secondaryCondition.wait(lock, [&job] { return job.recorded; });
+        secondaryWaitTimeNs += util::GetTimeNs() - startTime;
+
+        if (secondaryException)
+            std::rethrow_exception(secondaryException);
+
+        return **job.commandBuffer;
+    }
+
     void CommandRecordThread::ProcessSlot(Slot *slot) {
         TRACE_EVENT_FMT("gpu", "ProcessSlot: 0x{:X}, execution: {}", slot, u64{slot->executionTag});
         auto &gpu{*state.gpu};
+        auto startTime{util::GetTimeNs()};
+
+        secondaryWaitTimeNs = 0;
+        renderPassBeginTimeNs = 0;
+        renderPassBeginCount = 0;
+        if (secondaryWorkers && PrepareSecondaryJobs(slot)) {
+            while (slot->secondaryPools.size() < secondaryWorkerCount)
+                slot->secondaryPools.emplace_back(gpu);
+
+            nextSecondaryJob = 0;
+            secondaryException = nullptr;
+
+            // Every worker records jobs in order using its own pool till there are none left, this allows the primary to be stitched together while later jobs are still being recorded
+            for (auto &pool : slot->secondaryPools) {
+                pool.Reset();
+                std::ignore = secondaryWorkers->submit([this, slot, &pool] {
+                    for (size_t index{nextSecondaryJob++}; index < secondaryJobs.size(); index = nextSecondaryJob++) {
+                        auto &job{secondaryJobs[index]};
+                        auto jobStartTime{util::GetTimeNs()};
+
+                        try {
+                            RecordSecondary(slot, pool, job);
+                        } catch (...) {
+                            std::scoped_lock lock{secondaryMutex};
+                            secondaryException = std::current_exception();
+                        }
+
+                        job.recordTimeNs = util::GetTimeNs() - jobStartTime;
+                        {
+                            std::scoped_lock lock{secondaryMutex};
+                            job.recorded = true;
+                        }
+                        secondaryCondition.notify_all();
+                    }
+                });
+            }
+        }
 
-        vk::RenderPass lRenderPass;
+        node::RenderPassNode *lRenderPass{};
         u32 subpassIndex;
 
-        using namespace node;
-        for (NodeVariant &node : slot->nodes) {
-            std::visit(VariantVisitor{
-                [&](FunctionNode &node) {
-                    TRACE_EVENT_INSTANT("gpu", "FunctionNode");
-                    node(slot->commandBuffer, slot->cycle, gpu);
-                },
-
-                [&](CheckpointNode &node) {
-                    RecordFullBarrier(slot->commandBuffer);
-
-                    TRACE_EVENT_INSTANT("gpu", "CheckpointNode", "id", node.id, [&](perfetto::EventContext ctx) {
-                        ctx.event()->add_flow_ids(node.id);
-                    });
+        auto secondaryRenderPass{secondaryRenderPasses.begin()};
+        for (auto it{slot->nodes.Front()}; it; it = it->next) {
+            if (secondaryRenderPass != secondaryRenderPasses.end() && it->type == node::NodeType::RenderPass && &it->Get<node::RenderPassNode>() == secondaryRenderPass->node) {
+                TRACE_EVENT_INSTANT("gpu", "SecondaryRenderPass");
+                auto beginStartTime{util::GetTimeNs()};
+                secondaryRenderPass->node->Begin(slot->commandBuffer, vk::SubpassContents::eSecondaryCommandBuffers);
+                renderPassBeginTimeNs += util::GetTimeNs() - beginStartTime;
+                renderPassBeginCount++;
 
-                    std::array<vk::BufferCopy, 1> copy{vk::BufferCopy{
-                        .size = node.binding.size,
-                        .srcOffset = node.binding.offset,
-                        .dstOffset = 0,
-                    }};
-
-                    slot->commandBuffer.copyBuffer(node.binding.buffer, gpu.debugTracingBuffer.vkBuffer, copy);
-
-                    RecordFullBarrier(slot->commandBuffer);
-                },
-
-                [&](RenderPassNode &node) {
-                    TRACE_EVENT_INSTANT("gpu", "RenderPassNode");
-                    lRenderPass = node(slot->commandBuffer, slot->cycle, gpu);
-                    subpassIndex = 0;
-                },
-
-                [&](NextSubpassNode &node) {
-                    TRACE_EVENT_INSTANT("gpu", "NextSubpassNode");
-                    node(slot->commandBuffer, slot->cycle, gpu);
-                    ++subpassIndex;
-                },
-
-                [&](SubpassFunctionNode &node) {
-                    TRACE_EVENT_INSTANT("gpu", "SubpassFunctionNode");
-                    node(slot->commandBuffer, slot->cycle, gpu, lRenderPass, subpassIndex);
-                },
-
-                [&](NextSubpassFunctionNode &node) {
-                    TRACE_EVENT_INSTANT("gpu", "NextSubpassFunctionNode");
-                    node(slot->commandBuffer, slot->cycle, gpu, lRenderPass, ++subpassIndex);
-                },
-
-                [&](RenderPassEndNode &node) {
-                    TRACE_EVENT_INSTANT("gpu", "RenderPassEndNode");
-                    node(slot->commandBuffer, slot->cycle, gpu);
-                },
-            }, node);
-            #undef NODE
+                for (size_t i{}; i < secondaryRenderPass->jobCount; i++) {
+                    if (i != 0)
+                        secondaryRenderPass->node->NextSubpass(slot->commandBuffer, vk::SubpassContents::eSecondaryCommandBuffers);
+
+                    slot->commandBuffer.executeCommands(WaitSecondary(secondaryJobs[secondaryRenderPass->firstJob + i]));
+                }
+
+                secondaryRenderPass->node->End(slot->commandBuffer);
+
+                it = secondaryRenderPass->endNode;
+                secondaryRenderPass++;
+            } else {
+                RecordNode(slot, it, lRenderPass, subpassIndex);
+            }
         }
 
         slot->commandBuffer.end();
         slot->ready = false;
 
+        if (!secondaryJobs.empty())
+            secondaryWorkers->wait_for_tasks(); // Workers may still be checking for remaining jobs
+
+        // Report the recording time alongside the effective amount of cores that were busy recording during it
+        auto recordTimeNs{util::GetTimeNs() - startTime};
+        u64 busyTimeNs{recordTimeNs - secondaryWaitTimeNs};
+        for (const auto &job : secondaryJobs)
+            busyTimeNs += job.recordTimeNs;
+
+        TRACE_COUNTER("gpu", "Record Time", static_cast<i64>(recordTimeNs));
+        TRACE_COUNTER("gpu", "Record Node Count", static_cast<i64>(slot->nodes.Size()));
+        TRACE_COUNTER("gpu", "Record Secondary Count", static_cast<i64>(secondaryJobs.size()));
+        TRACE_COUNTER("gpu", "Record Core Utilization", recordTimeNs ? static_cast<double>(busyTimeNs) / static_cast<double>(recordTimeNs) : 1.0);
+
+        // The CPU cost of beginning a render pass, this includes the render pass and framebuffer cache lookups that are skipped with dynamic rendering
+        if (renderPassBeginCount)
+            TRACE_COUNTER("gpu", "RenderPass Begin Time", static_cast<i64>(renderPassBeginTimeNs / renderPassBeginCount));
+
         gpu.scheduler.SubmitCommandBuffer(slot->commandBuffer, slot->cycle);
 
-        slot->nodes.clear();
+        slot->nodes.Clear();
         slot->allocator.Reset();
+        secondaryJobs.clear();
+        secondaryRenderPasses.clear();
     }
 
     void CommandRecordThread::Run() {
@@ -229,6 +475,10 @@ namespace skyline::gpu::interconnect {
         return idle;
     }
 
+    bool CommandRecordThread::UsesSecondaryCommandBuffers() const {
+        return secondaryWorkers.has_value();
+    }
+
     CommandRecordThread::Slot *CommandRecordThread::AcquireSlot() {
         auto startTime{util::GetTimeNs()};
         auto slot{outgoing.Pop()};
@@ -350,6 +600,20 @@ namespace skyline::gpu::interconnect {
         return (!a && !b) || (a && b && b->GetView() == a);
     }
 
+    std::pair<bool, bool> CommandExecutor::CheckSubpassCompatibility(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment) {
+        span<TextureView *> depthStencilAttachmentSpan{depthStencilAttachment ? span<TextureView *>(depthStencilAttachment) : span<TextureView *>()};
+        auto outputAttachmentViews{ranges::views::concat(colorAttachments, depthStencilAttachmentSpan)};
+        bool attachmentsMatch{std::equal(lastSubpassInputAttachments.begin(), lastSubpassInputAttachments.end(), inputAttachments.begin(), inputAttachments.end(), ViewsEqual) &&
+                              std::equal(lastSubpassColorAttachments.begin(), lastSubpassColorAttachments.end(), colorAttachments.begin(), colorAttachments.end(), ViewsEqual) &&
+                              ViewsEqual(lastSubpassDepthStencilAttachment, depthStencilAttachment)};
+
+        bool splitRenderPass{renderPass == nullptr || renderPass->renderArea != renderArea || !attachmentsMatch ||
+            !ranges::all_of(outputAttachmentViews, [this] (auto view) { return !view || view->texture->ValidateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::RenderTarget); }) ||
+            !ranges::all_of(sampledImages, [this] (auto view) { return view->texture->ValidateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::Sampled); })};
+
+        return {splitRenderPass, attachmentsMatch};
+    }
+
     bool CommandExecutor::CreateRenderPassWithSubpass(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask) {
         auto addSubpass{[&] {
             renderPass->AddSubpass(inputAttachments, colorAttachments, depthStencilAttachment, gpu);
@@ -361,38 +625,33 @@ namespace skyline::gpu::interconnect {
             lastSubpassDepthStencilAttachment = depthStencilAttachment ? depthStencilAttachment->GetView() : vk::ImageView{};
         }};
 
-        span<TextureView *> depthStencilAttachmentSpan{depthStencilAttachment ? span<TextureView *>(depthStencilAttachment) : span<TextureView *>()};
-        auto outputAttachmentViews{ranges::views::concat(colorAttachments, depthStencilAttachmentSpan)};
-        bool attachmentsMatch{std::equal(lastSubpassInputAttachments.begin(), lastSubpassInputAttachments.end(), inputAttachments.begin(), inputAttachments.end(), ViewsEqual) &&
-                              std::equal(lastSubpassColorAttachments.begin(), lastSubpassColorAttachments.end(), colorAttachments.begin(), colorAttachments.end(), ViewsEqual) &&
-                              ViewsEqual(lastSubpassDepthStencilAttachment, depthStencilAttachment)};
-
-        bool splitRenderPass{renderPass == nullptr || renderPass->renderArea != renderArea || !attachmentsMatch ||
-            !ranges::all_of(outputAttachmentViews, [this] (auto view) { return !view || view->texture->ValidateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::RenderTarget); }) ||
-            !ranges::all_of(sampledImages, [this] (auto view) { return view->texture->ValidateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::Sampled); })};
+        auto [splitRenderPass, attachmentsMatch]{CheckSubpassCompatibility(renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment)};
 
         bool gotoNext{};
         if (splitRenderPass) {
             // We need to create a render pass if one doesn't already exist or the current one isn't compatible
             if (renderPass != nullptr) {
-                slot->nodes.emplace_back(std::in_place_type_t<node::RenderPassEndNode>());
-                slot->nodes.splice(slot->nodes.end(), slot->pendingPostRenderPassNodes);
+                slot->nodes.EmplaceBack<node::RenderPassEndNode>();
+                slot->nodes.Splice(slot->pendingPostRenderPassNodes);
                 renderPassIndex++;
             }
-            renderPass = &std::get<node::RenderPassNode>(slot->nodes.emplace_back(std::in_place_type_t<node::RenderPassNode>(), renderArea));
-            renderPassIt = std::prev(slot->nodes.end());
+            preRenderPassNode = slot->nodes.Back();
+            renderPass = &slot->nodes.EmplaceBack<node::RenderPassNode>(renderArea);
             addSubpass();
             subpassCount = 1;
+            subpassId++;
         } else if (!attachmentsMatch) {
             // The last subpass had different attachments, so we need to create a new one
             addSubpass();
             subpassCount++;
+            subpassId++;
             gotoNext = true;
         }
 
         renderPass->UpdateDependency(srcStageMask, dstStageMask);
 
-        for (auto view : outputAttachmentViews)
+        span<TextureView *> depthStencilAttachmentSpan{depthStencilAttachment ? span<TextureView *>(depthStencilAttachment) : span<TextureView *>()};
+        for (auto view : ranges::views::concat(colorAttachments, depthStencilAttachmentSpan))
             if (view)
                 view->texture->UpdateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::RenderTarget);
 
@@ -404,11 +663,12 @@ namespace skyline::gpu::interconnect {
 
     void CommandExecutor::FinishRenderPass() {
         if (renderPass) {
-            slot->nodes.emplace_back(std::in_place_type_t<node::RenderPassEndNode>());
-            slot->nodes.splice(slot->nodes.end(), slot->pendingPostRenderPassNodes);
+            slot->nodes.EmplaceBack<node::RenderPassEndNode>();
+            slot->nodes.Splice(slot->pendingPostRenderPassNodes);
             renderPassIndex++;
 
             renderPass = nullptr;
+            preRenderPassNode = nullptr;
             subpassCount = 0;
 
             lastSubpassInputAttachments.clear();
@@ -491,38 +751,28 @@ namespace skyline::gpu::interconnect {
         cycle->AttachObject(dependency);
     }
 
-    void CommandExecutor::AddSubpass(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation, vk::PipelineStageFlags srcStageMask, vk::PipelineStageFlags dstStageMask) {
-        bool gotoNext{CreateRenderPassWithSubpass(renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment ? &*depthStencilAttachment : nullptr, noSubpassCreation, srcStageMask, dstStageMask)};
-        if (gotoNext)
-            slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), std::forward<decltype(function)>(function));
-        else
-            slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), std::forward<decltype(function)>(function));
+    void CommandExecutor::PushSubpassNode(node::NodeHeader *node, bool gotoNext) {
+        slot->nodes.PushBack(node);
 
-        if (slot->nodes.size() > *state.settings->executorFlushThreshold && !gotoNext)
+        if (slot->nodes.Size() > *state.settings->executorFlushThreshold && !gotoNext)
             Submit();
     }
 
-    void CommandExecutor::AddOutsideRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        if (renderPass)
-            FinishRenderPass();
-
-        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
-    }
-
-    void CommandExecutor::AddCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
-    }
-
-    void CommandExecutor::InsertPreExecuteCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->nodes.emplace(slot->nodes.begin(), std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
-    }
+    void CommandExecutor::InsertPreExecuteNode(node::NodeHeader *node) {
+        slot->nodes.InsertAfter(nullptr, node);
 
-    void CommandExecutor::InsertPreRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->nodes.emplace(renderPass ? renderPassIt : slot->nodes.end(), std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+        // If the render pass node was at the start of the stream then the inserted node now directly precedes it
+        if (renderPass && !preRenderPassNode)
+            preRenderPassNode = node;
     }
 
-    void CommandExecutor::InsertPostRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
-        slot->pendingPostRenderPassNodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+    void CommandExecutor::InsertPreRpNode(node::NodeHeader *node) {
+        if (renderPass) {
+            slot->nodes.InsertAfter(preRenderPassNode, node);
+            preRenderPassNode = node;
+        } else {
+            slot->nodes.PushBack(node);
+        }
     }
 
     void CommandExecutor::AddFullBarrier() {
@@ -535,7 +785,7 @@ namespace skyline::gpu::interconnect {
         bool gotoNext{CreateRenderPassWithSubpass(vk::Rect2D{.extent = attachment->texture->dimensions}, {}, {}, attachment, nullptr)};
         if (renderPass->ClearColorAttachment(0, value, gpu)) {
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassNode>());
+                slot->nodes.EmplaceBack<node::NextSubpassNode>();
         } else {
             auto function{[scissor = attachment->texture->dimensions, value](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
                 commandBuffer.clearAttachments(vk::ClearAttachment{
@@ -550,9 +800,9 @@ namespace skyline::gpu::interconnect {
             }};
 
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), function);
+                slot->nodes.PushBack(slot->nodes.CreateFunction<node::NextSubpassFunctionNode>(function));
             else
-                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), function);
+                slot->nodes.PushBack(slot->nodes.CreateFunction<node::SubpassFunctionNode>(function));
         }
     }
 
@@ -560,7 +810,7 @@ namespace skyline::gpu::interconnect {
         bool gotoNext{CreateRenderPassWithSubpass(vk::Rect2D{.extent = attachment->texture->dimensions}, {}, {}, {}, attachment)};
         if (renderPass->ClearDepthStencilAttachment(value, gpu)) {
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassNode>());
+                slot->nodes.EmplaceBack<node::NextSubpassNode>();
         } else {
             auto function{[aspect = attachment->format->vkAspect, extent = attachment->texture->dimensions, value](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
                 commandBuffer.clearAttachments(vk::ClearAttachment{
@@ -574,9 +824,9 @@ namespace skyline::gpu::interconnect {
             }};
 
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), function);
+                slot->nodes.PushBack(slot->nodes.CreateFunction<node::NextSubpassFunctionNode>(function));
             else
-                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), function);
+                slot->nodes.PushBack(slot->nodes.CreateFunction<node::SubpassFunctionNode>(function));
         }
     }
 
@@ -597,11 +847,20 @@ namespace skyline::gpu::interconnect {
         return renderPassIndex;
     }
 
+    bool CommandExecutor::UsesSecondaryCommandBuffers() const {
+        return recordThread.UsesSecondaryCommandBuffers();
+    }
+
+    u64 CommandExecutor::GetSubpassId(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment) {
+        auto [splitRenderPass, attachmentsMatch]{CheckSubpassCompatibility(renderArea, sampledImages, {}, colorAttachments, depthStencilAttachment)};
+        return (splitRenderPass || !attachmentsMatch) ? subpassId + 1 : subpassId;
+    }
+
     u32 CommandExecutor::AddCheckpointImpl(std::string_view annotation) {
         if (renderPass)
             FinishRenderPass();
 
-        slot->nodes.emplace_back(node::CheckpointNode{gpu.megaBufferAllocator.Push(cycle, span<u32>(&nextCheckpointId, 1).cast<u8>()), nextCheckpointId});
+        slot->nodes.EmplaceBack<node::CheckpointNode>(node::CheckpointNode{gpu.megaBufferAllocator.Push(cycle, span<u32>(&nextCheckpointId, 1).cast<u8>()), nextCheckpointId});
 
         TRACE_EVENT_INSTANT("gpu", "Mark Checkpoint", "id", nextCheckpointId, "annotation", [&annotation](perfetto::TracedValue context) {
             std::move(context).WriteString(annotation.data(), annotation.size());
@@ -616,12 +875,14 @@ namespace skyline::gpu::interconnect {
         if (renderPass)
             FinishRenderPass();
 
-        slot->nodes.splice(slot->nodes.end(), slot->pendingPostRenderPassNodes);
+        slot->nodes.Splice(slot->pendingPostRenderPassNodes);
 
 
         {
             slot->WaitReady();
 
+            auto submissionIndex{gpu.memory.AdvanceSubmission()};
+
             // We need this barrier here to ensure that resources are in the state we expect them to be in, we shouldn't overwrite resources while prior commands might still be using them or read from them while they might be modified by prior commands
             RecordFullBarrier(slot->commandBuffer);
 
@@ -635,7 +896,16 @@ namespace skyline::gpu::interconnect {
                 }
 
                 texture->cycle = cycle;
-                texture->UpdateRenderPassUsage(0, texture::RenderPassUsage::None);
+                texture->lastUseSubmission.store(submissionIndex, std::memory_order_relaxed);
+
+                // The readback prefetch is recorded after all other nodes so it captures the final contents of the texture in this execution
+                // The backing and staging buffer are captured while the texture is locked as they may be swapped or replaced before the node is recorded
+                if (auto stagingBuffer{texture->PrepareReadbackPrefetch(cycle)})
+                    slot->nodes.PushBack(slot->nodes.CreateFunction<node::FunctionNode>([texture = texture.texture.get(), image = texture->GetBacking(), stagingBuffer = std::move(stagingBuffer), layout = texture->layout](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+                        texture->RecordReadbackPrefetch(commandBuffer, image, stagingBuffer, layout);
+                    }));
+
+                texture->UpdateRenderPassUsage(0, texture::RenderPassUsage::None); // This must follow the prefetch as it determines if the texture was written to in this execution
             }
 
             // Wait on texture syncs to finish before beginning the cmdbuf
@@ -675,7 +945,7 @@ namespace skyline::gpu::interconnect {
         executionTag = AllocateTag();
 
         // Ensure all pushed callbacks wait for the submission to have finished GPU execution
-        if (!slot->nodes.empty())
+        if (!slot->nodes.Empty())
             waiterThread.Queue(cycle, {});
 
         if (*state.settings->useDirectMemoryImport) {
@@ -689,7 +959,7 @@ namespace skyline::gpu::interconnect {
                 waiterThread.Queue(nullptr, std::move(callback));
         }
 
-        if (!slot->nodes.empty()) {
+        if (!slot->nodes.Empty()) {
             TRACE_EVENT("gpu", "CommandExecutor::Submit");
             SubmitInternal();
             submissionNumber++;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <boost/container/stable_vector.hpp>
+#include <BS_thread_pool.hpp>
 #include <renderdoc_app.h>
 #include <common/linear_allocator.h>
 #include <gpu/usage_tracker.h>
@@ -19,6 +20,28 @@ namespace skyline::gpu::interconnect {
      */
     class CommandRecordThread {
       public:
+        /**
+         * @brief A pool of secondary command buffers that is only used by a single worker at a time, as command pools require external synchronization
+         */
+        struct SecondaryCommandPool {
+            vk::raii::CommandPool commandPool;
+            boost::container::stable_vector<vk::raii::CommandBuffer> commandBuffers;
+            size_t usedCount{}; //!< The amount of command buffers that have been used since the last reset
+
+            SecondaryCommandPool(GPU &gpu);
+
+            /**
+             * @return A secondary command buffer from the pool in the initial state, this reference will remain valid until the pool is destroyed
+             */
+            vk::raii::CommandBuffer &Acquire(GPU &gpu);
+
+            /**
+             * @brief Resets all command buffers in the pool to the initial state so they can be reused
+             * @note None of the command buffers can be pending execution when this is called
+             */
+            void Reset();
+        };
+
         /**
          * @brief Single execution slot, buffered back and forth between the GPFIFO thread and the record thread
          */
@@ -40,8 +63,9 @@ namespace skyline::gpu::interconnect {
             vk::raii::Semaphore semaphore;
             std::shared_ptr<FenceCycle> cycle;
             LinearAllocatorState<> allocator;
-            std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>> nodes;
-            std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>> pendingPostRenderPassNodes;
+            node::NodeStream nodes;
+            node::NodeStream pendingPostRenderPassNodes;
+            std::vector<SecondaryCommandPool> secondaryPools; //!< Secondary command pools for every worker, one per slot as secondaries may still be pending execution from other slots
             std::mutex beginLock;
             std::condition_variable beginCondition;
             ContextTag executionTag;
@@ -69,14 +93,74 @@ namespace skyline::gpu::interconnect {
 
       private:
         static constexpr size_t GrowThresholdNs{constant::NsInMillisecond / 50}; //!< The wait time threshold at which the slot count will be increased
+        static constexpr u32 MaxSecondaryWorkerCount{4}; //!< The maximum amount of worker threads used to record secondary command buffers
+        static constexpr size_t SecondaryRenderPassThreshold{16}; //!< The minimum amount of nodes in a render pass for it to be recorded into secondary command buffers, smaller render passes are recorded inline as the overhead would outweigh any gains
+
+        /**
+         * @brief A range of nodes inside a single subpass which are recorded into a secondary command buffer by a worker
+         */
+        struct SecondaryJob {
+            node::NodeHeader *begin; //!< The first node in the subpass
+            node::NodeHeader *end; //!< The node after the last node in the subpass
+            node::RenderPassNode *renderPass;
+            u32 subpassIndex;
+            vk::raii::CommandBuffer *commandBuffer{}; //!< The recorded command buffer, this is only valid once `recorded` is set
+            u64 recordTimeNs{}; //!< The time spent recording the secondary command buffer on the worker thread
+            bool recorded{}; //!< If the job has finished recording, this is protected by `secondaryMutex`
+        };
+
+        /**
+         * @brief A render pass which is recorded into secondary command buffers, with every subpass corresponding to a single job
+         */
+        struct SecondaryRenderPass {
+            node::RenderPassNode *node;
+            node::NodeHeader *endNode; //!< The RenderPassEndNode for the render pass
+            size_t firstJob; //!< The index of the job for the first subpass in `secondaryJobs`
+            size_t jobCount;
+        };
+
         const DeviceState &state;
         CircularQueue<Slot *> incoming; //!< Slots pending recording
         CircularQueue<Slot *> outgoing; //!< Slots that have been submitted, may still be active on the GPU
         std::list<Slot> slots;
         std::atomic<bool> idle;
 
+        u32 secondaryWorkerCount{}; //!< The amount of threads in `secondaryWorkers`, this will be zero when parallel recording is disabled
+        std::optional<BS::thread_pool> secondaryWorkers; //!< A pool of threads for recording secondary command buffers, this is only created when parallel recording is enabled
+        std::vector<SecondaryJob> secondaryJobs; //!< The jobs for the slot that is currently being processed
+        std::vector<SecondaryRenderPass> secondaryRenderPasses;
+        std::atomic<size_t> nextSecondaryJob; //!< The index of the next job in `secondaryJobs` that should be picked up by a worker
+        std::mutex secondaryMutex;
+        std::condition_variable secondaryCondition; //!< Signalled whenever a worker finishes recording a job
+        std::exception_ptr secondaryException; //!< An exception thrown by a worker while recording, this will be rethrown on the record thread
+        u64 secondaryWaitTimeNs{}; //!< The time spent on the record thread waiting for workers during the current slot
+        u64 renderPassBeginTimeNs{}; //!< The time spent on the record thread preparing and beginning render passes during the current slot
+        u32 renderPassBeginCount{}; //!< The amount of render passes begun during the current slot
+
         std::thread thread;
 
+        /**
+         * @brief Records a single node into the supplied primary command buffer
+         */
+        void RecordNode(Slot *slot, node::NodeHeader *node, node::RenderPassNode *&renderPass, u32 &subpassIndex);
+
+        /**
+         * @brief Splits the nodes of the slot at subpass boundaries into jobs for all render passes that are large enough to benefit from parallel recording
+         * @return If any jobs were created
+         */
+        bool PrepareSecondaryJobs(Slot *slot);
+
+        /**
+         * @brief Records the nodes in the job into a secondary command buffer from the supplied pool
+         */
+        void RecordSecondary(Slot *slot, SecondaryCommandPool &pool, SecondaryJob &job);
+
+        /**
+         * @brief Blocks till the job has been recorded by a worker
+         * @return The recorded secondary command buffer
+         */
+        vk::CommandBuffer WaitSecondary(SecondaryJob &job);
+
         void ProcessSlot(Slot *slot);
 
         void Run();
@@ -86,6 +170,11 @@ namespace skyline::gpu::interconnect {
 
         bool IsIdle() const;
 
+        /**
+         * @return If render passes may be recorded into secondary command buffers, in which case no state is inherited between subpasses
+         */
+        bool UsesSecondaryCommandBuffers() const;
+
         /**
          * @return A free slot, `Reset` needs to be called before accessing it
          */
@@ -149,8 +238,9 @@ namespace skyline::gpu::interconnect {
         ExecutionWaiterThread waiterThread;
         std::optional<CheckpointPollerThread> checkpointPollerThread;
         node::RenderPassNode *renderPass{};
-        std::list<node::NodeVariant, LinearAllocator<node::NodeVariant>>::iterator renderPassIt;
+        node::NodeHeader *preRenderPassNode{}; //!< The node directly preceding the current render pass node, this is null if the render pass node is at the start of the stream
         size_t subpassCount{}; //!< The number of subpasses in the current render pass
+        u64 subpassId{}; //!< A monotonically increasing ID of the latest subpass, this is never reset between executions
         u32 renderPassIndex{};
         bool preserveLocked{};
 
@@ -208,6 +298,12 @@ namespace skyline::gpu::interconnect {
 
         void RotateRecordSlot();
 
+        /**
+         * @brief Checks if a subpass with the specified attachments is compatible with the current render pass and subpass
+         * @return A pair of if a new render pass must be created and if the attachments match those of the last subpass
+         */
+        std::pair<bool, bool> CheckSubpassCompatibility(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment);
+
         /**
          * @brief Create a new render pass and subpass with the specified attachments, if one doesn't already exist or the current one isn't compatible
          * @param noSubpassCreation Forces creation of a renderpass when a new subpass would otherwise be created
@@ -234,6 +330,21 @@ namespace skyline::gpu::interconnect {
 
         void AttachBufferBase(std::shared_ptr<Buffer> buffer);
 
+        /**
+         * @brief Appends a subpass function node created for the current subpass to the stream, submitting if the flush threshold has been exceeded
+         */
+        void PushSubpassNode(node::NodeHeader *node, bool gotoNext);
+
+        /**
+         * @brief Implementation of `InsertPreExecuteCommand` after the node has been created
+         */
+        void InsertPreExecuteNode(node::NodeHeader *node);
+
+        /**
+         * @brief Implementation of `InsertPreRpCommand` after the node has been created
+         */
+        void InsertPreRpNode(node::NodeHeader *node);
+
         /**
          * @brief Non-gated implementation of `AddCheckpoint`
          */
@@ -294,7 +405,14 @@ namespace skyline::gpu::interconnect {
          * @param exclusiveSubpass If this subpass should be the only subpass in a render pass
          * @note Any supplied texture should be attached prior and not undergo any persistent layout transitions till execution
          */
-        void AddSubpass(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments = {}, span<TextureView *> colorAttachments = {}, TextureView *depthStencilAttachment = {}, bool noSubpassCreation = false, vk::PipelineStageFlags srcStageMask = {}, vk::PipelineStageFlags dstStageMask = {});
+        template<typename Function>
+        void AddSubpass(Function &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments = {}, span<TextureView *> colorAttachments = {}, TextureView *depthStencilAttachment = {}, bool noSubpassCreation = false, vk::PipelineStageFlags srcStageMask = {}, vk::PipelineStageFlags dstStageMask = {}) {
+            bool gotoNext{CreateRenderPassWithSubpass(renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment, noSubpassCreation, srcStageMask, dstStageMask)};
+            if (gotoNext)
+                PushSubpassNode(slot->nodes.CreateFunction<node::NextSubpassFunctionNode>(std::forward<Function>(function)), gotoNext);
+            else
+                PushSubpassNode(slot->nodes.CreateFunction<node::SubpassFunctionNode>(std::forward<Function>(function)), gotoNext);
+        }
 
         /**
          * @brief Adds a subpass that clears the entirety of the specified attachment with a color value, it may utilize VK_ATTACHMENT_LOAD_OP_CLEAR for a more efficient clear when possible
@@ -311,27 +429,45 @@ namespace skyline::gpu::interconnect {
         /**
          * @brief Adds a command that needs to be executed outside the scope of a render pass
          */
-        void AddOutsideRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename Function>
+        void AddOutsideRpCommand(Function &&function) {
+            if (renderPass)
+                FinishRenderPass();
+
+            slot->nodes.PushBack(slot->nodes.CreateFunction<node::FunctionNode>(std::forward<Function>(function)));
+        }
 
         /**
          * @brief Adds a command that can be executed inside or outside of an RP
          */
-        void AddCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename Function>
+        void AddCommand(Function &&function) {
+            slot->nodes.PushBack(slot->nodes.CreateFunction<node::FunctionNode>(std::forward<Function>(function)));
+        }
 
         /**
          * @brief Inserts the input command into the node list at the beginning of the execution
          */
-        void InsertPreExecuteCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename Function>
+        void InsertPreExecuteCommand(Function &&function) {
+            InsertPreExecuteNode(slot->nodes.CreateFunction<node::FunctionNode>(std::forward<Function>(function)));
+        }
 
         /**
          * @brief Inserts the input command into the node list before the current RP begins (or immediately if not in an RP)
          */
-        void InsertPreRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename Function>
+        void InsertPreRpCommand(Function &&function) {
+            InsertPreRpNode(slot->nodes.CreateFunction<node::FunctionNode>(std::forward<Function>(function)));
+        }
 
         /**
          * @brief Inserts the input command into the node list after the current RP (or execution) finishes
          */
-        void InsertPostRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename Function>
+        void InsertPostRpCommand(Function &&function) {
+            slot->pendingPostRenderPassNodes.PushBack(slot->pendingPostRenderPassNodes.CreateFunction<node::FunctionNode>(std::forward<Function>(function)));
+        }
 
         /**
          * @brief Adds a full pipeline barrier to the command buffer
@@ -355,6 +491,17 @@ namespace skyline::gpu::interconnect {
 
         std::optional<u32> GetRenderPassIndex();
 
+        /**
+         * @return If subpasses may be recorded into separate secondary command buffers, see GetSubpassId
+         */
+        bool UsesSecondaryCommandBuffers() const;
+
+        /**
+         * @return The ID of the subpass that a subpass with the specified attachments would be recorded into, this will differ from the last returned value when a new subpass would be created
+         * @note As secondary command buffers don't inherit any state, users that skip redundant state updates need to re-emit all state when this changes and UsesSecondaryCommandBuffers is true
+         */
+        u64 GetSubpassId(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment);
+
         /**
          * @brief Records a checkpoint into the GPU command stream at the current
          * @param annotation A string annotation to display in perfetto for this checkpoint
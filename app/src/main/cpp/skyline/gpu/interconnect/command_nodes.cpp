@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <boost/container/small_vector.hpp>
 #include "command_nodes.h"
 #include "gpu/texture/texture.h"
 #include <vulkan/vulkan_enums.hpp>
@@ -32,6 +33,7 @@ namespace skyline::gpu::interconnect::node {
                 .finalLayout = view->texture->layout,
                 .flags = vk::AttachmentDescriptionFlagBits::eMayAlias
             });
+            attachmentAspects.push_back(view->format->vkAspect);
 
             if (auto usage{view->texture->GetLastRenderPassUsage()}; usage != texture::RenderPassUsage::None) {
                 vk::PipelineStageFlags attachmentDstStageMask{};
@@ -123,6 +125,8 @@ namespace skyline::gpu::interconnect::node {
     }
 
     void RenderPassNode::AddSubpass(span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, GPU &gpu) {
+        hasInputAttachments |= !inputAttachments.empty();
+
         attachmentReferences.reserve(attachmentReferences.size() + inputAttachments.size() + colorAttachments.size() + (depthStencilAttachment ? 1 : 0));
 
         auto inputAttachmentsOffset{attachmentReferences.size() * sizeof(vk::AttachmentReference)};
@@ -219,7 +223,7 @@ namespace skyline::gpu::interconnect::node {
         return false;
     }
 
-    vk::RenderPass RenderPassNode::operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+    void RenderPassNode::Prepare(GPU &gpu) {
         auto preserveAttachmentIt{preserveAttachmentReferences.begin()};
         for (auto &subpassDescription : subpassDescriptions) {
             subpassDescription.pInputAttachments = RebasePointer(attachmentReferences, subpassDescription.pInputAttachments);
@@ -236,23 +240,37 @@ namespace skyline::gpu::interconnect::node {
             preserveAttachmentIt++;
         }
 
-        if (dependencyDstStageMask && dependencySrcStageMask) {
-            commandBuffer.pipelineBarrier(dependencySrcStageMask, dependencyDstStageMask, {}, {vk::MemoryBarrier{
-                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
-                .dstAccessMask = vk::AccessFlagBits::eMemoryWrite | vk::AccessFlagBits::eMemoryRead,
-            }}, {}, {});
+        useDynamicRendering = gpu.traits.supportsDynamicRendering && !hasInputAttachments;
+        if (useDynamicRendering) {
+            // Subpasses are in order of recording, so the first subpass which references an attachment is the one that needs to apply its load operation
+            attachmentFirstSubpass.assign(attachments.size(), std::numeric_limits<u32>::max());
+            for (u32 subpassIndex{}; subpassIndex < subpassDescriptions.size(); subpassIndex++) {
+                const auto &subpassDescription{subpassDescriptions[subpassIndex]};
+                for (const auto &reference : span<const vk::AttachmentReference>{subpassDescription.pColorAttachments, subpassDescription.colorAttachmentCount})
+                    if (reference.attachment != VK_ATTACHMENT_UNUSED)
+                        attachmentFirstSubpass[reference.attachment] = std::min(attachmentFirstSubpass[reference.attachment], subpassIndex);
+
+                if (subpassDescription.pDepthStencilAttachment)
+                    attachmentFirstSubpass[subpassDescription.pDepthStencilAttachment->attachment] = std::min(attachmentFirstSubpass[subpassDescription.pDepthStencilAttachment->attachment], subpassIndex);
+            }
+
+            referenceFormats.reserve(attachmentReferences.size());
+            for (const auto &reference : attachmentReferences)
+                referenceFormats.push_back(reference.attachment != VK_ATTACHMENT_UNUSED ? attachmentDescriptions[reference.attachment].format : vk::Format::eUndefined);
+
+            return;
         }
 
-        auto renderPass{gpu.renderPassCache.GetRenderPass(vk::RenderPassCreateInfo{
+        renderPass = gpu.renderPassCache.GetRenderPass(vk::RenderPassCreateInfo{
             .attachmentCount = static_cast<u32>(attachmentDescriptions.size()),
             .pAttachments = attachmentDescriptions.data(),
             .subpassCount = static_cast<u32>(subpassDescriptions.size()),
             .pSubpasses = subpassDescriptions.data(),
             .dependencyCount = static_cast<u32>(subpassDependencies.size()),
             .pDependencies = subpassDependencies.data(),
-        })};
+        });
 
-        auto useImagelessFramebuffer{gpu.traits.supportsImagelessFramebuffers};
+        useImagelessFramebuffer = gpu.traits.supportsImagelessFramebuffers;
         cache::FramebufferCreateInfo framebufferCreateInfo{
             vk::FramebufferCreateInfo{
                 .flags = useImagelessFramebuffer ? vk::FramebufferCreateFlagBits::eImageless : vk::FramebufferCreateFlags{},
@@ -272,7 +290,22 @@ namespace skyline::gpu::interconnect::node {
         if (!useImagelessFramebuffer)
             framebufferCreateInfo.unlink<vk::FramebufferAttachmentsCreateInfo>();
 
-        auto framebuffer{gpu.framebufferCache.GetFramebuffer(framebufferCreateInfo)};
+        framebuffer = gpu.framebufferCache.GetFramebuffer(framebufferCreateInfo);
+    }
+
+    void RenderPassNode::Begin(vk::raii::CommandBuffer &commandBuffer, vk::SubpassContents contents) {
+        if (dependencyDstStageMask && dependencySrcStageMask) {
+            commandBuffer.pipelineBarrier(dependencySrcStageMask, dependencyDstStageMask, {}, {vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryWrite | vk::AccessFlagBits::eMemoryRead,
+            }}, {}, {});
+        }
+
+        if (useDynamicRendering) {
+            currentSubpass = 0;
+            BeginRendering(commandBuffer, currentSubpass, contents);
+            return;
+        }
 
         vk::StructureChain<vk::RenderPassBeginInfo, vk::RenderPassAttachmentBeginInfo> renderPassBeginInfo{
             vk::RenderPassBeginInfo{
@@ -291,8 +324,169 @@ namespace skyline::gpu::interconnect::node {
         if (!useImagelessFramebuffer)
             renderPassBeginInfo.unlink<vk::RenderPassAttachmentBeginInfo>();
 
-        commandBuffer.beginRenderPass(renderPassBeginInfo.get<vk::RenderPassBeginInfo>(), vk::SubpassContents::eInline);
+        commandBuffer.beginRenderPass(renderPassBeginInfo.get<vk::RenderPassBeginInfo>(), contents);
+    }
+
+    void RenderPassNode::BeginRendering(vk::raii::CommandBuffer &commandBuffer, u32 subpassIndex, vk::SubpassContents contents) {
+        auto getAttachmentInfo{[&](const vk::AttachmentReference &reference, bool stencil) -> vk::RenderingAttachmentInfo {
+            if (reference.attachment == VK_ATTACHMENT_UNUSED)
+                return {};
+
+            const auto &attachmentDescription{attachmentDescriptions[reference.attachment]};
+            return vk::RenderingAttachmentInfo{
+                .imageView = attachments[reference.attachment],
+                .imageLayout = reference.layout,
+                // Only the first rendering instance using an attachment applies its load operation, later ones need to load the contents written by prior ones
+                .loadOp = attachmentFirstSubpass[reference.attachment] == subpassIndex ? (stencil ? attachmentDescription.stencilLoadOp : attachmentDescription.loadOp) : vk::AttachmentLoadOp::eLoad,
+                .storeOp = stencil ? attachmentDescription.stencilStoreOp : attachmentDescription.storeOp,
+                .clearValue = reference.attachment < clearValues.size() ? clearValues[reference.attachment] : vk::ClearValue{},
+            };
+        }};
+
+        const auto &subpassDescription{subpassDescriptions[subpassIndex]};
+        boost::container::small_vector<vk::RenderingAttachmentInfo, 8> colorAttachments;
+        for (const auto &reference : span<const vk::AttachmentReference>{subpassDescription.pColorAttachments, subpassDescription.colorAttachmentCount})
+            colorAttachments.push_back(getAttachmentInfo(reference, false));
+
+        vk::RenderingAttachmentInfo depthAttachment{}, stencilAttachment{};
+        if (subpassDescription.pDepthStencilAttachment) {
+            auto aspect{attachmentAspects[subpassDescription.pDepthStencilAttachment->attachment]};
+            if (aspect & vk::ImageAspectFlagBits::eDepth)
+                depthAttachment = getAttachmentInfo(*subpassDescription.pDepthStencilAttachment, false);
+            if (aspect & vk::ImageAspectFlagBits::eStencil)
+                stencilAttachment = getAttachmentInfo(*subpassDescription.pDepthStencilAttachment, true);
+        }
+
+        commandBuffer.beginRenderingKHR(vk::RenderingInfo{
+            .flags = contents == vk::SubpassContents::eSecondaryCommandBuffers ? vk::RenderingFlagBits::eContentsSecondaryCommandBuffers : vk::RenderingFlags{},
+            .renderArea = renderArea,
+            .layerCount = 1,
+            .colorAttachmentCount = static_cast<u32>(colorAttachments.size()),
+            .pColorAttachments = colorAttachments.data(),
+            .pDepthAttachment = depthAttachment.imageView ? &depthAttachment : nullptr,
+            .pStencilAttachment = stencilAttachment.imageView ? &stencilAttachment : nullptr,
+        });
+    }
+
+    void RenderPassNode::NextSubpass(vk::raii::CommandBuffer &commandBuffer, vk::SubpassContents contents) {
+        if (!useDynamicRendering) {
+            commandBuffer.nextSubpass(contents);
+            return;
+        }
+
+        commandBuffer.endRenderingKHR();
+        currentSubpass++;
+
+        // The dependencies into the next subpass are recorded as a by-region barrier between the rendering instances which is equivalent to them being inside a render pass
+        vk::PipelineStageFlags srcStageMask{}, dstStageMask{};
+        vk::MemoryBarrier barrier{};
+        for (const auto &dependency : subpassDependencies) {
+            if (dependency.dstSubpass == currentSubpass) {
+                srcStageMask |= dependency.srcStageMask;
+                dstStageMask |= dependency.dstStageMask;
+                barrier.srcAccessMask |= dependency.srcAccessMask;
+                barrier.dstAccessMask |= dependency.dstAccessMask;
+            }
+        }
+
+        if (srcStageMask && dstStageMask)
+            commandBuffer.pipelineBarrier(srcStageMask, dstStageMask, vk::DependencyFlagBits::eByRegion, barrier, {}, {});
 
+        BeginRendering(commandBuffer, currentSubpass, contents);
+    }
+
+    void RenderPassNode::End(vk::raii::CommandBuffer &commandBuffer) {
+        if (useDynamicRendering)
+            commandBuffer.endRenderingKHR();
+        else
+            commandBuffer.endRenderPass();
+    }
+
+    vk::CommandBufferInheritanceRenderingInfo RenderPassNode::GetInheritanceRenderingInfo(u32 subpassIndex) {
+        const auto &subpassDescription{subpassDescriptions[subpassIndex]};
+
+        vk::Format depthFormat{}, stencilFormat{};
+        if (subpassDescription.pDepthStencilAttachment) {
+            auto attachmentIndex{subpassDescription.pDepthStencilAttachment->attachment};
+            auto aspect{attachmentAspects[attachmentIndex]};
+            if (aspect & vk::ImageAspectFlagBits::eDepth)
+                depthFormat = attachmentDescriptions[attachmentIndex].format;
+            if (aspect & vk::ImageAspectFlagBits::eStencil)
+                stencilFormat = attachmentDescriptions[attachmentIndex].format;
+        }
+
+        return vk::CommandBufferInheritanceRenderingInfo{
+            .colorAttachmentCount = subpassDescription.colorAttachmentCount,
+            .pColorAttachmentFormats = referenceFormats.data() + (subpassDescription.pColorAttachments - attachmentReferences.data()),
+            .depthAttachmentFormat = depthFormat,
+            .stencilAttachmentFormat = stencilFormat,
+            .rasterizationSamples = vk::SampleCountFlagBits::e1, // This matches the sample count of the attachments in render pass objects
+        };
+    }
+
+    vk::RenderPass RenderPassNode::operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+        Prepare(gpu);
+        Begin(commandBuffer, vk::SubpassContents::eInline);
         return renderPass;
     }
+
+    NodeStream::NodeStream(LinearAllocatorState<> &allocator) : allocator{allocator} {}
+
+    NodeStream::NodeStream(NodeStream &&other) : allocator{other.allocator}, head{std::exchange(other.head, nullptr)}, tail{std::exchange(other.tail, nullptr)}, count{std::exchange(other.count, 0)} {}
+
+    NodeStream::~NodeStream() {
+        Clear();
+    }
+
+    void NodeStream::PushBack(NodeHeader *node) {
+        node->next = nullptr;
+        if (tail)
+            tail->next = node;
+        else
+            head = node;
+
+        tail = node;
+        count++;
+    }
+
+    void NodeStream::InsertAfter(NodeHeader *previous, NodeHeader *node) {
+        if (previous) {
+            node->next = previous->next;
+            previous->next = node;
+        } else {
+            node->next = head;
+            head = node;
+        }
+
+        if (!node->next)
+            tail = node;
+
+        count++;
+    }
+
+    void NodeStream::Splice(NodeStream &other) {
+        if (!other.head)
+            return;
+
+        if (tail)
+            tail->next = other.head;
+        else
+            head = other.head;
+
+        tail = std::exchange(other.tail, nullptr);
+        other.head = nullptr;
+        count += std::exchange(other.count, 0);
+    }
+
+    void NodeStream::Clear() {
+        for (auto node{head}; node;) {
+            auto next{node->next};
+            if (node->destroy)
+                node->destroy(node);
+            node = next;
+        }
+
+        head = tail = nullptr;
+        count = 0;
+    }
 }
@@ -3,40 +3,77 @@
 
 #pragma once
 
+#include <common/linear_allocator.h>
 #include <gpu.h>
 
 namespace skyline::gpu::interconnect::node {
     /**
-     * @brief A generic node for simply executing a function
+     * @brief The type of a node in a NodeStream, this is used for dispatching on the node during replay
      */
-    template<typename FunctionSignature = void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)>
+    enum class NodeType : u8 {
+        Function,
+        Checkpoint,
+        RenderPass,
+        NextSubpass,
+        SubpassFunction,
+        NextSubpassFunction,
+        RenderPassEnd,
+    };
+
+    /**
+     * @brief A generic node for simply executing a function, the function object is stored inline directly after the node in the stream and called through a function pointer
+     */
+    template<NodeType NodeTypeValue, typename... Args>
     struct FunctionNodeBase {
-        std::function<FunctionSignature> function;
+        static constexpr NodeType Type{NodeTypeValue};
+
+        using InvokeFunction = void (*)(FunctionNodeBase *node, Args... args);
+        InvokeFunction invoke; //!< A function that calls the inline function object with the supplied arguments
+
+        /**
+         * @return A pointer to the inline function object which follows the node
+         */
+        template<typename Function>
+        Function *GetFunction() {
+            return reinterpret_cast<Function *>(util::AlignUp(reinterpret_cast<uintptr_t>(this) + sizeof(FunctionNodeBase), alignof(Function)));
+        }
 
-        FunctionNodeBase(std::function<FunctionSignature> &&function) : function(function) {}
+        template<typename Function>
+        static void Invoke(FunctionNodeBase *node, Args... args) {
+            (*node->GetFunction<Function>())(std::forward<Args>(args)...);
+        }
 
-        template<class... Args>
-        void operator()(Args &&... args) {
-            function(std::forward<Args>(args)...);
+        void operator()(Args... args) {
+            invoke(this, std::forward<Args>(args)...);
         }
     };
 
-    using FunctionNode = FunctionNodeBase<>;
+    using FunctionNode = FunctionNodeBase<NodeType::Function, vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &>;
 
     /**
      * @brief Creates and begins a VkRenderPass alongside managing all resources bound to it and to the subpasses inside it
+     * @note When dynamic rendering is supported no render pass or framebuffer objects are created, every subpass is instead recorded as its own rendering instance with the subpass dependencies between them recorded as barriers, render passes with input attachments are the exception as they can only be read inside a render pass object
      */
     struct RenderPassNode {
       private:
         std::vector<vk::ImageView> attachments;
         std::vector<vk::FramebufferAttachmentImageInfo> attachmentInfo;
         std::vector<vk::AttachmentDescription> attachmentDescriptions;
+        std::vector<vk::ImageAspectFlags> attachmentAspects;
 
         std::vector<vk::AttachmentReference> attachmentReferences;
         std::vector<std::vector<u32>> preserveAttachmentReferences; //!< Any attachment that must be preserved to be utilized by a future subpass, these are stored per-subpass to ensure contiguity
 
         constexpr static uintptr_t NoDepthStencil{std::numeric_limits<uintptr_t>::max()}; //!< A sentinel value to denote the lack of a depth stencil attachment in a VkSubpassDescription
 
+        bool useImagelessFramebuffer{}; //!< If the framebuffer was created as imageless and the attachments need to be supplied when beginning the render pass
+
+        bool hasInputAttachments{}; //!< If any subpass reads input attachments, these require a render pass object regardless of dynamic rendering support
+        bool useDynamicRendering{}; //!< If subpasses are recorded as dynamic rendering instances rather than inside a render pass object
+        u32 currentSubpass{}; //!< The index of the subpass that is currently being recorded, this is only used with dynamic rendering
+        std::vector<u32> attachmentFirstSubpass; //!< The index of the first subpass that uses each attachment, only this subpass applies the load operation of the attachment with dynamic rendering
+        std::vector<vk::Format> referenceFormats; //!< The format of the attachment for each attachment reference, this is used for the inheritance info of secondary command buffers with dynamic rendering
+
         /**
          * @brief Rebases a pointer containing an offset relative to the beginning of a container
          */
@@ -45,7 +82,14 @@ namespace skyline::gpu::interconnect::node {
             return reinterpret_cast<T *>(reinterpret_cast<uintptr_t>(container.data()) + reinterpret_cast<uintptr_t>(offset));
         }
 
+        /**
+         * @brief Begins a dynamic rendering instance with the attachments of the supplied subpass
+         */
+        void BeginRendering(vk::raii::CommandBuffer &commandBuffer, u32 subpassIndex, vk::SubpassContents contents);
+
       public:
+        static constexpr NodeType Type{NodeType::RenderPass};
+
         std::vector<vk::SubpassDescription> subpassDescriptions;
         std::vector<vk::SubpassDependency> subpassDependencies;
         vk::PipelineStageFlags dependencySrcStageMask;
@@ -54,6 +98,9 @@ namespace skyline::gpu::interconnect::node {
         vk::Rect2D renderArea;
         std::vector<vk::ClearValue> clearValues;
 
+        vk::RenderPass renderPass{}; //!< The render pass object for this node, this is only valid after `Prepare` has been called and is null with dynamic rendering
+        vk::Framebuffer framebuffer{}; //!< The framebuffer object for this node, this is only valid after `Prepare` has been called and is null with dynamic rendering
+
         RenderPassNode(vk::Rect2D renderArea);
 
         /**
@@ -64,6 +111,7 @@ namespace skyline::gpu::interconnect::node {
 
         /**
          * @brief Creates a subpass with the attachments bound in the specified order
+         * @note Input attachments cause the render pass to be recorded with a render pass object even when dynamic rendering is supported
          */
         void AddSubpass(span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, GPU &gpu);
 
@@ -87,48 +135,187 @@ namespace skyline::gpu::interconnect::node {
          */
         bool ClearDepthStencilAttachment(const vk::ClearDepthStencilValue &value, GPU& gpu);
 
+        /**
+         * @brief Finalizes the subpass descriptions and looks up the render pass and framebuffer objects for the node, the lookups are skipped with dynamic rendering
+         * @note This must be called exactly once and prior to `Begin`
+         */
+        void Prepare(GPU &gpu);
+
+        /**
+         * @brief Records the dependency barrier and begins the render pass that was created by `Prepare`
+         * @param contents If the first subpass will have its commands recorded inline or in secondary command buffers
+         */
+        void Begin(vk::raii::CommandBuffer &commandBuffer, vk::SubpassContents contents);
+
+        /**
+         * @brief Progresses to the next subpass, with dynamic rendering this ends the current rendering instance and begins a new one after recording the dependencies of the next subpass
+         * @param contents If the next subpass will have its commands recorded inline or in secondary command buffers
+         */
+        void NextSubpass(vk::raii::CommandBuffer &commandBuffer, vk::SubpassContents contents);
+
+        /**
+         * @brief Ends the render pass or the rendering instance of the last subpass
+         */
+        void End(vk::raii::CommandBuffer &commandBuffer);
+
+        /**
+         * @return The inheritance info required by secondary command buffers to continue the supplied subpass with dynamic rendering
+         * @note The returned structure references storage inside the node and is only valid after `Prepare` has been called
+         */
+        vk::CommandBufferInheritanceRenderingInfo GetInheritanceRenderingInfo(u32 subpassIndex);
+
         vk::RenderPass operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu);
     };
 
     /**
-     * @brief A node which progresses to the next subpass during a render pass
+     * @brief A node which progresses to the next subpass during a render pass, the transition is recorded by the RenderPassNode of the render pass
      */
     struct NextSubpassNode {
-        void operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
-            commandBuffer.nextSubpass(vk::SubpassContents::eInline);
-        }
+        static constexpr NodeType Type{NodeType::NextSubpass};
     };
 
-    using SubpassFunctionNode = FunctionNodeBase<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)>;
+    using SubpassFunctionNode = FunctionNodeBase<NodeType::SubpassFunction, vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32>;
 
     /**
-     * @brief A FunctionNode which progresses to the next subpass prior to calling the function
+     * @brief A SubpassFunctionNode which requires progressing to the next subpass prior to calling the function, the transition is recorded during replay as it may be recorded into a different command buffer than the function
      */
-    struct NextSubpassFunctionNode : private SubpassFunctionNode {
-        using SubpassFunctionNode::SubpassFunctionNode;
-
-        void operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu, vk::RenderPass renderPass, u32 subpassIndex) {
-            commandBuffer.nextSubpass(vk::SubpassContents::eInline);
-            SubpassFunctionNode::operator()(commandBuffer, cycle, gpu, renderPass, subpassIndex);
-        }
-    };
+    using NextSubpassFunctionNode = FunctionNodeBase<NodeType::NextSubpassFunction, vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32>;
 
     /**
-     * @brief Ends a VkRenderPass that would be created prior with RenderPassNode
+     * @brief Ends a VkRenderPass that would be created prior with RenderPassNode, the end is recorded by the RenderPassNode of the render pass
      */
     struct RenderPassEndNode {
-        void operator()(vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
-            commandBuffer.endRenderPass();
-        }
+        static constexpr NodeType Type{NodeType::RenderPassEnd};
     };
 
     /**
      * @brief A node which copies the contained ID value to the debug tracking buffer
      */
     struct CheckpointNode {
+        static constexpr NodeType Type{NodeType::Checkpoint};
+
         BufferBinding binding; //!< Binding for a GPU-side buffer containing the checkpoint ID
         u32 id;
     };
 
-    using NodeVariant = std::variant<FunctionNode, CheckpointNode, RenderPassNode, NextSubpassNode, SubpassFunctionNode, NextSubpassFunctionNode, RenderPassEndNode>; //!< A variant encompassing all command nodes types
+    /**
+     * @brief The header preceding every node in a NodeStream, the node itself directly follows the header in memory
+     */
+    struct alignas(std::max_align_t) NodeHeader {
+        using DestroyFunction = void (*)(NodeHeader *header);
+
+        NodeHeader *next; //!< The next node in the stream, this is null for the last node
+        DestroyFunction destroy; //!< Destroys the node and any inline payload, this is null for nodes which are trivially destructible
+        NodeType type;
+
+        template<typename T>
+        T &Get() {
+            return *reinterpret_cast<T *>(reinterpret_cast<u8 *>(this) + sizeof(NodeHeader));
+        }
+    };
+
+    /**
+     * @brief A singly-linked stream of variable-sized type-tagged nodes which are linearly allocated from the slot allocator, this allows replay to be a single sequential walk over mostly contiguous memory without any per-node heap allocations
+     * @note Nodes are allocated as untracked allocations and their memory is only reclaimed when the backing allocator is reset, `Clear` must be called prior to that
+     */
+    class NodeStream {
+      private:
+        LinearAllocatorState<> &allocator;
+        NodeHeader *head{};
+        NodeHeader *tail{};
+        size_t count{};
+
+        template<typename T>
+        static void Destroy(NodeHeader *header) {
+            std::destroy_at(&header->Get<T>());
+        }
+
+        template<typename T, typename Function>
+        static void DestroyInlineFunction(NodeHeader *header) {
+            std::destroy_at(header->Get<T>().template GetFunction<Function>());
+        }
+
+      public:
+        NodeStream(LinearAllocatorState<> &allocator);
+
+        NodeStream(const NodeStream &) = delete;
+
+        NodeStream(NodeStream &&other);
+
+        ~NodeStream();
+
+        /**
+         * @brief Allocates and constructs a node without linking it into the stream
+         */
+        template<typename T, typename... Args>
+        NodeHeader *Create(Args &&... args) {
+            auto header{std::construct_at(reinterpret_cast<NodeHeader *>(allocator.Allocate(sizeof(NodeHeader) + sizeof(T), false)), NodeHeader{
+                .destroy = std::is_trivially_destructible_v<T> ? nullptr : &Destroy<T>,
+                .type = T::Type,
+            })};
+            std::construct_at(&header->Get<T>(), std::forward<Args>(args)...);
+            return header;
+        }
+
+        /**
+         * @brief Allocates and constructs a function node with the function object stored inline after it without linking it into the stream
+         */
+        template<typename T, typename Function>
+        NodeHeader *CreateFunction(Function &&function) {
+            using FunctionType = std::decay_t<Function>;
+            static_assert(alignof(FunctionType) <= alignof(std::max_align_t));
+
+            auto header{std::construct_at(reinterpret_cast<NodeHeader *>(allocator.Allocate(util::AlignUp(sizeof(NodeHeader) + sizeof(T), alignof(FunctionType)) + sizeof(FunctionType), false)), NodeHeader{
+                .destroy = std::is_trivially_destructible_v<FunctionType> ? nullptr : &DestroyInlineFunction<T, FunctionType>,
+                .type = T::Type,
+            })};
+            auto node{std::construct_at(&header->Get<T>(), T{&T::template Invoke<FunctionType>})};
+            std::construct_at(node->template GetFunction<FunctionType>(), std::forward<Function>(function));
+            return header;
+        }
+
+        /**
+         * @brief Appends a node created with `Create` or `CreateFunction` to the end of the stream
+         */
+        void PushBack(NodeHeader *node);
+
+        /**
+         * @brief Inserts a node created with `Create` or `CreateFunction` after the supplied node
+         * @param previous The node to insert after, the node is inserted at the start of the stream if this is null
+         */
+        void InsertAfter(NodeHeader *previous, NodeHeader *node);
+
+        template<typename T, typename... Args>
+        T &EmplaceBack(Args &&... args) {
+            NodeHeader *header{Create<T>(std::forward<Args>(args)...)};
+            PushBack(header);
+            return header->Get<T>();
+        }
+
+        /**
+         * @brief Moves all nodes from the supplied stream to the end of this stream, both streams must share the same allocator
+         */
+        void Splice(NodeStream &other);
+
+        /**
+         * @brief Destroys all nodes in the stream, the memory backing them is only reclaimed once the allocator is reset
+         */
+        void Clear();
+
+        NodeHeader *Front() const {
+            return head;
+        }
+
+        NodeHeader *Back() const {
+            return tail;
+        }
+
+        size_t Size() const {
+            return count;
+        }
+
+        bool Empty() const {
+            return count == 0;
+        }
+    };
 }
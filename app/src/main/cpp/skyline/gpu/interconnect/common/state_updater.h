@@ -203,27 +203,33 @@ namespace skyline::gpu::interconnect {
     };
     using SetBaseStencilStateCmd = CmdHolder<SetBaseStencilStateCmdImpl>;
 
+    /**
+     * @brief Resolves the buffer descriptor infos of a descriptor update from their dynamic bindings
+     */
+    inline void ResolveDescriptorBufferInfos(GPU &gpu, DescriptorUpdateInfo *updateInfo) {
+        for (size_t i{}; i < updateInfo->bufferDescDynamicBindings.size(); i++) {
+            auto &dynamicBinding{updateInfo->bufferDescDynamicBindings[i]};
+            BufferBinding binding{[&dynamicBinding, &gpu]() {
+                if (auto view{std::get_if<BufferView>(&dynamicBinding)})
+                    return view->GetBinding(gpu);
+                else if (auto binding{std::get_if<BufferBinding>(&dynamicBinding)})
+                    return *binding;
+                else
+                    return BufferBinding{};
+            }()};
+
+            updateInfo->bufferDescs[i] = vk::DescriptorBufferInfo{
+                .buffer = binding.buffer,
+                .offset = binding.offset,
+                .range = binding.size
+            };
+        }
+    }
+
     template<bool PushDescriptor>
     struct SetDescriptorSetCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
-            // Resolve descriptor infos from dynamic bindings
-            for (size_t i{}; i < updateInfo->bufferDescDynamicBindings.size(); i++) {
-                auto &dynamicBinding{updateInfo->bufferDescDynamicBindings[i]};
-                BufferBinding binding{[&dynamicBinding, &gpu]() {
-                    if (auto view{std::get_if<BufferView>(&dynamicBinding)})
-                        return view->GetBinding(gpu);
-                    else if (auto binding{std::get_if<BufferBinding>(&dynamicBinding)})
-                        return *binding;
-                    else
-                        return BufferBinding{};
-                }()};
-
-                updateInfo->bufferDescs[i] = vk::DescriptorBufferInfo{
-                    .buffer = binding.buffer,
-                    .offset = binding.offset,
-                    .range = binding.size
-                };
-            }
+            ResolveDescriptorBufferInfos(gpu, updateInfo);
 
             if constexpr (PushDescriptor) {
                 commandBuffer.pushDescriptorSetKHR(updateInfo->bindPoint, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex, updateInfo->writes);
@@ -256,6 +262,24 @@ namespace skyline::gpu::interconnect {
     using SetDescriptorSetWithUpdateCmd = CmdHolder<SetDescriptorSetCmdImpl<false>>;
     using SetDescriptorSetWithPushCmd = CmdHolder<SetDescriptorSetCmdImpl<true>>;
 
+    struct SetDescriptorSetWithBufferCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            ResolveDescriptorBufferInfos(gpu, updateInfo);
+
+            // Copies are only used for partial updates where all other descriptors are carried over from the previous set, since both sets share a layout we can copy the entire set prior to performing the writes
+            if (!updateInfo->copies.empty() && srcAllocation)
+                dstAllocation->region.copy_from(srcAllocation->region);
+
+            gpu.descriptorBuffer.Write(*dstAllocation, updateInfo->descriptorSetLayout, updateInfo->writes);
+            gpu.descriptorBuffer.Bind(commandBuffer, *dstAllocation, updateInfo->bindPoint, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex);
+        }
+
+        DescriptorUpdateInfo *updateInfo;
+        DescriptorBufferAllocator::Allocation *srcAllocation;
+        DescriptorBufferAllocator::Allocation *dstAllocation;
+    };
+    using SetDescriptorSetWithBufferCmd = CmdHolder<SetDescriptorSetWithBufferCmdImpl>;
+
     struct SetPipelineCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
             commandBuffer.bindPipeline(bindPoint, pipeline);
@@ -478,6 +502,15 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
+        void SetDescriptorSetWithBuffer(DescriptorUpdateInfo *updateInfo, DescriptorBufferAllocator::Allocation *dstAllocation, DescriptorBufferAllocator::Allocation *srcAllocation) {
+            AppendCmd<SetDescriptorSetWithBufferCmd>(
+                {
+                    .updateInfo = updateInfo,
+                    .srcAllocation = srcAllocation,
+                    .dstAllocation = dstAllocation,
+                });
+        }
+
         void SetPipeline(vk::Pipeline pipeline, vk::PipelineBindPoint bindPoint) {
             AppendCmd<SetPipelineCmd>(
                 {
@@ -43,8 +43,11 @@ namespace skyline::gpu::interconnect::kepler_compute {
         auto *descUpdateInfo{pipeline->SyncDescriptors(ctx, constantBuffers.boundConstantBuffers, samplers, textures, srcStageMask, dstStageMask)};
         builder.SetPipeline(*pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eCompute);
 
-        if (ctx.gpu.traits.supportsPushDescriptors) {
+        if (ctx.gpu.traits.descriptorBackend == TraitManager::DescriptorBackend::Push) {
             builder.SetDescriptorSetWithPush(descUpdateInfo);
+        } else if (ctx.gpu.traits.descriptorBackend == TraitManager::DescriptorBackend::Buffer) {
+            auto *allocation{ctx.executor.allocator->EmplaceUntracked<DescriptorBufferAllocator::Allocation>(ctx.gpu.descriptorBuffer.Allocate(ctx.executor.cycle, descUpdateInfo->descriptorSetLayout))};
+            builder.SetDescriptorSetWithBuffer(descUpdateInfo, allocation, nullptr);
         } else {
             auto set{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(ctx.gpu.descriptor.AllocateSet(descUpdateInfo->descriptorSetLayout))};
 
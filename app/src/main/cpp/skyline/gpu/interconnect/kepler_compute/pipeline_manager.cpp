@@ -69,7 +69,16 @@ namespace skyline::gpu::interconnect::kepler_compute {
                                                                                const Pipeline::ShaderStage &shaderStage,
                                                                                span<vk::DescriptorSetLayoutBinding> layoutBindings) {
         vk::raii::DescriptorSetLayout descriptorSetLayout{ctx.gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
-            .flags = vk::DescriptorSetLayoutCreateFlags{ctx.gpu.traits.supportsPushDescriptors ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
+            .flags = [&]() -> vk::DescriptorSetLayoutCreateFlags {
+                switch (ctx.gpu.traits.descriptorBackend) {
+                    case TraitManager::DescriptorBackend::Push:
+                        return vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+                    case TraitManager::DescriptorBackend::Buffer:
+                        return vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT;
+                    default:
+                        return {};
+                }
+            }(),
             .pBindings = layoutBindings.data(),
             .bindingCount = static_cast<u32>(layoutBindings.size()),
         }};
@@ -86,6 +95,7 @@ namespace skyline::gpu::interconnect::kepler_compute {
         };
 
         vk::ComputePipelineCreateInfo pipelineInfo{
+            .flags = ctx.gpu.traits.descriptorBackend == TraitManager::DescriptorBackend::Buffer ? vk::PipelineCreateFlagBits::eDescriptorBufferEXT : vk::PipelineCreateFlags{},
             .stage = shaderStageInfo,
             .layout = *pipelineLayout,
         };
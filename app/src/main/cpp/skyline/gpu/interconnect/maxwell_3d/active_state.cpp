@@ -417,9 +417,13 @@ namespace skyline::gpu::interconnect::maxwell3d {
           directState{pipeline.Get().directState} {}
 
     void ActiveState::MarkAllDirty() {
+        pipeline.MarkDirty(true);
+        MarkEmittedStateDirty();
+    }
+
+    void ActiveState::MarkEmittedStateDirty() {
         auto dirtyFunc{[&](auto &stateElem) { stateElem.MarkDirty(true); }};
 
-        dirtyFunc(pipeline);
         ranges::for_each(vertexBuffers, dirtyFunc);
         dirtyFunc(indexBuffer);
         ranges::for_each(transformFeedbackBuffers, dirtyFunc);
@@ -432,19 +436,23 @@ namespace skyline::gpu::interconnect::maxwell3d {
         dirtyFunc(stencilValues);
     }
 
-    void ActiveState::Update(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, StateUpdateBuilder &builder,
-                             bool indexed, engine::DrawTopology topology, bool estimateIndexBufferSize, u32 drawFirstIndex, u32 drawElementCount,
-                             vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask) {
-        TRACE_EVENT("gpu", "ActiveState::Update");
+    void ActiveState::UpdatePipeline(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, engine::DrawTopology topology) {
+        TRACE_EVENT("gpu", "ActiveState::UpdatePipeline");
         if (topology != directState.inputAssembly.GetPrimitiveTopology()) {
             directState.inputAssembly.SetPrimitiveTopology(topology);
             pipeline.MarkDirty(false);
         }
 
+        pipeline.Update(ctx, textures, constantBuffers);
+    }
+
+    void ActiveState::Update(InterconnectContext &ctx, StateUpdateBuilder &builder,
+                             bool indexed, bool estimateIndexBufferSize, u32 drawFirstIndex, u32 drawElementCount,
+                             vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask) {
+        TRACE_EVENT("gpu", "ActiveState::Update");
         auto updateFunc{[&](auto &stateElem, auto &&... args) { stateElem.Update(ctx, builder, args...); }};
         auto updateFuncBuffer{[&](auto &stateElem, auto &&... args) { stateElem.Update(ctx, builder, srcStageMask, dstStageMask, args...); }};
 
-        pipeline.Update(ctx, textures, constantBuffers, builder);
         ranges::for_each(vertexBuffers, updateFuncBuffer);
         if (indexed)
             updateFuncBuffer(indexBuffer, directState.inputAssembly.NeedsQuadConversion(), estimateIndexBufferSize, drawFirstIndex, drawElementCount);
@@ -259,11 +259,22 @@ namespace skyline::gpu::interconnect::maxwell3d {
         void MarkAllDirty();
 
         /**
-         * @brief Updates the active state for a given draw operation, removing the dirtiness of all member states
+         * @brief Marks all state that is emitted into the command buffer as dirty, this excludes the pipeline as it's bound separately
+         */
+        void MarkEmittedStateDirty();
+
+        /**
+         * @brief Updates the pipeline state for a given draw operation, this resolves the pipeline and its attachments without emitting any state
+         */
+        void UpdatePipeline(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, engine::DrawTopology topology);
+
+        /**
+         * @brief Updates the remaining active state for a given draw operation, removing the dirtiness of all member states
+         * @note UpdatePipeline() must be called prior to this for the same draw
          * @note If `extimateIndexBufferSize` is false and `indexed` is true the `drawFirstIndex` and `drawElementCount` arguments must be populated
          */
-        void Update(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, StateUpdateBuilder &builder,
-                    bool indexed, engine::DrawTopology topology, bool estimateIndexBufferSize, u32 drawFirstIndex, u32 drawElementCount,
+        void Update(InterconnectContext &ctx, StateUpdateBuilder &builder,
+                    bool indexed, bool estimateIndexBufferSize, u32 drawFirstIndex, u32 drawElementCount,
                     vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask);
 
         Pipeline *GetPipeline();
@@ -33,6 +33,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 activeDescriptorSet = nullptr;
             }
 
+            activeDescriptorBufferAllocation = nullptr;
+
             activeState.MarkAllDirty();
             constantBuffers.MarkAllDirty();
             samplers.MarkAllDirty();
@@ -45,6 +47,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         ctx.executor.AddPipelineChangeCallback([this] {
             activeState.MarkAllDirty();
             activeDescriptorSet = nullptr;
+            activeDescriptorBufferAllocation = nullptr;
         });
     }
 
@@ -132,22 +135,53 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return scissor;
     }
 
+    void Maxwell3D::InvalidateBoundState() {
+        activeState.MarkEmittedStateDirty();
+        constantBuffers.DisableQuickBind();
+        activeDescriptorSet = nullptr;
+        activeDescriptorBufferAllocation = nullptr;
+        forcePipelineBind = true;
+    }
+
      void Maxwell3D::PrepareDraw(StateUpdateBuilder &builder,
                                  engine::DrawTopology topology, bool indexed, bool estimateIndexBufferSize, u32 firstIndex, u32 count,
                                  vk::PipelineStageFlags &srcStageMask, vk::PipelineStageFlags &dstStageMask) {
          Pipeline *oldPipeline{activeState.GetPipeline()};
          samplers.Update(ctx, samplerBinding.value == engine::SamplerBinding::Value::ViaHeaderBinding);
-         activeState.Update(ctx, textures, constantBuffers.boundConstantBuffers,
-                            builder,
-                            indexed, topology, estimateIndexBufferSize, firstIndex, count,
-                            srcStageMask, dstStageMask);
+         activeState.UpdatePipeline(ctx, textures, constantBuffers.boundConstantBuffers, topology);
          Pipeline *pipeline{activeState.GetPipeline()};
          activeDescriptorSetSampledImages.resize(pipeline->GetTotalSampledImageCount());
 
+         // Secondary command buffers don't inherit any state, so the first draw of every subpass needs to emit all of it rather than only what has changed since the last draw
+         // The subpass is determined before any state is built as the allocations for it (descriptor sets, megabuffer space) would otherwise have to be redone
+         bool usesSecondaryCommandBuffers{ctx.executor.UsesSecondaryCommandBuffers()};
+         auto checkSubpassChange{[&]() {
+             if (!usesSecondaryCommandBuffers)
+                 return false;
+
+             u64 subpassId{ctx.executor.GetSubpassId(GetDrawScissor(), activeDescriptorSetSampledImages, activeState.GetColorAttachments(), activeState.GetDepthAttachment())};
+             if (subpassId == boundStateSubpassId)
+                 return false;
+
+             boundStateSubpassId = subpassId;
+             InvalidateBoundState();
+             return true;
+         }};
+
+         auto syncDescriptors{[&]() {
+             return pipeline->SyncDescriptors(ctx, constantBuffers.boundConstantBuffers, samplers, textures,
+                                              activeDescriptorSetSampledImages,
+                                              srcStageMask, dstStageMask);
+         }};
+
+         // If bindings between the old and new pipelines are the same we can reuse the descriptor sets given that quick bind is enabled (meaning that no buffer updates or calls to non-graphics engines have occurred that could invalidate them)
+         // The sampled images of the prior draw are valid for this pipeline in that case, so a subpass change can be detected prior to syncing descriptors and a full update performed instead
+         bool quickBindable{((oldPipeline == pipeline) || (oldPipeline && oldPipeline->CheckBindingMatch(pipeline))) && constantBuffers.quickBindEnabled};
+         if (quickBindable && checkSubpassChange())
+             quickBindable = false;
 
          auto *descUpdateInfo{[&]() -> DescriptorUpdateInfo * {
-             if (((oldPipeline == pipeline) || (oldPipeline && oldPipeline->CheckBindingMatch(pipeline))) && constantBuffers.quickBindEnabled) {
-                 // If bindings between the old and new pipelines are the same we can reuse the descriptor sets given that quick bind is enabled (meaning that no buffer updates or calls to non-graphics engines have occurred that could invalidate them)
+             if (quickBindable) {
                  if (constantBuffers.quickBind)
                      // If only a single constant buffer has been rebound between draws we can perform a partial descriptor update
                      return pipeline->SyncDescriptorsQuickBind(ctx, constantBuffers.boundConstantBuffers, samplers, textures,
@@ -157,19 +191,31 @@ namespace skyline::gpu::interconnect::maxwell3d {
                      return nullptr;
              } else {
                  // If bindings have changed or quick bind is disabled, perform a full descriptor update
-                 return pipeline->SyncDescriptors(ctx, constantBuffers.boundConstantBuffers, samplers, textures,
-                                                  activeDescriptorSetSampledImages,
-                                                  srcStageMask, dstStageMask);
+                 return syncDescriptors();
              }
          }()};
 
-         if (oldPipeline != pipeline)
+         // The sampled images are only known after syncing descriptors, a quick bind can rebind textures in a way that moves the draw into a new subpass which requires a full update after all
+         if (checkSubpassChange() && quickBindable)
+             descUpdateInfo = syncDescriptors();
+
+         activeState.Update(ctx, builder,
+                            indexed, estimateIndexBufferSize, firstIndex, count,
+                            srcStageMask, dstStageMask);
+
+         if (std::exchange(forcePipelineBind, false) || oldPipeline != pipeline)
              // If the pipeline has changed, we need to update the pipeline state
              builder.SetPipeline(pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eGraphics);
 
          if (descUpdateInfo) {
-             if (ctx.gpu.traits.supportsPushDescriptors) {
+             if (ctx.gpu.traits.descriptorBackend == TraitManager::DescriptorBackend::Push) {
                  builder.SetDescriptorSetWithPush(descUpdateInfo);
+             } else if (ctx.gpu.traits.descriptorBackend == TraitManager::DescriptorBackend::Buffer) {
+                 auto *newAllocation{ctx.executor.allocator->EmplaceUntracked<DescriptorBufferAllocator::Allocation>(ctx.gpu.descriptorBuffer.Allocate(ctx.executor.cycle, descUpdateInfo->descriptorSetLayout))};
+                 auto *oldAllocation{activeDescriptorBufferAllocation};
+                 activeDescriptorBufferAllocation = newAllocation;
+
+                 builder.SetDescriptorSetWithBuffer(descUpdateInfo, activeDescriptorBufferAllocation, oldAllocation);
              } else {
                  if (!attachedDescriptorSets)
                      attachedDescriptorSets = std::make_shared<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>>();
@@ -351,7 +397,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
             if (drawParams->transformFeedbackEnable)
                 commandBuffer.endTransformFeedbackEXT(0, {}, {});
-        }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !ctx.gpu.traits.quirks.relaxedRenderPassCompatibility, srcStageMask, dstStageMask);
+        }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !(ctx.gpu.traits.quirks.relaxedRenderPassCompatibility || ctx.gpu.traits.supportsDynamicRendering), srcStageMask, dstStageMask);
         ctx.executor.AddCheckpoint("After draw");
     }
 
@@ -414,7 +460,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
             if (drawParams->transformFeedbackEnable)
                 commandBuffer.endTransformFeedbackEXT(0, {}, {});
-        }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !ctx.gpu.traits.quirks.relaxedRenderPassCompatibility, srcStageMask, dstStageMask);
+        }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !(ctx.gpu.traits.quirks.relaxedRenderPassCompatibility || ctx.gpu.traits.supportsDynamicRendering), srcStageMask, dstStageMask);
         ctx.executor.AddCheckpoint("After indirect draw");
     }
 
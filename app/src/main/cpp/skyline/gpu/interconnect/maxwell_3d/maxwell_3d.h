@@ -4,6 +4,7 @@
 #pragma once
 
 #include <gpu/descriptor_allocator.h>
+#include <gpu/descriptor_buffer.h>
 #include <gpu/interconnect/common/samplers.h>
 #include <gpu/interconnect/common/textures.h>
 #include <soc/gm20b/gmmu.h>
@@ -57,7 +58,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
         static constexpr size_t DescriptorBatchSize{0x100};
         std::shared_ptr<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>> attachedDescriptorSets;
         DescriptorAllocator::ActiveDescriptorSet *activeDescriptorSet{};
+        DescriptorBufferAllocator::Allocation *activeDescriptorBufferAllocation{}; //!< The descriptor buffer allocation of the last draw, this is linearly allocated in the executor's allocator and is only valid until the next flush
         std::vector<TextureView *> activeDescriptorSetSampledImages{};
+        u64 boundStateSubpassId{}; //!< The ID of the subpass that the bound state was last fully emitted for, only used when subpasses are recorded into secondary command buffers
+        bool forcePipelineBind{}; //!< If the pipeline needs to be bound on the next draw even if it's unchanged
 
         size_t UpdateQuadConversionBuffer(u32 count, u32 firstVertex);
 
@@ -71,6 +75,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
          */
         vk::Rect2D GetDrawScissor();
 
+        /**
+         * @brief Marks all state as dirty and drops any bound descriptors so that the next draw will emit all of its state into the command buffer
+         */
+        void InvalidateBoundState();
+
         /**
          * @brief Performs operations common across indirect and regular draws
          */
@@ -384,7 +384,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
           globalShaderConfig{engine.globalShaderConfigRegisters},
           ctSelect{engine.ctSelect} {}
 
-    void PipelineState::Flush(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, StateUpdateBuilder &builder) {
+    void PipelineState::Flush(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers) {
         TRACE_EVENT("gpu", "PipelineState::Flush");
 
         packedState.dynamicStateActive = ctx.gpu.traits.supportsExtendedDynamicState;
@@ -5,7 +5,7 @@
 #include "megabuffer.h"
 
 namespace skyline::gpu {
-    MegaBufferChunk::MegaBufferChunk(GPU &gpu) : backing{gpu.memory.AllocateBuffer(MegaBufferChunkSize)}, freeRegion{backing.subspan(PAGE_SIZE)} {}
+    MegaBufferChunk::MegaBufferChunk(GPU &gpu, vk::DeviceSize size) : backing{gpu.memory.AllocateBuffer(size)}, residentMemory{gpu.memory.TrackResidency(memory::ResidencyCategory::MegaBuffer, backing.vmaAllocation)}, freeRegion{backing.subspan(PAGE_SIZE)} {}
 
     bool MegaBufferChunk::TryReset() {
         if (cycle && cycle->Poll(true)) {
@@ -21,6 +21,10 @@ namespace skyline::gpu {
         return backing.vkBuffer;
     }
 
+    vk::DeviceSize MegaBufferChunk::GetSize() const {
+        return backing.size();
+    }
+
     std::pair<vk::DeviceSize, span<u8>> MegaBufferChunk::Allocate(const std::shared_ptr<FenceCycle> &newCycle, vk::DeviceSize size, bool pageAlign) {
         if (pageAlign) {
             // If page aligned data was requested then align the free
@@ -45,15 +49,80 @@ namespace skyline::gpu {
         return {static_cast<vk::DeviceSize>(resultSpan.data() - backing.data()), resultSpan};
     }
 
-    MegaBufferAllocator::MegaBufferAllocator(GPU &gpu) : gpu{gpu}, activeChunk{chunks.emplace(chunks.end(), gpu)} {}
+    MegaBufferAllocator::MegaBufferAllocator(GPU &gpu) : gpu{gpu}, activeChunk{chunks.emplace(chunks.end(), gpu, MegaBufferChunkSize)} {}
+
+    void MegaBufferAllocator::EndFrame(u64 frame) {
+        // Any frames that were skipped over had no allocations made during them
+        for (u64 skippedFrame{currentFrame}; skippedFrame < frame && skippedFrame - currentFrame < UsageHistoryFrameCount; skippedFrame++)
+            usageHistory[skippedFrame % UsageHistoryFrameCount] = (skippedFrame == currentFrame) ? frameBytes : 0;
+
+        // New chunks should be able to fit the allocations of an entire frame to avoid switching chunks mid-frame
+        auto highWaterMark{*ranges::max_element(usageHistory)};
+        chunkSize = std::clamp(util::AlignUp(highWaterMark, MegaBufferMinChunkSize), MegaBufferMinChunkSize, MegaBufferMaxChunkSize);
+
+        size_t freedCount{};
+        for (auto it{chunks.begin()}; it != chunks.end();) {
+            if (it != activeChunk && (frame - it->lastUsedFrame > IdleFrameThreshold || it->GetSize() > chunkSize * 2) && it->TryReset()) {
+                it = chunks.erase(it);
+                freedCount++;
+            } else {
+                it++;
+            }
+        }
+
+        TRACE_COUNTER("gpu", "MegaBuffer Bytes Pushed", static_cast<i64>(frameBytes));
+        TRACE_COUNTER("gpu", "MegaBuffer High-Water Mark", static_cast<i64>(highWaterMark));
+        TRACE_COUNTER("gpu", "MegaBuffer Chunk Size", static_cast<i64>(chunkSize));
+        TRACE_COUNTER("gpu", "MegaBuffer Chunk Count", static_cast<i64>(chunks.size()));
+        TRACE_COUNTER("gpu", "MegaBuffer Freed Chunks", static_cast<i64>(freedCount));
+        TRACE_COUNTER("gpu", "MegaBuffer Stalls", static_cast<i64>(frameStallCount));
+        TRACE_COUNTER("gpu", "MegaBuffer Fallbacks", static_cast<i64>(frameFallbackCount));
+
+        currentFrame = frame;
+        frameBytes = 0;
+        frameStallCount = 0;
+        frameFallbackCount = 0;
+    }
+
+    void MegaBufferAllocator::AdvanceChunk(vk::DeviceSize requiredSize) {
+        activeChunk->lastUsedFrame = currentFrame;
+
+        // Walk the ring starting from the least recently used chunk, which is the most likely to have been signalled
+        auto it{activeChunk};
+        for (size_t i{}; i < chunks.size(); i++) {
+            if (++it == chunks.end())
+                it = chunks.begin();
+
+            if (it->GetSize() < requiredSize)
+                continue;
+
+            if (it->TryReset()) {
+                activeChunk = it;
+                activeChunk->lastUsedFrame = currentFrame;
+                return;
+            }
+
+            if (i == 0)
+                frameStallCount++; // A fixed-size ring would have to wait on the GPU here
+        }
+
+        // Inserting the new chunk after the active chunk keeps the ring ordered by usage
+        frameFallbackCount++;
+        activeChunk = chunks.emplace(std::next(activeChunk), gpu, std::max(chunkSize, requiredSize));
+        activeChunk->lastUsedFrame = currentFrame;
+    }
 
     MegaBufferAllocator::Allocation MegaBufferAllocator::Allocate(const std::shared_ptr<FenceCycle> &cycle, vk::DeviceSize size, bool pageAlign) {
+        if (auto frame{frameCount.load(std::memory_order_relaxed)}; frame != currentFrame) [[unlikely]]
+            EndFrame(frame);
+
+        frameBytes += size;
+
         if (auto allocation{activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
             return {activeChunk->GetBacking(), allocation.first, allocation.second};
 
-        activeChunk = ranges::find_if(chunks, [&](auto &chunk) { return chunk.TryReset(); });
-        if (activeChunk == chunks.end()) // If there are no chunks available, allocate a new one
-            activeChunk = chunks.emplace(chunks.end(), gpu);
+        // The first page of every chunk is reserved and another page may be lost to alignment
+        AdvanceChunk(util::AlignUp(size, PAGE_SIZE) + (PAGE_SIZE * 2));
 
         if (auto allocation{activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
             return {activeChunk->GetBacking(), allocation.first, allocation.second};
@@ -66,4 +135,8 @@ namespace skyline::gpu {
         allocation.region.copy_from(data);
         return allocation;
     }
+
+    void MegaBufferAllocator::MarkFrame() {
+        frameCount.fetch_add(1, std::memory_order_relaxed);
+    }
 }
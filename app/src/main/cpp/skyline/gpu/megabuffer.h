@@ -6,7 +6,9 @@
 #include "memory_manager.h"
 
 namespace skyline::gpu {
-    constexpr static vk::DeviceSize MegaBufferChunkSize{25 * 1024 * 1024}; //!< Size in bytes of a single megabuffer chunk (25MiB)
+    constexpr static vk::DeviceSize MegaBufferChunkSize{25 * 1024 * 1024}; //!< Size in bytes of the initial megabuffer chunk (25MiB), this is also the limit for the size of data which should be megabuffered
+    constexpr static vk::DeviceSize MegaBufferMinChunkSize{4 * 1024 * 1024}; //!< The minimum size in bytes of a megabuffer chunk (4MiB), chunk sizes are also a multiple of this
+    constexpr static vk::DeviceSize MegaBufferMaxChunkSize{64 * 1024 * 1024}; //!< The maximum size in bytes of a megabuffer chunk that is sized from the usage high-water mark (64MiB)
 
     /**
       * @brief A simple linearly allocated GPU-side buffer used to temporarily store buffer modifications allowing them to be replayed in-sequence on the GPU
@@ -16,10 +18,13 @@ namespace skyline::gpu {
       private:
         std::shared_ptr<FenceCycle> cycle; //!< Latest cycle this chunk has had allocations in
         memory::Buffer backing; //!< The GPU buffer as the backing storage for the chunk
+        memory::ResidentMemory residentMemory;
         span<u8> freeRegion; //!< The unallocated space in the chunk
 
       public:
-        MegaBufferChunk(GPU &gpu);
+        u64 lastUsedFrame{}; //!< The last frame during which the chunk was the active chunk of the allocator
+
+        MegaBufferChunk(GPU &gpu, vk::DeviceSize size);
 
         /**
          * @brief If the chunk's cycle is is signalled, resets the free region of the megabuffer to its initial state, if it's not signalled the chunk must not be used
@@ -32,18 +37,42 @@ namespace skyline::gpu {
          */
         vk::Buffer GetBacking() const;
 
+        vk::DeviceSize GetSize() const;
+
         std::pair<vk::DeviceSize, span<u8>> Allocate(const std::shared_ptr<FenceCycle> &newCycle, vk::DeviceSize size, bool pageAlign = false);
     };
 
     /**
      * @brief Allocator for megabuffer chunks that takes the usage of resources on the GPU into account
-     * @note This class is not thread-safe and any calls must be externally synchronized
+     * @note Chunks are reused as a ring and the size of new chunks is adapted to the high-water mark of per-frame usage, chunks that have been idle for a while or are far larger than required are freed
+     * @note This class is not thread-safe and any calls must be externally synchronized, with the exception of `MarkFrame`
      */
     class MegaBufferAllocator {
       private:
+        static constexpr size_t UsageHistoryFrameCount{32}; //!< The amount of frames that the usage high-water mark is calculated over
+        static constexpr u64 IdleFrameThreshold{120}; //!< The amount of frames a chunk must be unused for before it is freed
+
         GPU &gpu;
-        std::list<MegaBufferChunk> chunks; //!< A pool of all allocated megabuffer chunks, these are dynamically utilized
+        std::list<MegaBufferChunk> chunks; //!< A ring of all allocated megabuffer chunks, the chunks following the active chunk are ordered from least to most recently used
         decltype(chunks)::iterator activeChunk; //!< Currently active chunk of the megabuffer which is being allocated into
+        vk::DeviceSize chunkSize{MegaBufferChunkSize}; //!< The size of any newly allocated chunks, this is recalculated every frame
+
+        std::atomic<u64> frameCount{}; //!< The amount of frames that have been marked, this may be updated from any thread
+        u64 currentFrame{}; //!< The frame that allocations are currently being accounted to
+        std::array<vk::DeviceSize, UsageHistoryFrameCount> usageHistory{}; //!< The amount of bytes allocated in each of the last `UsageHistoryFrameCount` frames
+        vk::DeviceSize frameBytes{}; //!< The amount of bytes allocated during the current frame
+        u32 frameStallCount{}; //!< The amount of times the next chunk in the ring was still in use by the GPU during the current frame
+        u32 frameFallbackCount{}; //!< The amount of times no chunk in the ring could be reused and a new chunk had to be allocated during the current frame
+
+        /**
+         * @brief Records the usage statistics of the current frame, resizes chunks based on the new high-water mark and frees any idle chunks
+         */
+        void EndFrame(u64 frame);
+
+        /**
+         * @brief Makes the next free chunk in the ring with at least the supplied size the active chunk, allocating a new chunk if there are none
+         */
+        void AdvanceChunk(vk::DeviceSize requiredSize);
 
       public:
         /**
@@ -74,5 +103,11 @@ namespace skyline::gpu {
          * @note The allocator *MUST* be locked before calling this function
          */
         Allocation Push(const std::shared_ptr<FenceCycle> &cycle, span<u8> data, bool pageAlign = false);
+
+        /**
+         * @brief Marks the end of a guest frame, this is used for tracking per-frame usage
+         * @note This is thread-safe and does not require the allocator to be locked
+         */
+        void MarkFrame();
     };
 }
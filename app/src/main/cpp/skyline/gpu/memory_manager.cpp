@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/trace.h>
 #include <gpu.h>
 #include "memory_manager.h"
 
@@ -33,7 +34,27 @@ namespace skyline::gpu::memory {
         return pointer;
     }
 
-    MemoryManager::MemoryManager(GPU &pGpu) : gpu{pGpu} {
+    ResidentMemory::ResidentMemory(MemoryManager &manager, ResidencyCategory category, vk::DeviceSize size) : manager{&manager}, category{category}, size{size} {
+        manager.UpdateResidentSize(category, static_cast<i64>(size));
+    }
+
+    ResidentMemory::ResidentMemory(ResidentMemory &&other) : manager{std::exchange(other.manager, nullptr)}, category{other.category}, size{std::exchange(other.size, 0)} {}
+
+    ResidentMemory &ResidentMemory::operator=(ResidentMemory &&other) {
+        if (manager)
+            manager->UpdateResidentSize(category, -static_cast<i64>(size));
+        manager = std::exchange(other.manager, nullptr);
+        category = other.category;
+        size = std::exchange(other.size, 0);
+        return *this;
+    }
+
+    ResidentMemory::~ResidentMemory() {
+        if (manager)
+            manager->UpdateResidentSize(category, -static_cast<i64>(size));
+    }
+
+    MemoryManager::MemoryManager(GPU &pGpu, bool enableSmallImagePools) : gpu{pGpu}, enableSmallImagePools{enableSmallImagePools} {
         auto instanceDispatcher{gpu.vkInstance.getDispatcher()};
         auto deviceDispatcher{gpu.vkDevice.getDispatcher()};
         VmaVulkanFunctions vulkanFunctions{
@@ -60,9 +81,20 @@ namespace skyline::gpu::memory {
             .vkBindImageMemory2KHR = deviceDispatcher->vkBindImageMemory2,
             .vkGetPhysicalDeviceMemoryProperties2KHR = instanceDispatcher->vkGetPhysicalDeviceMemoryProperties2,
         };
+        VmaDeviceMemoryCallbacks deviceMemoryCallbacks{
+            .pfnAllocate = [](VmaAllocator, u32, VkDeviceMemory, VkDeviceSize, void *userData) {
+                static_cast<MemoryManager *>(userData)->UpdateDeviceMemoryCount(1);
+            },
+            .pfnFree = [](VmaAllocator, u32, VkDeviceMemory, VkDeviceSize, void *userData) {
+                static_cast<MemoryManager *>(userData)->UpdateDeviceMemoryCount(-1);
+            },
+            .pUserData = this,
+        };
         VmaAllocatorCreateInfo allocatorCreateInfo{
+            .flags = (gpu.traits.supportsBufferDeviceAddress ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : VmaAllocatorCreateFlags{}) | (gpu.traits.supportsMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : VmaAllocatorCreateFlags{}),
             .physicalDevice = *gpu.vkPhysicalDevice,
             .device = *gpu.vkDevice,
+            .pDeviceMemoryCallbacks = &deviceMemoryCallbacks,
             .instance = *gpu.vkInstance,
             .pVulkanFunctions = &vulkanFunctions,
             .vulkanApiVersion = VkApiVersion,
@@ -71,16 +103,101 @@ namespace skyline::gpu::memory {
     }
 
     MemoryManager::~MemoryManager() {
+        for (auto pool : smallImagePools)
+            if (pool)
+                vmaDestroyPool(vmaAllocator, pool);
         vmaDestroyAllocator(vmaAllocator);
     }
 
+    void MemoryManager::UpdateResidentSize(ResidencyCategory category, i64 delta) {
+        auto size{residentSizes[static_cast<size_t>(category)].fetch_add(delta, std::memory_order_relaxed) + delta};
+        switch (category) {
+            case ResidencyCategory::Texture:
+                TRACE_COUNTER("gpu", "Resident Texture Memory", size);
+                break;
+            case ResidencyCategory::Buffer:
+                TRACE_COUNTER("gpu", "Resident Buffer Memory", size);
+                break;
+            case ResidencyCategory::MegaBuffer:
+                TRACE_COUNTER("gpu", "Resident MegaBuffer Memory", size);
+                break;
+        }
+    }
+
+    void MemoryManager::UpdateDeviceMemoryCount(i64 delta) {
+        TRACE_COUNTER("gpu", "Device Memory Objects", deviceMemoryCount.fetch_add(delta, std::memory_order_relaxed) + delta);
+    }
+
+    ResidentMemory MemoryManager::TrackResidency(ResidencyCategory category, VmaAllocation allocation) {
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(vmaAllocator, allocation, &allocationInfo);
+        return ResidentMemory{*this, category, allocationInfo.size};
+    }
+
+    MemoryManager::Budget MemoryManager::GetDeviceLocalBudget() {
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets{};
+        vmaGetHeapBudgets(vmaAllocator, heapBudgets.data());
+
+        const VkPhysicalDeviceMemoryProperties *memoryProperties;
+        vmaGetMemoryProperties(vmaAllocator, &memoryProperties);
+
+        Budget budget{};
+        for (u32 heap{}; heap < memoryProperties->memoryHeapCount; heap++) {
+            if (memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+                budget.usage += heapBudgets[heap].usage;
+                budget.budget += heapBudgets[heap].budget;
+            }
+        }
+
+        TRACE_COUNTER("gpu", "Device Memory Usage", static_cast<i64>(budget.usage));
+        TRACE_COUNTER("gpu", "Device Memory Budget", static_cast<i64>(budget.budget));
+        return budget;
+    }
+
+    VmaPool MemoryManager::GetSmallImagePool(u32 memoryTypeBits, const VmaAllocationCreateInfo &allocationCreateInfo) {
+        u32 memoryTypeIndex;
+        ThrowOnFail(vmaFindMemoryTypeIndex(vmaAllocator, memoryTypeBits, &allocationCreateInfo, &memoryTypeIndex));
+
+        std::scoped_lock lock{smallImagePoolMutex};
+        auto &pool{smallImagePools[memoryTypeIndex]};
+        if (!pool) {
+            VmaPoolCreateInfo poolCreateInfo{
+                .memoryTypeIndex = memoryTypeIndex,
+                .blockSize = SmallImagePoolBlockSize,
+            };
+            ThrowOnFail(vmaCreatePool(vmaAllocator, &poolCreateInfo, &pool));
+        }
+
+        return pool;
+    }
+
+    u32 MemoryManager::AdvanceSubmission() {
+        auto index{submissionIndex.fetch_add(1, std::memory_order_relaxed) + 1};
+        vmaSetCurrentFrameIndex(vmaAllocator, index);
+        return index;
+    }
+
+    vk::BufferUsageFlags MemoryManager::GetBufferUsage() const {
+        vk::BufferUsageFlags usage{vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT};
+        if (gpu.traits.supportsBufferDeviceAddress)
+            usage |= vk::BufferUsageFlagBits::eShaderDeviceAddress; // Required to resolve buffer addresses when writing descriptors into descriptor buffers
+        return usage;
+    }
+
+    vk::DeviceAddress MemoryManager::GetBufferDeviceAddress(vk::Buffer buffer) const {
+        return (*gpu.vkDevice).getBufferAddressKHR(vk::BufferDeviceAddressInfo{
+            .buffer = buffer,
+        }, *gpu.vkDevice.getDispatcher());
+    }
+
     std::shared_ptr<StagingBuffer> MemoryManager::AllocateStagingBuffer(vk::DeviceSize size) {
+        auto queueFamilyIndices{gpu.GetTransferQueueFamilyIndices()};
         vk::BufferCreateInfo bufferCreateInfo{
             .size = size,
             .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
-            .sharingMode = vk::SharingMode::eExclusive,
-            .queueFamilyIndexCount = 1,
-            .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
+            .sharingMode = queueFamilyIndices.size() > 1 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+            .queueFamilyIndexCount = static_cast<u32>(queueFamilyIndices.size()),
+            .pQueueFamilyIndices = queueFamilyIndices.data(),
         };
         VmaAllocationCreateInfo allocationCreateInfo{
             .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
@@ -95,10 +212,10 @@ namespace skyline::gpu::memory {
         return std::make_shared<memory::StagingBuffer>(reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation);
     }
 
-    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size) {
+    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size, vk::BufferUsageFlags extraUsage) {
         vk::BufferCreateInfo bufferCreateInfo{
             .size = size,
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT,
+            .usage = GetBufferUsage() | extraUsage,
             .sharingMode = vk::SharingMode::eExclusive,
             .queueFamilyIndexCount = 1,
             .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
@@ -118,14 +235,40 @@ namespace skyline::gpu::memory {
     }
 
     Image MemoryManager::AllocateImage(const vk::ImageCreateInfo &createInfo) {
+        TRACE_EVENT("gpu", "MemoryManager::AllocateImage");
+
         VmaAllocationCreateInfo allocationCreateInfo{
             .usage = VMA_MEMORY_USAGE_GPU_ONLY,
         };
 
-        VkImage image;
+        // The image is created prior to allocating memory for it as the pool it's allocated from depends on its memory requirements
+        const auto &device{*gpu.vkDevice};
+        const auto &dispatcher{*gpu.vkDevice.getDispatcher()};
+        auto image{device.createImage(createInfo, nullptr, dispatcher)};
+
         VmaAllocation allocation;
-        VmaAllocationInfo allocationInfo;
-        ThrowOnFail(vmaCreateImage(vmaAllocator, &static_cast<const VkImageCreateInfo &>(createInfo), &allocationCreateInfo, &image, &allocation, &allocationInfo));
+        try {
+            auto requirements{device.getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(vk::ImageMemoryRequirementsInfo2{
+                .image = image,
+            }, dispatcher)};
+            const auto &memoryRequirements{requirements.get<vk::MemoryRequirements2>().memoryRequirements};
+
+            if (enableSmallImagePools && memoryRequirements.size <= SmallImageMaxSize && createInfo.tiling == vk::ImageTiling::eOptimal && !requirements.get<vk::MemoryDedicatedRequirements>().requiresDedicatedAllocation) {
+                allocationCreateInfo.pool = GetSmallImagePool(memoryRequirements.memoryTypeBits, allocationCreateInfo);
+                ThrowOnFail(vmaAllocateMemory(vmaAllocator, &static_cast<const VkMemoryRequirements &>(memoryRequirements), &allocationCreateInfo, &allocation, nullptr));
+            } else {
+                ThrowOnFail(vmaAllocateMemoryForImage(vmaAllocator, image, &allocationCreateInfo, &allocation, nullptr));
+            }
+        } catch (...) {
+            device.destroyImage(image, nullptr, dispatcher);
+            throw;
+        }
+
+        if (auto result{vmaBindImageMemory(vmaAllocator, allocation, image)}; result != VK_SUCCESS) [[unlikely]] {
+            vmaFreeMemory(vmaAllocator, allocation);
+            device.destroyImage(image, nullptr, dispatcher);
+            ThrowOnFail(result);
+        }
 
         return Image(vmaAllocator, image, allocation);
     }
@@ -153,11 +296,16 @@ namespace skyline::gpu::memory {
 
         auto buffer{gpu.vkDevice.createBuffer(vk::BufferCreateInfo{
             .size = cpuMapping.size(),
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT,
+            .usage = GetBufferUsage(),
             .sharingMode = vk::SharingMode::eExclusive
         })};
 
+        vk::MemoryAllocateFlagsInfo allocateFlagsInfo{
+            .flags = vk::MemoryAllocateFlagBits::eDeviceAddress,
+        };
+
         auto memory{gpu.vkDevice.allocateMemory(vk::MemoryAllocateInfo{
+            .pNext = gpu.traits.supportsBufferDeviceAddress ? &allocateFlagsInfo : nullptr,
             .allocationSize = cpuMapping.size(),
             .memoryTypeIndex = gpu.traits.hostVisibleCoherentCachedMemoryType,
         })};
@@ -113,6 +113,43 @@ namespace skyline::gpu::memory {
         u8 *data();
     };
 
+    /**
+     * @brief The categories of host GPU memory that the amount of resident memory is tracked for
+     */
+    enum class ResidencyCategory : u8 {
+        Texture,
+        Buffer,
+        MegaBuffer,
+    };
+
+    class MemoryManager;
+
+    /**
+     * @brief Accounts for the size of an allocation in the resident memory of its category for the lifetime of the object
+     */
+    class ResidentMemory {
+      private:
+        MemoryManager *manager{};
+        ResidencyCategory category{};
+
+      public:
+        vk::DeviceSize size{};
+
+        ResidentMemory() = default;
+
+        ResidentMemory(MemoryManager &manager, ResidencyCategory category, vk::DeviceSize size);
+
+        ResidentMemory(const ResidentMemory &) = delete;
+
+        ResidentMemory(ResidentMemory &&other);
+
+        ResidentMemory &operator=(const ResidentMemory &) = delete;
+
+        ResidentMemory &operator=(ResidentMemory &&other);
+
+        ~ResidentMemory();
+    };
+
     /**
      * @brief An abstraction over memory operations done in Vulkan, it's used for all allocations on the host GPU
      */
@@ -120,12 +157,79 @@ namespace skyline::gpu::memory {
       private:
         GPU &gpu;
         VmaAllocator vmaAllocator{VK_NULL_HANDLE};
+        std::array<std::atomic<i64>, 3> residentSizes{}; //!< The amount of resident memory in every ResidencyCategory
+        std::atomic<u32> submissionIndex{}; //!< A counter of all executor submissions, this is used as VMA's frame index and to order resources by their last use
+        std::atomic<i64> deviceMemoryCount{}; //!< The amount of VkDeviceMemory objects allocated by VMA, this is maintained by VMA's device memory callbacks
+
+        static constexpr vk::DeviceSize SmallImageMaxSize{256 * 1024}; //!< The maximum size of an image's memory requirements for it to be allocated from a small image pool
+        static constexpr vk::DeviceSize SmallImagePoolBlockSize{16 * 1024 * 1024}; //!< The size of the memory blocks that small image pools suballocate from
+        bool enableSmallImagePools; //!< If small images are allocated from the small image pools rather than alongside all other resources
+        std::mutex smallImagePoolMutex; //!< Synchronizes the creation of small image pools
+        std::array<VmaPool, VK_MAX_MEMORY_TYPES> smallImagePools{}; //!< Pools dedicated to small optimally tiled images for every memory type, these are created on first use
+
+        friend ResidentMemory;
+
+        /**
+         * @brief Adds the supplied delta to the resident memory of a category and updates its counter
+         */
+        void UpdateResidentSize(ResidencyCategory category, i64 delta);
+
+        /**
+         * @brief Adds the supplied delta to the amount of device memory objects and updates its counter, this is called by VMA whenever it allocates or frees a VkDeviceMemory
+         */
+        void UpdateDeviceMemoryCount(i64 delta);
+
+        /**
+         * @return The small image pool for the memory type VMA selects from the supplied memory type bits, it'll be created if it doesn't exist yet
+         */
+        VmaPool GetSmallImagePool(u32 memoryTypeBits, const VmaAllocationCreateInfo &allocationCreateInfo);
 
       public:
-        MemoryManager(GPU &gpu);
+        /**
+         * @brief The usage and budget of all device-local memory heaps
+         * @note Without VK_EXT_memory_budget, VMA estimates the usage from its own allocations and the budget from the heap sizes
+         */
+        struct Budget {
+            vk::DeviceSize usage;
+            vk::DeviceSize budget;
+        };
+
+        /**
+         * @param enableSmallImagePools If small images should be suballocated from dedicated pools, this is only disabled to compare against allocating them alongside all other resources
+         */
+        MemoryManager(GPU &gpu, bool enableSmallImagePools = true);
 
         ~MemoryManager();
 
+        /**
+         * @return An object accounting for the size of the supplied allocation in the resident memory of the category while it exists
+         */
+        ResidentMemory TrackResidency(ResidencyCategory category, VmaAllocation allocation);
+
+        Budget GetDeviceLocalBudget();
+
+        /**
+         * @brief Advances the submission index for an executor submission, this refreshes the memory budget when VK_EXT_memory_budget is supported
+         * @return The submission index of the new submission
+         */
+        u32 AdvanceSubmission();
+
+        /**
+         * @return The amount of VkDeviceMemory objects that are currently allocated
+         */
+        i64 GetDeviceMemoryCount() const {
+            return deviceMemoryCount.load(std::memory_order_relaxed);
+        }
+
+        u32 GetSubmissionIndex() const {
+            return submissionIndex.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @return The usage flags for any general-purpose buffers, this includes device address usage when supported
+         */
+        vk::BufferUsageFlags GetBufferUsage() const;
+
         /**
          * @brief Creates a buffer which is optimized for staging (Transfer Source)
          */
@@ -133,11 +237,13 @@ namespace skyline::gpu::memory {
 
         /**
          * @brief Creates a buffer with a CPU mapping and all usage flags
+         * @param extraUsage Any additional usage flags beyond the general-purpose ones (e.g. descriptor buffer usage)
          */
-        Buffer AllocateBuffer(vk::DeviceSize size);
+        Buffer AllocateBuffer(vk::DeviceSize size, vk::BufferUsageFlags extraUsage = {});
 
         /**
          * @brief Creates an image which is allocated and deallocated using RAII
+         * @note Small images are suballocated from pools that only contain other small images, this avoids them fragmenting the blocks of larger resources and being padded to the buffer-image granularity
          */
         Image AllocateImage(const vk::ImageCreateInfo &createInfo);
 
@@ -150,5 +256,11 @@ namespace skyline::gpu::memory {
          * @brief Maps the input CPU mapped region into a new buffer
          */
         ImportedBuffer ImportBuffer(span<u8> cpuMapping);
+
+        /**
+         * @return The GPU virtual address of the supplied buffer
+         * @note This requires 'TraitManager::supportsBufferDeviceAddress', all buffers allocated by this class will have the required usage flags
+         */
+        vk::DeviceAddress GetBufferDeviceAddress(vk::Buffer buffer) const;
     };
 }
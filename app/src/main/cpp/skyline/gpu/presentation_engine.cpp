@@ -24,6 +24,7 @@ namespace skyline::gpu {
     PresentationEngine::PresentationEngine(const DeviceState &state, GPU &gpu)
         : state{state},
           gpu{gpu},
+          headless{*state.settings->headlessPresentation},
           presentSemaphores{util::MakeFilledArray<vk::raii::Semaphore, MaxSwapchainImageCount>(gpu.vkDevice, vk::SemaphoreCreateInfo{})},
           acquireSemaphores{util::MakeFilledArray<vk::raii::Semaphore, MaxSwapchainImageCount>(gpu.vkDevice, vk::SemaphoreCreateInfo{})},
           presentationTrack{static_cast<u64>(trace::TrackIds::Presentation), perfetto::ProcessTrack::Current()},
@@ -36,12 +37,16 @@ namespace skyline::gpu {
     }
 
     PresentationEngine::~PresentationEngine() {
-        auto env{state.jvm->GetEnv()};
-        if (!env->IsSameObject(jSurface, nullptr))
-            env->DeleteGlobalRef(jSurface);
+        // A surface is never held while headless, the JVM isn't touched in that case so the engine can be used without one
+        if (jSurface)
+            state.jvm->GetEnv()->DeleteGlobalRef(jSurface);
 
         if (choreographerThread.joinable()) {
-            if (choreographerLooper) {
+            if (headless) {
+                std::scoped_lock lock{mutex};
+                choreographerStop = true;
+                headlessVsyncCondition.notify_all();
+            } else if (choreographerLooper) {
                 choreographerStop = true;
                 ALooper_wake(choreographerLooper);
             }
@@ -74,9 +79,13 @@ namespace skyline::gpu {
 
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
-            choreographerLooper = ALooper_prepare(0);
-            AChoreographer_postFrameCallback64(AChoreographer_getInstance(), reinterpret_cast<AChoreographer_frameCallback64>(&ChoreographerCallback), this);
-            while (ALooper_pollAll(-1, nullptr, nullptr, nullptr) == ALOOPER_POLL_WAKE && !choreographerStop); // Will block and process callbacks till ALooper_wake() is called with choreographerStop set
+            if (headless) {
+                HeadlessVsyncThread();
+            } else {
+                choreographerLooper = ALooper_prepare(0);
+                AChoreographer_postFrameCallback64(AChoreographer_getInstance(), reinterpret_cast<AChoreographer_frameCallback64>(&ChoreographerCallback), this);
+                while (ALooper_pollAll(-1, nullptr, nullptr, nullptr) == ALOOPER_POLL_WAKE && !choreographerStop); // Will block and process callbacks till ALooper_wake() is called with choreographerStop set
+            }
         } catch (const signal::SignalException &e) {
             Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
             if (state.process)
@@ -92,6 +101,30 @@ namespace skyline::gpu {
         }
     }
 
+    static i64 GetMonotonicNs() {
+        timespec time;
+        if (clock_gettime(CLOCK_MONOTONIC, &time))
+            throw exception("Failed to clock_gettime with '{}'", strerror(errno));
+        return (time.tv_sec * constant::NsInSecond) + time.tv_nsec;
+    }
+
+    void PresentationEngine::HeadlessVsyncThread() {
+        std::unique_lock lock{mutex};
+        auto nextVsync{std::chrono::steady_clock::now()};
+        while (true) {
+            nextVsync += std::chrono::nanoseconds{HeadlessRefreshCycleDuration};
+            if (headlessVsyncCondition.wait_until(lock, nextVsync, [this] { return choreographerStop; }))
+                return;
+
+            lastChoreographerTime = GetMonotonicNs();
+            if (!skipSignal.exchange(false)) {
+                lock.unlock();
+                vsyncEvent->Signal();
+                lock.lock();
+            }
+        }
+    }
+
     void PresentationEngine::PresentFrame(const PresentableFrame &frame) {
         std::unique_lock lock(mutex);
         surfaceCondition.wait(lock, [this]() { return vkSurface.has_value(); });
@@ -148,13 +181,6 @@ namespace skyline::gpu {
 
         frameFence = nextImageTexture->cycle;
 
-        auto getMonotonicNsNow{[]() -> i64 {
-            timespec time;
-            if (clock_gettime(CLOCK_MONOTONIC, &time))
-                throw exception("Failed to clock_gettime with '{}'", strerror(errno));
-            return (time.tv_sec * constant::NsInSecond) + time.tv_nsec;
-        }};
-
         i64 timestamp{frame.timestamp};
         if (timestamp) {
             // If the timestamp is specified, we need to convert it from the util::GetTimeNs base to the CLOCK_MONOTONIC one
@@ -162,7 +188,7 @@ namespace skyline::gpu {
             // Note: It's important we do this right before present as going past the timestamp could lead to fewer Binder IPC calls
             i64 current{util::GetTimeNs()};
             if (current < timestamp) {
-                timestamp = getMonotonicNsNow() + (timestamp - current);
+                timestamp = GetMonotonicNs() + (timestamp - current);
             } else {
                 timestamp = 0;
             }
@@ -202,7 +228,47 @@ namespace skyline::gpu {
             }); // We don't care about suboptimal images as they are caused by not respecting the transform hint, we handle transformations externally
         }
 
-        timestamp = (timestamp && !*state.settings->disableFrameThrottling) ? timestamp : getMonotonicNsNow(); // We tie FPS to the submission time rather than presentation timestamp, if we don't have the presentation timestamp available or if frame throttling is disabled as we want the maximum measured FPS to not be restricted to the refresh rate
+        timestamp = (timestamp && !*state.settings->disableFrameThrottling) ? timestamp : GetMonotonicNs(); // We tie FPS to the submission time rather than presentation timestamp, if we don't have the presentation timestamp available or if frame throttling is disabled as we want the maximum measured FPS to not be restricted to the refresh rate
+        UpdateFrameStatistics(timestamp);
+    }
+
+    void PresentationEngine::PresentFrameHeadless(const PresentableFrame &frame) {
+        frame.fence.Wait(state.soc->host1x);
+
+        {
+            std::scoped_lock textureLock(*frame.textureView);
+            auto texture{frame.textureView->texture};
+            texture->SynchronizeHost();
+
+            // There's no swapchain image to copy the frame into, the frame's own cycle is tracked in its place to bound the amount of frames in flight on the GPU
+            auto &frameFence{frameFences[frameIndex]};
+            if (frameFence)
+                frameFence->Wait();
+            frameFence = texture->cycle;
+            frameIndex = (frameIndex + 1) % HeadlessImageCount;
+        }
+
+        i64 now{GetMonotonicNs()}, timestamp{};
+        if (frame.timestamp) {
+            // The timestamp is converted from the util::GetTimeNs base to the CLOCK_MONOTONIC one as is done when presenting
+            i64 current{util::GetTimeNs()};
+            if (current < frame.timestamp)
+                timestamp = now + (frame.timestamp - current);
+        }
+
+        if (frame.swapInterval && headlessLastPresentTime)
+            timestamp = std::max(timestamp, headlessLastPresentTime + (HeadlessRefreshCycleDuration * frame.swapInterval));
+
+        if (timestamp > now && !*state.settings->disableFrameThrottling) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds{timestamp - now});
+            now = GetMonotonicNs();
+        }
+
+        headlessLastPresentTime = now;
+        UpdateFrameStatistics(now);
+    }
+
+    void PresentationEngine::UpdateFrameStatistics(i64 timestamp) {
         if (frameTimestamp) {
             i64 sampleWeight{Fps ? Fps : 1}; //!< The weight of each sample in calculating the average, we want to roughly average the past second
 
@@ -222,6 +288,15 @@ namespace skyline::gpu {
 
             TRACE_EVENT_INSTANT("gpu", "Present", presentationTrack, "FrameTimeNs", timestamp - frameTimestamp, "Fps", Fps);
 
+            constexpr u64 PercentileTraceInterval{60}; //!< The amount of frames between updates of the frametime percentile counters, computing them requires walking the entire histogram
+            if (frameTimeHistogram.Record(currentFrametime) % PercentileTraceInterval == 0) {
+                auto summary{frameTimeHistogram.GetSummary()};
+                TRACE_COUNTER("gpu", "Frametime P50 (ms)", summary.p50Ms);
+                TRACE_COUNTER("gpu", "Frametime P95 (ms)", summary.p95Ms);
+                TRACE_COUNTER("gpu", "Frametime P99 (ms)", summary.p99Ms);
+                TRACE_COUNTER("gpu", "1% Low FPS", summary.onePercentLowFps);
+            }
+
             frameTimestamp = timestamp;
         } else {
             frameTimestamp = timestamp;
@@ -236,7 +311,10 @@ namespace skyline::gpu {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
 
             presentQueue.Process([this](const PresentableFrame &frame) {
-                PresentFrame(frame);
+                if (headless)
+                    PresentFrameHeadless(frame);
+                else
+                    PresentFrame(frame);
                 frame.presentCallback(); // We're calling the callback here as it's outside of all the locks in PresentFrame
                 skipSignal = true;
                 vsyncEvent->Signal();
@@ -342,6 +420,9 @@ namespace skyline::gpu {
     }
 
     void PresentationEngine::UpdateSurface(jobject newSurface) {
+        if (headless)
+            return; // Any surface is ignored as frames are never presented
+
         std::scoped_lock guard{mutex};
 
         auto env{state.jvm->GetEnv()};
@@ -392,12 +473,16 @@ namespace skyline::gpu {
     }
 
     u64 PresentationEngine::Present(const std::shared_ptr<TextureView> &texture, i64 timestamp, i64 swapInterval, AndroidRect crop, NativeWindowScalingMode scalingMode, NativeWindowTransform transform, skyline::service::hosbinder::AndroidFence fence, const std::function<void()> &presentCallback) {
-        if (!vkSurface.has_value()) {
+        if (!headless && !vkSurface.has_value()) {
             // We want this function to generally (not necessarily always) block when a surface is not present to implicitly pause the game
             std::unique_lock lock{mutex};
             surfaceCondition.wait(lock, [this] { return vkSurface.has_value(); });
         }
 
+        gpu.megaBufferAllocator.MarkFrame();
+        if (state.soc->gpfifoCapture) [[unlikely]]
+            state.soc->gpfifoCapture->RecordFrame();
+
         presentQueue.Push(PresentableFrame{
             texture,
             fence,
@@ -414,6 +499,9 @@ namespace skyline::gpu {
     }
 
     NativeWindowTransform PresentationEngine::GetTransformHint() {
+        if (headless)
+            return NativeWindowTransform::Identity;
+
         if (!vkSurface.has_value()) {
             std::unique_lock lock{mutex};
             surfaceCondition.wait(lock, [this]() { return vkSurface.has_value(); });
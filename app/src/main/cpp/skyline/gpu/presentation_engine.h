@@ -10,6 +10,7 @@
 #include <kernel/types/KEvent.h>
 #include <services/hosbinder/GraphicBufferProducer.h>
 #include "texture/texture.h"
+#include "frame_time_histogram.h"
 
 struct ANativeWindow;
 
@@ -21,6 +22,7 @@ namespace skyline::gpu {
       private:
         const DeviceState &state;
         GPU &gpu;
+        bool headless; //!< If frames are consumed without a surface, the swapchain, Choreographer and JVM are never used in this case
 
         std::mutex mutex; //!< Synchronizes access to the surface objects
         std::condition_variable surfaceCondition; //!< Signalled when a valid Vulkan surface is available
@@ -49,8 +51,14 @@ namespace skyline::gpu {
         i64 frameTimestamp{}; //!< The timestamp of the last frame being shown in nanoseconds
         i64 averageFrametimeNs{}; //!< The average time between frames in nanoseconds
         i64 averageFrametimeDeviationNs{}; //!< The average deviation of frametimes in nanoseconds
+        FrameTimeHistogram frameTimeHistogram; //!< A histogram of all frametimes during the session
         perfetto::Track presentationTrack; //!< Perfetto track used for presentation events
 
+        static constexpr i64 HeadlessRefreshCycleDuration{constant::NsInSecond / 60}; //!< The duration of a single refresh cycle of the emulated display while headless
+        static constexpr size_t HeadlessImageCount{3}; //!< The amount of frames that can be in flight on the GPU while headless, this mirrors a triple buffered swapchain
+        std::condition_variable headlessVsyncCondition; //!< Signalled to stop the headless V-Sync thread, this is used with 'mutex'
+        i64 headlessLastPresentTime{}; //!< The CLOCK_MONOTONIC timestamp of the last frame consumed while headless
+
       public:
         std::atomic<bool> skipSignal; //!< If true, the next signal will be skipped by the choreographer thread
         std::shared_ptr<kernel::type::KEvent> vsyncEvent; //!< Signalled every time a frame is drawn
@@ -90,11 +98,26 @@ namespace skyline::gpu {
          */
         void ChoreographerThread();
 
+        /**
+         * @brief Signals the V-Sync event at a fixed refresh rate in place of the Choreographer while headless
+         */
+        void HeadlessVsyncThread();
+
         /**
          * @brief Submits a single frame to the host API for presentation with the appropriate waits and copies
          */
         void PresentFrame(const PresentableFrame& frame);
 
+        /**
+         * @brief Consumes a single frame without presenting it while pacing it according to its timestamp and swap interval
+         */
+        void PresentFrameHeadless(const PresentableFrame &frame);
+
+        /**
+         * @brief Updates the frametime averages, histogram and FPS with a frame being shown at the supplied timestamp
+         */
+        void UpdateFrameStatistics(i64 timestamp);
+
         /**
          * @brief The thread that handles presentation of frames submitted to it
          */
@@ -133,5 +156,12 @@ namespace skyline::gpu {
          * @return A transform that the application should render with to elide costly transforms later
          */
         service::hosbinder::NativeWindowTransform GetTransformHint();
+
+        /**
+         * @brief Writes the frametime histogram of the session to the supplied path
+         */
+        void WriteFrameTimeReport(const std::string &path) {
+            frameTimeHistogram.WriteReport(path);
+        }
     };
 }
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <common/trace.h>
+#include <gpu.h>
+#include "sparse_buffer_heap.h"
+
+namespace skyline::gpu {
+    constexpr auto HostMemoryHandleType{vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT};
+
+    SparseBufferHeap::Chunk::Chunk(SparseBufferHeap &heap, u8 *guestBlock, span<u8> host, vk::raii::DeviceMemory memory) : heap{heap}, guestBlock{guestBlock}, host{host}, memory{std::move(memory)} {}
+
+    SparseBufferHeap::Chunk::~Chunk() {
+        memory = nullptr; // The device memory must be freed prior to unmapping the host memory it was imported from
+        munmap(host.data(), host.size());
+
+        std::scoped_lock lock{heap.mutex};
+        // The guest block may have been committed again by another chunk after this one expired but before it was destroyed
+        if (auto it{heap.chunks.find(guestBlock)}; it != heap.chunks.end() && it->second.expired())
+            heap.chunks.erase(it);
+        heap.committedSize -= host.size();
+        TRACE_COUNTER("gpu", "Sparse Buffer Committed Memory", static_cast<i64>(heap.committedSize));
+    }
+
+    SparseBufferHeap::SparseBufferHeap(GPU &gpu) : gpu{gpu}, usage{gpu.memory.GetBufferUsage()}, bindFence{gpu.vkDevice, vk::FenceCreateInfo{}} {
+        auto externalProperties{gpu.vkPhysicalDevice.getExternalBufferProperties(vk::PhysicalDeviceExternalBufferInfo{
+            .flags = vk::BufferCreateFlagBits::eSparseBinding,
+            .usage = usage,
+            .handleType = HostMemoryHandleType,
+        })};
+        if (!(externalProperties.externalMemoryProperties.externalMemoryFeatures & vk::ExternalMemoryFeatureFlagBits::eImportable))
+            throw exception("Host memory can't be imported for sparse buffers");
+
+        // The alignment and memory types of sparse buffers don't depend on their size so a minimally sized buffer is used to query them
+        auto importAlignment{std::max<size_t>(gpu.traits.minImportedHostPointerAlignment, constant::PageSize)};
+        vk::StructureChain<vk::BufferCreateInfo, vk::ExternalMemoryBufferCreateInfo> createInfo{
+            vk::BufferCreateInfo{
+                .flags = vk::BufferCreateFlagBits::eSparseBinding,
+                .size = importAlignment,
+                .usage = usage,
+                .sharingMode = vk::SharingMode::eExclusive,
+            },
+            vk::ExternalMemoryBufferCreateInfo{
+                .handleTypes = HostMemoryHandleType,
+            }
+        };
+        auto requirements{gpu.vkDevice.createBuffer(createInfo.get<vk::BufferCreateInfo>()).getMemoryRequirements()};
+
+        memoryTypeBits = requirements.memoryTypeBits;
+        blockSize = std::max<size_t>(requirements.alignment, importAlignment);
+        if (!std::has_single_bit(blockSize))
+            throw exception("Sparse buffer block size isn't a power of two: 0x{:X}", blockSize);
+
+        Logger::Info("Using sparse buffers with a block size of 0x{:X} bytes", blockSize);
+    }
+
+    span<u8> SparseBufferHeap::MapHostBlock() {
+        // Twice the block size is reserved so the mapping can be aligned to the block size, this satisfies the host pointer import alignment which may exceed the page size
+        auto reservation{static_cast<u8 *>(mmap(nullptr, blockSize * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0))};
+        if (reservation == MAP_FAILED) [[unlikely]]
+            throw exception("Failed to reserve address space for a sparse buffer chunk: {}", strerror(errno));
+
+        auto block{util::AlignUp(reservation, blockSize)};
+        if (mmap(block, blockSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) [[unlikely]] {
+            munmap(reservation, blockSize * 2);
+            throw exception("Failed to map a sparse buffer chunk: {}", strerror(errno));
+        }
+
+        if (block != reservation)
+            munmap(reservation, static_cast<size_t>(block - reservation));
+        munmap(block + blockSize, static_cast<size_t>(reservation + blockSize * 2 - (block + blockSize)));
+
+        return span<u8>{block, blockSize};
+    }
+
+    std::shared_ptr<SparseBufferHeap::Chunk> SparseBufferHeap::AcquireChunk(u8 *guestBlock) {
+        auto &entry{chunks[guestBlock]};
+        if (auto chunk{entry.lock()})
+            return chunk;
+
+        auto host{MapHostBlock()};
+        try {
+            auto importableTypeBits{gpu.vkDevice.getMemoryHostPointerPropertiesEXT(HostMemoryHandleType, host.data()).memoryTypeBits & memoryTypeBits};
+            if (!importableTypeBits) [[unlikely]]
+                throw exception("No memory type supports binding imported host memory to sparse buffers");
+
+            vk::StructureChain<vk::MemoryAllocateInfo, vk::ImportMemoryHostPointerInfoEXT, vk::MemoryAllocateFlagsInfo> allocateInfo{
+                vk::MemoryAllocateInfo{
+                    .allocationSize = blockSize,
+                    .memoryTypeIndex = static_cast<u32>(std::countr_zero(importableTypeBits)),
+                },
+                vk::ImportMemoryHostPointerInfoEXT{
+                    .handleType = HostMemoryHandleType,
+                    .pHostPointer = host.data(),
+                },
+                vk::MemoryAllocateFlagsInfo{
+                    .flags = vk::MemoryAllocateFlagBits::eDeviceAddress,
+                }
+            };
+            if (!gpu.traits.supportsBufferDeviceAddress)
+                allocateInfo.unlink<vk::MemoryAllocateFlagsInfo>();
+
+            auto chunk{std::make_shared<Chunk>(*this, guestBlock, host, gpu.vkDevice.allocateMemory(allocateInfo.get<vk::MemoryAllocateInfo>()))};
+            entry = chunk;
+            committedSize += blockSize;
+            TRACE_COUNTER("gpu", "Sparse Buffer Committed Memory", static_cast<i64>(committedSize));
+            return chunk;
+        } catch (...) {
+            munmap(host.data(), host.size());
+            throw;
+        }
+    }
+
+    void SparseBufferHeap::Bind(vk::Buffer buffer, span<const std::shared_ptr<Chunk>> bufferChunks) {
+        TRACE_EVENT("gpu", "SparseBufferHeap::Bind", "chunks", bufferChunks.size());
+
+        std::vector<vk::SparseMemoryBind> binds;
+        binds.reserve(bufferChunks.size());
+        for (size_t index{}; index < bufferChunks.size(); index++)
+            binds.push_back(vk::SparseMemoryBind{
+                .resourceOffset = index * blockSize,
+                .size = blockSize,
+                .memory = *bufferChunks[index]->memory,
+            });
+
+        vk::SparseBufferMemoryBindInfo bufferBind{
+            .buffer = buffer,
+            .bindCount = static_cast<u32>(binds.size()),
+            .pBinds = binds.data(),
+        };
+
+        std::scoped_lock lock{bindMutex};
+        {
+            std::scoped_lock queueLock{gpu.queueMutex};
+            gpu.vkQueue.bindSparse(vk::BindSparseInfo{
+                .bufferBindCount = 1,
+                .pBufferBinds = &bufferBind,
+            }, *bindFence);
+        }
+
+        // The bind must be complete before the buffer is used in any submission, these are rare enough that waiting here is preferable to tracking them
+        vk::Fence fence{*bindFence};
+        vk::Result waitResult;
+        while ((waitResult = (*gpu.vkDevice).waitForFences(1, &fence, true, std::numeric_limits<u64>::max(), *gpu.vkDevice.getDispatcher())) != vk::Result::eSuccess) {
+            if (waitResult == vk::Result::eTimeout || waitResult == vk::Result::eErrorInitializationFailed)
+                continue; // See FenceCycle::Wait for why eErrorInitializationFailed is retried
+
+            throw exception("An error occurred while waiting for a sparse bind: {}", vk::to_string(waitResult));
+        }
+        gpu.vkDevice.resetFences(fence);
+    }
+
+    SparseBufferHeap::Backing::Backing(SparseBufferHeap &heap, span<u8> guest) : vkBuffer{nullptr} {
+        auto blockStart{util::AlignDown(guest.data(), heap.blockSize)}, blockEnd{util::AlignUp(guest.end().base(), heap.blockSize)};
+        auto size{static_cast<size_t>(blockEnd - blockStart)};
+        offset = static_cast<vk::DeviceSize>(guest.data() - blockStart);
+
+        chunks.reserve(size / heap.blockSize);
+        {
+            std::scoped_lock lock{heap.mutex};
+            for (auto block{blockStart}; block != blockEnd; block += heap.blockSize)
+                chunks.emplace_back(heap.AcquireChunk(block));
+        }
+
+        vk::StructureChain<vk::BufferCreateInfo, vk::ExternalMemoryBufferCreateInfo> createInfo{
+            vk::BufferCreateInfo{
+                .flags = vk::BufferCreateFlagBits::eSparseBinding,
+                .size = size,
+                .usage = heap.usage,
+                .sharingMode = vk::SharingMode::eExclusive,
+            },
+            vk::ExternalMemoryBufferCreateInfo{
+                .handleTypes = HostMemoryHandleType,
+            }
+        };
+        vkBuffer = heap.gpu.vkDevice.createBuffer(createInfo.get<vk::BufferCreateInfo>());
+        heap.Bind(*vkBuffer, chunks);
+
+        // Aliases of every chunk are mapped into a contiguous region so the CPU sees the same layout as the GPU does through the sparse buffer
+        auto viewBase{static_cast<u8 *>(mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0))};
+        if (viewBase == MAP_FAILED) [[unlikely]]
+            throw exception("Failed to reserve address space for a sparse buffer: {}", strerror(errno));
+
+        for (size_t index{}; index < chunks.size(); index++) {
+            auto &host{chunks[index]->host};
+            if (mremap(host.data(), 0, host.size(), MREMAP_FIXED | MREMAP_MAYMOVE, viewBase + index * heap.blockSize) == MAP_FAILED) [[unlikely]] {
+                munmap(viewBase, size);
+                throw exception("Failed to map a sparse buffer chunk at 0x{:X}: {}", chunks[index]->guestBlock, strerror(errno));
+            }
+        }
+
+        view = span<u8>{viewBase, size};
+    }
+
+    SparseBufferHeap::Backing::~Backing() {
+        if (view.valid())
+            munmap(view.data(), view.size());
+    }
+}
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+#include <common.h>
+
+namespace skyline::gpu {
+    class GPU;
+
+    /**
+     * @brief A heap of host memory blocks that are imported into Vulkan (with VK_EXT_external_memory_host) and bound to sparse buffers, every block backs a fixed block of guest address space
+     * @note As the memory backing a guest address is the same for every sparse buffer covering it, overlapping buffers can be coalesced by binding the same blocks to a new buffer rather than copying their contents
+     * @note Blocks are committed on first use when a buffer covering their guest block is created and are released when no buffer covers them anymore
+     */
+    class SparseBufferHeap {
+      private:
+        /**
+         * @brief A block of host memory backing a single block of guest address space
+         */
+        struct Chunk {
+            SparseBufferHeap &heap;
+            u8 *guestBlock; //!< The start of the guest block this chunk backs
+            span<u8> host; //!< The shared anonymous mapping that the device memory was imported from, sparse buffers map aliases of it for CPU access
+            vk::raii::DeviceMemory memory;
+
+            Chunk(SparseBufferHeap &heap, u8 *guestBlock, span<u8> host, vk::raii::DeviceMemory memory);
+
+            Chunk(const Chunk &) = delete;
+
+            Chunk &operator=(const Chunk &) = delete;
+
+            ~Chunk();
+        };
+
+        GPU &gpu;
+        vk::BufferUsageFlags usage; //!< The usage flags of all sparse buffers, these match those of regular buffers
+        u32 memoryTypeBits; //!< The memory types that can be bound to sparse buffers
+        std::mutex mutex; //!< Synchronizes access to the chunk map and the committed size
+        std::unordered_map<u8 *, std::weak_ptr<Chunk>> chunks; //!< A map from the start of a guest block to the chunk backing it
+        size_t committedSize{}; //!< The total size of all committed chunks
+        std::mutex bindMutex; //!< Synchronizes usage of the bind fence
+        vk::raii::Fence bindFence; //!< A fence used to wait on sparse bind operations to complete
+
+        /**
+         * @return A new block-sized shared anonymous mapping which is aligned to the block size
+         */
+        span<u8> MapHostBlock();
+
+        /**
+         * @return The chunk backing the supplied guest block, it'll be committed if no chunk currently backs it
+         * @note The mutex must be locked when calling this
+         */
+        std::shared_ptr<Chunk> AcquireChunk(u8 *guestBlock);
+
+        /**
+         * @brief Binds the supplied chunks to consecutive blocks of a sparse buffer and waits for the bind to complete
+         */
+        void Bind(vk::Buffer buffer, span<const std::shared_ptr<Chunk>> bufferChunks);
+
+      public:
+        size_t blockSize; //!< The granularity at which guest memory is backed by chunks, this is a multiple of the sparse buffer alignment and the host pointer import alignment
+
+        /**
+         * @brief A sparse buffer covering a range of guest memory with a contiguous CPU mapping of all the chunks bound to it
+         * @note The buffer covers entire guest blocks, the supplied guest range starts at `offset` into it
+         */
+        class Backing {
+          private:
+            std::vector<std::shared_ptr<Chunk>> chunks;
+            span<u8> view; //!< A contiguous CPU mapping of all chunks in the same layout as the sparse buffer
+
+          public:
+            vk::raii::Buffer vkBuffer;
+            vk::DeviceSize offset; //!< The offset of the guest range into the sparse buffer and its CPU mapping
+
+            /**
+             * @note The guest range must be page-aligned
+             */
+            Backing(SparseBufferHeap &heap, span<u8> guest);
+
+            Backing(const Backing &) = delete;
+
+            Backing &operator=(const Backing &) = delete;
+
+            ~Backing();
+
+            /**
+             * @return A CPU mapping of the buffer's contents starting from the supplied guest range
+             */
+            u8 *data() const {
+                return view.data() + offset;
+            }
+        };
+
+        /**
+         * @note This throws if the device is unable to bind imported host memory to sparse buffers
+         */
+        SparseBufferHeap(GPU &gpu);
+    };
+}
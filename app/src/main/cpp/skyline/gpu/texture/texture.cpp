@@ -424,14 +424,13 @@ namespace skyline::gpu {
         commandBuffer.copyBufferToImage(stagingBuffer->vkBuffer, image, layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
     }
 
-    void Texture::CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
-        auto image{GetBacking()};
+    void Texture::CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, vk::Image image, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer, vk::ImageLayout pLayout) {
         commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eBottomOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
             .image = image,
             .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
             .dstAccessMask = vk::AccessFlagBits::eTransferRead,
-            .oldLayout = layout,
-            .newLayout = layout,
+            .oldLayout = pLayout,
+            .newLayout = pLayout,
             .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
             .subresourceRange = {
@@ -442,7 +441,7 @@ namespace skyline::gpu {
         });
 
         auto bufferImageCopies{GetBufferImageCopies()};
-        commandBuffer.copyImageToBuffer(image, layout, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        commandBuffer.copyImageToBuffer(image, pLayout, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
 
         commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, {}, vk::BufferMemoryBarrier{
             .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
@@ -610,6 +609,8 @@ namespace skyline::gpu {
         else if (imageType == vk::ImageType::e3D)
             flags |= vk::ImageCreateFlagBits::e2DArrayCompatible;
 
+        // Guest textures are uploaded on the transfer queue when it's in use, they need to be shared with it to avoid queue family ownership transfers
+        auto queueFamilyIndices{gpu.GetTransferQueueFamilyIndices()};
         vk::ImageCreateInfo imageCreateInfo{
             .flags = flags,
             .imageType = imageType,
@@ -620,12 +621,14 @@ namespace skyline::gpu {
             .samples = vk::SampleCountFlagBits::e1,
             .tiling = tiling,
             .usage = usage,
-            .sharingMode = vk::SharingMode::eExclusive,
-            .queueFamilyIndexCount = 1,
-            .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
+            .sharingMode = queueFamilyIndices.size() > 1 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+            .queueFamilyIndexCount = static_cast<u32>(queueFamilyIndices.size()),
+            .pQueueFamilyIndices = queueFamilyIndices.data(),
             .initialLayout = layout,
         };
         backing = tiling != vk::ImageTiling::eLinear ? gpu.memory.AllocateImage(imageCreateInfo) : gpu.memory.AllocateMappedImage(imageCreateInfo);
+        residentMemory = gpu.memory.TrackResidency(memory::ResidencyCategory::Texture, std::get<memory::Image>(backing).vmaAllocation);
+        lastUseSubmission.store(gpu.memory.GetSubmissionIndex(), std::memory_order_relaxed);
 
         SetupGuestMappings();
     }
@@ -693,6 +696,7 @@ namespace skyline::gpu {
 
         backing = std::move(pBacking);
         layout = pLayout;
+        readbackPrefetched = false;
         if (GetBacking())
             backingCondition.notify_all();
     }
@@ -762,12 +766,18 @@ namespace skyline::gpu {
         if (stagingBuffer) {
             if (cycle)
                 cycle->WaitSubmit();
-            auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
+
+            auto copyFunction{[&](vk::raii::CommandBuffer &commandBuffer) {
                 CopyFromStagingBuffer(commandBuffer, stagingBuffer);
-            })};
+            }};
+
+            // Queues without graphics or compute support can't copy to depth/stencil aspects and require buffer offsets to be aligned to 4 bytes
+            bool transferQueueCompatible{format->vkAspect == vk::ImageAspectFlagBits::eColor && ranges::all_of(GetBufferImageCopies(), [](const vk::BufferImageCopy &copy) { return copy.bufferOffset % 4 == 0; })};
+            auto lCycle{transferQueueCompatible ? gpu.scheduler.SubmitTransfer(copyFunction, cycle) : gpu.scheduler.Submit(copyFunction)};
             lCycle->AttachObjects(stagingBuffer, shared_from_this());
             lCycle->ChainCycle(cycle);
             cycle = lCycle;
+            readbackPrefetched = false;
         }
 
         {
@@ -808,6 +818,7 @@ namespace skyline::gpu {
             pCycle->AttachObjects(stagingBuffer, shared_from_this());
             pCycle->ChainCycle(cycle);
             cycle = pCycle;
+            readbackPrefetched = false;
         }
 
         {
@@ -839,6 +850,8 @@ namespace skyline::gpu {
             memoryFreed = false;
         }
 
+        readbackPrediction = std::min<u8>(readbackPrediction + 1, ReadbackPredictionMax);
+
         if (layout == vk::ImageLayout::eUndefined || format != guest->format)
             // If the state of the host texture is undefined then so can the guest
             // If the texture has differing formats on the guest and host, we don't support converting back in that case as it may involve recompression of a decompressed texture
@@ -846,13 +859,18 @@ namespace skyline::gpu {
 
         WaitOnBacking();
 
-        if (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) {
+        if (std::exchange(readbackPrefetched, false)) {
+            // The contents were already copied into the staging buffer at the end of the submission that wrote them, only the fence needs to be waited on which the trap lock callback usually has done already
+            TRACE_EVENT("gpu", "Texture::SynchronizeGuest::Prefetched");
+            WaitOnFence();
+            CopyToGuest(downloadStagingBuffer->data());
+        } else if (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) {
             if (!downloadStagingBuffer)
                 downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
 
             WaitOnFence();
             auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
-                CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer);
+                CopyIntoStagingBuffer(commandBuffer, GetBacking(), downloadStagingBuffer, layout);
             })};
             lCycle->Wait(); // We block till the copy is complete
 
@@ -872,6 +890,41 @@ namespace skyline::gpu {
                 gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this texture
     }
 
+    std::shared_ptr<memory::StagingBuffer> Texture::PrepareReadbackPrefetch(const std::shared_ptr<FenceCycle> &pCycle) {
+        if (lastRenderPassUsage != texture::RenderPassUsage::RenderTarget)
+            return nullptr; // Textures that weren't written to in this execution keep their prior contents, any prior prefetch remains valid and isn't a miss
+
+        if (std::exchange(readbackPrefetched, false)) {
+            // The prior prefetch was never consumed as the texture has been written to again without the guest reading it
+            readbackPrediction--;
+            TRACE_EVENT_INSTANT("gpu", "Texture Readback Prefetch Miss");
+        }
+
+        if (readbackPrediction < ReadbackPrefetchThreshold || !guest || layout == vk::ImageLayout::eUndefined || format != guest->format)
+            return nullptr;
+
+        if (tiling != vk::ImageTiling::eOptimal && std::holds_alternative<memory::Image>(backing))
+            return nullptr; // Linear textures that are mapped on the CPU are read back directly from their backing
+
+        {
+            std::scoped_lock lock{stateMutex};
+            if (dirtyState != DirtyState::GpuDirty)
+                return nullptr;
+        }
+
+        if (!downloadStagingBuffer)
+            downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
+
+        pCycle->AttachObject(downloadStagingBuffer);
+        readbackPrefetched = true;
+        return downloadStagingBuffer;
+    }
+
+    void Texture::RecordReadbackPrefetch(const vk::raii::CommandBuffer &commandBuffer, vk::Image image, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer, vk::ImageLayout pLayout) {
+        TRACE_EVENT("gpu", "Texture::RecordReadbackPrefetch");
+        CopyIntoStagingBuffer(commandBuffer, image, stagingBuffer, pLayout);
+    }
+
     std::shared_ptr<TextureView> Texture::GetView(vk::ImageViewType type, vk::ImageSubresourceRange range, texture::Format pFormat, vk::ComponentMapping mapping) {
         if (!pFormat || pFormat == guest->format)
             pFormat = format; // We want to use the texture's format if it isn't supplied or if the requested format matches the guest format then we want to use the host format just in case it is host incompatible and the host format differs from the guest format
@@ -1019,6 +1072,7 @@ namespace skyline::gpu {
         }()};
         newCycle->AttachObjects(std::move(source), shared_from_this());
         cycle = newCycle;
+        readbackPrefetched = false;
     }
 
     bool Texture::ValidateRenderPassUsage(u32 renderPassIndex, texture::RenderPassUsage renderPassUsage) {
@@ -381,6 +381,7 @@ namespace skyline::gpu {
         std::condition_variable_any backingCondition; //!< Signalled when a valid backing has been swapped in
         using BackingType = std::variant<vk::Image, vk::raii::Image, memory::Image>;
         BackingType backing; //!< The Vulkan image that backs this texture, it is nullable
+        memory::ResidentMemory residentMemory; //!< The resident memory of the backing when it's owned by the texture
 
         span<u8> mirror{}; //!< A contiguous mirror of all the guest mappings to allow linear access on the CPU
         span<u8> alignedMirror{}; //!< The mirror mapping aligned to page size to reflect the full mapping
@@ -437,9 +438,11 @@ namespace skyline::gpu {
 
         /**
          * @brief Records commands for copying data from the texture's backing to a staging buffer into the supplied command buffer
+         * @param image The backing of the texture, this is supplied by the caller as it may be swapped by the time the commands are recorded
+         * @param pLayout The layout the texture will be in when the commands are executed
          * @note Any caller **must** ensure that the layout is not `eUndefined`
          */
-        void CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer);
+        void CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, vk::Image image, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer, vk::ImageLayout pLayout);
 
         /**
          * @brief Copies data from the supplied host buffer into the guest texture
@@ -466,8 +469,14 @@ namespace skyline::gpu {
         size_t accumulatedGuestWaitCounter{}; //!< Total number of times the texture has been waited on
         std::chrono::nanoseconds accumulatedGuestWaitTime{}; //!< Amount of time the texture has been waited on for since the `SkipReadbackHackWaitCountThreshold`th wait on it by the guest
 
+        static constexpr u8 ReadbackPrefetchThreshold{2}; //!< The value of the readback prediction counter at which readbacks of the texture are prefetched at the end of submissions writing to it
+        static constexpr u8 ReadbackPredictionMax{3}; //!< The value at which the readback prediction counter saturates, this bounds the amount of unused prefetches before they stop
+        u8 readbackPrediction{}; //!< A saturating counter that is incremented when the guest reads the texture back after the GPU has written to it and decremented when a prefetched readback goes unused
+        bool readbackPrefetched{}; //!< If the download staging buffer will contain the contents of the texture once its current cycle is signalled, any other host mutation of the texture invalidates this
+
       public:
         std::shared_ptr<FenceCycle> cycle; //!< A fence cycle for when any host operation mutating the texture has completed, it must be waited on prior to any mutations to the backing
+        std::atomic<u32> lastUseSubmission{}; //!< The submission index (MemoryManager::GetSubmissionIndex) of the last executor submission the texture was used in, the least recently used textures are evicted first, this is read during eviction without the texture being locked so it's only accessed with relaxed ordering
         std::optional<GuestTexture> guest;
         texture::Dimensions dimensions;
         texture::Format format;
@@ -591,6 +600,24 @@ namespace skyline::gpu {
          */
         void SynchronizeGuest(bool cpuDirty = false, bool skipTrap = false);
 
+        /**
+         * @brief Prepares for prefetching the readback of the texture at the end of the supplied cycle's submission if the guest is predicted to read it after the GPU writes to it, this allows the readback to be serviced from the download staging buffer without another submission
+         * @return The staging buffer to prefetch into, if this is non-null RecordReadbackPrefetch() must be called with it after all other commands using the texture have been recorded into the supplied cycle's submission
+         * @note The texture's cycle must have been set to the supplied cycle prior to calling this
+         * @note This must be called prior to the render pass usage of the texture being reset at the end of the execution, only textures used as render targets in the execution are written to by it
+         * @note The texture **must** be locked prior to calling this
+         */
+        std::shared_ptr<memory::StagingBuffer> PrepareReadbackPrefetch(const std::shared_ptr<FenceCycle> &pCycle);
+
+        /**
+         * @brief Records commands for copying the texture's contents into the download staging buffer for a readback prefetch
+         * @param image The backing of the texture at the time PrepareReadbackPrefetch() was called
+         * @param stagingBuffer The staging buffer returned by PrepareReadbackPrefetch()
+         * @param pLayout The layout of the texture at the end of the submission
+         * @note This doesn't require the texture to be locked as all mutable state is supplied by the caller, it must be read while the texture was locked for PrepareReadbackPrefetch()
+         */
+        void RecordReadbackPrefetch(const vk::raii::CommandBuffer &commandBuffer, vk::Image image, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer, vk::ImageLayout pLayout);
+
         /**
          * @return A cached or newly created view into this texture with the supplied attributes
          */
@@ -1,16 +1,165 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <unordered_set>
 #include <common/trace.h>
+#include <gpu.h>
 #include "texture_manager.h"
 
 namespace skyline::gpu {
     TextureManager::TextureManager(GPU &gpu) : gpu(gpu) {}
 
-    std::shared_ptr<TextureView> TextureManager::FindOrCreate(const GuestTexture &guestTexture, ContextTag tag) {
-        TRACE_EVENT("gpu", "TextureManager::FindOrCreate");
+    template<typename Function>
+    void TextureManager::ForEachOverlap(span<u8> range, Function function) {
+        size_t rangeStart{reinterpret_cast<size_t>(range.data())}, rangeEnd{rangeStart + std::max<size_t>(range.size(), 1)};
+        size_t firstBucket{rangeStart >> BucketBits}, lastBucket{(rangeEnd - 1) >> BucketBits};
+        for (size_t bucket{firstBucket}; bucket <= lastBucket; bucket++) {
+            auto bucketIt{mappingBuckets.find(bucket)};
+            if (bucketIt == mappingBuckets.end())
+                continue;
+
+            for (auto mapping : bucketIt->second) {
+                // Mappings spanning multiple buckets are only reported in the first bucket of the range that they're present in
+                if (std::max(reinterpret_cast<size_t>(mapping->data()) >> BucketBits, firstBucket) != bucket)
+                    continue;
+
+                if (mapping->data() < range.data() + range.size() && range.data() < mapping->data() + mapping->size())
+                    function(*mapping);
+            }
+        }
+    }
+
+    void TextureManager::InsertTexture(const std::shared_ptr<Texture> &texture) {
+        bool overlapping{};
+        for (auto it{texture->guest->mappings.begin()}; it != texture->guest->mappings.end(); it++) {
+            ForEachOverlap(*it, [&](TextureMapping &overlap) {
+                if (overlap.texture == texture)
+                    return;
+
+                // The overlapped texture can no longer be looked up through the fast path as it may not be the only candidate
+                overlapping = true;
+                for (const auto &mapping : overlap.texture->guest->mappings)
+                    textureTable.Set(mapping.begin().base(), mapping.end().base(), nullptr);
+            });
+
+            auto &mapping{textures.emplace_back(texture, it, *it)};
+            size_t mappingStart{reinterpret_cast<size_t>(mapping.data())}, mappingEnd{mappingStart + std::max<size_t>(mapping.size(), 1)};
+            for (size_t bucket{mappingStart >> BucketBits}; bucket <= ((mappingEnd - 1) >> BucketBits); bucket++)
+                mappingBuckets[bucket].push_back(&mapping);
+        }
+
+        for (const auto &mapping : texture->guest->mappings)
+            textureTable.Set(mapping.begin().base(), mapping.end().base(), overlapping ? nullptr : texture.get());
+    }
+
+    void TextureManager::EvictTextures() {
+        auto submissionIndex{gpu.memory.GetSubmissionIndex()};
+        if (submissionIndex == lastEvictionSubmission)
+            return;
+        lastEvictionSubmission = submissionIndex;
+
+        auto budget{gpu.memory.GetDeviceLocalBudget()};
+        if (static_cast<double>(budget.usage) <= static_cast<double>(budget.budget) * EvictionThreshold)
+            return;
+
+        TRACE_EVENT("gpu", "TextureManager::EvictTextures");
+
+        // The submission index of the last use is captured alongside every candidate as it may be concurrently updated by the executor, sorting on the live value could be inconsistent
+        std::vector<std::pair<u32, Texture *>> candidates;
+        for (const auto &mapping : textures) {
+            auto &texture{mapping.texture};
+            if (mapping.iterator != texture->guest->mappings.begin())
+                continue; // Textures are only considered through their first mapping to visit them once
+
+            auto lastUseSubmission{texture->lastUseSubmission.load(std::memory_order_relaxed)};
+            if (submissionIndex - lastUseSubmission < EvictionMinimumAge)
+                continue;
+
+            // Any references beyond the texture manager's own mappings are from views, cycles or other users that still require the texture
+            if (static_cast<size_t>(texture.use_count()) == texture->guest->mappings.size())
+                candidates.emplace_back(lastUseSubmission, texture.get());
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        // Evicted textures are kept alive till the end of the function so they're destroyed after their state locks are released, the locks must be held till the texture is removed to prevent it becoming GPU dirty in the meantime
+        std::vector<std::shared_ptr<Texture>> evictedTextures;
+        std::vector<std::unique_lock<std::recursive_mutex>> stateLocks;
+
+        auto excessSize{static_cast<i64>(budget.usage) - static_cast<i64>(static_cast<double>(budget.budget) * EvictionTarget)};
+        std::unordered_set<Texture *> evicted;
+        for (auto [lastUseSubmission, texture] : candidates) {
+            if (excessSize <= 0)
+                break;
+
+            std::unique_lock stateLock{texture->stateMutex, std::try_to_lock};
+            if (!stateLock || texture->dirtyState == Texture::DirtyState::GpuDirty)
+                continue; // The contents of GPU dirty textures only exist on the host and would be lost by evicting them
 
+            excessSize -= static_cast<i64>(texture->residentMemory.size);
+            evicted.emplace(texture);
+            stateLocks.push_back(std::move(stateLock));
+        }
+
+        if (evicted.empty())
+            return;
+
+        // The textures are only destroyed once the state locks have been released on return, this'll remove any traps on their guest mappings
+        evictedTextures.reserve(evicted.size());
+        for (auto it{textures.begin()}; it != textures.end();) {
+            if (!evicted.contains(it->texture.get())) {
+                ++it;
+                continue;
+            }
+
+            if (it->iterator == it->texture->guest->mappings.begin())
+                evictedTextures.push_back(it->texture);
+
+            size_t mappingStart{reinterpret_cast<size_t>(it->data())}, mappingEnd{mappingStart + std::max<size_t>(it->size(), 1)};
+            for (size_t bucket{mappingStart >> BucketBits}; bucket <= ((mappingEnd - 1) >> BucketBits); bucket++) {
+                auto &bucketMappings{mappingBuckets[bucket]};
+                bucketMappings.erase(std::find(bucketMappings.begin(), bucketMappings.end(), &*it));
+            }
+            textureTable.Set(it->begin().base(), it->end().base(), nullptr);
+
+            it = textures.erase(it);
+        }
+
+        TRACE_EVENT_INSTANT("gpu", "Evicted Textures", "count", evicted.size());
+        Logger::Debug("Evicted {} textures with device memory usage at 0x{:X} of a 0x{:X} budget", evicted.size(), budget.usage, budget.budget);
+    }
+
+    bool TextureManager::IsFullMatchCompatible(const GuestTexture &matchGuestTexture, const GuestTexture &guestTexture) {
+        return matchGuestTexture.format->IsCompatible(*guestTexture.format) &&
+            ((((matchGuestTexture.dimensions.width == guestTexture.dimensions.width &&
+                matchGuestTexture.dimensions.height == guestTexture.dimensions.height) || matchGuestTexture.CalculateLayerSize() == guestTexture.CalculateLayerSize()) &&
+                matchGuestTexture.GetViewDepth() <= guestTexture.GetViewDepth())
+                || matchGuestTexture.viewMipBase > 0)
+            && matchGuestTexture.tileConfig == guestTexture.tileConfig;
+    }
+
+    std::shared_ptr<TextureView> TextureManager::FindOrCreate(const GuestTexture &guestTexture, ContextTag tag) {
         auto guestMapping{guestTexture.mappings.front()};
+        TRACE_EVENT("gpu", "TextureManager::FindOrCreate", "address", reinterpret_cast<u64>(guestMapping.data()), "size", guestMapping.size()); // The arguments allow lookups to be replayed by the TextureLookup benchmark
+
+        // Try to do a fast lookup in the page table, this only contains textures which don't overlap any other texture so a matching texture must be the only candidate
+        if (auto lookupTexture{textureTable[guestMapping.begin().base()]}; lookupTexture && !lookupTexture->replaced) {
+            const auto &lookupMappings{lookupTexture->guest->mappings};
+            if (std::equal(lookupMappings.begin(), lookupMappings.end(), guestTexture.mappings.begin(), guestTexture.mappings.end(), [](const span<u8> &lhs, const span<u8> &rhs) {
+                return lhs.data() == rhs.data() && lhs.size() == rhs.size();
+            }) && IsFullMatchCompatible(*lookupTexture->guest, guestTexture)) {
+                ContextLock textureLock{tag, *lookupTexture};
+                return lookupTexture->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
+                    .aspectMask = guestTexture.aspect,
+                    .baseMipLevel = guestTexture.viewMipBase,
+                    .levelCount = guestTexture.viewMipCount,
+                    .baseArrayLayer = guestTexture.baseArrayLayer,
+                    .layerCount = guestTexture.GetViewLayerCount(),
+                }, guestTexture.format, guestTexture.swizzle);
+            }
+        }
 
         /*
          * Iterate over all textures that overlap with the first mapping of the guest texture and compare the mappings:
@@ -28,20 +177,29 @@ namespace skyline::gpu {
 
         std::shared_ptr<Texture> match{};
         boost::container::small_vector<std::shared_ptr<Texture>, 4> matches{};
-        auto mappingEnd{std::upper_bound(textures.begin(), textures.end(), guestMapping, [guestMapping](const auto &value, const auto &element) {
-            return guestMapping.end() < element.end();
-        })}, hostMapping{std::lower_bound(mappingEnd, textures.end(), guestMapping, [guestMapping](const auto &value, const auto &element) {
-            return guestMapping.begin() < element.end();
-        })};
+
+        // Only mappings containing the first guest mapping are candidates, these must all be in the bucket containing its start
+        boost::container::small_vector<TextureMapping *, 8> candidates;
+        if (auto bucketIt{mappingBuckets.find(reinterpret_cast<size_t>(guestMapping.data()) >> BucketBits)}; bucketIt != mappingBuckets.end())
+            for (auto mapping : bucketIt->second)
+                if (mapping->contains(guestMapping))
+                    candidates.push_back(mapping);
+
+        // Candidates are visited from the highest to the lowest end address with later insertions first for equal ends, this is the order of the end-sorted mapping list that preceded the buckets
+        // Buckets hold mappings in their insertion order so a stable sort retains it for equal ends
+        std::stable_sort(candidates.begin(), candidates.end(), [](TextureMapping *lhs, TextureMapping *rhs) {
+            return lhs->end() < rhs->end();
+        });
 
         std::shared_ptr<Texture> fullMatch{};
         std::shared_ptr<Texture> layerMipMatch{};
         u32 matchLevel{};
         u32 matchLayer{};
 
-        while (hostMapping != textures.begin() && (--hostMapping)->end() > guestMapping.begin()) {
+        for (auto candidateIt{candidates.rbegin()}; candidateIt != candidates.rend(); candidateIt++) {
+            auto hostMapping{*candidateIt};
             auto &hostMappings{hostMapping->texture->guest->mappings};
-            if (!hostMapping->contains(guestMapping) || hostMapping->texture->replaced)
+            if (hostMapping->texture->replaced)
                 continue;
 
             // We need to check that all corresponding mappings in the candidate texture and the guest texture match up
@@ -57,13 +215,7 @@ namespace skyline::gpu {
 
             if (firstHostMapping == hostMappings.begin() && firstHostMapping->begin() == guestMapping.begin() && mappingMatch && lastHostMapping == hostMappings.end() && lastGuestMapping.end() == std::prev(lastHostMapping)->end()) {
                 // We've gotten a perfect 1:1 match for *all* mappings from the start to end, we just need to check for compatibility aside from this
-                auto &matchGuestTexture{*hostMapping->texture->guest};
-                if (matchGuestTexture.format->IsCompatible(*guestTexture.format) &&
-                    ((((matchGuestTexture.dimensions.width == guestTexture.dimensions.width &&
-                        matchGuestTexture.dimensions.height == guestTexture.dimensions.height) || matchGuestTexture.CalculateLayerSize() == guestTexture.CalculateLayerSize()) &&
-                        matchGuestTexture.GetViewDepth() <= guestTexture.GetViewDepth())
-                        || matchGuestTexture.viewMipBase > 0)
-                    && matchGuestTexture.tileConfig == guestTexture.tileConfig) {
+                if (IsFullMatchCompatible(*hostMapping->texture->guest, guestTexture)) {
                     fullMatch = hostMapping->texture;
                 } else {
                     matches.push_back(hostMapping->texture);
@@ -133,18 +285,14 @@ namespace skyline::gpu {
         for (auto &texture : matches)
             texture->SynchronizeGuest(false, true);
 
+        EvictTextures();
+
         // Create a texture as we cannot find one that matches
         auto texture{std::make_shared<Texture>(gpu, guestTexture)};
         texture->SetupGuestMappings();
         texture->TransitionLayout(vk::ImageLayout::eGeneral);
-        auto it{texture->guest->mappings.begin()};
-        textures.emplace(mappingEnd, TextureMapping{texture, it, guestMapping});
-        while ((++it) != texture->guest->mappings.end()) {
-            guestMapping = *it;
-            auto mapping{std::upper_bound(textures.begin(), textures.end(), guestMapping)};
-            // TODO: Delete overlapping textures that aren't in texture pool
-            textures.emplace(mapping, TextureMapping{texture, it, guestMapping});
-        }
+        // TODO: Delete overlapping textures that aren't in texture pool
+        InsertTexture(texture);
 
         return texture->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
             .aspectMask = guestTexture.aspect,
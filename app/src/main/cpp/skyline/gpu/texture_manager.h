@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <tsl/robin_map.h>
+#include <common/segment_table.h>
 #include "texture/texture.h"
 
 namespace skyline::gpu {
@@ -26,7 +28,40 @@ namespace skyline::gpu {
         };
 
         GPU &gpu;
-        std::vector<TextureMapping> textures; //!< A sorted vector of all texture mappings
+        std::list<TextureMapping> textures; //!< All texture mappings, these are referenced by `mappingBuckets`
+
+        static constexpr size_t BucketBits{20}; //!< The amount of AS (in bytes) a single bucket in `mappingBuckets` covers (1 MiB == 1 << 20)
+        tsl::robin_map<size_t, boost::container::small_vector<TextureMapping *, 4>> mappingBuckets; //!< An index of texture mappings for every bucket of the AS that they overlap, overlap lookups only need to consider mappings in the buckets that a range overlaps
+
+        static constexpr size_t L2EntryGranularity{19}; //!< The amount of AS (in bytes) a single L2 PTE covers (512 KiB == 1 << 19)
+        SegmentTable<Texture *, constant::AddressSpaceSize, constant::PageSizeBits, L2EntryGranularity> textureTable; //!< A page table of all textures that don't overlap any other textures for O(1) lookups on full matches
+
+        static constexpr double EvictionThreshold{0.9}; //!< The fraction of the device-local memory budget which once exceeded causes textures to be evicted
+        static constexpr double EvictionTarget{0.75}; //!< The fraction of the device-local memory budget that eviction attempts to reduce the usage to
+        static constexpr u32 EvictionMinimumAge{32}; //!< The minimum amount of submissions since a texture was last used for it to be evicted, this avoids evicting textures that are used in a cycle across frames
+        u32 lastEvictionSubmission{}; //!< The submission index during which the budget was last checked, it's checked at most once per submission
+
+        /**
+         * @brief Evicts the least recently used textures that aren't referenced outside the texture manager and whose contents are held by the guest when the device-local memory usage exceeds its budget
+         * @note The texture manager **must** be locked prior to calling this
+         */
+        void EvictTextures();
+
+        /**
+         * @brief Calls the supplied function with every texture mapping that overlaps the supplied range exactly once
+         */
+        template<typename Function>
+        void ForEachOverlap(span<u8> range, Function function);
+
+        /**
+         * @brief Inserts all mappings of the texture into the lookup structures
+         */
+        void InsertTexture(const std::shared_ptr<Texture> &texture);
+
+        /**
+         * @return If a texture with mappings that fully match the guest texture can be used for it
+         */
+        static bool IsFullMatchCompatible(const GuestTexture &matchGuestTexture, const GuestTexture &guestTexture);
 
       public:
         TextureManager(GPU &gpu);
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "timeline_semaphore.h"
+
+namespace skyline::gpu {
+    static vk::raii::Semaphore CreateTimelineSemaphore(const vk::raii::Device &device) {
+        vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> createInfo{
+            vk::SemaphoreCreateInfo{},
+            vk::SemaphoreTypeCreateInfo{
+                .semaphoreType = vk::SemaphoreType::eTimeline,
+                .initialValue = 0,
+            }
+        };
+        return vk::raii::Semaphore{device, createInfo.get<vk::SemaphoreCreateInfo>()};
+    }
+
+    TimelineSemaphore::TimelineSemaphore(const vk::raii::Device &device) : device{device}, semaphore{CreateTimelineSemaphore(device)} {}
+
+    void TimelineSemaphore::UpdateCompleted(u64 value) {
+        u64 completed{completedValue.load(std::memory_order_relaxed)};
+        while (completed < value && !completedValue.compare_exchange_weak(completed, value, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    bool TimelineSemaphore::IsSignalled(u64 value, bool quick) {
+        if (completedValue.load(std::memory_order_acquire) >= value)
+            return true;
+
+        if (quick)
+            return false;
+
+        u64 counterValue{};
+        auto result{(*device).getSemaphoreCounterValueKHR(*semaphore, &counterValue, *device.getDispatcher())};
+        if (result != vk::Result::eSuccess)
+            throw exception("An error occurred while querying timeline semaphore 0x{:X}: {}", static_cast<VkSemaphore>(*semaphore), vk::to_string(result));
+
+        UpdateCompleted(counterValue);
+        return counterValue >= value;
+    }
+
+    void TimelineSemaphore::Wait(u64 value) {
+        if (completedValue.load(std::memory_order_acquire) >= value)
+            return;
+
+        vk::Semaphore waitSemaphore{*semaphore};
+        vk::SemaphoreWaitInfo waitInfo{
+            .semaphoreCount = 1,
+            .pSemaphores = &waitSemaphore,
+            .pValues = &value,
+        };
+
+        vk::Result waitResult;
+        while ((waitResult = (*device).waitSemaphoresKHR(&waitInfo, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
+            if (waitResult == vk::Result::eTimeout)
+                // Retry if the waiting time out
+                continue;
+
+            if (waitResult == vk::Result::eErrorInitializationFailed)
+                // eErrorInitializationFailed occurs on Mali GPU drivers due to them using the ppoll() syscall which isn't correctly restarted after a signal, we need to manually retry waiting in that case
+                continue;
+
+            throw exception("An error occurred while waiting for timeline semaphore 0x{:X} to reach {}: {}", static_cast<VkSemaphore>(*semaphore), value, vk::to_string(waitResult));
+        }
+
+        // The semaphore has likely progressed past the value we waited on by the time we return, picking that up here lets any cycles up to it skip their waits entirely
+        u64 counterValue{value};
+        if ((*device).getSemaphoreCounterValueKHR(*semaphore, &counterValue, *device.getDispatcher()) != vk::Result::eSuccess)
+            counterValue = value;
+        UpdateCompleted(std::max(counterValue, value));
+    }
+}
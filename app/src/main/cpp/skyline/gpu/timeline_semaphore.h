@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+#include <common.h>
+
+namespace skyline::gpu {
+    /**
+     * @brief A wrapper around a Vulkan timeline semaphore (with VK_KHR_timeline_semaphore) which is signalled by every submission to a single queue with a monotonically increasing value
+     * @note As every signal operation on a queue implicitly waits for all prior submissions to it, a value being reached implies all lower values have been reached too
+     */
+    class TimelineSemaphore {
+      private:
+        const vk::raii::Device &device;
+        vk::raii::Semaphore semaphore;
+        u64 nextValue{1}; //!< The value that will be signalled by the next submission, this must only be accessed with the queue mutex held
+        std::atomic<u64> lastSubmittedValue{}; //!< The highest value that has been submitted to the queue
+        std::atomic<u64> completedValue{}; //!< The highest value the semaphore is known to have reached, this is a cache to avoid querying the semaphore on every check
+
+        /**
+         * @brief Raises the cached completed value to the supplied value if it's higher
+         */
+        void UpdateCompleted(u64 value);
+
+      public:
+        TimelineSemaphore(const vk::raii::Device &device);
+
+        vk::Semaphore operator*() const {
+            return *semaphore;
+        }
+
+        /**
+         * @return The value that should be signalled by the next submission
+         * @note The queue mutex must be held from calling this till the submission is done, Submitted() must be called if the submission succeeds
+         */
+        u64 NextValue() const {
+            return nextValue;
+        }
+
+        /**
+         * @brief Marks the value returned from NextValue() as submitted
+         * @note The queue mutex must be held while calling this
+         */
+        void Submitted() {
+            lastSubmittedValue.store(nextValue++, std::memory_order_release);
+        }
+
+        /**
+         * @return The highest value that has been submitted to the queue, a GPU wait on this value orders a submission after all prior ones
+         */
+        u64 LastSubmittedValue() const {
+            return lastSubmittedValue.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @return The highest value the semaphore is known to have reached, this may lag behind the semaphore as it's only updated by waits and non-quick checks
+         */
+        u64 LastCompletedValue() const {
+            return completedValue.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @param quick Skips querying the semaphore, only checking against the cached completed value
+         * @return If the semaphore has reached the supplied value
+         */
+        bool IsSignalled(u64 value, bool quick = false);
+
+        /**
+         * @brief Blocks till the semaphore has reached the supplied value
+         * @note The cached completed value is updated to the current value of the semaphore afterwards, this allows a single host wait to signal all cycles with lower values
+         */
+        void Wait(u64 value);
+    };
+}
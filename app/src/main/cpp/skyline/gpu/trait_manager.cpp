@@ -5,10 +5,16 @@
 #include "trait_manager.h"
 
 namespace skyline::gpu {
-    TraitManager::TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice) : quirks(deviceProperties2.get<vk::PhysicalDeviceProperties2>().properties, deviceProperties2.get<vk::PhysicalDeviceDriverProperties>()) {
-        bool hasCustomBorderColorExt{}, hasShaderAtomicInt64Ext{}, hasShaderFloat16Int8Ext{}, hasShaderDemoteToHelperExt{}, hasVertexAttributeDivisorExt{}, hasProvokingVertexExt{}, hasPrimitiveTopologyListRestartExt{}, hasImagelessFramebuffersExt{}, hasTransformFeedbackExt{}, hasUint8IndicesExt{}, hasExtendedDynamicStateExt{}, hasRobustness2Ext{};
+    TraitManager::TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice, bool enableDescriptorBuffers, bool enableTimelineSemaphores, bool enableDynamicRendering, bool enableSparseBuffers) : quirks(deviceProperties2.get<vk::PhysicalDeviceProperties2>().properties, deviceProperties2.get<vk::PhysicalDeviceDriverProperties>()) {
+        bool hasCustomBorderColorExt{}, hasShaderAtomicInt64Ext{}, hasShaderFloat16Int8Ext{}, hasShaderDemoteToHelperExt{}, hasVertexAttributeDivisorExt{}, hasProvokingVertexExt{}, hasPrimitiveTopologyListRestartExt{}, hasImagelessFramebuffersExt{}, hasTransformFeedbackExt{}, hasUint8IndicesExt{}, hasExtendedDynamicStateExt{}, hasRobustness2Ext{}, hasBufferDeviceAddressExt{}, hasDescriptorBufferExt{}, hasTimelineSemaphoreExt{}, hasDynamicRenderingExt{}, hasExternalMemoryHostExt{};
         bool supportsUniformBufferStandardLayout{}; // We require VK_KHR_uniform_buffer_standard_layout but assume it is implicitly supported even when not present
 
+        // VK_KHR_dynamic_rendering depends on VK_KHR_depth_stencil_resolve which in turn depends on VK_KHR_create_renderpass2, all of them need to be present for any to be enabled
+        auto hasExtension{[&](std::string_view name) {
+            return std::any_of(deviceExtensions.begin(), deviceExtensions.end(), [name](const vk::ExtensionProperties &extension) { return name == std::string_view{extension.extensionName}; });
+        }};
+        enableDynamicRendering = enableDynamicRendering && hasExtension("VK_KHR_dynamic_rendering") && hasExtension("VK_KHR_depth_stencil_resolve") && hasExtension("VK_KHR_create_renderpass2");
+
         for (auto &extension : deviceExtensions) {
             #define EXT_SET_COND(name, property, cond)                                                       \
             case util::Hash(name):                                                                           \
@@ -60,6 +66,14 @@ namespace skyline::gpu {
                 EXT_SET("VK_EXT_transform_feedback", hasTransformFeedbackExt);
                 EXT_SET_COND("VK_EXT_extended_dynamic_state", hasExtendedDynamicStateExt, !quirks.brokenDynamicStateVertexBindings);
                 EXT_SET("VK_EXT_robustness2", hasRobustness2Ext);
+                EXT_SET_COND("VK_KHR_buffer_device_address", hasBufferDeviceAddressExt, enableDescriptorBuffers);
+                EXT_SET_COND("VK_EXT_descriptor_buffer", hasDescriptorBufferExt, enableDescriptorBuffers);
+                EXT_SET_COND("VK_KHR_timeline_semaphore", hasTimelineSemaphoreExt, enableTimelineSemaphores);
+                EXT_SET_COND("VK_KHR_create_renderpass2", hasDynamicRenderingExt, enableDynamicRendering);
+                EXT_SET_COND("VK_KHR_depth_stencil_resolve", hasDynamicRenderingExt, enableDynamicRendering);
+                EXT_SET_COND("VK_KHR_dynamic_rendering", hasDynamicRenderingExt, enableDynamicRendering);
+                EXT_SET_COND("VK_EXT_external_memory_host", hasExternalMemoryHostExt, enableSparseBuffers);
+                EXT_SET("VK_EXT_memory_budget", supportsMemoryBudget);
             }
 
             #undef EXT_SET_COND
@@ -81,7 +95,7 @@ namespace skyline::gpu {
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderInt16, supportsInt16)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderInt64, supportsInt64)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderStorageImageReadWithoutFormat, supportsImageReadWithoutFormat)
-        FEAT_SET(vk::PhysicalDeviceFeatures2, features.robustBufferAccess, std::ignore)
+        FEAT_SET(vk::PhysicalDeviceFeatures2, features.robustBufferAccess, supportsRobustBufferAccess)
 
         if (hasUint8IndicesExt)
             FEAT_SET(vk::PhysicalDeviceIndexTypeUint8FeaturesEXT, indexTypeUint8, supportsUint8Indices)
@@ -173,18 +187,55 @@ namespace skyline::gpu {
             enabledFeatures2.unlink<vk::PhysicalDeviceTransformFeedbackFeaturesEXT>();
         }
 
+        if (hasBufferDeviceAddressExt)
+            FEAT_SET(vk::PhysicalDeviceBufferDeviceAddressFeatures, bufferDeviceAddress, supportsBufferDeviceAddress)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceBufferDeviceAddressFeatures>();
+
+        if (hasDescriptorBufferExt && supportsBufferDeviceAddress)
+            FEAT_SET(vk::PhysicalDeviceDescriptorBufferFeaturesEXT, descriptorBuffer, supportsDescriptorBuffer)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+
+        if (hasTimelineSemaphoreExt)
+            FEAT_SET(vk::PhysicalDeviceTimelineSemaphoreFeatures, timelineSemaphore, supportsTimelineSemaphores)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceTimelineSemaphoreFeatures>();
+
+        if (hasDynamicRenderingExt)
+            FEAT_SET(vk::PhysicalDeviceDynamicRenderingFeatures, dynamicRendering, supportsDynamicRendering)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceDynamicRenderingFeatures>();
+
+        if (hasExternalMemoryHostExt)
+            FEAT_SET(vk::PhysicalDeviceFeatures2, features.sparseBinding, supportsSparseBuffers)
+
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.geometryShader, supportsGeometryShaders)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.vertexPipelineStoresAndAtomics, supportsVertexPipelineStoresAndAtomics)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.fragmentStoresAndAtomics, supportsFragmentStoresAndAtomics)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderStorageImageWriteWithoutFormat, supportsShaderStorageImageWriteWithoutFormat)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.wideLines, supportsWideLines)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.depthClamp, supportsDepthClamp)
+        FEAT_SET(vk::PhysicalDeviceFeatures2, features.inheritedQueries, supportsInheritedQueries)
 
         #undef FEAT_SET
 
         if (supportsFloatControls)
             floatControls = deviceProperties2.get<vk::PhysicalDeviceFloatControlsProperties>();
 
+        if (supportsDescriptorBuffer)
+            descriptorBufferProperties = deviceProperties2.get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+
+        if (supportsSparseBuffers)
+            minImportedHostPointerAlignment = static_cast<u32>(deviceProperties2.get<vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>().minImportedHostPointerAlignment);
+
+        if (supportsDescriptorBuffer)
+            descriptorBackend = DescriptorBackend::Buffer;
+        else if (supportsPushDescriptors)
+            descriptorBackend = DescriptorBackend::Push;
+        else
+            descriptorBackend = DescriptorBackend::Pool;
+
         auto &subgroupProperties{deviceProperties2.get<vk::PhysicalDeviceSubgroupProperties>()};
         supportsSubgroupVote = static_cast<bool>(subgroupProperties.supportedOperations & vk::SubgroupFeatureFlagBits::eVote);
         subgroupSize = deviceProperties2.get<vk::PhysicalDeviceSubgroupProperties>().subgroupSize;
@@ -222,8 +273,8 @@ namespace skyline::gpu {
 
     std::string TraitManager::Summary() {
         return fmt::format(
-            "\n* Supports U8 Indices: {}\n* Supports Sampler Mirror Clamp To Edge: {}\n* Supports Sampler Reduction Mode: {}\n* Supports Custom Border Color (Without Format): {}\n* Supports Anisotropic Filtering: {}\n* Supports Last Provoking Vertex: {}\n* Supports Logical Operations: {}\n* Supports Vertex Attribute Divisor: {}\n* Supports Vertex Attribute Zero Divisor: {}\n* Supports Push Descriptors: {}\n* Supports Imageless Framebuffers: {}\n* Supports Global Priority: {}\n* Supports Multiple Viewports: {}\n* Supports Shader Viewport Index: {}\n* Supports SPIR-V 1.4: {}\n* Supports Shader Invocation Demotion: {}\n* Supports 16-bit FP: {}\n* Supports 8-bit Integers: {}\n* Supports 16-bit Integers: {}\n* Supports 64-bit Integers: {}\n* Supports Atomic 64-bit Integers: {}\n* Supports Floating Point Behavior Control: {}\n* Supports Image Read Without Format: {}\n* Supports List Primitive Topology Restart: {}\n* Supports Patch List Primitive Topology Restart: {}\n* Supports Transform Feedback: {}\n* Supports Geometry Shaders: {}\n*  Supports Vertex Pipeline Stores and Atomics: {}\n* Supports Fragment Stores and Atomics: {}\n* Supports Shader Storage Image Write Without Format: {}\n*Supports Subgroup Vote: {}\n* Subgroup Size: {}\n* BCn Support: {}",
-            supportsUint8Indices, supportsSamplerMirrorClampToEdge, supportsSamplerReductionMode, supportsCustomBorderColor, supportsAnisotropicFiltering, supportsLastProvokingVertex, supportsLogicOp, supportsVertexAttributeDivisor, supportsVertexAttributeZeroDivisor, supportsPushDescriptors, supportsImagelessFramebuffers, supportsGlobalPriority, supportsMultipleViewports, supportsShaderViewportIndexLayer, supportsSpirv14, supportsShaderDemoteToHelper, supportsFloat16, supportsInt8, supportsInt16, supportsInt64, supportsAtomicInt64, supportsFloatControls, supportsImageReadWithoutFormat, supportsTopologyListRestart, supportsTopologyPatchListRestart, supportsTransformFeedback, supportsGeometryShaders, supportsVertexPipelineStoresAndAtomics, supportsFragmentStoresAndAtomics, supportsShaderStorageImageWriteWithoutFormat, supportsSubgroupVote, subgroupSize, bcnSupport.to_string()
+            "\n* Supports U8 Indices: {}\n* Supports Sampler Mirror Clamp To Edge: {}\n* Supports Sampler Reduction Mode: {}\n* Supports Custom Border Color (Without Format): {}\n* Supports Anisotropic Filtering: {}\n* Supports Last Provoking Vertex: {}\n* Supports Logical Operations: {}\n* Supports Vertex Attribute Divisor: {}\n* Supports Vertex Attribute Zero Divisor: {}\n* Supports Push Descriptors: {}\n* Supports Imageless Framebuffers: {}\n* Supports Global Priority: {}\n* Supports Multiple Viewports: {}\n* Supports Shader Viewport Index: {}\n* Supports SPIR-V 1.4: {}\n* Supports Shader Invocation Demotion: {}\n* Supports 16-bit FP: {}\n* Supports 8-bit Integers: {}\n* Supports 16-bit Integers: {}\n* Supports 64-bit Integers: {}\n* Supports Atomic 64-bit Integers: {}\n* Supports Floating Point Behavior Control: {}\n* Supports Image Read Without Format: {}\n* Supports List Primitive Topology Restart: {}\n* Supports Patch List Primitive Topology Restart: {}\n* Supports Transform Feedback: {}\n* Supports Geometry Shaders: {}\n*  Supports Vertex Pipeline Stores and Atomics: {}\n* Supports Fragment Stores and Atomics: {}\n* Supports Shader Storage Image Write Without Format: {}\n*Supports Subgroup Vote: {}\n* Supports Descriptor Buffers: {}\n* Supports Timeline Semaphores: {}\n* Supports Dynamic Rendering: {}\n* Supports Sparse Buffers: {}\n* Supports Memory Budget: {}\n* Descriptor Backend: {}\n* Subgroup Size: {}\n* BCn Support: {}",
+            supportsUint8Indices, supportsSamplerMirrorClampToEdge, supportsSamplerReductionMode, supportsCustomBorderColor, supportsAnisotropicFiltering, supportsLastProvokingVertex, supportsLogicOp, supportsVertexAttributeDivisor, supportsVertexAttributeZeroDivisor, supportsPushDescriptors, supportsImagelessFramebuffers, supportsGlobalPriority, supportsMultipleViewports, supportsShaderViewportIndexLayer, supportsSpirv14, supportsShaderDemoteToHelper, supportsFloat16, supportsInt8, supportsInt16, supportsInt64, supportsAtomicInt64, supportsFloatControls, supportsImageReadWithoutFormat, supportsTopologyListRestart, supportsTopologyPatchListRestart, supportsTransformFeedback, supportsGeometryShaders, supportsVertexPipelineStoresAndAtomics, supportsFragmentStoresAndAtomics, supportsShaderStorageImageWriteWithoutFormat, supportsSubgroupVote, supportsDescriptorBuffer, supportsTimelineSemaphores, supportsDynamicRendering, supportsSparseBuffers, supportsMemoryBudget, descriptorBackend == DescriptorBackend::Buffer ? "Buffer" : (descriptorBackend == DescriptorBackend::Push ? "Push" : "Pool"), subgroupSize, bcnSupport.to_string()
         );
     }
 
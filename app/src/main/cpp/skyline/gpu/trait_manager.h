@@ -48,8 +48,18 @@ namespace skyline::gpu {
         bool supportsSubgroupVote{}; //!< If subgroup votes are supported in shaders with SPV_KHR_subgroup_vote
         bool supportsWideLines{}; //!< If the device supports the 'wideLines' Vulkan feature
         bool supportsDepthClamp{}; //!< If the device supports the 'depthClamp' Vulkan feature
+        bool supportsInheritedQueries{}; //!< If the device supports the 'inheritedQueries' Vulkan feature, this is required to record render passes into secondary command buffers while an occlusion query is active
         bool supportsExtendedDynamicState{}; //!< If the device supports the 'VK_EXT_extended_dynamic_state' Vulkan extension
         bool supportsNullDescriptor{}; //!< If the device supports the null descriptor feature in the 'VK_EXT_robustness2' Vulkan extension
+        bool supportsRobustBufferAccess{}; //!< If the device supports the 'robustBufferAccess' Vulkan feature, this affects the size of buffer descriptors in descriptor buffers
+        bool supportsBufferDeviceAddress{}; //!< If the device supports querying the device address of buffers (with VK_KHR_buffer_device_address)
+        bool supportsDescriptorBuffer{}; //!< If the device supports writing descriptors directly into buffer memory (with VK_EXT_descriptor_buffer)
+        bool supportsTimelineSemaphores{}; //!< If the device supports timeline semaphores (with VK_KHR_timeline_semaphore) and they should be used for tracking submissions
+        bool supportsDynamicRendering{}; //!< If the device supports beginning render passes without render pass and framebuffer objects (with VK_KHR_dynamic_rendering) and it should be used for all render passes
+        bool supportsSparseBuffers{}; //!< If the device supports binding imported host memory (with VK_EXT_external_memory_host) to sparse buffers and they should be used for large guest buffers
+        u32 minImportedHostPointerAlignment{}; //!< The alignment required for the address and size of host memory imports, this is only valid when sparse buffers are supported
+        bool supportsMemoryBudget{}; //!< If the device reports the usage and budget of its memory heaps (with VK_EXT_memory_budget)
+        vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties{}; //!< Sizes and alignment requirements of descriptors in descriptor buffers (All members will be zero'd out when unavailable)
         u32 subgroupSize{}; //!< Size of a subgroup on the host GPU
         u32 hostVisibleCoherentCachedMemoryType{std::numeric_limits<u32>::max()};
         u32 minimumStorageBufferAlignment{}; //!< Minimum alignment for storage buffers passed to shaders
@@ -62,6 +72,15 @@ namespace skyline::gpu {
         std::bitset<7> bcnSupport{}; //!< Bitmask of BCn texture formats supported, it is ordered as BC1, BC2, BC3, BC4, BC5, BC6H and BC7
         bool supportsAdrenoDirectMemoryImport{};
 
+        /**
+         * @brief The mechanism used to bind descriptors for guest draws and dispatches
+         */
+        enum class DescriptorBackend {
+            Pool, //!< Descriptor sets are allocated from a VkDescriptorPool by DescriptorAllocator and updated with vkUpdateDescriptorSets
+            Push, //!< Descriptors are pushed directly into the command buffer (with VK_KHR_push_descriptor)
+            Buffer, //!< Descriptors are written into a ring-allocated descriptor buffer by DescriptorBufferAllocator (with VK_EXT_descriptor_buffer)
+        } descriptorBackend{DescriptorBackend::Pool}; //!< The descriptor binding backend selected at runtime, this falls back from descriptor buffers to push descriptors to pools based on support
+
         /**
          * @brief Manages a list of any vendor/device-specific errata in the host GPU
          */
@@ -101,7 +120,9 @@ namespace skyline::gpu {
             vk::PhysicalDeviceDriverProperties,
             vk::PhysicalDeviceFloatControlsProperties,
             vk::PhysicalDeviceTransformFeedbackPropertiesEXT,
-            vk::PhysicalDeviceSubgroupProperties>;
+            vk::PhysicalDeviceSubgroupProperties,
+            vk::PhysicalDeviceDescriptorBufferPropertiesEXT,
+            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>;
 
         using DeviceFeatures2 = vk::StructureChain<
             vk::PhysicalDeviceFeatures2,
@@ -118,9 +139,19 @@ namespace skyline::gpu {
             vk::PhysicalDeviceTransformFeedbackFeaturesEXT,
             vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-            vk::PhysicalDeviceRobustness2FeaturesEXT>;
+            vk::PhysicalDeviceRobustness2FeaturesEXT,
+            vk::PhysicalDeviceBufferDeviceAddressFeatures,
+            vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+            vk::PhysicalDeviceTimelineSemaphoreFeatures,
+            vk::PhysicalDeviceDynamicRenderingFeatures>;
 
-        TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice);
+        /**
+         * @param enableDescriptorBuffers If the descriptor buffer backend should be used when it is supported by the device
+         * @param enableTimelineSemaphores If timeline semaphores should be used for tracking submissions when they are supported by the device
+         * @param enableDynamicRendering If dynamic rendering should be used for all render passes when it is supported by the device
+         * @param enableSparseBuffers If sparse buffers should be used for large guest buffers when they are supported by the device
+         */
+        TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice, bool enableDescriptorBuffers, bool enableTimelineSemaphores, bool enableDynamicRendering, bool enableSparseBuffers);
 
         /**
          * @brief Applies driver specific binary patches to the driver (e.g. BCeNabler)
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <common/utils.h>
+#include "guest_profiler.h"
+
+namespace skyline::hle {
+    GuestProfiler::ThreadBuffer::~ThreadBuffer() {
+        for (auto &block : blocks)
+            delete block.load(std::memory_order_relaxed);
+    }
+
+    GuestProfiler::SymbolCounter &GuestProfiler::ThreadBuffer::GetCounter(u32 index) {
+        auto &blockPointer{blocks[index / CounterBlockSize]};
+        auto block{blockPointer.load(std::memory_order_relaxed)}; // Only the owning thread ever stores to this
+        if (!block) [[unlikely]] {
+            block = new CounterBlock{};
+            blockPointer.store(block, std::memory_order_release);
+        }
+
+        return (*block)[index % CounterBlockSize];
+    }
+
+    GuestProfiler::ThreadBuffer &GuestProfiler::GetThreadBuffer() {
+        // The buffer is cached per-thread alongside the ID of the profiler it belongs to, so a stale buffer from a previous profiler is never used
+        thread_local std::pair<u64, ThreadBuffer *> cachedBuffer{};
+        if (cachedBuffer.first == id) [[likely]]
+            return *cachedBuffer.second;
+
+        std::scoped_lock lock{mutex};
+        cachedBuffer = {id, &threadBuffers.emplace_back()};
+        return *cachedBuffer.second;
+    }
+
+    void GuestProfiler::OnEntry(u32 index) {
+        auto &buffer{GetThreadBuffer()};
+        auto &counter{buffer.GetCounter(index)};
+
+        // There's only a single writer so a load and store is sufficient, avoiding the cost of an atomic RMW
+        counter.calls.store(counter.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counter.depth++;
+        buffer.stack.push_back(CallFrame{index, util::GetTimeNs()});
+    }
+
+    void GuestProfiler::OnExit(u32 index) {
+        auto &buffer{GetThreadBuffer()};
+        i64 exitNs{util::GetTimeNs()};
+
+        // Any frames above the exiting symbol belong to calls that were never exited (such as due to a longjmp), they're unwound as if they returned now
+        auto frame{std::find_if(buffer.stack.rbegin(), buffer.stack.rend(), [index](const CallFrame &frame) { return frame.index == index; })};
+        if (frame == buffer.stack.rend())
+            return; // The entry of this call occurred prior to the thread buffer existing, there's nothing to account it against
+
+        for (auto it{buffer.stack.rbegin()}; it != std::next(frame); it++) {
+            auto &counter{buffer.GetCounter(it->index)};
+            if (--counter.depth == 0) // Only the outermost call of a recursive symbol is accounted so time isn't counted multiple times
+                counter.inclusiveNs.store(counter.inclusiveNs.load(std::memory_order_relaxed) + static_cast<u64>(exitNs - it->entryNs), std::memory_order_relaxed);
+        }
+
+        buffer.stack.erase(std::prev(frame.base()), buffer.stack.end());
+    }
+
+    GuestProfiler::GuestProfiler(std::string_view symbols) : id{[] {
+        static std::atomic<u64> nextId{1};
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }()} {
+        constexpr std::string_view Separators{", \t\r\n"};
+        for (size_t start{symbols.find_first_not_of(Separators)}; start != std::string_view::npos;) {
+            size_t end{symbols.find_first_of(Separators, start)};
+            filter.emplace_back(symbols.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+            start = symbols.find_first_not_of(Separators, end);
+        }
+
+        std::sort(filter.begin(), filter.end());
+        if (filter.empty())
+            Logger::Info("Guest profiler enabled for all exported functions");
+        else
+            Logger::Info("Guest profiler enabled for {} function(s)", filter.size());
+    }
+
+    bool GuestProfiler::ShouldProfile(std::string_view name) {
+        if (!filter.empty())
+            return std::binary_search(filter.begin(), filter.end(), name, [](std::string_view lhs, std::string_view rhs) { return lhs < rhs; });
+
+        // Small libc functions are called extremely frequently and the hook overhead would dwarf their actual cost
+        return !(name == "memcpy" || name == "memcmp" || name == "memset" || name == "memmove" || name == "strcmp" || name == "strlen");
+    }
+
+    HookType GuestProfiler::CreateHook(std::string_view name) {
+        u32 index;
+        {
+            std::scoped_lock lock{mutex};
+            if (symbolNames.size() >= MaxSymbolCount)
+                throw exception("Exceeded maximum amount of profiled guest symbols: {}", MaxSymbolCount);
+
+            index = static_cast<u32>(symbolNames.size());
+            symbolNames.emplace_back(Demangle(name));
+        }
+
+        return EntryExitHook{
+            .entry = [this, index](const DeviceState &, const HookedSymbol &) { OnEntry(index); },
+            .exit = [this, index](const DeviceState &, const HookedSymbol &) { OnExit(index); },
+        };
+    }
+
+    std::vector<GuestProfiler::SymbolStatistics> GuestProfiler::GetStatistics() {
+        std::scoped_lock lock{mutex};
+
+        std::vector<SymbolStatistics> statistics(symbolNames.size());
+        for (auto &buffer : threadBuffers) {
+            for (size_t blockIndex{}; blockIndex < MaxCounterBlocks; blockIndex++) {
+                auto block{buffer.blocks[blockIndex].load(std::memory_order_acquire)};
+                if (!block)
+                    continue;
+
+                for (size_t counterIndex{}; counterIndex < CounterBlockSize; counterIndex++) {
+                    size_t index{(blockIndex * CounterBlockSize) + counterIndex};
+                    if (index >= statistics.size())
+                        break;
+
+                    auto &counter{(*block)[counterIndex]};
+                    statistics[index].calls += counter.calls.load(std::memory_order_relaxed);
+                    statistics[index].inclusiveNs += counter.inclusiveNs.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        for (size_t index{}; index < statistics.size(); index++)
+            statistics[index].name = symbolNames[index];
+
+        std::erase_if(statistics, [](const SymbolStatistics &symbol) { return symbol.calls == 0; });
+        std::sort(statistics.begin(), statistics.end(), [](const SymbolStatistics &lhs, const SymbolStatistics &rhs) { return lhs.inclusiveNs > rhs.inclusiveNs; });
+        return statistics;
+    }
+
+    void GuestProfiler::WriteReport(const std::string &path) {
+        constexpr size_t LoggedSymbolCount{16}; //!< The amount of the most expensive symbols which are logged in addition to being written to the report
+
+        auto statistics{GetStatistics()};
+
+        std::ofstream stream{path, std::ios::trunc};
+        if (stream.fail())
+            Logger::Warn("Failed to open guest profiler report: {}", path);
+        else
+            stream << fmt::format("{:>16} {:>16} {:>12} Symbol\n", "Inclusive (ns)", "Calls", "Avg (ns)");
+
+        for (size_t index{}; index < statistics.size(); index++) {
+            const auto &symbol{statistics[index]};
+            auto line{fmt::format("{:>16} {:>16} {:>12} {}", symbol.inclusiveNs, symbol.calls, symbol.inclusiveNs / symbol.calls, symbol.name)};
+            if (stream)
+                stream << line << '\n';
+            if (index < LoggedSymbolCount)
+                Logger::Info("{}", line);
+        }
+
+        Logger::Info("Wrote guest profiler report with {} symbol(s) to {}", statistics.size(), path);
+    }
+}
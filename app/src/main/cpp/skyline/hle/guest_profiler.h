@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include "symbol_hooks.h"
+
+namespace skyline::hle {
+    /**
+     * @brief An instrumenting profiler for guest functions which attaches entry/exit hooks to guest symbols and accumulates call counts and inclusive host time per symbol
+     * @note Every hooked call is also emitted as a slice in the "hook" perfetto category by NCE::HookHandler, this class provides the aggregated view on top of that
+     * @note Statistics are recorded into per-thread buffers which are only written by their owning thread, reading them for a report doesn't require any synchronization with guest threads
+     */
+    class GuestProfiler {
+      private:
+        /**
+         * @brief The statistics for a single symbol on a single thread
+         */
+        struct SymbolCounter {
+            std::atomic<u64> calls; //!< The amount of times the symbol was entered
+            std::atomic<u64> inclusiveNs; //!< The host time spent inside the symbol including any callees, recursive calls are only counted once
+            u32 depth; //!< The amount of active calls to this symbol on the owning thread, this is only accessed by the owning thread
+        };
+
+        static constexpr size_t CounterBlockSize{256}; //!< The amount of symbol counters in a single lazily allocated block
+        static constexpr size_t MaxCounterBlocks{1024}; //!< The maximum amount of counter blocks per thread, this limits the amount of symbols that can be profiled
+        static constexpr size_t MaxSymbolCount{CounterBlockSize * MaxCounterBlocks};
+
+        using CounterBlock = std::array<SymbolCounter, CounterBlockSize>;
+
+        /**
+         * @brief A call to a profiled symbol which hasn't returned yet
+         */
+        struct CallFrame {
+            u32 index; //!< The index of the symbol that was called
+            i64 entryNs; //!< The host time at which the symbol was entered
+        };
+
+        /**
+         * @brief The profiling data of a single host thread, only the owning thread writes to this
+         */
+        struct ThreadBuffer {
+            std::array<std::atomic<CounterBlock *>, MaxCounterBlocks> blocks{}; //!< Blocks are published with release semantics so they can be read by the reporting thread
+            std::vector<CallFrame> stack; //!< The stack of active calls on this thread
+
+            ~ThreadBuffer();
+
+            SymbolCounter &GetCounter(u32 index);
+        };
+
+        u64 id; //!< A unique ID for this profiler instance, used to invalidate cached thread buffers of a previous instance
+        std::vector<std::string> filter; //!< A sorted list of mangled symbol names to profile, all exported symbols are profiled if this is empty
+
+        std::mutex mutex; //!< Synchronizes registration of symbols and threads
+        std::vector<std::string> symbolNames; //!< The demangled names of all registered symbols, indexed by symbol index
+        std::list<ThreadBuffer> threadBuffers; //!< The buffers of all threads that have called into a profiled symbol, these are retained after threads exit
+
+        ThreadBuffer &GetThreadBuffer();
+
+        void OnEntry(u32 index);
+
+        void OnExit(u32 index);
+
+      public:
+        /**
+         * @param symbols A comma or whitespace separated list of mangled symbol names to profile, an empty list profiles all exported functions
+         */
+        GuestProfiler(std::string_view symbols);
+
+        /**
+         * @return If the supplied mangled symbol should be hooked for profiling
+         */
+        bool ShouldProfile(std::string_view name);
+
+        /**
+         * @brief Registers a symbol with the profiler
+         * @return An entry/exit hook that records statistics for the symbol
+         */
+        HookType CreateHook(std::string_view name);
+
+        struct SymbolStatistics {
+            std::string name; //!< The demangled name of the symbol
+            u64 calls;
+            u64 inclusiveNs;
+        };
+
+        /**
+         * @return The statistics of all symbols summed across all threads that have been called at least once, sorted by descending inclusive time
+         * @note This can be called while guest threads are running, the result is a consistent snapshot for every individual counter but not across counters
+         */
+        std::vector<SymbolStatistics> GetStatistics();
+
+        /**
+         * @brief Writes a flat report of all statistics to the supplied path and logs the most expensive symbols
+         */
+        void WriteReport(const std::string &path);
+    };
+}
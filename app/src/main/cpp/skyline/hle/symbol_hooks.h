@@ -26,4 +26,9 @@ namespace skyline::hle {
 
         HookedSymbol(std::string name, HookType hook);
     };
+
+    /**
+     * @return The demangled form of the supplied symbol name or the name itself if it isn't a valid mangled name
+     */
+    std::string Demangle(std::string_view mangledName);
 }
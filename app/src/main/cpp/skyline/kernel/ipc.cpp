@@ -5,6 +5,32 @@
 #include "types/KProcess.h"
 
 namespace skyline::kernel::ipc {
+    /**
+     * @brief Warns if an A/B/W buffer isn't in memory that's allowed to be sent over IPC with the supplied buffer flags
+     * @note Only the state of the first and last page of the buffer is checked, these are O(1) page table lookups rather than a query of every chunk in the buffer
+     */
+    static void ValidateBuffer(const DeviceState &state, u8 *pointer, u64 size, u8 flags) {
+        auto isSendAllowed{[flags](std::optional<PageDescriptor> page) -> bool {
+            if (!page)
+                return false;
+
+            auto pageState{page->GetState()};
+            switch (flags) {
+                case 0:
+                    return pageState.ipcSendAllowed;
+                case 1:
+                    return pageState.nonSecureIpcSendAllowed;
+                case 3:
+                    return pageState.nonDeviceIpcSendAllowed;
+                default:
+                    return false;
+            }
+        }};
+
+        if (size && (!isSendAllowed(state.process->memory.GetPage(pointer)) || !isSendAllowed(state.process->memory.GetPage(pointer + size - 1)))) [[unlikely]]
+            Logger::Warn("Buffer 0x{:X} - 0x{:X} isn't in memory that can be sent over IPC with flags {}", pointer, pointer + size, flags);
+    }
+
     IpcRequest::IpcRequest(bool isDomain, const DeviceState &state) : isDomain(isDomain) {
         auto tls{state.ctx->tpidrroEl0};
         u8 *pointer{tls};
@@ -38,6 +64,7 @@ namespace skyline::kernel::ipc {
         for (u8 index{}; header->aNo > index; index++) {
             auto bufA{reinterpret_cast<BufferDescriptorABW *>(pointer)};
             if (bufA->Pointer()) {
+                ValidateBuffer(state, bufA->Pointer(), bufA->Size(), bufA->flags);
                 inputBuf.emplace_back(bufA->Pointer(), bufA->Size());
                 Logger::Verbose("Buf A #{}: 0x{:X}, 0x{:X}", index, bufA->Pointer(), static_cast<u64>(bufA->Size()));
             }
@@ -47,6 +74,7 @@ namespace skyline::kernel::ipc {
         for (u8 index{}; header->bNo > index; index++) {
             auto bufB{reinterpret_cast<BufferDescriptorABW *>(pointer)};
             if (bufB->Pointer()) {
+                ValidateBuffer(state, bufB->Pointer(), bufB->Size(), bufB->flags);
                 outputBuf.emplace_back(bufB->Pointer(), bufB->Size());
                 Logger::Verbose("Buf B #{}: 0x{:X}, 0x{:X}", index, bufB->Pointer(), static_cast<u64>(bufB->Size()));
             }
@@ -56,6 +84,7 @@ namespace skyline::kernel::ipc {
         for (u8 index{}; header->wNo > index; index++) {
             auto bufW{reinterpret_cast<BufferDescriptorABW *>(pointer)};
             if (bufW->Pointer()) {
+                ValidateBuffer(state, bufW->Pointer(), bufW->Size(), bufW->flags);
                 outputBuf.emplace_back(bufW->Pointer(), bufW->Size());
                 outputBuf.emplace_back(bufW->Pointer(), bufW->Size());
                 Logger::Verbose("Buf W #{}: 0x{:X}, 0x{:X}", index, bufW->Pointer(), static_cast<u16>(bufW->Size()));
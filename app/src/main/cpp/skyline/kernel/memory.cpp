@@ -3,6 +3,7 @@
 
 #include <asm-generic/unistd.h>
 #include <fcntl.h>
+#include <common/trace.h>
 #include "memory.h"
 #include "types/KProcess.h"
 
@@ -18,100 +19,17 @@ namespace skyline::kernel {
     }
 
     void MemoryManager::MapInternal(const std::pair<u8 *, ChunkDescriptor> &newDesc) {
-        // The chunk that contains / precedes the new chunk base address
-        auto firstChunkBase{chunks.lower_bound(newDesc.first)};
-        if (newDesc.first <= firstChunkBase->first)
-            --firstChunkBase;
+        TRACE_EVENT("kernel", "MemoryManager::MapInternal");
 
-        // The chunk that contains / follows the end address of the new chunk
-        auto lastChunkBase{chunks.lower_bound(newDesc.first + newDesc.second.size)};
-        if ((newDesc.first + newDesc.second.size) < lastChunkBase->first)
-            --lastChunkBase;
-
-        ChunkDescriptor firstChunk{firstChunkBase->second};
-        ChunkDescriptor lastChunk{lastChunkBase->second};
-
-        bool needsReprotection{false};
+        u8 *newEnd{newDesc.first + newDesc.second.size};
         bool isUnmapping{newDesc.second.state == memory::states::Unmapped};
 
-        // We cut a hole in a single chunk
-        if (firstChunkBase->first == lastChunkBase->first) {
-            if (firstChunk.IsCompatible(newDesc.second)) [[unlikely]]
-                // No editing necessary
-                return;
-
-            if ((firstChunk.state == memory::states::Unmapped) != isUnmapping)
-                needsReprotection = true;
-
-            // We reduce the size of the first half
-            firstChunk.size = static_cast<size_t>(newDesc.first - firstChunkBase->first);
-            chunks[firstChunkBase->first] = firstChunk;
-
-            // We create the chunk's second half
-            lastChunk.size = static_cast<size_t>((lastChunkBase->first + lastChunk.size) - (newDesc.first + newDesc.second.size));
-            chunks.insert({newDesc.first + newDesc.second.size, lastChunk});
-
-            // Insert new chunk in between
-            chunks.insert(newDesc);
-        } else {
-            // If there are descriptors between first and last chunk, delete them
-            if ((firstChunkBase->first + firstChunk.size) != lastChunkBase->first) {
-                auto tempChunkBase{std::next(firstChunkBase)};
-
-                while (tempChunkBase->first != lastChunkBase->first) {
-                    auto tmp{tempChunkBase++};
-                    if ((tmp->second.state == memory::states::Unmapped) != isUnmapping)
-                        needsReprotection = true;
-                }
-                chunks.erase(std::next(firstChunkBase), lastChunkBase);
-            }
-
-            bool shouldInsert{true};
-
-            // We check if the new chunk and the first chunk is mergable
-            if (firstChunk.IsCompatible(newDesc.second)) {
-                shouldInsert = false;
-
-                firstChunk.size = static_cast<size_t>((newDesc.first + newDesc.second.size) - firstChunkBase->first);
-                chunks[firstChunkBase->first] = firstChunk;
-            } else if ((firstChunkBase->first + firstChunk.size) != newDesc.first) { // If it's not mergable check if it needs resizing
-                firstChunk.size = static_cast<size_t>(newDesc.first - firstChunkBase->first);
-
-                chunks[firstChunkBase->first] = firstChunk;
-
-                if ((firstChunk.state == memory::states::Unmapped) != isUnmapping)
-                    needsReprotection = true;
-            }
-
-            // We check if the new chunk and the last chunk is mergable
-            if (lastChunk.IsCompatible(newDesc.second)) {
-                u8 *oldBase{lastChunkBase->first};
-                chunks.erase(lastChunkBase);
-
-                if (shouldInsert) {
-                    shouldInsert = false;
-
-                    lastChunk.size = static_cast<size_t>((lastChunk.size + oldBase) - (newDesc.first));
-
-                    chunks[newDesc.first] = lastChunk;
-                } else {
-                    firstChunk.size = static_cast<size_t>((lastChunk.size + oldBase) - firstChunkBase->first);
-                    chunks[firstChunkBase->first] = firstChunk;
-                }
-            } else if ((newDesc.first + newDesc.second.size) != lastChunkBase->first) { // If it's not mergable check if it needs resizing
-                lastChunk.size = static_cast<size_t>((lastChunk.size + lastChunkBase->first) - (newDesc.first + newDesc.second.size));
-
-                chunks.erase(lastChunkBase);
-                chunks[newDesc.first + newDesc.second.size] = lastChunk;
-
-                if ((lastChunk.state == memory::states::Unmapped) != isUnmapping)
-                    needsReprotection = true;
-            }
+        // The host mapping only needs to be reprotected if any part of the range changes between being mapped and unmapped
+        bool needsReprotection{false};
+        for (u8 *address{newDesc.first}; address < newEnd && !needsReprotection; address = pageTable.GetRange(address, address, newEnd).second)
+            needsReprotection = (pageTable[address].GetState() == memory::states::Unmapped) != isUnmapping;
 
-            // Insert if not merged
-            if (shouldInsert)
-                chunks.insert(newDesc);
-        }
+        pageTable.Set(newDesc.first, newEnd, PageDescriptor{newDesc.second});
 
         if (needsReprotection)
             if (mprotect(newDesc.first, newDesc.second.size, !isUnmapping ? PROT_READ | PROT_WRITE | PROT_EXEC : PROT_NONE)) [[unlikely]]
@@ -119,38 +37,17 @@ namespace skyline::kernel {
     }
 
     void MemoryManager::ForeachChunkInRange(span<u8> memory, auto editCallback) {
-        auto chunkBase{chunks.lower_bound(memory.data())};
-        if (memory.data() < chunkBase->first)
-            --chunkBase;
-
-        size_t sizeLeft{memory.size()};
-
-        if (chunkBase->first < memory.data()) [[unlikely]] {
-            size_t chunkSize{std::min<size_t>(chunkBase->second.size - (static_cast<size_t>(memory.data() - chunkBase->first)), memory.size())};
-
-            std::pair<u8 *, ChunkDescriptor> temp{memory.data(), chunkBase->second};
-            temp.second.size = chunkSize;
-            editCallback(temp);
-
-            ++chunkBase;
-            sizeLeft -= chunkSize;
+        // The end of every chunk is determined prior to calling the callback as it may modify the chunk
+        for (u8 *address{memory.data()}; address < memory.end().base();) {
+            auto chunk{GetChunkInRange(address, address, memory.end().base())};
+            address = chunk.first + chunk.second.size;
+            editCallback(chunk);
         }
+    }
 
-        while (sizeLeft) {
-            if (sizeLeft < chunkBase->second.size) {
-                std::pair<u8 *, ChunkDescriptor> temp(*chunkBase);
-                temp.second.size = sizeLeft;
-                editCallback(temp);
-                break;
-            } else [[likely]] {
-                std::pair<u8 *, ChunkDescriptor> temp(*chunkBase);
-
-                editCallback(temp);
-
-                sizeLeft = sizeLeft - chunkBase->second.size;
-                ++chunkBase;
-            }
-        }
+    std::pair<u8 *, ChunkDescriptor> MemoryManager::GetChunkInRange(u8 *addr, u8 *lowerLimit, u8 *upperLimit) {
+        auto [start, end]{pageTable.GetRange(addr, lowerLimit, upperLimit)};
+        return {start, pageTable[addr].GetChunk(static_cast<size_t>(end - start))};
     }
 
     constexpr size_t RegionAlignment{1ULL << 21}; //!< The minimum alignment of a HOS memory region
@@ -234,13 +131,8 @@ namespace skyline::kernel {
             }
         }
 
-        // Insert a placeholder element at the end of the map to make sure upper_bound/lower_bound never triggers std::map::end() which is broken
-        chunks = {{addressSpace.data(),{
-            .size = addressSpace.size(),
-            .state = memory::states::Unmapped,
-        }}, {reinterpret_cast<u8 *>(UINT64_MAX), {
-            .state = memory::states::Reserved,
-        }}};
+        // The entire address space is explicitly set as unmapped so that it's covered by L2 entries, this allows the bounds of large unmapped regions to be found at L2 granularity
+        pageTable.Set(addressSpace.data(), addressSpace.end().base(), PageDescriptor{});
     }
 
     void MemoryManager::InitializeRegions(span<u8> codeRegion) {
@@ -378,11 +270,16 @@ namespace skyline::kernel {
         if (!addressSpace.contains(addr)) [[unlikely]]
             return std::nullopt;
 
-        auto chunkBase{chunks.lower_bound(addr)};
-        if (addr < chunkBase->first)
-            --chunkBase;
+        return GetChunkInRange(addr, addressSpace.data(), addressSpace.end().base());
+    }
+
+    std::optional<PageDescriptor> MemoryManager::GetPage(u8 *addr) {
+        std::shared_lock lock{mutex};
 
-        return std::make_optional(*chunkBase);
+        if (!addressSpace.contains(addr)) [[unlikely]]
+            return std::nullopt;
+
+        return pageTable[addr];
     }
 
     __attribute__((always_inline)) void MemoryManager::MapCodeMemory(span<u8> memory, memory::Permission permission) {
@@ -414,8 +311,7 @@ namespace skyline::kernel {
             memory.data(),{
                 .size = memory.size(),
                 .permission = {true, true, false},
-                .state = memory::states::Stack,
-                .isSrcMergeDisallowed = true
+                .state = memory::states::Stack
         }));
     }
 
@@ -437,8 +333,7 @@ namespace skyline::kernel {
             memory.data(),{
                 .size = memory.size(),
                 .permission = permission,
-                .state = memory::states::SharedMemory,
-                .isSrcMergeDisallowed = true
+                .state = memory::states::SharedMemory
         }));
     }
 
@@ -449,8 +344,7 @@ namespace skyline::kernel {
             memory.data(),{
                 .size = memory.size(),
                 .permission = permission,
-                .state = permission.raw ? memory::states::TransferMemory : memory::states::TransferMemoryIsolated,
-                .isSrcMergeDisallowed = true
+                .state = permission.raw ? memory::states::TransferMemory : memory::states::TransferMemoryIsolated
         }));
     }
 
@@ -508,8 +402,7 @@ namespace skyline::kernel {
             destination.data(),{
                 .size = destination.size(),
                 .permission = {true, true, false},
-                .state = memory::states::Stack,
-                .isSrcMergeDisallowed = true
+                .state = memory::states::Stack
         }));
 
         std::memcpy(destination.data(), source.data(), source.size());
@@ -524,20 +417,19 @@ namespace skyline::kernel {
     void MemoryManager::SvcUnmapMemory(span<u8> source, span<u8> destination) {
         std::unique_lock lock{mutex};
 
-        auto dstChunk = chunks.lower_bound(destination.data());
-        if (destination.data() < dstChunk->first)
-            --dstChunk;
-        while (dstChunk->second.state.value == memory::states::Unmapped)
-            ++dstChunk;
+        // Only the first mapped chunk in the destination is restored to the source
+        auto dstChunk{GetChunkInRange(destination.data(), destination.data(), destination.end().base())};
+        while (dstChunk.second.state == memory::states::Unmapped && dstChunk.first + dstChunk.second.size < destination.end().base())
+            dstChunk = GetChunkInRange(dstChunk.first + dstChunk.second.size, destination.data(), destination.end().base());
 
-        if ((destination.data() + destination.size()) > dstChunk->first) [[likely]] {
-            ForeachChunkInRange(span<u8>{source.data() + (dstChunk->first - destination.data()), dstChunk->second.size}, [&](std::pair<u8 *, ChunkDescriptor> &desc) __attribute__((always_inline)) {
-                desc.second.permission = dstChunk->second.permission;
+        if (dstChunk.second.state != memory::states::Unmapped) [[likely]] {
+            ForeachChunkInRange(span<u8>{source.data() + (dstChunk.first - destination.data()), dstChunk.second.size}, [&](std::pair<u8 *, ChunkDescriptor> &desc) __attribute__((always_inline)) {
+                desc.second.permission = dstChunk.second.permission;
                 desc.second.attributes.isBorrowed = false;
                 MapInternal(desc);
             });
 
-            std::memcpy(source.data() + (dstChunk->first - destination.data()), dstChunk->first, dstChunk->second.size);
+            std::memcpy(source.data() + (dstChunk.first - destination.data()), dstChunk.first, dstChunk.second.size);
         }
     }
 
@@ -556,13 +448,10 @@ namespace skyline::kernel {
         std::shared_lock lock{mutex};
         size_t size{};
 
-        auto currChunk = chunks.lower_bound(heap.data());
-
-        while (currChunk->first < heap.end().base()) {
-            if (currChunk->second.state == memory::states::Heap)
-                size += currChunk->second.size;
-            ++currChunk;
-        }
+        ForeachChunkInRange(heap, [&](const std::pair<u8 *, ChunkDescriptor> &chunk) {
+            if (chunk.second.state == memory::states::Heap)
+                size += chunk.second.size;
+        });
 
         return size + code.size() + state.process->mainThreadStack.size();
     }
@@ -570,6 +459,10 @@ namespace skyline::kernel {
     size_t MemoryManager::GetSystemResourceUsage() {
         std::shared_lock lock{mutex};
         constexpr size_t KMemoryBlockSize{0x40};
-        return std::min(static_cast<size_t>(state.process->npdm.meta.systemResourceSize), util::AlignUp(chunks.size() * KMemoryBlockSize, constant::PageSize));
+        size_t blockCount{};
+        ForeachChunkInRange(addressSpace, [&](const std::pair<u8 *, ChunkDescriptor> &) {
+            blockCount++;
+        });
+        return std::min(static_cast<size_t>(state.process->npdm.meta.systemResourceSize), util::AlignUp(blockCount * KMemoryBlockSize, constant::PageSize));
     }
 }
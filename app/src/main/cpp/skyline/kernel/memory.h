@@ -6,7 +6,7 @@
 #include <sys/mman.h>
 #include <common.h>
 #include <common/file_descriptor.h>
-#include <map>
+#include <common/segment_table.h>
 
 namespace skyline {
     namespace kernel::type {
@@ -207,15 +207,52 @@ namespace skyline {
     }
 
     namespace kernel {
+        /**
+         * @brief A run of contiguous pages in the guest address space which share the same state, this is what svcQueryMemory reports as a single block
+         */
         struct ChunkDescriptor {
-            bool isSrcMergeDisallowed;
             memory::Permission permission;
             memory::MemoryAttribute attributes;
             memory::MemoryState state;
             size_t size;
+        };
+
+        /**
+         * @brief The state of a single page in the guest address space in a trivial form that can be stored in a page table
+         */
+        struct PageDescriptor {
+            u32 state; //!< The raw value of the page's memory::MemoryState
+            u8 permission; //!< The raw value of the page's memory::Permission
+            u8 attributes; //!< The raw value of the page's memory::MemoryAttribute
+
+            constexpr PageDescriptor() = default;
+
+            constexpr PageDescriptor(const ChunkDescriptor &chunk) : state{chunk.state.value}, permission{chunk.permission.raw}, attributes{chunk.attributes.value} {}
+
+            constexpr bool operator==(const PageDescriptor &) const = default;
+
+            /**
+             * @return A descriptor of a chunk of the supplied size with the state of this page
+             */
+            constexpr ChunkDescriptor GetChunk(size_t size) const {
+                return ChunkDescriptor{
+                    .permission = memory::Permission{permission},
+                    .attributes = memory::MemoryAttribute{attributes},
+                    .state = memory::MemoryState{state},
+                    .size = size,
+                };
+            }
 
-            constexpr bool IsCompatible(const ChunkDescriptor &chunk) const noexcept {
-                return chunk.permission == permission && chunk.state.value == state.value && chunk.attributes.value == attributes.value && !isSrcMergeDisallowed;
+            constexpr memory::MemoryState GetState() const {
+                return memory::MemoryState{state};
+            }
+
+            constexpr memory::Permission GetPermission() const {
+                return memory::Permission{permission};
+            }
+
+            constexpr memory::MemoryAttribute GetAttributes() const {
+                return memory::MemoryAttribute{attributes};
             }
         };
 
@@ -225,14 +262,24 @@ namespace skyline {
         class MemoryManager {
           private:
             const DeviceState &state;
-            std::map<u8 *, ChunkDescriptor> chunks;
+            static constexpr size_t PageTableL2Bits{21}; //!< The amount of AS (in bytes) a single L2 entry of the page table covers (2 MiB == 1 << 21), this matches the HOS region alignment
+            SegmentTable<PageDescriptor, constant::AddressSpaceSize, constant::PageSizeBits, PageTableL2Bits> pageTable; //!< A table of the state of every page in the address space, contiguous pages with the same state are only coalesced into chunks by queries which require the bounds of a chunk
 
             std::vector<std::shared_ptr<type::KMemory>> memRefs;
 
             void MapInternal(const std::pair<u8 *, ChunkDescriptor> &newDesc);
 
+            /**
+             * @brief Calls the supplied function with every chunk in the range, the chunks are clipped to the range
+             */
             void ForeachChunkInRange(span<u8> memory, auto editCallback);
 
+            /**
+             * @return The chunk containing the supplied address, it's clipped to the supplied limits
+             * @note `mutex` **must** be locked when calling this
+             */
+            std::pair<u8 *, ChunkDescriptor> GetChunkInRange(u8 *addr, u8 *lowerLimit, u8 *upperLimit);
+
           public:
             memory::AddressSpaceType addressSpaceType{};
             span<u8> addressSpace{}; //!< The entire address space
@@ -292,10 +339,16 @@ namespace skyline {
             void SetRegionPermission(span<u8> memory, memory::Permission permission);
 
             /**
-             * @brief Gets the highest chunk's descriptor that contains this address
+             * @brief Gets the chunk that contains this address, this coalesces all pages around the address with the same state as it
+             * @note This is only required for queries of the bounds of a chunk such as svcQueryMemory, GetPage should be used for anything else
              */
             std::optional<std::pair<u8 *, ChunkDescriptor>> GetChunk(u8 *addr);
 
+            /**
+             * @brief Gets the state of the page that contains this address in O(1)
+             */
+            std::optional<PageDescriptor> GetPage(u8 *addr);
+
             // Various mapping functions for use by the guest, argument validity must be checked by the caller
             void MapCodeMemory(span<u8> memory, memory::Permission permission);
 
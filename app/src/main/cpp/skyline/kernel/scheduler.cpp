@@ -10,6 +10,49 @@
 namespace skyline::kernel {
     Scheduler::CoreContext::CoreContext(u8 id, i8 preemptionPriority) : id(id), preemptionPriority(preemptionPriority) {}
 
+    bool Scheduler::CoreContext::Empty() const {
+        return !priorityMask.load(std::memory_order_relaxed);
+    }
+
+    type::KThread *Scheduler::CoreContext::Front() const {
+        u64 mask{priorityMask.load(std::memory_order_relaxed)};
+        return mask ? queues[static_cast<size_t>(std::countr_zero(mask))].front().thread : nullptr;
+    }
+
+    type::KThread *Scheduler::CoreContext::Next(const type::KThread &thread) const {
+        const auto &link{thread.schedulerLink};
+        const auto &queue{queues[static_cast<size_t>(link.priority)]};
+        if (auto it{std::next(queue.iterator_to(link))}; it != queue.end())
+            return it->thread;
+
+        // If the thread is at the back of its own priority's queue then the next thread is at the front of the next lower priority queue
+        u64 mask{priorityMask.load(std::memory_order_relaxed) & ~((2ULL << link.priority) - 1)};
+        return mask ? queues[static_cast<size_t>(std::countr_zero(mask))].front().thread : nullptr;
+    }
+
+    void Scheduler::CoreContext::PushBack(type::KThread &thread, i8 priority) {
+        auto &link{thread.schedulerLink};
+        link.priority = priority;
+        link.timeslice = thread.averageTimeslice ? thread.averageTimeslice : 1UL;
+
+        queues[static_cast<size_t>(priority)].push_back(link);
+        queueTimeslices[static_cast<size_t>(priority)] += link.timeslice;
+        priorityMask.store(priorityMask.load(std::memory_order_relaxed) | (1ULL << priority), std::memory_order_relaxed);
+    }
+
+    bool Scheduler::CoreContext::Remove(type::KThread &thread) {
+        bool wasFront{Front() == &thread};
+
+        auto &link{thread.schedulerLink};
+        auto &queue{queues[static_cast<size_t>(link.priority)]};
+        queue.erase(queue.iterator_to(link));
+        queueTimeslices[static_cast<size_t>(link.priority)] -= link.timeslice;
+        if (queue.empty())
+            priorityMask.store(priorityMask.load(std::memory_order_relaxed) & ~(1ULL << link.priority), std::memory_order_relaxed);
+
+        return wasFront;
+    }
+
     Scheduler::Scheduler(const DeviceState &state) : state(state) {}
 
     void Scheduler::SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls) {
@@ -33,7 +76,7 @@ namespace skyline::kernel {
     Scheduler::CoreContext &Scheduler::GetOptimalCoreForThread(const std::shared_ptr<type::KThread> &thread) {
         auto *currentCore{&cores.at(thread->coreId)};
 
-        if (!currentCore->queue.empty() && thread->affinityMask.count() != 1) {
+        if (!currentCore->Empty() && thread->affinityMask.count() != 1) {
             // Select core where the current thread will be scheduled the earliest based off average timeslice durations for resident threads
             // There's a preference for the current core as migration isn't free
             size_t minTimeslice{};
@@ -42,12 +85,10 @@ namespace skyline::kernel {
                 if (thread->affinityMask.test(candidateCore.id)) {
                     u64 timeslice{};
 
-                    if (!candidateCore.queue.empty()) {
+                    if (!candidateCore.Empty()) {
                         std::scoped_lock coreLock{candidateCore.mutex};
 
-                        auto threadIterator{candidateCore.queue.cbegin()};
-                        if (threadIterator != candidateCore.queue.cend()) {
-                            const auto &runningThread{*threadIterator};
+                        if (auto runningThread{candidateCore.Front()}) {
                             timeslice += [&]() {
                                 if (runningThread->averageTimeslice)
                                     return std::min(runningThread->averageTimeslice - (util::GetTimeTicks() - runningThread->timesliceStart), 1UL);
@@ -57,11 +98,12 @@ namespace skyline::kernel {
                                     return 1UL;
                             }();
 
-                            while (++threadIterator != candidateCore.queue.cend()) {
-                                const auto &residentThread{*threadIterator};
-                                if (residentThread->priority <= thread->priority)
-                                    timeslice += residentThread->averageTimeslice ? residentThread->averageTimeslice : 1UL;
-                            }
+                            // The resident threads which would run prior to this thread are accounted for by the timeslice sums of all queues with an equal or higher priority
+                            u64 mask{candidateCore.priorityMask.load(std::memory_order_relaxed) & ((2ULL << thread->priority) - 1)};
+                            for (; mask; mask &= mask - 1)
+                                timeslice += candidateCore.queueTimeslices[static_cast<size_t>(std::countr_zero(mask))];
+                            if (runningThread->schedulerLink.priority <= thread->priority)
+                                timeslice -= runningThread->schedulerLink.timeslice;
                         }
                     }
 
@@ -85,14 +127,14 @@ namespace skyline::kernel {
         return *currentCore;
     }
 
-    void Scheduler::YieldThread(const std::shared_ptr<type::KThread> &thread) {
-        if (state.thread != thread) {
+    void Scheduler::YieldThread(type::KThread &thread) {
+        if (state.thread.get() != &thread) {
             // If another thread is being yielded, we need to send it an OS signal to yield
-            if (!thread->pendingYield) {
+            if (!thread.pendingYield) {
                 // We only want to yield the thread if it hasn't already been sent a signal to yield in the past
                 // Not doing this can lead to races and deadlocks but is also slower as it prevents redundant signals
-                thread->SendSignal(YieldSignal);
-                thread->pendingYield = true;
+                thread.SendSignal(YieldSignal);
+                thread.pendingYield = true;
             }
         } else {
             // If the calling thread is being yielded, we can just set the YieldPending flag
@@ -101,6 +143,22 @@ namespace skyline::kernel {
         }
     }
 
+    void Scheduler::PreemptFront(CoreContext &core, type::KThread &thread) {
+        // We can yield the thread which is currently scheduled on the core by sending it a signal
+        // It is optimized to avoid waiting for the thread to yield on receiving the signal which serializes the entire pipeline
+        auto front{core.Front()};
+        front->forceYield = true;
+        core.Remove(*front);
+        core.PushBack(*front, front->priority);
+        core.PushBack(thread, thread.priority);
+
+        auto newFront{core.Front()};
+        if (newFront != state.thread.get())
+            newFront->scheduleCondition.notify(); // We only want to trigger the conditional variable if the current thread isn't the one being scheduled
+
+        YieldThread(*front);
+    }
+
     void Scheduler::InsertThread(const std::shared_ptr<type::KThread> &thread) {
         std::scoped_lock migrationLock{thread->coreMigrationMutex};
         auto &core{cores.at(thread->coreId)};
@@ -112,48 +170,33 @@ namespace skyline::kernel {
             return;
         }
 
-        #ifndef NDEBUG
-        // Scan the queue for the same thread to prevent double insertion
-        for (auto &residentThread : core.queue) {
-            if (residentThread == thread) {
-                Logger::Error("T{} already exists in C{}", thread->id, core.id);
-                Logger::EmulationContext.Flush();
-            }
+        if (thread->schedulerLink.is_linked()) [[unlikely]] {
+            // A thread that's linked into a queue cannot be linked again without corrupting the queue
+            Logger::Error("T{} already exists in C{}", thread->id, core.id);
+            Logger::EmulationContext.Flush();
+            return;
         }
-        #endif
-
-        auto nextThread{std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
-        if (nextThread == core.queue.begin()) {
-            if (nextThread != core.queue.end()) {
-                // If the inserted thread has a higher priority than the currently running thread (and the queue isn't empty)
-                // We can yield the thread which is currently scheduled on the core by sending it a signal
-                // It is optimized to avoid waiting for the thread to yield on receiving the signal which serializes the entire pipeline
-                auto front{core.queue.front()};
-                front->forceYield = true;
-                core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), front->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
-                core.queue.push_front(thread);
-
-                YieldThread(front);
-            } else {
-                core.queue.push_front(thread);
-            }
-            if (thread != state.thread)
-                thread->scheduleCondition.notify(); // We only want to trigger the conditional variable if the current thread isn't inserting itself
+
+        auto front{core.Front()};
+        if (front && thread->priority < front->priority) {
+            // If the inserted thread has a higher priority than the currently running thread (and the queue isn't empty)
+            PreemptFront(core, *thread);
         } else {
-            core.queue.insert(nextThread, thread);
+            core.PushBack(*thread, thread->priority);
+            if (core.Front() == thread.get() && thread != state.thread)
+                thread->scheduleCondition.notify(); // We only want to trigger the conditional variable if the current thread isn't inserting itself
         }
     }
 
     void Scheduler::MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<SpinLock> &lock) {
+        TRACE_EVENT("scheduler", "MigrateToCore");
+
         // We need to check if the thread was in its resident core's queue
         // If it was, we need to remove it from the queue
-        auto it{std::find(currentCore->queue.begin(), currentCore->queue.end(), thread)};
-        bool wasInserted{it != currentCore->queue.end()};
-        if (wasInserted) {
-            it = currentCore->queue.erase(it);
-            if (it == currentCore->queue.begin() && it != currentCore->queue.end())
-                (*it)->scheduleCondition.notify();
-        }
+        bool wasInserted{thread->schedulerLink.is_linked()};
+        if (wasInserted && currentCore->Remove(*thread))
+            if (auto front{currentCore->Front()})
+                front->scheduleCondition.notify();
         lock.unlock();
 
         thread->coreId = targetCore->id;
@@ -178,7 +221,7 @@ namespace skyline::kernel {
                 if (!thread->affinityMask.test(thread->coreId)) // We need to retest in case the thread was migrated while the core was unlocked
                     MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return core->Front() == thread.get();
         }};
 
         TRACE_EVENT("scheduler", "WaitSchedule");
@@ -216,7 +259,7 @@ namespace skyline::kernel {
                 std::scoped_lock migrationLock{thread->coreMigrationMutex};
                 MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return core->Front() == thread.get();
         })) {
             if (thread->priority == core->preemptionPriority)
                 thread->ArmPreemptionTimer(PreemptiveTimeslice);
@@ -233,23 +276,25 @@ namespace skyline::kernel {
         auto &thread{state.thread};
         auto &core{cores.at(thread->coreId)};
 
+        TRACE_EVENT("scheduler", "Rotate");
         std::unique_lock lock(core.mutex);
 
-        if (core.queue.front() == thread) {
+        thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
+
+        if (core.Front() == thread.get()) {
             // If this thread is at the front of the thread queue then we need to rotate the thread
             // In the case where this thread was forcefully yielded, we don't need to do this as it's done by the thread which yielded to this thread
-            // Splice the linked element from the beginning of the queue to where its priority is present
-            core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
+            // Relink the thread to the back of the queue for its current priority, this also accounts for any priority changes while it was running
+            core.Remove(*thread);
+            core.PushBack(*thread, thread->priority);
 
-            auto &front{core.queue.front()};
-            if (front != thread)
+            auto front{core.Front()};
+            if (front != thread.get())
                 front->scheduleCondition.notify(); // If we aren't at the front of the queue, only then should we wake the thread at the front up
         } else if (!thread->forceYield) {
             throw exception("T{} called Rotate while not being in C{}'s queue", thread->id, thread->coreId);
         }
 
-        thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
-
         thread->DisarmPreemptionTimer(); // If a preemptive thread did a cooperative yield then we need to disarm the preemptive timer
         thread->pendingYield = false;
         thread->forceYield = false;
@@ -262,16 +307,14 @@ namespace skyline::kernel {
             std::unique_lock lock(core.mutex);
 
             if (!thread->isPaused) {
-                auto it{std::find(core.queue.begin(), core.queue.end(), thread)};
-                if (it != core.queue.end()) {
-                    it = core.queue.erase(it);
-                    if (it == core.queue.begin()) {
+                if (thread->schedulerLink.is_linked()) {
+                    if (core.Remove(*thread)) {
                         // We need to update the averageTimeslice accordingly, if we've been unscheduled by this
                         if (thread->timesliceStart)
                             thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
-                        if (it != core.queue.end())
-                            (*it)->scheduleCondition.notify(); // We need to wake the thread at the front of the queue, if we were at the front previously
+                        if (auto front{core.Front()})
+                            front->scheduleCondition.notify(); // We need to wake the thread at the front of the queue, if we were at the front previously
                     }
                 } else {
                     Logger::Warn("T{} was not in C{}'s queue", thread->id, thread->coreId);
@@ -292,13 +335,20 @@ namespace skyline::kernel {
         auto *core{&cores.at(thread->coreId)};
         std::unique_lock coreLock(core->mutex);
 
-        auto currentIt{std::find(core->queue.begin(), core->queue.end(), thread)}, nextIt{std::next(currentIt)};
-        if (currentIt == core->queue.end()) {
+        auto front{core->Front()};
+        if (!thread->schedulerLink.is_linked()) {
             return;
-        } else if (currentIt == core->queue.begin()) {
+        } else if (front == thread.get()) {
             // Alternatively, if it's currently running then we'd just want to yield if there's a higher priority thread to run instead
-            if (nextIt != core->queue.end() && (*nextIt)->priority < thread->priority) {
-                YieldThread(thread);
+            // The running thread stays linked into the queue of its prior priority till it's rotated so it remains at the front, unless its priority was raised which keeps it at the front regardless
+            if (thread->priority < thread->schedulerLink.priority) {
+                core->Remove(*thread);
+                core->PushBack(*thread, thread->priority);
+            }
+
+            auto nextThread{core->Next(*thread)};
+            if (nextThread && nextThread->priority < thread->priority) {
+                YieldThread(*thread);
             } else if (!thread->isPreempted && thread->priority == core->preemptionPriority) {
                 // If the thread needs to be preempted due to its new priority then arm its preemption timer
                 thread->ArmPreemptionTimer(PreemptiveTimeslice);
@@ -306,16 +356,15 @@ namespace skyline::kernel {
                 // If the thread no longer needs to be preempted due to its new priority then disarm its preemption timer
                 thread->DisarmPreemptionTimer();
             }
-        } else if (thread->priority < (*std::prev(currentIt))->priority || (nextIt != core->queue.end() && thread->priority > (*nextIt)->priority)) {
-            // If the thread is in the queue and it's position is affected by the priority change then need to remove and re-insert the thread
-            core->queue.erase(currentIt);
-
-            auto targetIt{std::upper_bound(core->queue.begin(), core->queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
-            if (targetIt == core->queue.begin() && targetIt != core->queue.end()) {
-                core->queue.insert(std::next(core->queue.begin()), thread);
-                YieldThread(core->queue.front());
+        } else if (thread->priority != thread->schedulerLink.priority) {
+            // If the thread is in the queue and its priority has changed then it needs to be relinked into the queue for its new priority
+            core->Remove(*thread);
+
+            if (thread->priority < front->priority) {
+                // If it now has a higher priority than the running thread then it needs to preempt it
+                PreemptFront(*core, *thread);
             } else {
-                core->queue.insert(targetIt, thread);
+                core->PushBack(*thread, thread->priority);
             }
         }
     }
@@ -323,7 +372,7 @@ namespace skyline::kernel {
     void Scheduler::UpdateCore(const std::shared_ptr<type::KThread> &thread) {
         auto *core{&cores.at(thread->coreId)};
         std::scoped_lock coreLock{core->mutex};
-        if (core->queue.front() == thread)
+        if (core->Front() == thread.get())
             thread->SendSignal(YieldSignal);
         else
             thread->scheduleCondition.notify();
@@ -331,13 +380,14 @@ namespace skyline::kernel {
 
     void Scheduler::ParkThread() {
         auto &thread{state.thread};
+        TRACE_EVENT("scheduler", "ParkThread");
         std::scoped_lock migrationLock{thread->coreMigrationMutex};
         RemoveThread();
 
         auto originalCoreId{thread->coreId};
         thread->coreId = constant::ParkedCoreId;
         for (auto &core : cores)
-            if (originalCoreId != core.id && thread->affinityMask.test(core.id) && (core.queue.empty() || core.queue.front()->priority > thread->priority))
+            if (originalCoreId != core.id && thread->affinityMask.test(core.id) && (core.Empty() || std::countr_zero(core.priorityMask.load(std::memory_order_relaxed)) > thread->priority))
                 thread->coreId = core.id;
 
         if (thread->coreId == constant::ParkedCoreId) {
@@ -355,8 +405,9 @@ namespace skyline::kernel {
             auto &thread{state.thread};
             auto &core{cores.at(thread->coreId)};
             std::unique_lock coreLock(core.mutex);
-            auto nextThread{core.queue.size() > 1 ? *std::next(core.queue.begin()) : nullptr};
-            nextThread = nextThread->priority == thread->priority ? nextThread : nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
+            auto nextThread{thread->schedulerLink.is_linked() ? core.Next(*thread) : nullptr};
+            if (nextThread && nextThread->priority != thread->priority)
+                nextThread = nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
             auto parkedThread{parkedQueue.front()};
 
             // We need to be conservative about waking up a parked thread, it should only be done if its priority is higher than the current thread
@@ -375,17 +426,15 @@ namespace skyline::kernel {
 
         thread->isPaused = true;
 
-        auto it{std::find(core->queue.begin(), core->queue.end(), thread)};
-        if (it != core->queue.end()) {
+        if (thread->schedulerLink.is_linked()) {
             thread->insertThreadOnResume = true; // If we're handling removing the thread then we need to be responsible for inserting it back inside ResumeThread
 
-            it = core->queue.erase(it);
-            if (it == core->queue.begin() && it != core->queue.end())
-                (*it)->scheduleCondition.notify();
+            if (core->Remove(*thread)) {
+                if (auto front{core->Front()})
+                    front->scheduleCondition.notify();
 
-            if (it == core->queue.begin()) {
                 // We need to send a yield signal to the thread if it's currently running
-                YieldThread(thread);
+                YieldThread(*thread);
                 thread->forceYield = true;
             }
         } else {
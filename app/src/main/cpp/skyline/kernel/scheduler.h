@@ -6,6 +6,7 @@
 #include "common/spin_lock.h"
 #include <common.h>
 #include <condition_variable>
+#include <boost/intrusive/list.hpp>
 
 namespace skyline {
     namespace constant {
@@ -36,6 +37,17 @@ namespace skyline {
             }
         };
 
+        constexpr u8 PriorityCount{std::numeric_limits<u64>::digits}; //!< The amount of distinct scheduler priorities, this corresponds to the bits of a priority bitmask
+
+        /**
+         * @brief An intrusive link for a thread in the run queue of a core, every KThread embeds one of these as it can only be resident on a single core at once
+         */
+        struct SchedulerLink : public boost::intrusive::list_base_hook<> {
+            type::KThread *thread; //!< The thread which this link belongs to
+            i8 priority; //!< The priority of the queue that the thread is linked into, this may differ from the thread's priority while it is running till it's rotated
+            u64 timeslice; //!< The timeslice estimate that this thread contributed to the load of its core when it was linked
+        };
+
         /**
          * @brief The Scheduler is responsible for determining which threads should run on which virtual cores and when they should be scheduled
          * @note We tend to stray a lot from HOS in our scheduler design as we've designed it around our 1 host thread per guest thread which leads to scheduling from the perspective of threads while the HOS scheduler deals with scheduling from the perspective of cores, not doing this would lead to missing out on key optimizations and serialization of scheduling
@@ -44,13 +56,44 @@ namespace skyline {
           private:
             const DeviceState &state;
 
+            /**
+             * @brief The run queue of a single core, threads are split into a FIFO queue per priority with a bitmask of non-empty queues akin to HOS's KPriorityQueue
+             * @note The thread at the front of the queue with the highest priority is the one that's running or to be run on this core
+             */
             struct CoreContext {
                 u8 id;
                 i8 preemptionPriority; //!< The priority at which this core becomes preemptive as opposed to cooperative
-                SpinLock mutex; //!< Synchronizes all operations on the queue
-                std::list<std::shared_ptr<type::KThread>> queue; //!< A queue of threads which are running or to be run on this core
+                SpinLock mutex; //!< Synchronizes all operations on the queues
+                std::array<boost::intrusive::list<SchedulerLink, boost::intrusive::constant_time_size<false>>, PriorityCount> queues; //!< A queue for every priority of threads which are running or to be run on this core
+                std::array<u64, PriorityCount> queueTimeslices{}; //!< The sum of the timeslice estimates of all threads in the queue for every priority
+                std::atomic<u64> priorityMask{}; //!< A bitmask of priorities with non-empty queues, this is only modified with the mutex held but may be read without it as an estimate
 
                 CoreContext(u8 id, i8 preemptionPriority);
+
+                bool Empty() const;
+
+                /**
+                 * @return The thread which is running or to be run next on this core or nullptr if there's no threads in the queue
+                 * @note The mutex **must** be locked by the calling thread
+                 */
+                type::KThread *Front() const;
+
+                /**
+                 * @return The thread which follows the supplied thread in the queue or nullptr if it's at the back
+                 * @note The mutex **must** be locked by the calling thread and the supplied thread **must** be in the queue
+                 */
+                type::KThread *Next(const type::KThread &thread) const;
+
+                /**
+                 * @brief Links the thread at the back of the queue for the supplied priority
+                 */
+                void PushBack(type::KThread &thread, i8 priority);
+
+                /**
+                 * @brief Unlinks the thread from the queue it's in
+                 * @return If the thread was at the front of the queue prior to being removed
+                 */
+                bool Remove(type::KThread &thread);
             };
 
             std::array<CoreContext, constant::CoreCount> cores{CoreContext(0, 59), CoreContext(1, 59), CoreContext(2, 59), CoreContext(3, 63)};
@@ -68,7 +111,13 @@ namespace skyline {
             /**
              * @brief Trigger a thread to yield via a signal or on SVC exit if it is the current thread
              */
-            void YieldThread(const std::shared_ptr<type::KThread> &thread);
+            void YieldThread(type::KThread &thread);
+
+            /**
+             * @brief Forcefully yields the thread at the front of the core's queue and links the supplied thread to run in its place
+             * @note The core's mutex **must** be locked by the calling thread and the supplied thread **must** have a higher priority than the current front
+             */
+            void PreemptFront(CoreContext &core, type::KThread &thread);
 
           public:
             static constexpr std::chrono::milliseconds PreemptiveTimeslice{10}; //!< The duration of time a preemptive thread can run before yielding
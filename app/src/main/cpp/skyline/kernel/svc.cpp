@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <boost/container/static_vector.hpp>
 #include <os.h>
 #include <nce.h>
 #include <kernel/types/KProcess.h>
@@ -71,10 +72,10 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto chunk{state.process->memory.GetChunk(address).value()};
-        if (!chunk.second.state.permissionChangeAllowed) [[unlikely]] {
+        auto page{state.process->memory.GetPage(address).value()};
+        if (!page.GetState().permissionChangeAllowed) [[unlikely]] {
             state.ctx->gpr.w0 = result::InvalidState;
-            Logger::Warn("Permission change not allowed for chunk at: 0x{:X}, state: 0x{:X}", chunk.first, chunk.second.state.value);
+            Logger::Warn("Permission change not allowed for chunk at: 0x{:X}, state: 0x{:X}", address, page.state);
             return;
         }
 
@@ -115,12 +116,12 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto chunk{state.process->memory.GetChunk(address).value()};
+        auto page{state.process->memory.GetPage(address).value()};
 
         // We only check the first found chunk for whatever reason.
-        if (!chunk.second.state.attributeChangeAllowed) [[unlikely]] {
+        if (!page.GetState().attributeChangeAllowed) [[unlikely]] {
             state.ctx->gpr.w0 = result::InvalidState;
-            Logger::Warn("Attribute change not allowed for chunk: 0x{:X}", chunk.first);
+            Logger::Warn("Attribute change not allowed for chunk: 0x{:X}", address);
             return;
         }
 
@@ -165,10 +166,10 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto chunk{state.process->memory.GetChunk(source)};
-        if (!chunk->second.state.mapAllowed) [[unlikely]] {
+        auto page{state.process->memory.GetPage(source)};
+        if (!page->GetState().mapAllowed) [[unlikely]] {
             state.ctx->gpr.w0 = result::InvalidState;
-            Logger::Warn("Source doesn't allow usage of svcMapMemory: 'source': 0x{:X}, 'size': 0x{:X}, MemoryState: 0x{:X}", source, size, chunk->second.state.value);
+            Logger::Warn("Source doesn't allow usage of svcMapMemory: 'source': 0x{:X}, 'size': 0x{:X}, MemoryState: 0x{:X}", source, size, page->state);
             return;
         }
 
@@ -656,10 +657,8 @@ namespace skyline::kernel::svc {
     }
 
     void WaitSynchronization(const DeviceState &state) {
-        constexpr u8 MaxSyncHandles{0x40}; // The total amount of handles that can be passed to WaitSynchronization
-
         u32 numHandles{state.ctx->gpr.w2};
-        if (numHandles > MaxSyncHandles) {
+        if (numHandles > type::KSyncObject::MaxSyncHandles) {
             state.ctx->gpr.w0 = result::OutOfRange;
             return;
         }
@@ -698,90 +697,34 @@ namespace skyline::kernel::svc {
 
         TRACE_EVENT_FMT("kernel", waitHandles.size() == 1 ? "WaitSynchronization 0x{:X}" : "WaitSynchronizationMultiple 0x{:X}", waitHandles[0]);
 
-        std::unique_lock lock(type::KSyncObject::syncObjectMutex);
-        if (state.thread->cancelSync) {
-            state.thread->cancelSync = false;
-            state.ctx->gpr.w0 = result::Cancelled;
-            return;
-        }
-
-        u32 index{};
-        for (const auto &object : objectTable) {
-            if (object->signalled) {
-                Logger::Debug("Signalled 0x{:X}", waitHandles[index]);
-                state.ctx->gpr.w0 = Result{};
-                state.ctx->gpr.w1 = index;
-                return;
-            }
-            index++;
-        }
-
-        if (timeout == 0) {
-            Logger::Debug("No handle is currently signalled");
-            state.ctx->gpr.w0 = result::TimedOut;
-            return;
-        }
-
-        auto priority{state.thread->priority.load()};
+        boost::container::static_vector<type::KSyncObject *, type::KSyncObject::MaxSyncHandles> objects;
         for (const auto &object : objectTable)
-            object->syncObjectWaiters.insert(std::upper_bound(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), priority, type::KThread::IsHigherPriority), state.thread);
-
-        state.thread->isCancellable = true;
-        state.thread->wakeObject = nullptr;
-        state.scheduler->RemoveThread();
-
-        lock.unlock();
-        if (timeout > 0)
-            state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout));
-        else
-            state.scheduler->WaitSchedule(false);
-        lock.lock();
-
-        state.thread->isCancellable = false;
-        auto wakeObject{state.thread->wakeObject};
-
-        u32 wakeIndex{};
-        index = 0;
-        for (const auto &object : objectTable) {
-            if (object.get() == wakeObject)
-                wakeIndex = index;
-
-            auto it{std::find(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), state.thread)};
-            if (it != object->syncObjectWaiters.end())
-                object->syncObjectWaiters.erase(it);
-            else
-                throw exception("svcWaitSynchronization: An object (0x{:X}) has been removed from the syncObjectWaiters queue incorrectly", waitHandles[index]);
+            objects.push_back(object.get());
 
-            index++;
-        }
-
-        if (wakeObject) {
-            Logger::Debug("Signalled 0x{:X}", waitHandles[wakeIndex]);
+        auto waitResult{type::KSyncObject::WaitForAny(state, span<type::KSyncObject *>{objects.data(), objects.size()}, timeout)};
+        if (waitResult) {
+            Logger::Debug("Signalled 0x{:X}", waitHandles[*waitResult]);
             state.ctx->gpr.w0 = Result{};
-            state.ctx->gpr.w1 = wakeIndex;
-        } else if (state.thread->cancelSync) {
-            state.thread->cancelSync = false;
-            Logger::Debug("Wait has been cancelled");
-            state.ctx->gpr.w0 = result::Cancelled;
+            state.ctx->gpr.w1 = *waitResult;
         } else {
-            Logger::Debug("Wait has timed out");
-            state.ctx->gpr.w0 = result::TimedOut;
-            lock.unlock();
-            state.scheduler->InsertThread(state.thread);
-            state.scheduler->WaitSchedule();
+            auto error{static_cast<Result>(waitResult)};
+            if (error == result::Cancelled)
+                Logger::Debug("Wait has been cancelled");
+            else if (timeout == 0)
+                Logger::Debug("No handle is currently signalled");
+            else
+                Logger::Debug("Wait has timed out");
+            state.ctx->gpr.w0 = error;
         }
     }
 
     void CancelSynchronization(const DeviceState &state) {
         try {
-            std::unique_lock lock(type::KSyncObject::syncObjectMutex);
             auto thread{state.process->GetHandle<type::KThread>(state.ctx->gpr.w0)};
             Logger::Debug("Cancelling Synchronization {}", thread->id);
             thread->cancelSync = true;
-            if (thread->isCancellable) {
-                thread->isCancellable = false;
+            if (thread->isCancellable.exchange(false))
                 state.scheduler->InsertThread(thread);
-            }
             state.ctx->gpr.w0 = Result{};
         } catch (const std::out_of_range &) {
             Logger::Warn("'handle' invalid: 0x{:X}", static_cast<u32>(state.ctx->gpr.w0));
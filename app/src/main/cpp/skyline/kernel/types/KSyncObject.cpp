@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <boost/container/static_vector.hpp>
+#include <kernel/results.h>
 #include "KSyncObject.h"
 #include "KThread.h"
 
@@ -9,10 +11,11 @@ namespace skyline::kernel::type {
         std::scoped_lock lock{syncObjectMutex};
         signalled = true;
         for (auto &waiter : syncObjectWaiters) {
-            if (waiter->isCancellable) {
-                waiter->isCancellable = false;
-                waiter->wakeObject = this;
-                state.scheduler->InsertThread(waiter);
+            // A thread may be waiting on multiple objects, only the first object (or cancellation) to claim it is responsible for waking it up
+            auto thread{waiter.thread};
+            if (thread->isCancellable.exchange(false)) {
+                thread->wakeObject = this;
+                state.scheduler->InsertThread(thread->shared_from_this());
             }
         }
     }
@@ -25,4 +28,85 @@ namespace skyline::kernel::type {
         }
         return false;
     }
+
+    void KSyncObject::AddWaiter(SyncWaiter &waiter) {
+        auto priority{waiter.thread->priority.load()};
+        auto it{std::find_if(syncObjectWaiters.begin(), syncObjectWaiters.end(), [priority](const SyncWaiter &other) {
+            return priority < other.thread->priority; // Equivalent to KThread::IsHigherPriority, threads are inserted after any threads of the same priority
+        })};
+        syncObjectWaiters.insert(it, waiter);
+    }
+
+    void KSyncObject::RemoveWaiter(SyncWaiter &waiter) {
+        syncObjectWaiters.erase(syncObjectWaiters.iterator_to(waiter));
+    }
+
+    ResultValue<u32> KSyncObject::WaitForAny(const DeviceState &state, span<KSyncObject *> objects, i64 timeout) {
+        if (state.thread->cancelSync.exchange(false))
+            return result::Cancelled;
+
+        // All objects are locked in order of their address to avoid deadlocks with other threads waiting on an overlapping set of objects, duplicate objects are only locked once
+        boost::container::static_vector<KSyncObject *, MaxSyncHandles> lockedObjects{objects.begin(), objects.end()};
+        std::sort(lockedObjects.begin(), lockedObjects.end());
+        lockedObjects.erase(std::unique(lockedObjects.begin(), lockedObjects.end()), lockedObjects.end());
+
+        auto lockObjects{[&] {
+            for (auto object : lockedObjects)
+                object->syncObjectMutex.lock();
+        }};
+        auto unlockObjects{[&] {
+            for (auto it{lockedObjects.rbegin()}; it != lockedObjects.rend(); it++)
+                (*it)->syncObjectMutex.unlock();
+        }};
+
+        lockObjects();
+
+        for (u32 index{}; index < objects.size(); index++) {
+            if (objects[index]->signalled) {
+                unlockObjects();
+                return index;
+            }
+        }
+
+        if (timeout == 0) {
+            unlockObjects();
+            return result::TimedOut;
+        }
+
+        for (size_t i{}; i < lockedObjects.size(); i++)
+            lockedObjects[i]->AddWaiter(state.thread->syncWaiters[i]);
+
+        state.scheduler->RemoveThread();
+        state.thread->wakeObject = nullptr;
+        state.thread->isCancellable = true;
+
+        // A cancellation doesn't lock any objects, if it raced with the thread becoming cancellable then the thread needs to wake itself up
+        if (state.thread->cancelSync && state.thread->isCancellable.exchange(false))
+            state.scheduler->InsertThread(state.thread);
+
+        unlockObjects();
+        if (timeout > 0)
+            state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout));
+        else
+            state.scheduler->WaitSchedule(false);
+        lockObjects();
+
+        // If the thread is still cancellable then nothing has woken it up and the wait has timed out
+        bool timedOut{state.thread->isCancellable.exchange(false)};
+        auto wakeObject{state.thread->wakeObject};
+
+        for (size_t i{}; i < lockedObjects.size(); i++)
+            lockedObjects[i]->RemoveWaiter(state.thread->syncWaiters[i]);
+
+        unlockObjects();
+
+        if (!timedOut && wakeObject)
+            return static_cast<u32>(std::distance(objects.begin(), std::find(objects.begin(), objects.end(), wakeObject)));
+        else if (!timedOut && state.thread->cancelSync.exchange(false))
+            return result::Cancelled;
+
+        state.scheduler->InsertThread(state.thread);
+        state.scheduler->WaitSchedule();
+        return result::TimedOut;
+    }
 }
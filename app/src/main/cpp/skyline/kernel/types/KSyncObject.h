@@ -3,17 +3,29 @@
 
 #pragma once
 
+#include <boost/intrusive/list.hpp>
 #include "KObject.h"
 
 namespace skyline::kernel::type {
+    class KThread;
+
+    /**
+     * @brief An intrusive link for a thread in the waiter queue of a single KSyncObject, every KThread embeds one of these for each object it can wait on at once
+     */
+    struct SyncWaiter : public boost::intrusive::list_base_hook<> {
+        KThread *thread{}; //!< The thread which this link belongs to
+    };
+
     /**
      * @brief KSyncObject is an abstract class which holds everything necessary for an object to be synchronizable
      * @note This abstraction is roughly equivalent to KSynchronizationObject on HOS
      */
     class KSyncObject : public KObject {
       public:
-        inline static std::mutex syncObjectMutex; //!< A global lock used for locking all signalling to avoid races
-        std::list<std::shared_ptr<KThread>> syncObjectWaiters; //!< A list of threads waiting on this object to be signalled
+        static constexpr u8 MaxSyncHandles{0x40}; //!< The total amount of handles that can be passed to WaitSynchronization
+
+        std::mutex syncObjectMutex; //!< Synchronizes the signalled state and the waiters of this object, when multiple objects are locked together they must be locked in order of their address
+        boost::intrusive::list<SyncWaiter, boost::intrusive::constant_time_size<false>> syncObjectWaiters; //!< A queue of threads waiting on this object to be signalled sorted by priority
         bool signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset)
 
         /**
@@ -32,6 +44,27 @@ namespace skyline::kernel::type {
          */
         bool ResetSignal();
 
+        /**
+         * @brief Inserts the link into the waiter queue in order of the priority of its thread
+         * @note `syncObjectMutex` **must** be locked when calling this
+         */
+        void AddWaiter(SyncWaiter &waiter);
+
+        /**
+         * @brief Removes the link from the waiter queue
+         * @note `syncObjectMutex` **must** be locked when calling this
+         */
+        void RemoveWaiter(SyncWaiter &waiter);
+
+        /**
+         * @brief Blocks the calling thread till any of the supplied objects are signalled, the timeout expires or the wait is cancelled
+         * @param objects The objects to wait on, these may contain duplicates and must be at most `MaxSyncHandles` long
+         * @param timeout The timeout in nanoseconds, 0 only checks if any object is signalled and a negative value denotes an infinite wait
+         * @return The index of the first signalled object or TimedOut/Cancelled
+         * @note This is the implementation of svcWaitSynchronization aside from the handle lookup
+         */
+        static ResultValue<u32> WaitForAny(const DeviceState &state, span<KSyncObject *> objects, i64 timeout);
+
         virtual ~KSyncObject() = default;
     };
 }
@@ -24,6 +24,10 @@ namespace skyline::kernel::type {
           coreId(idealCore),
           KSyncObject(state, KType::KThread) {
         affinityMask.set(coreId);
+        schedulerLink.thread = this;
+
+        for (auto &waiter : syncWaiters)
+            waiter.thread = this;
     }
 
     KThread::~KThread() {
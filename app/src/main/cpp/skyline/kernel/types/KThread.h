@@ -54,6 +54,7 @@ namespace skyline {
             u8 idealCore; //!< The ideal CPU core for this thread to run on
             u8 coreId; //!< The CPU core on which this thread is running
             CoreMask affinityMask{}; //!< A mask of CPU cores this thread is allowed to run on
+            SchedulerLink schedulerLink{}; //!< Links the thread into the run queue of its resident core, this is guarded by the core's mutex
 
             u64 timesliceStart{}; //!< A timestamp in host CNTVCT ticks of when the thread's current timeslice started
             u64 averageTimeslice{}; //!< A weighted average of the timeslice duration for this thread
@@ -71,9 +72,10 @@ namespace skyline {
             bool waitSignalled{}; //!< If the conditional variable has been signalled already
             Result waitResult; //!< The result of the wait operation
 
-            bool isCancellable{false}; //!< If the thread is currently in a position where it's cancellable
-            bool cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
+            std::atomic<bool> isCancellable{false}; //!< If the thread is currently in a position where it's cancellable, this is atomically exchanged by anything that wants to wake the thread so it's only woken once
+            std::atomic<bool> cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
             type::KSyncObject *wakeObject{}; //!< A pointer to the synchronization object responsible for waking this thread up
+            std::array<SyncWaiter, KSyncObject::MaxSyncHandles> syncWaiters; //!< Links into the waiter queues of every object that this thread is waiting on with SvcWaitSynchronization
 
             bool isPaused{false}; //!< If the thread is currently paused and not runnable
             bool insertThreadOnResume{false}; //!< If the thread should be inserted into the scheduler when it resumes (used for pausing threads during sleep/sync)
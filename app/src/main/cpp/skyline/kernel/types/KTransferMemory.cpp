@@ -12,11 +12,9 @@ namespace skyline::kernel::type {
         std::memcpy(host.data(), map.data(), map.size());
         u8 *result{KMemory::Map(map, permission)};
 
-        auto oldChunk{state.process->memory.GetChunk(map.data()).value()};
+        originalMapping = state.process->memory.GetPage(map.data()).value();
 
-        originalMapping = oldChunk.second;
-
-        if (!originalMapping.state.transferMemoryAllowed) [[unlikely]] {
+        if (!originalMapping.GetState().transferMemoryAllowed) [[unlikely]] {
             Logger::Warn("Tried to map transfer memory with incompatible state at: 0x{:X} (0x{:X} bytes)", map.data(), map.size());
             return nullptr;
         } else {
@@ -30,7 +28,7 @@ namespace skyline::kernel::type {
         KMemory::Unmap(map);
 
         guest = span<u8>{};
-        switch (originalMapping.state.type) {
+        switch (originalMapping.GetState().type) {
             case memory::MemoryType::CodeMutable:
                 state.process->memory.MapMutableCodeMemory(map);
                 break;
@@ -38,7 +36,7 @@ namespace skyline::kernel::type {
                 state.process->memory.MapHeapMemory(map);
                 break;
             default:
-                Logger::Warn("Unmapping KTransferMemory with incompatible state: (0x{:X})", originalMapping.state.value);
+                Logger::Warn("Unmapping KTransferMemory with incompatible state: (0x{:X})", originalMapping.state);
         }
         std::memcpy(map.data(), host.data(), map.size());
     }
@@ -48,7 +46,7 @@ namespace skyline::kernel::type {
             if (mmap(guest.data(), guest.size(), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED | MAP_ANONYMOUS | MAP_POPULATE, -1, 0) == MAP_FAILED) [[unlikely]]
                 Logger::Warn("An error occurred while unmapping transfer memory in guest: {}", strerror(errno));
 
-            switch (originalMapping.state.type) {
+            switch (originalMapping.GetState().type) {
                 case memory::MemoryType::CodeMutable:
                     state.process->memory.MapMutableCodeMemory(guest);
                     break;
@@ -56,7 +54,7 @@ namespace skyline::kernel::type {
                     state.process->memory.MapHeapMemory(guest);
                     break;
                 default:
-                    Logger::Warn("Unmapping KTransferMemory with incompatible state: (0x{:X})", originalMapping.state.value);
+                    Logger::Warn("Unmapping KTransferMemory with incompatible state: (0x{:X})", originalMapping.state);
             }
             std::memcpy(guest.data(), host.data(), guest.size());
         }
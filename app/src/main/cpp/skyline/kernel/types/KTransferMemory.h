@@ -12,7 +12,7 @@ namespace skyline::kernel::type {
      */
     class KTransferMemory : public KMemory {
       private:
-        ChunkDescriptor originalMapping;
+        PageDescriptor originalMapping;
 
       public:
         /**
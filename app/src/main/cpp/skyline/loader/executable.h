@@ -51,5 +51,8 @@ namespace skyline::loader {
 
         RelativeSegment dynsym; //!< The .dynsym segment relative to .rodata
         RelativeSegment dynstr; //!< The .dynstr segment relative to .rodata
+
+        std::array<u64, 4> buildId{}; //!< The build ID of the executable, this is zeroed if it's unknown
+        std::array<u64, 4> textHash{}; //!< A SHA256 hash covering the contents of .text, this is zeroed if it's unknown
     };
 }
@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <common/utils.h>
+#include <vfs/os_backing.h>
+#include <vfs/region_backing.h>
+#include "executable_cache.h"
+
+namespace skyline::loader {
+    constexpr u32 CacheMagic{util::MakeMagic<u32>("EXEC")};
+
+    ExecutableCache::ExecutableCache(std::string pDirectory, const vfs::NCA &nca) : directory{std::move(pDirectory)} {
+        path = directory / fmt::format("{:016X}.bin", nca.header.programId);
+
+        expectedHeader.magic = CacheMagic;
+        expectedHeader.version = CacheVersion;
+        expectedHeader.programId = nca.header.programId;
+        expectedHeader.sectionHashes = nca.header.sectionHashes;
+    }
+
+    ExecutableCache::~ExecutableCache() {
+        if (mapping.valid())
+            munmap(mapping.data(), mapping.size());
+        if (fd != -1)
+            close(fd);
+    }
+
+    bool ExecutableCache::Open() {
+        fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            return false;
+
+        auto fail{[&](std::string_view reason) {
+            Logger::Warn("Ignoring invalid executable cache file '{}': {}", path.string(), reason);
+            if (mapping.valid())
+                munmap(mapping.data(), mapping.size());
+            mapping = {};
+            close(fd);
+            fd = -1;
+            return false;
+        }};
+
+        struct stat fileInfo{};
+        if (fstat(fd, &fileInfo) || static_cast<size_t>(fileInfo.st_size) < sizeof(FileHeader))
+            return fail("Truncated header");
+
+        auto pointer{mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0)};
+        if (pointer == MAP_FAILED)
+            return fail(strerror(errno));
+        mapping = span<u8>{static_cast<u8 *>(pointer), static_cast<size_t>(fileInfo.st_size)};
+
+        const auto &header{mapping.as<FileHeader>()};
+        if (header.magic != CacheMagic || header.version != CacheVersion)
+            return fail("Mismatching version");
+
+        if (header.programId != expectedHeader.programId || header.sectionHashes != expectedHeader.sectionHashes) {
+            // The program NCA has changed since the cache file was written, this is expected after an update so it's not logged as an error
+            Logger::Info("Executable cache for {:016X} is stale", expectedHeader.programId);
+            munmap(mapping.data(), mapping.size());
+            mapping = {};
+            close(fd);
+            fd = -1;
+            return false;
+        }
+
+        if (header.fileSize != mapping.size() || sizeof(FileHeader) + header.moduleCount * sizeof(ModuleHeader) > mapping.size() || header.npdmOffset + header.npdmSize > mapping.size())
+            return fail("Truncated file");
+
+        auto modules{mapping.subspan(sizeof(FileHeader), header.moduleCount * sizeof(ModuleHeader)).cast<const ModuleHeader>()};
+        for (const auto &cachedModule : modules) {
+            u64 hash{};
+            for (const auto &segment : {cachedModule.text, cachedModule.ro, cachedModule.data}) {
+                if (segment.fileOffset + segment.size > mapping.size())
+                    return fail("Segment out of bounds");
+                hash = XXH64(mapping.data() + segment.fileOffset, segment.size, hash);
+            }
+
+            if (hash != cachedModule.hash)
+                return fail("Hash mismatch");
+        }
+
+        // The modification time is used to determine the least recently used titles during eviction
+        std::error_code error;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+        return true;
+    }
+
+    bool ExecutableCache::IsOpen() const {
+        return mapping.valid();
+    }
+
+    std::shared_ptr<vfs::Backing> ExecutableCache::GetNpdm() {
+        const auto &header{mapping.as<FileHeader>()};
+        return std::make_shared<vfs::RegionBacking>(std::make_shared<vfs::OsBacking>(fd), header.npdmOffset, header.npdmSize);
+    }
+
+    std::vector<std::pair<std::string, Executable>> ExecutableCache::GetModules() {
+        const auto &header{mapping.as<FileHeader>()};
+        auto modules{mapping.subspan(sizeof(FileHeader), header.moduleCount * sizeof(ModuleHeader)).cast<const ModuleHeader>()};
+
+        auto getSegment{[&](const SegmentHeader &segment) {
+            auto contents{mapping.subspan(segment.fileOffset, segment.size)};
+            return Executable::Segment{{contents.begin(), contents.end()}, segment.memoryOffset};
+        }};
+
+        std::vector<std::pair<std::string, Executable>> executables;
+        executables.reserve(modules.size());
+        for (const auto &cachedModule : modules) {
+            Executable executable{
+                .text = getSegment(cachedModule.text),
+                .ro = getSegment(cachedModule.ro),
+                .data = getSegment(cachedModule.data),
+                .bssSize = cachedModule.bssSize,
+                .dynsym = cachedModule.dynsym,
+                .dynstr = cachedModule.dynstr,
+                .buildId = cachedModule.buildId,
+                .textHash = cachedModule.textHash,
+            };
+            executables.emplace_back(std::string{cachedModule.name.data(), strnlen(cachedModule.name.data(), cachedModule.name.size())}, std::move(executable));
+        }
+
+        return executables;
+    }
+
+    void ExecutableCache::Evict(size_t requiredSize) {
+        std::error_code error;
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::directory_entry>> entries;
+        size_t totalSize{};
+        for (const auto &entry : std::filesystem::directory_iterator{directory, error}) {
+            if (!entry.is_regular_file(error) || entry.path().extension() != ".bin" || entry.path() == path)
+                continue;
+
+            totalSize += entry.file_size(error);
+            entries.emplace_back(entry.last_write_time(error), entry);
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+        for (auto it{entries.begin()}; it != entries.end() && totalSize + requiredSize > MaxCacheSize; it++) {
+            totalSize -= it->second.file_size(error);
+            std::filesystem::remove(it->second.path(), error);
+            Logger::Info("Evicted executable cache file '{}'", it->second.path().string());
+        }
+    }
+
+    void ExecutableCache::Write(const std::shared_ptr<vfs::Backing> &npdm, span<const ModuleView> modules) {
+        auto startTime{util::GetTimeNs()};
+
+        FileHeader header{expectedHeader};
+        header.moduleCount = static_cast<u32>(modules.size());
+        header.npdmSize = static_cast<u32>(npdm->size);
+
+        // All contents are page-aligned in the file so they can be efficiently mapped
+        size_t offset{util::AlignUp(sizeof(FileHeader) + modules.size() * sizeof(ModuleHeader), constant::PageSize)};
+        auto allocate{[&](size_t size) {
+            size_t allocation{offset};
+            offset = util::AlignUp(offset + size, constant::PageSize);
+            return allocation;
+        }};
+
+        header.npdmOffset = allocate(npdm->size);
+
+        std::vector<ModuleHeader> moduleHeaders;
+        moduleHeaders.reserve(modules.size());
+        for (const auto &view : modules) {
+            const auto &executable{view.executable};
+            ModuleHeader moduleHeader{
+                .buildId = executable.buildId,
+                .textHash = executable.textHash,
+                .text = {allocate(executable.text.contents.size()), executable.text.contents.size(), executable.text.offset},
+                .ro = {allocate(executable.ro.contents.size()), executable.ro.contents.size(), executable.ro.offset},
+                .data = {allocate(executable.data.contents.size()), executable.data.contents.size(), executable.data.offset},
+                .bssSize = executable.bssSize,
+                .dynsym = executable.dynsym,
+                .dynstr = executable.dynstr,
+            };
+            if (view.name.size() >= moduleHeader.name.size())
+                throw exception("Module name is too long to be cached: {}", view.name);
+            view.name.copy(moduleHeader.name.data(), moduleHeader.name.size() - 1);
+
+            u64 hash{};
+            for (const auto &segment : {&executable.text, &executable.ro, &executable.data})
+                hash = XXH64(segment->contents.data(), segment->contents.size(), hash);
+            moduleHeader.hash = hash;
+
+            moduleHeaders.push_back(moduleHeader);
+        }
+
+        header.fileSize = offset;
+        if (header.fileSize > MaxCacheSize) {
+            Logger::Warn("Executable cache for {:016X} exceeds the maximum cache size: 0x{:X}", header.programId, header.fileSize);
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        Evict(header.fileSize);
+
+        // The file is written to a temporary path and then renamed over the existing entry, this ensures a partially written file can never be opened
+        auto temporaryPath{path};
+        temporaryPath += ".tmp";
+        {
+            std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+            if (stream.fail()) {
+                Logger::Warn("Failed to write executable cache file: {}", temporaryPath.string());
+                return;
+            }
+
+            auto writeAt{[&](size_t fileOffset, const void *data, size_t size) {
+                stream.seekp(static_cast<std::streamoff>(fileOffset));
+                stream.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+            }};
+
+            writeAt(0, &header, sizeof(FileHeader));
+            writeAt(sizeof(FileHeader), moduleHeaders.data(), moduleHeaders.size() * sizeof(ModuleHeader));
+
+            std::vector<u8> npdmContents(npdm->size);
+            npdm->Read(npdmContents);
+            writeAt(header.npdmOffset, npdmContents.data(), npdmContents.size());
+
+            for (size_t index{}; index < modules.size(); index++) {
+                const auto &executable{modules[index].executable};
+                const auto &moduleHeader{moduleHeaders[index]};
+                writeAt(moduleHeader.text.fileOffset, executable.text.contents.data(), executable.text.contents.size());
+                writeAt(moduleHeader.ro.fileOffset, executable.ro.contents.data(), executable.ro.contents.size());
+                writeAt(moduleHeader.data.fileOffset, executable.data.contents.data(), executable.data.contents.size());
+            }
+
+            // Pad the file out to its full size, the final segment's padding wouldn't be written otherwise
+            if (stream.tellp() < static_cast<std::streamoff>(header.fileSize)) {
+                stream.seekp(static_cast<std::streamoff>(header.fileSize - 1));
+                stream.put('\0');
+            }
+
+            if (stream.fail()) {
+                Logger::Warn("Failed to write executable cache file: {}", temporaryPath.string());
+                std::filesystem::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+            Logger::Warn("Failed to replace executable cache file '{}': {}", path.string(), error.message());
+        else
+            Logger::Info("Wrote executable cache for {:016X} (0x{:X} bytes) in {}ms", header.programId, header.fileSize, (util::GetTimeNs() - startTime) / constant::NsInMillisecond);
+    }
+}
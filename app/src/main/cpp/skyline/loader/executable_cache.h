@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <filesystem>
+#include <vfs/nca.h>
+#include "executable.h"
+
+namespace skyline::loader {
+    /**
+     * @brief A persistent per-title cache of the NPDM and decompressed module images from a program NCA's ExeFS, this allows skipping ExeFS decryption and NSO decompression on subsequent boots
+     * @note Module images are cached prior to being patched as the .patch section contains host addresses which differ between runs, patch offsets are cached separately by NCE
+     * @note Entries are keyed by the program ID and the NCA section hashes, any change to the program NCA (such as from an update) results in the entry being replaced
+     */
+    class ExecutableCache {
+      private:
+        constexpr static u32 CacheVersion{1}; //!< The version of the cache format, this must be incremented whenever the format changes
+        constexpr static size_t MaxCacheSize{1024 * 1024 * 1024}; //!< The maximum combined size of all cached titles (1GiB), the least recently used titles are evicted to stay below this
+
+        struct FileHeader {
+            u32 magic; //!< The magic of the cache file: 'EXEC'
+            u32 version; //!< The CacheVersion that the file was written with
+            u64 programId; //!< The program ID of the NCA
+            std::array<std::array<u8, 0x20>, 4> sectionHashes; //!< The SHA256 hashes of the NCA's section headers, these transitively cover the contents of every section
+            u32 moduleCount; //!< The amount of ModuleHeader structures that follow this header
+            u32 npdmSize; //!< The size of the NPDM in bytes
+            u64 npdmOffset; //!< The offset of the NPDM in the file
+            u64 fileSize; //!< The total size of the file, this catches truncated files
+        };
+        static_assert(sizeof(FileHeader) == 0xA8);
+
+        struct SegmentHeader {
+            u64 fileOffset; //!< The page-aligned offset of the segment contents in the file
+            u64 size; //!< The size of the segment contents
+            u64 memoryOffset; //!< The offset from the base address of the executable to load the segment at
+        };
+
+        struct ModuleHeader {
+            std::array<char, 0x10> name; //!< The null-terminated name of the module
+            std::array<u64, 4> buildId;
+            std::array<u64, 4> textHash;
+            SegmentHeader text;
+            SegmentHeader ro;
+            SegmentHeader data;
+            u64 bssSize;
+            Executable::RelativeSegment dynsym;
+            Executable::RelativeSegment dynstr;
+            u64 hash; //!< The XXH64 hash of the contents of all segments
+        };
+        static_assert(sizeof(ModuleHeader) == 0xC8);
+
+        std::filesystem::path directory; //!< The directory containing the cache files of all titles
+        std::filesystem::path path; //!< The path to the cache file of this title
+        FileHeader expectedHeader{}; //!< A header with all the key fields filled in for the title
+
+        int fd{-1}; //!< The FD of the opened cache file
+        span<u8> mapping; //!< A read-only mapping of the opened cache file
+
+        /**
+         * @brief Removes the least recently used cache files until an additional file of the supplied size fits within MaxCacheSize
+         */
+        void Evict(size_t requiredSize);
+
+      public:
+        /**
+         * @brief A view of an executable which is to be written into the cache
+         */
+        struct ModuleView {
+            std::string_view name;
+            const Executable &executable;
+        };
+
+        /**
+         * @param directory The directory to store the cache files of all titles in
+         * @param nca The program NCA which the cache entry corresponds to
+         */
+        ExecutableCache(std::string directory, const vfs::NCA &nca);
+
+        ExecutableCache(const ExecutableCache &) = delete;
+
+        ExecutableCache &operator=(const ExecutableCache &) = delete;
+
+        ~ExecutableCache();
+
+        /**
+         * @brief Maps the cache file for the title and validates it against the NCA
+         * @return If a valid cache entry was present, the other accessors can only be used if this is true
+         */
+        bool Open();
+
+        /**
+         * @return If a valid cache entry has been opened
+         */
+        bool IsOpen() const;
+
+        /**
+         * @return A backing containing the cached NPDM
+         */
+        std::shared_ptr<vfs::Backing> GetNpdm();
+
+        /**
+         * @return The names and executables of all cached modules in load order
+         */
+        std::vector<std::pair<std::string, Executable>> GetModules();
+
+        /**
+         * @brief Writes the cache entry for the title atomically, replacing any existing entry for it
+         * @param modules The modules in load order, these must not have been patched yet
+         * @note Failures are logged rather than thrown as the cache is purely an optimization
+         */
+        void Write(const std::shared_ptr<vfs::Backing> &npdm, span<const ModuleView> modules);
+    };
+}
@@ -8,10 +8,15 @@
 #include <kernel/types/KProcess.h>
 #include <kernel/memory.h>
 #include <hle/symbol_hook_table.h>
+#include <hle/guest_profiler.h>
 #include "loader.h"
 
 namespace skyline::loader {
     Loader::ExecutableLoadInfo Loader::LoadExecutable(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, Executable &executable, size_t offset, const std::string &name, bool dynamicallyLinked) {
+        return LoadExecutable(process, state, executable, state.nce->GetCachedPatchData(executable), offset, name, dynamicallyLinked);
+    }
+
+    Loader::ExecutableLoadInfo Loader::LoadExecutable(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, Executable &executable, const nce::NCE::PatchData &patch, size_t offset, const std::string &name, bool dynamicallyLinked) {
         u8 *base{reinterpret_cast<u8 *>(process->memory.code.data() + offset)};
 
         size_t textSize{executable.text.contents.size()};
@@ -27,14 +32,13 @@ namespace skyline::loader {
         if (!util::IsPageAligned(executable.text.offset) || !util::IsPageAligned(executable.ro.offset) || !util::IsPageAligned(executable.data.offset))
             throw exception("Section offsets are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", executable.text.offset, executable.ro.offset, executable.data.offset);
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
-
         span dynsym{reinterpret_cast<Elf64_Sym *>(executable.ro.contents.data() + executable.dynsym.offset), executable.dynsym.size / sizeof(Elf64_Sym)};
         span dynstr{reinterpret_cast<char *>(executable.ro.contents.data() + executable.dynstr.offset), executable.dynstr.size};
         std::vector<nce::NCE::HookedSymbolEntry> executableSymbols;
         size_t hookSize{};
         if (dynamicallyLinked) {
-            if constexpr (!hle::HookedSymbols.empty()) {
+            auto &profiler{state.profiler};
+            if (!hle::HookedSymbols.empty() || profiler) {
                 for (auto &symbol : dynsym) {
                     if (symbol.st_name == 0 || symbol.st_value == 0)
                         continue;
@@ -52,6 +56,11 @@ namespace skyline::loader {
                         continue;
                     }
 
+                    if (profiler && profiler->ShouldProfile(symbolName)) {
+                        executableSymbols.emplace_back(std::string{symbolName}, profiler->CreateHook(symbolName), &symbol.st_value);
+                        continue;
+                    }
+
                     #ifdef PRINT_HOOK_ALL
                     if (symbolName == "memcpy" || symbolName == "memcmp" || symbolName == "memset" || symbolName == "strcmp" ||  symbolName == "strlen")
                         // If symbol is from libc (such as memcpy, strcmp, strlen, etc), we don't need to hook it
@@ -6,6 +6,7 @@
 #include <linux/elf.h>
 #include <vfs/nacp.h>
 #include <common/signal.h>
+#include <nce.h>
 #include "executable.h"
 
 namespace skyline::loader {
@@ -84,6 +85,11 @@ namespace skyline::loader {
          */
         ExecutableLoadInfo LoadExecutable(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, Executable &executable, size_t offset = 0, const std::string &name = {}, bool dynamicallyLinked = false);
 
+        /**
+         * @brief Loads an executable into memory with patch data that was retrieved ahead of time, this allows scanning to be done concurrently with loading other executables
+         */
+        ExecutableLoadInfo LoadExecutable(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, Executable &executable, const nce::NCE::PatchData &patch, size_t offset = 0, const std::string &name = {}, bool dynamicallyLinked = false);
+
         std::optional<vfs::NACP> nacp;
         std::shared_ptr<vfs::Backing> romFs;
 
@@ -3,6 +3,8 @@
 
 #include <kernel/types/KProcess.h>
 #include <vfs/npdm.h>
+#include <common/settings.h>
+#include <os.h>
 #include "nso.h"
 #include "nca.h"
 
@@ -12,42 +14,101 @@ namespace skyline::loader {
             throw exception("Only NCAs with an ExeFS can be loaded directly");
     }
 
-    void *NcaLoader::LoadExeFs(Loader *loader, const std::shared_ptr<vfs::FileSystem> &exeFs, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
+    void *NcaLoader::LoadExeFs(Loader *loader, const std::shared_ptr<vfs::FileSystem> &exeFs, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, ExecutableCache *cache) {
         if (exeFs == nullptr)
             throw exception("Cannot load a null ExeFS");
 
-        if (!exeFs->FileExists("rtld"))
+        bool cached{cache && cache->IsOpen()};
+        if (!cached && !exeFs->FileExists("rtld"))
             throw exception("Cannot load an ExeFS that doesn't contain rtld");
 
-        auto nsoFile{exeFs->OpenFile("rtld")};
+        auto prepareStart{util::GetTimeNs()};
+
+        // A module which is read, decompressed and scanned for patching concurrently with other modules
+        struct PreparedModule {
+            std::string name;
+            std::optional<NsoLoader::PendingNso> nso; //!< The NSO which the executable is being read from, this is empty if it was retrieved from the executable cache
+            Executable executable{};
+            std::future<std::pair<nce::NCE::PatchData, i64>> patch; //!< The patch data of the module alongside the time at which it was ready
+        };
+
+        constexpr std::array ModuleNames{"rtld", "main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"};
+        std::vector<PreparedModule> modules;
+        modules.reserve(ModuleNames.size()); // Pending patch scans reference the executables inside this so it must never reallocate
+
+        // All segments of every module are submitted to the pool upfront, only the final address assignment and mapping is done in order
+        // Note: The pool must be destroyed prior to the modules as its destructor waits for any pending tasks which reference them
+        BS::thread_pool pool;
+        if (cached) {
+            for (auto &[name, executable] : cache->GetModules())
+                modules.push_back(PreparedModule{std::move(name), std::nullopt, std::move(executable)});
+        } else {
+            for (const auto &nso : ModuleNames)
+                if (exeFs->FileExists(nso))
+                    modules.push_back(PreparedModule{nso + std::string(".nso"), NsoLoader::PendingNso{exeFs->OpenFile(nso), pool}});
+        }
+
+        for (auto &prepared : modules) {
+            if (prepared.nso)
+                prepared.executable = prepared.nso->Get();
+            prepared.patch = pool.submit([&state, &executable = prepared.executable] {
+                auto patch{state.nce->GetCachedPatchData(executable)};
+                return std::make_pair(std::move(patch), util::GetTimeNs());
+            });
+        }
+
+        if (cache && !cached) {
+            // The executables are written prior to being patched during loading, concurrent patch scans only read them
+            std::vector<ExecutableCache::ModuleView> views;
+            for (const auto &prepared : modules)
+                views.push_back({prepared.name, prepared.executable});
+            cache->Write(exeFs->OpenFile("main.npdm"), views);
+        }
 
         state.process->memory.InitializeVmm(process->npdm.meta.flags.type);
 
-        auto loadInfo{NsoLoader::LoadNso(loader, nsoFile, process, state, 0, "rtld.nso")};
-        u64 offset{loadInfo.size};
-        u8 *base{loadInfo.base};
-        void *entry{loadInfo.entry};
+        u64 offset{};
+        u8 *base{};
+        void *entry{};
+        for (auto &prepared : modules) {
+            auto [patch, preparedTime]{prepared.patch.get()};
 
-        Logger::Info("Loaded 'rtld.nso' at 0x{:X} (.text @ 0x{:X})", base, entry);
+            auto loadStart{util::GetTimeNs()};
+            bool isRtld{offset == 0}; // rtld is always the first module, it's the only one that isn't dynamically linked
+            auto loadInfo{loader->LoadExecutable(process, state, prepared.executable, patch, offset, prepared.name, !isRtld)};
+            auto loadEnd{util::GetTimeNs()};
 
-        for (const auto &nso : {"main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"}) {
-            if (exeFs->FileExists(nso))
-                nsoFile = exeFs->OpenFile(nso);
-            else
-                continue;
+            if (isRtld) {
+                base = loadInfo.base;
+                entry = loadInfo.entry;
+            }
 
-            loadInfo = NsoLoader::LoadNso(loader, nsoFile, process, state, offset, nso + std::string(".nso"), true);
-            Logger::Info("Loaded '{}.nso' at 0x{:X} (.text @ 0x{:X})", nso, base + offset, loadInfo.entry);
+            Logger::Info("Loaded '{}' at 0x{:X} (.text @ 0x{:X}), ready after {}ms and mapped in {}ms", prepared.name, base + offset, loadInfo.entry, (preparedTime - prepareStart) / constant::NsInMillisecond, (loadEnd - loadStart) / constant::NsInMillisecond);
             offset += loadInfo.size;
         }
 
+        Logger::Info("Loaded {} modules{} in {}ms", modules.size(), cached ? " from the executable cache" : "", (util::GetTimeNs() - prepareStart) / constant::NsInMillisecond);
+
         state.process->memory.InitializeRegions(span<u8>{base, offset});
 
         return entry;
     }
 
-    void *NcaLoader::LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
+    void *NcaLoader::LoadProgram(Loader *loader, const vfs::NCA &nca, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
+        std::optional<ExecutableCache> cache;
+        if (*state.settings->enableExecutableCache) {
+            cache.emplace(state.os->publicAppFilesPath + "executable_cache/", nca);
+            if (cache->Open()) {
+                process->npdm = vfs::NPDM(cache->GetNpdm());
+                return LoadExeFs(loader, nca.exeFs, process, state, &*cache);
+            }
+        }
+
         process->npdm = vfs::NPDM(nca.exeFs->OpenFile("main.npdm"));
-        return LoadExeFs(this, nca.exeFs, process, state);
+        return LoadExeFs(loader, nca.exeFs, process, state, cache ? &*cache : nullptr);
+    }
+
+    void *NcaLoader::LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
+        return LoadProgram(this, nca, process, state);
     }
 }
@@ -5,6 +5,7 @@
 
 #include <vfs/nca.h>
 #include "loader.h"
+#include "executable_cache.h"
 
 namespace skyline::loader {
     /**
@@ -21,8 +22,14 @@ namespace skyline::loader {
         /**
          * @brief Loads an ExeFS into memory and processes it accordingly for execution
          * @param exefs A filesystem object containing the ExeFS filesystem to load into memory
+         * @param cache An optional executable cache, the modules are loaded from it if it's open otherwise it's populated with the modules from the ExeFS
          */
-        static void *LoadExeFs(Loader *loader, const std::shared_ptr<vfs::FileSystem> &exefs, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state);
+        static void *LoadExeFs(Loader *loader, const std::shared_ptr<vfs::FileSystem> &exefs, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, ExecutableCache *cache = nullptr);
+
+        /**
+         * @brief Loads the NPDM and ExeFS of a program NCA, using the executable cache if it's enabled
+         */
+        static void *LoadProgram(Loader *loader, const vfs::NCA &nca, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state);
 
         void *LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) override;
     };
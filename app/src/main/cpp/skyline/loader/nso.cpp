@@ -29,23 +29,27 @@ namespace skyline::loader {
         return outputBuffer;
     }
 
-    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name, bool dynamicallyLinked) {
-        auto header{backing->Read<NsoHeader>()};
-
+    NsoLoader::PendingNso::PendingNso(const std::shared_ptr<vfs::Backing> &backing, BS::thread_pool &pool) : header{backing->Read<NsoHeader>()} {
         if (header.magic != util::MakeMagic<u32>("NSO0"))
             throw exception("Invalid NSO magic! 0x{0:X}", header.magic);
 
+        text = pool.submit(&NsoLoader::GetSegment, backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
+        ro = pool.submit(&NsoLoader::GetSegment, backing, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0);
+        data = pool.submit(&NsoLoader::GetSegment, backing, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0);
+    }
+
+    Executable NsoLoader::PendingNso::Get() {
         Executable executable{};
 
-        executable.text.contents = GetSegment(backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
+        executable.text.contents = text.get();
         executable.text.contents.resize(util::AlignUp(executable.text.contents.size(), constant::PageSize));
         executable.text.offset = header.text.memoryOffset;
 
-        executable.ro.contents = GetSegment(backing, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0);
+        executable.ro.contents = ro.get();
         executable.ro.contents.resize(util::AlignUp(executable.ro.contents.size(), constant::PageSize));
         executable.ro.offset = header.ro.memoryOffset;
 
-        executable.data.contents = GetSegment(backing, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0);
+        executable.data.contents = data.get();
         executable.data.offset = header.data.memoryOffset;
 
         // Data and BSS are aligned together
@@ -56,6 +60,16 @@ namespace skyline::loader {
             executable.dynstr = {header.dynstr.offset, header.dynstr.size};
         }
 
+        executable.buildId = header.buildId;
+        if (header.flags.textHash)
+            executable.textHash = header.segmentHashes[0];
+
+        return executable;
+    }
+
+    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name, bool dynamicallyLinked) {
+        BS::thread_pool pool{3}; // A thread for each segment
+        auto executable{PendingNso{backing, pool}.Get()};
         return loader->LoadExecutable(process, state, executable, offset, name, dynamicallyLinked);
     }
 
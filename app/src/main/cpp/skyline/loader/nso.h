@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <future>
+#include <BS_thread_pool.hpp>
 #include "loader.h"
 
 namespace skyline::loader {
@@ -78,6 +80,27 @@ namespace skyline::loader {
         static std::vector<u8> GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize);
 
       public:
+        /**
+         * @brief An NSO with segments that are being read and decompressed concurrently on a thread pool
+         */
+        class PendingNso {
+          private:
+            NsoHeader header;
+            std::future<std::vector<u8>> text, ro, data;
+
+          public:
+            /**
+             * @note The backing must be safe to read from multiple threads concurrently
+             */
+            PendingNso(const std::shared_ptr<vfs::Backing> &backing, BS::thread_pool &pool);
+
+            /**
+             * @brief Waits for all segments to be decompressed and constructs an executable from them
+             * @note This must only be called once
+             */
+            Executable Get();
+        };
+
         NsoLoader(std::shared_ptr<vfs::Backing> backing);
 
         /**
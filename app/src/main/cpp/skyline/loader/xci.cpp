@@ -61,8 +61,7 @@ namespace skyline::loader {
     }
 
     void *XciLoader::LoadProcessData(const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state) {
-        process->npdm = vfs::NPDM(programNca->exeFs->OpenFile("main.npdm"));
-        return NcaLoader::LoadExeFs(this, programNca->exeFs, process, state);
+        return NcaLoader::LoadProgram(this, *programNca, process, state);
     }
 
     std::vector<u8> XciLoader::GetIcon(language::ApplicationLanguage language) {
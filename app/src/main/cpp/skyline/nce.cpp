@@ -3,6 +3,9 @@
 
 #include <cxxabi.h>
 #include <unistd.h>
+#include <arm_neon.h>
+#include <filesystem>
+#include <BS_thread_pool.hpp>
 #include "common/signal.h"
 #include "common/trace.h"
 #include "os.h"
@@ -354,6 +357,71 @@ namespace skyline::nce {
     constexpr u32 CntvctEl0{0x5F02};        // ID of CNTVCT_EL0 in MRS
     constexpr u32 TegraX1Freq{19200000};    // The clock frequency of the Tegra X1 (19.2 MHz)
 
+    /**
+     * @brief Checks if a single instruction needs to be patched and accumulates its patch size and offset if so
+     */
+    static void ScanInstruction(const u32 *instruction, size_t instructionOffset, bool rescaleClock, size_t &size, std::vector<size_t> &offsets) {
+        auto svc{*reinterpret_cast<const instructions::Svc *>(instruction)};
+        auto mrs{*reinterpret_cast<const instructions::Mrs *>(instruction)};
+        auto msr{*reinterpret_cast<const instructions::Msr *>(instruction)};
+
+        if (svc.Verify()) {
+            size += 7;
+            offsets.push_back(instructionOffset);
+        } else if (mrs.Verify()) {
+            if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
+                size += ((mrs.destReg != registers::X0) ? 6 : 3);
+                offsets.push_back(instructionOffset);
+            } else {
+                if (rescaleClock) {
+                    if (mrs.srcReg == CntpctEl0) {
+                        size += RescaleClockSize + 3;
+                        offsets.push_back(instructionOffset);
+                    } else if (mrs.srcReg == CntfrqEl0) {
+                        size += 3;
+                        offsets.push_back(instructionOffset);
+                    }
+                } else if (mrs.srcReg == CntpctEl0) {
+                    offsets.push_back(instructionOffset);
+                }
+            }
+        } else if (msr.Verify() && msr.destReg == TpidrEl0) {
+            size += 6;
+            offsets.push_back(instructionOffset);
+        }
+    }
+
+    /**
+     * @brief Scans a range of .text for instructions that need to be patched, blocks of instructions are filtered with NEON mask-compares so only blocks containing an SVC/MRS/MSR are decoded
+     * @param start The start of .text, offsets are relative to this
+     * @param begin The first instruction to scan
+     */
+    static void ScanInstructions(const u32 *start, const u32 *begin, const u32 *end, bool rescaleClock, size_t &size, std::vector<size_t> &offsets) {
+        constexpr size_t BlockInstructionCount{16}; //!< The amount of instructions which are checked with a single set of vector compares
+        const uint32x4_t svcMask{vdupq_n_u32(0xFFE0001F)}, svcValue{vdupq_n_u32(0xD4000001)}; // SVC #imm16
+        const uint32x4_t sysMask{vdupq_n_u32(0xFFD00000)}, sysValue{vdupq_n_u32(0xD5100000)}; // MRS/MSR (Register), the masked bit distinguishes between them
+
+        auto instruction{begin};
+        for (; instruction + BlockInstructionCount <= end; instruction += BlockInstructionCount) {
+            uint32x4_t matches{vdupq_n_u32(0)};
+            for (size_t i{}; i < BlockInstructionCount; i += 4) {
+                uint32x4_t words{vld1q_u32(instruction + i)};
+                matches = vorrq_u32(matches, vceqq_u32(vandq_u32(words, svcMask), svcValue));
+                matches = vorrq_u32(matches, vceqq_u32(vandq_u32(words, sysMask), sysValue));
+            }
+
+            if (vmaxvq_u32(matches)) [[unlikely]]
+                // The vast majority of blocks contain no candidates, we only decode the ones that do
+                for (size_t i{}; i < BlockInstructionCount; i++)
+                    ScanInstruction(instruction + i, static_cast<size_t>(instruction + i - start), rescaleClock, size, offsets);
+        }
+
+        for (; instruction < end; instruction++)
+            ScanInstruction(instruction, static_cast<size_t>(instruction - start), rescaleClock, size, offsets);
+    }
+
+    constexpr size_t ParallelScanChunkSize{4 * 1024 * 1024}; //!< The minimum size of .text (in bytes) that will be scanned by a single thread, anything smaller than this is scanned inline
+
     NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
         size_t size{guest::SaveCtxSize + guest::LoadCtxSize + TrampolineSize};
         std::vector<size_t> offsets;
@@ -361,40 +429,134 @@ namespace skyline::nce {
         bool rescaleClock{util::ClockFrequency != TegraX1Freq};
 
         auto start{reinterpret_cast<const u32 *>(text.data())}, end{reinterpret_cast<const u32 *>(text.data() + text.size())};
-        for (const u32 *instruction{start}; instruction < end; instruction++) {
-            auto svc{*reinterpret_cast<const instructions::Svc *>(instruction)};
-            auto mrs{*reinterpret_cast<const instructions::Mrs *>(instruction)};
-            auto msr{*reinterpret_cast<const instructions::Msr *>(instruction)};
-            auto instructionOffset{static_cast<size_t>(instruction - start)};
+        size_t chunkCount{std::min<size_t>(text.size() / ParallelScanChunkSize, std::thread::hardware_concurrency())};
+        if (chunkCount <= 1) {
+            ScanInstructions(start, start, end, rescaleClock, size, offsets);
+            return {util::AlignUp(size * sizeof(u32), constant::PageSize), offsets};
+        }
 
-            if (svc.Verify()) {
-                size += 7;
-                offsets.push_back(instructionOffset);
-            } else if (mrs.Verify()) {
-                if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
-                    size += ((mrs.destReg != registers::X0) ? 6 : 3);
-                    offsets.push_back(instructionOffset);
-                } else {
-                    if (rescaleClock) {
-                        if (mrs.srcReg == CntpctEl0) {
-                            size += RescaleClockSize + 3;
-                            offsets.push_back(instructionOffset);
-                        } else if (mrs.srcReg == CntfrqEl0) {
-                            size += 3;
-                            offsets.push_back(instructionOffset);
-                        }
-                    } else if (mrs.srcReg == CntpctEl0) {
-                        offsets.push_back(instructionOffset);
-                    }
-                }
-            } else if (msr.Verify() && msr.destReg == TpidrEl0) {
-                size += 6;
-                offsets.push_back(instructionOffset);
-            }
+        // Split .text into equally sized chunks which are scanned in parallel, the results are then concatenated in order so offsets remain sorted
+        struct ChunkResult {
+            size_t size;
+            std::vector<size_t> offsets;
+        };
+
+        size_t chunkInstructionCount{util::DivideCeil(static_cast<size_t>(end - start), chunkCount)};
+        BS::thread_pool pool{static_cast<BS::concurrency_t>(chunkCount)};
+        std::vector<std::future<ChunkResult>> chunks;
+        for (auto chunkStart{start}; chunkStart < end; chunkStart += chunkInstructionCount) {
+            auto chunkEnd{std::min(chunkStart + chunkInstructionCount, end)};
+            chunks.emplace_back(pool.submit([=] {
+                ChunkResult result{};
+                ScanInstructions(start, chunkStart, chunkEnd, rescaleClock, result.size, result.offsets);
+                return result;
+            }));
         }
+
+        for (auto &chunk : chunks) {
+            auto result{chunk.get()};
+            size += result.size;
+            offsets.insert(offsets.end(), result.offsets.begin(), result.offsets.end());
+        }
+
         return {util::AlignUp(size * sizeof(u32), constant::PageSize), offsets};
     }
 
+    constexpr u32 PatchCacheVersion{2}; //!< The version of the patch cache format, this must be incremented whenever the patching logic is changed in a way that affects the patch size or offsets
+
+    /**
+     * @brief Unique header serialized into the patch cache filename as a hexdump to identify a particular executable
+     */
+    struct PatchCacheFileNameHeader {
+        std::array<u64, 4> buildId; //!< The build ID of the executable
+        std::array<u64, 4> textHash; //!< The SHA256 hash covering the executable's .text
+        u64 rescaleClock; //!< If clock reads are being rescaled, this changes the set of patched instructions
+
+        std::string HexDump() {
+            return util::HexDump(span<u8>{reinterpret_cast<u8 *>(this), sizeof(PatchCacheFileNameHeader)});
+        }
+    };
+
+    /**
+     * @brief Header that precedes the serialized offsets in the patch cache file
+     */
+    struct PatchCacheFileDataHeader {
+        u32 version; //!< The PatchCacheVersion that the file was written with
+        u32 baseSize; //!< The size of the patch section prior to any per-instruction patches, this catches changes to the guest context save/restore code
+        u64 textSize; //!< The size of .text in bytes
+        u64 patchSize; //!< The size of the .patch section in bytes
+        u64 offsetCount; //!< The amount of u32 offsets that follow this header
+        u64 hash; //!< The XXH64 hash of this header (with this field zeroed) and the offsets
+
+        /**
+         * @return The hash of this header and the supplied offsets, this covers the header as its fields determine how the offsets are applied
+         */
+        u64 Hash(span<const u32> offsets) const {
+            PatchCacheFileDataHeader header{*this};
+            header.hash = 0;
+            return XXH64(offsets.data(), offsets.size_bytes(), XXH64(&header, sizeof(PatchCacheFileDataHeader), 0));
+        }
+    };
+    static_assert(sizeof(PatchCacheFileDataHeader) == 0x28);
+
+    NCE::PatchData NCE::GetCachedPatchData(const loader::Executable &executable) {
+        constexpr std::array<u64, 4> UnknownId{};
+        if (executable.buildId == UnknownId || executable.textHash == UnknownId)
+            return GetPatchData(executable.text.contents);
+
+        PatchCacheFileNameHeader fileNameHeader{
+            .buildId = executable.buildId,
+            .textHash = executable.textHash,
+            .rescaleClock = util::ClockFrequency != TegraX1Freq,
+        };
+        std::filesystem::path cacheDir{state.os->publicAppFilesPath + "patch_cache/"};
+        std::filesystem::path path{cacheDir / fileNameHeader.HexDump()};
+        u32 baseSize{static_cast<u32>(guest::SaveCtxSize + guest::LoadCtxSize + TrampolineSize)};
+
+        if (std::ifstream stream{path, std::ios::binary}; stream) {
+            PatchCacheFileDataHeader header{};
+            stream.read(reinterpret_cast<char *>(&header), sizeof(PatchCacheFileDataHeader));
+
+            // Every instruction is patched at most once and the patch section always contains the base code, anything else can only be from a corrupt file and must be rejected before allocating for it
+            size_t textInstructionCount{executable.text.contents.size() / sizeof(u32)};
+            if (stream && header.version == PatchCacheVersion && header.baseSize == baseSize && header.textSize == executable.text.contents.size() &&
+                header.offsetCount <= textInstructionCount && header.patchSize >= baseSize * sizeof(u32) && util::IsPageAligned(header.patchSize)) {
+                std::vector<u32> cachedOffsets(header.offsetCount);
+                stream.read(reinterpret_cast<char *>(cachedOffsets.data()), static_cast<std::streamsize>(cachedOffsets.size() * sizeof(u32)));
+
+                if (stream && header.hash == header.Hash(cachedOffsets) && std::all_of(cachedOffsets.begin(), cachedOffsets.end(), [&](u32 offset) { return offset < textInstructionCount; }))
+                    return {header.patchSize, {cachedOffsets.begin(), cachedOffsets.end()}};
+            }
+
+            Logger::Warn("Ignoring invalid patch cache file: {}", path.string());
+        }
+
+        auto patch{GetPatchData(executable.text.contents)};
+
+        std::vector<u32> cachedOffsets(patch.offsets.begin(), patch.offsets.end());
+        PatchCacheFileDataHeader header{
+            .version = PatchCacheVersion,
+            .baseSize = baseSize,
+            .textSize = executable.text.contents.size(),
+            .patchSize = patch.size,
+            .offsetCount = cachedOffsets.size(),
+        };
+        header.hash = header.Hash(cachedOffsets);
+
+        std::error_code error;
+        std::filesystem::create_directories(cacheDir, error);
+        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+        if (stream.fail()) {
+            Logger::Warn("Failed to write patch cache: {}", path.string());
+            return patch;
+        }
+
+        stream.write(reinterpret_cast<char *>(&header), sizeof(PatchCacheFileDataHeader));
+        stream.write(reinterpret_cast<char *>(cachedOffsets.data()), static_cast<std::streamsize>(cachedOffsets.size() * sizeof(u32)));
+
+        return patch;
+    }
+
     void NCE::PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets, size_t textOffset) {
         u32 *start{patch};
         u32 *end{patch + (patchSize / sizeof(u32))};
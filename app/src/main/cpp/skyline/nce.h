@@ -8,6 +8,7 @@
 #include "common.h"
 #include "hle/symbol_hooks.h"
 #include "common/interval_map.h"
+#include "loader/executable.h"
 
 namespace skyline::nce {
     /**
@@ -105,8 +106,17 @@ namespace skyline::nce {
             std::vector<size_t> offsets; //!< Offsets in .text of instructions that need to be patched
         };
 
+        /**
+         * @brief Scans .text for all instructions that need to be patched, large sections are split into chunks that are scanned in parallel
+         */
         static PatchData GetPatchData(const std::vector<u8> &text);
 
+        /**
+         * @brief Retrieves the patch data for an executable from the on-disk patch cache or scans .text and writes the result to the cache if it's not present
+         * @note The cache is bypassed for executables without a build ID and .text hash as there's no way to identify them
+         */
+        PatchData GetCachedPatchData(const loader::Executable &executable);
+
         /**
          * @brief Writes the .patch section and mutates the code accordingly
          * @param patch A pointer to the .patch section which should be exactly patchSize in size and located before the .text section
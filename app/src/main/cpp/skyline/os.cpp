@@ -2,8 +2,11 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include "gpu.h"
+#include "soc.h"
 #include "nce.h"
 #include "nce/guest.h"
+#include "hle/guest_profiler.h"
+#include "soc/gm20b/gpfifo_replayer.h"
 #include "kernel/types/KProcess.h"
 #include "vfs/os_backing.h"
 #include "loader/nro.h"
@@ -68,12 +71,22 @@ namespace skyline::kernel {
         }
 
         process->InitializeHeapTls();
-        auto thread{process->CreateThread(entry)};
-        if (thread) {
+        if (*state.settings->replayGpfifoTrace) {
+            // The guest is never run during a replay, it's only loaded to set up an address space which replayed GPU memory is allocated from
+            soc::gm20b::GpfifoReplayer replayer{state, publicAppFilesPath + "gpfifo_trace.bin"};
+            soc::gm20b::GpfifoReplayer::WriteReport(replayer.Replay(), publicAppFilesPath + "gpfifo_replay.txt");
+        } else if (auto thread{process->CreateThread(entry)}) {
             Logger::Info("Starting main HOS thread");
             Logger::EmulationContext.Flush();
             thread->Start(true);
             process->Kill(true, true, true);
         }
+
+        if (state.profiler)
+            state.profiler->WriteReport(publicAppFilesPath + "guest_profile.txt");
+        if (*state.settings->writeFrameTimeReport)
+            state.gpu->presentation.WriteFrameTimeReport(publicAppFilesPath + "frame_times.txt");
+        if (state.soc->gpfifoCapture)
+            state.soc->gpfifoCapture->Flush();
     }
 }
@@ -92,6 +92,7 @@ namespace skyline::service::fssrv {
     }
 
     Result IFileSystem::Commit(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        backing->Commit();
         return {};
     }
 
@@ -3,6 +3,7 @@
 
 #include <os.h>
 #include <vfs/os_filesystem.h>
+#include <vfs/save_data_filesystem.h>
 #include <vfs/nca.h>
 #include <loader/loader.h>
 #include "results.h"
@@ -66,7 +67,14 @@ namespace skyline::service::fssrv {
             }
         }()};
 
-        manager.RegisterService(std::make_shared<IFileSystem>(std::make_shared<vfs::OsFileSystem>(state.os->publicAppFilesPath + "/switch" + saveDataPath), state, manager), session, response);
+        // Temporary and cache storage isn't journaled on the Switch, writes to it are applied immediately
+        std::shared_ptr<vfs::FileSystem> fileSystem;
+        if (attribute.type == SaveDataType::Temporary || attribute.type == SaveDataType::Cache)
+            fileSystem = std::make_shared<vfs::OsFileSystem>(state.os->publicAppFilesPath + "/switch" + saveDataPath);
+        else
+            fileSystem = std::make_shared<vfs::SaveDataFileSystem>(state.os->publicAppFilesPath + "/switch" + saveDataPath);
+
+        manager.RegisterService(std::make_shared<IFileSystem>(std::move(fileSystem), state, manager), session, response);
         return {};
     }
 
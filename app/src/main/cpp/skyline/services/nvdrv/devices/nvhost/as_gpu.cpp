@@ -315,6 +315,8 @@ namespace skyline::service::nvdrv::device::nvhost {
         vm.bigPageAllocator = std::make_unique<VM::Allocator>(startBigPages, endBigPages);
 
         asCtx = std::make_shared<soc::gm20b::AddressSpaceContext>();
+        if (state.soc->gpfifoCapture)
+            state.soc->gpfifoCapture->AttachAddressSpace(*asCtx);
         vm.initialised = true;
 
         return PosixResult::Success;
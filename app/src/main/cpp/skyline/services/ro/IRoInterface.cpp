@@ -61,7 +61,11 @@ namespace skyline::service::ro {
         u64 roSize{executable.ro.contents.size()};
         u64 dataSize{executable.data.contents.size() + executable.bssSize};
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        // The hash of the entire NRO covers .text so it can be used to identify the executable in the patch cache
+        executable.buildId = header.buildId;
+        std::memcpy(executable.textHash.data(), hash.data(), sizeof(executable.textHash));
+
+        auto patch{state.nce->GetCachedPatchData(executable)};
         auto size{patch.size + textSize + roSize + dataSize};
 
         u8 *ptr{};
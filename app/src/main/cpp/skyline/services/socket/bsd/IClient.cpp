@@ -2,11 +2,51 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <poll.h>
+#include <fcntl.h>
 #include "IClient.h"
 
 namespace skyline::service::socket {
+    constexpr i32 BsdMessageWaitAll{0x40}; //!< MSG_WAITALL on the guest, this is MSG_DONTWAIT on Linux
+    constexpr i32 BsdMessageDontWait{0x80}; //!< MSG_DONTWAIT on the guest, this is MSG_EOR on Linux
+    constexpr i32 BsdNonBlock{0x4}; //!< O_NONBLOCK on the guest
+
     IClient::IClient(const DeviceState &state, ServiceManager &manager) : BaseService(state, manager) {}
 
+    ssize_t IClient::ReceiveBuffer(i32 fd, span<u8> buffer, i32 flags, sockaddr *address, socklen_t *addressLength) {
+        bool nonBlocking{static_cast<bool>(flags & BsdMessageDontWait)}, waitAll{static_cast<bool>(flags & BsdMessageWaitAll)};
+        i32 hostFlags{(flags & ~(BsdMessageDontWait | BsdMessageWaitAll)) | MSG_DONTWAIT};
+
+        ssize_t received{};
+        do {
+            ssize_t result{reactor.PerformOperation(fd, POLLIN, nonBlocking, [&] {
+                return recvfrom(fd, buffer.data() + received, buffer.size() - static_cast<size_t>(received), hostFlags, address, addressLength);
+            })};
+            if (result <= 0)
+                return received ? received : result;
+            received += result;
+        } while (waitAll && static_cast<size_t>(received) < buffer.size());
+
+        return received;
+    }
+
+    ssize_t IClient::SendBuffer(i32 fd, span<u8> buffer, i32 flags, const sockaddr *address, socklen_t addressLength) {
+        bool nonBlocking{static_cast<bool>(flags & BsdMessageDontWait)};
+        i32 hostFlags{(flags & ~(BsdMessageDontWait | BsdMessageWaitAll)) | MSG_DONTWAIT | MSG_NOSIGNAL};
+
+        // A blocking send only returns once all data has been sent, this may take multiple non-blocking sends on stream sockets
+        ssize_t sent{};
+        do {
+            ssize_t result{reactor.PerformOperation(fd, POLLOUT, nonBlocking, [&] {
+                return sendto(fd, buffer.data() + sent, buffer.size() - static_cast<size_t>(sent), hostFlags, address, addressLength);
+            })};
+            if (result < 0)
+                return sent ? sent : result;
+            sent += result;
+        } while (!nonBlocking && static_cast<size_t>(sent) < buffer.size());
+
+        return sent;
+    }
+
     Result IClient::RegisterClient(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         response.Push<i32>(0);
         return {};
@@ -36,50 +76,27 @@ namespace skyline::service::socket {
 
         span outputBuf{request.outputBuf.at(0)};
         auto fds{span<pollfd>(reinterpret_cast<pollfd*>(outputBuf.data()), static_cast<u32>(fdsCount))};
-        i32 result{poll(fds.data(), static_cast<u32>(fdsCount), static_cast<i32>(timeout))};
-        return PushBsdResult(response, result, errno);
+
+        i32 result{reactor.Poll(fds, timeout)};
+        return PushBsdResult(response, result, result == -1 ? errno : 0);
     }
 
     Result IClient::Recv(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
-        if (fcntl(fd, F_GETFL) == -1)
-            return PushBsdResult(response, -1, EBADF);
-
-        bool shouldBlockAfterOperation{false};
-        if (!(fcntl(fd, F_GETFL) & O_NONBLOCK) && (flags & MSG_EOR)) {
-            fcntl(fd, F_SETFL, O_NONBLOCK);
-            shouldBlockAfterOperation = true;
-        }
-
-        ssize_t result{recv(fd, request.outputBuf.at(0).data(), request.outputBuf.at(0).size(), flags)};
 
-        if (shouldBlockAfterOperation)
-            fcntl(fd, F_SETFL, MSG_EOR);
+        ssize_t result{ReceiveBuffer(fd, request.outputBuf.at(0), flags)};
         return PushBsdResultErrno(response, result);
     }
 
     Result IClient::RecvFrom(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
-        if (fcntl(fd, F_GETFL) == -1)
-            return PushBsdResult(response, -1, EBADF);
-
-        bool shouldBlockAfterOperation{false};
-        if (!(fcntl(fd, F_GETFL) & O_NONBLOCK) && (flags & MSG_EOR)) {
-            fcntl(fd, F_SETFL, O_NONBLOCK);
-            shouldBlockAfterOperation = true;
-        }
 
         sockaddr addrIn{};
         socklen_t addrLen{sizeof(addrIn)};
-        span message{request.outputBuf.at(0)};
-        ssize_t result{recvfrom(fd, message.data(), message.size(), 0, &addrIn, &addrLen)};
-
-        if (shouldBlockAfterOperation)
-            fcntl(fd, F_SETFL, MSG_EOR);
+        ssize_t result{ReceiveBuffer(fd, request.outputBuf.at(0), flags, &addrIn, &addrLen)};
 
-        request.outputBuf.at(0).copy_from(message);
         if (!request.outputBuf.at(1).empty())
             request.outputBuf.at(1).copy_from(span{addrIn});
         response.Push(request.outputBuf.at(1).size());
@@ -90,7 +107,7 @@ namespace skyline::service::socket {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
 
-        ssize_t result{send(fd, request.inputBuf.at(0).data(), request.inputBuf.at(0).size(), flags)};
+        ssize_t result{SendBuffer(fd, request.inputBuf.at(0), flags)};
         return PushBsdResultErrno(response, result);
     }
 
@@ -100,8 +117,7 @@ namespace skyline::service::socket {
 
         sockaddr addrIn{request.inputBuf.at(1).as<sockaddr>()};
         addrIn.sa_family = AF_INET;
-        ssize_t result{sendto(fd, request.inputBuf.at(0).data(), request.inputBuf.at(0).size(), flags,
-                          &addrIn, sizeof(addrIn))};
+        ssize_t result{SendBuffer(fd, request.inputBuf.at(0), flags, &addrIn, sizeof(addrIn))};
         return PushBsdResultErrno(response, result);
     }
 
@@ -109,13 +125,22 @@ namespace skyline::service::socket {
         i32 fd{request.Pop<i32>()};
         sockaddr addr{};
         socklen_t addrLen{sizeof(addr)};
-        i32 result{accept(fd, &addr, &addrLen)};
-        if (errno != 0)
+        i32 result{static_cast<i32>(reactor.PerformOperation(fd, POLLIN, false, [&]() -> ssize_t {
+            // Accepting has no per-call non-blocking flag, the socket is checked for a pending connection prior to accepting on it instead
+            pollfd pollFd{.fd = fd, .events = POLLIN};
+            int flags{fcntl(fd, F_GETFL)};
+            if (flags != -1 && !(flags & O_NONBLOCK) && poll(&pollFd, 1, 0) == 0) {
+                errno = EAGAIN;
+                return -1;
+            }
+            return accept(fd, &addr, &addrLen);
+        }))};
+        if (result == -1)
             return PushBsdResult(response, -1, errno);
 
         request.outputBuf.at(0).copy_from(span{addr});
         response.Push(request.outputBuf.at(0).size());
-        return PushBsdResult(response, result, errno);
+        return PushBsdResult(response, result, 0);
     }
 
     Result IClient::Bind(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -176,8 +201,18 @@ namespace skyline::service::socket {
         i32 fd{request.Pop<i32>()};
         i32 cmd{request.Pop<i32>()};
         i32 arg{request.Pop<i32>()};
+
+        // Only the non-blocking status flag differs between the guest and host, it's translated as it determines if socket operations wait for readiness
+        if (cmd == F_SETFL)
+            arg = (arg & ~BsdNonBlock) | ((arg & BsdNonBlock) ? O_NONBLOCK : 0);
+
         i32 result{fcntl(fd, cmd, arg)};
-        return PushBsdResult(response, 0, errno);
+        if (result == -1)
+            return PushBsdResult(response, -1, errno);
+
+        if (cmd == F_GETFL)
+            result = (result & ~O_NONBLOCK) | ((result & O_NONBLOCK) ? BsdNonBlock : 0);
+        return PushBsdResult(response, result, 0);
     }
 
     Result IClient::SetSockOpt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -204,20 +239,22 @@ namespace skyline::service::socket {
     Result IClient::Write(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 flags{request.Pop<i32>()};
-        ssize_t result{send(fd, request.inputBuf.at(0).data(), request.inputBuf.at(0).size(), flags)};
+        ssize_t result{SendBuffer(fd, request.inputBuf.at(0), flags)};
         return PushBsdResultErrno(response, result);
     }
 
     Result IClient::Read(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
-        ssize_t result{recv(fd, request.outputBuf.at(0).data(), request.outputBuf.at(0).size(), 0)};
+        ssize_t result{ReceiveBuffer(fd, request.outputBuf.at(0), 0)};
         return PushBsdResultErrno(response, result);
     }
 
     Result IClient::Close(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         i32 fd{request.Pop<i32>()};
         i32 result{close(fd)};
-        return PushBsdResult(response, 0, errno);
+        i32 error{result == -1 ? errno : 0};
+        reactor.Cancel(fd); // Closing a socket doesn't wake threads waiting on it, they're woken to observe it being closed
+        return PushBsdResult(response, 0, error);
     }
 
     Result IClient::EventFd(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
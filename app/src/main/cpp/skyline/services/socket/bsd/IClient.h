@@ -5,6 +5,7 @@
 
 #include <services/serviceman.h>
 #include <netinet/in.h>
+#include "socket_reactor.h"
 
 namespace skyline::service::socket {
     enum class OptionName : u32 {
@@ -21,6 +22,21 @@ namespace skyline::service::socket {
      * @url https://switchbrew.org/wiki/Sockets_services#bsd:u.2C_bsd:s
      */
     class IClient : public BaseService {
+      private:
+        SocketReactor reactor; //!< The reactor which is used to wait on sockets rather than blocking in socket syscalls
+
+        /**
+         * @brief Receives data from a socket without blocking in the receive syscall
+         * @param flags The flags for the receive in terms of the guest's BSD values
+         */
+        ssize_t ReceiveBuffer(i32 fd, span<u8> buffer, i32 flags, sockaddr *address = nullptr, socklen_t *addressLength = nullptr);
+
+        /**
+         * @brief Sends data to a socket without blocking in the send syscall, all data is sent if the socket is in blocking mode
+         * @param flags The flags for the send in terms of the guest's BSD values
+         */
+        ssize_t SendBuffer(i32 fd, span<u8> buffer, i32 flags, const sockaddr *address = nullptr, socklen_t addressLength = 0);
+
       public:
         IClient(const DeviceState &state, ServiceManager &manager);
 
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "socket_reactor.h"
+
+namespace skyline::service::socket {
+    SocketReactor::SocketReactor() : epollFd{epoll_create1(EPOLL_CLOEXEC)}, wakeFd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)} {
+        if (epollFd < 0)
+            throw exception("Failed to create the socket reactor epoll instance: {}", strerror(errno));
+        if (wakeFd < 0)
+            throw exception("Failed to create the socket reactor eventfd: {}", strerror(errno));
+
+        epoll_event event{.events = EPOLLIN, .data = {.fd = wakeFd}};
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0)
+            throw exception("Failed to register the socket reactor eventfd: {}", strerror(errno));
+
+        thread = std::thread(&SocketReactor::ReactorThread, this);
+    }
+
+    SocketReactor::~SocketReactor() {
+        {
+            std::scoped_lock lock{mutex};
+            exiting = true;
+        }
+
+        u64 value{1};
+        write(wakeFd, &value, sizeof(value));
+        if (thread.joinable())
+            thread.join();
+
+        {
+            std::scoped_lock lock{mutex};
+            for (auto &[fd, registration] : registrations)
+                WakeWaiters(registration);
+        }
+
+        close(wakeFd);
+        close(epollFd);
+    }
+
+    void SocketReactor::ReactorThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-SockReactor")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::array<epoll_event, 16> events;
+        while (true) {
+            int count{epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), -1)};
+            if (count < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                Logger::Error("Socket reactor failed to wait on epoll: {}", strerror(errno));
+                return;
+            }
+
+            std::scoped_lock lock{mutex};
+            for (const auto &event : span{events}.first(static_cast<size_t>(count))) {
+                if (event.data.fd == wakeFd) {
+                    if (exiting)
+                        return;
+                    continue;
+                }
+
+                if (auto it{registrations.find(event.data.fd)}; it != registrations.end()) {
+                    it->second.events = 0; // EPOLLONESHOT disarms the socket after it has been triggered
+                    WakeWaiters(it->second);
+                }
+            }
+        }
+    }
+
+    void SocketReactor::WakeWaiters(Registration &registration) {
+        for (auto waiter : registration.waiters) {
+            waiter->woken = true;
+            waiter->condition.notify_one();
+        }
+        registration.waiters.clear();
+    }
+
+    static u32 ToEpollEvents(short pollEvents) {
+        u32 events{};
+        if (pollEvents & (POLLIN | POLLRDNORM | POLLRDBAND))
+            events |= EPOLLIN;
+        if (pollEvents & POLLPRI)
+            events |= EPOLLPRI;
+        if (pollEvents & (POLLOUT | POLLWRNORM | POLLWRBAND))
+            events |= EPOLLOUT;
+        return events | EPOLLRDHUP; // Errors and hangups are always reported by epoll, peer shutdowns need to be requested
+    }
+
+    bool SocketReactor::Wait(span<pollfd> fds, std::optional<Clock::time_point> deadline) {
+        Waiter waiter;
+        std::unique_lock lock{mutex};
+
+        for (const auto &fd : fds) {
+            if (fd.fd < 0)
+                continue;
+
+            auto &registration{registrations[fd.fd]};
+            registration.waiters.push_back(&waiter);
+
+            // The socket is always re-armed with the union of all waiters' events, epoll evaluates readiness during the control operation so readiness prior to this isn't lost
+            u32 events{registration.events | ToEpollEvents(fd.events)};
+            epoll_event event{.events = events | EPOLLONESHOT, .data = {.fd = fd.fd}};
+            int result{epoll_ctl(epollFd, EPOLL_CTL_MOD, fd.fd, &event)};
+            if (result < 0 && errno == ENOENT)
+                result = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd.fd, &event);
+
+            if (result < 0) {
+                // Files such as regular files don't support epoll while invalid descriptors should be reported by retrying the operation, both are handled by not waiting at all
+                WakeWaiters(registration);
+                registrations.erase(fd.fd);
+            } else {
+                registration.events = events;
+            }
+        }
+
+        auto predicate{[&waiter] { return waiter.woken; }};
+        if (deadline)
+            waiter.condition.wait_until(lock, *deadline, predicate);
+        else if (!fds.empty())
+            waiter.condition.wait(lock, predicate);
+
+        // The waiter may still be registered on other sockets than the one that woke it
+        for (const auto &fd : fds)
+            if (auto it{registrations.find(fd.fd)}; it != registrations.end())
+                std::erase(it->second.waiters, &waiter);
+
+        return waiter.woken;
+    }
+
+    void SocketReactor::Cancel(int fd) {
+        std::scoped_lock lock{mutex};
+        if (auto it{registrations.find(fd)}; it != registrations.end()) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr); // This is expected to fail if the socket was already closed as that implicitly removes it
+            WakeWaiters(it->second);
+            registrations.erase(it);
+        }
+    }
+
+    std::optional<SocketReactor::Clock::time_point> SocketReactor::GetDeadline(int fd, int option) {
+        timeval timeout{};
+        socklen_t length{sizeof(timeout)};
+        if (getsockopt(fd, SOL_SOCKET, option, &timeout, &length) < 0 || (timeout.tv_sec == 0 && timeout.tv_usec == 0))
+            return std::nullopt;
+
+        return Clock::now() + std::chrono::seconds{timeout.tv_sec} + std::chrono::microseconds{timeout.tv_usec};
+    }
+
+    int SocketReactor::Poll(span<pollfd> fds, int timeout) {
+        std::optional<Clock::time_point> deadline;
+        if (timeout > 0)
+            deadline = Clock::now() + std::chrono::milliseconds{timeout};
+
+        int result;
+        while ((result = poll(fds.data(), fds.size(), 0)) == 0 && timeout != 0)
+            if (!Wait(fds, deadline))
+                break;
+
+        return result;
+    }
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <thread>
+#include <condition_variable>
+#include <common.h>
+
+namespace skyline::service::socket {
+    /**
+     * @brief An epoll-based reactor which allows threads to wait for readiness on a set of sockets with a deadline, the wait can be cancelled from other threads unlike blocking socket syscalls
+     * @note Sockets are registered with EPOLLONESHOT and only armed while a thread is waiting on them, every waiter on a socket is woken when it becomes ready and is expected to retry its operation
+     */
+    class SocketReactor {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+      private:
+        /**
+         * @brief The state of a single thread waiting on the reactor
+         */
+        struct Waiter {
+            std::condition_variable condition;
+            bool woken{}; //!< If any of the sockets being waited on became ready or were cancelled
+        };
+
+        /**
+         * @brief The state of a single socket that has been registered with the epoll instance
+         */
+        struct Registration {
+            u32 events{}; //!< The epoll events that are currently armed for the socket, this is 0 after it has been triggered
+            std::vector<Waiter *> waiters;
+        };
+
+        int epollFd;
+        int wakeFd; //!< An eventfd which is used to wake the reactor thread for it to exit
+        std::mutex mutex; //!< Synchronizes access to all registrations and waiters
+        std::unordered_map<int, Registration> registrations;
+        bool exiting{};
+        std::thread thread;
+
+        void ReactorThread();
+
+        /**
+         * @brief Wakes all threads waiting on the supplied registration and clears them from it
+         * @note The mutex must be locked when calling this
+         */
+        static void WakeWaiters(Registration &registration);
+
+      public:
+        SocketReactor();
+
+        ~SocketReactor();
+
+        /**
+         * @brief Blocks the calling thread till any of the supplied sockets are ready for any of their requested poll events, the deadline expires or the socket is cancelled
+         * @param deadline The point in time to stop waiting at, no deadline denotes an infinite wait
+         * @return If the wait ended prior to the deadline, the caller should retry its operation in this case
+         * @note A socket which doesn't support epoll is treated as always being ready
+         */
+        bool Wait(span<pollfd> fds, std::optional<Clock::time_point> deadline);
+
+        /**
+         * @brief Wakes all threads waiting on the supplied socket and forgets its registration, this must be called after closing a socket
+         */
+        void Cancel(int fd);
+
+        /**
+         * @param option The socket option containing the timeout, either SO_RCVTIMEO or SO_SNDTIMEO
+         * @return The point in time at which an operation on the socket should time out, if the socket has a timeout set
+         */
+        static std::optional<Clock::time_point> GetDeadline(int fd, int option);
+
+        /**
+         * @brief Performs a socket operation which must not block, if it would've blocked on a socket in blocking mode then it's retried when the socket is ready for the supplied events
+         * @param nonBlocking If the operation shouldn't be retried regardless of the mode of the socket
+         * @param operation A function performing the operation, it should return -1 with errno set to EAGAIN rather than blocking
+         * @return The result of the operation, errno is set accordingly if it's -1 and is EAGAIN if the timeout of the socket expired
+         */
+        template<typename Function>
+        ssize_t PerformOperation(int fd, short events, bool nonBlocking, Function operation) {
+            ssize_t result{operation()};
+            if (result != -1 || (errno != EAGAIN && errno != EWOULDBLOCK) || nonBlocking)
+                return result;
+
+            int flags{fcntl(fd, F_GETFL)};
+            if (flags == -1 || (flags & O_NONBLOCK))
+                return result;
+
+            // The calling guest thread has already been removed from its core's scheduler queue for the duration of the IPC, waiting here doesn't hold up other guest threads
+            auto deadline{GetDeadline(fd, (events & POLLOUT) ? SO_SNDTIMEO : SO_RCVTIMEO)};
+            pollfd pollFd{.fd = fd, .events = events};
+            while (Wait(span<pollfd>{pollFd}, deadline)) {
+                result = operation();
+                if (result != -1 || (errno != EAGAIN && errno != EWOULDBLOCK))
+                    return result;
+            }
+
+            errno = EAGAIN; // This matches the behavior of a blocking socket call timing out
+            return -1;
+        }
+
+        /**
+         * @brief Polls the supplied sockets with the semantics of poll(), the sockets are only ever polled without blocking while waiting for them is done on the reactor
+         * @param timeout The timeout in milliseconds, 0 returns immediately and a negative value denotes an infinite wait
+         * @return The result of the final poll() call, errno is set accordingly if it's -1
+         */
+        int Poll(span<pollfd> fds, int timeout);
+    };
+}
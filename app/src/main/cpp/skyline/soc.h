@@ -6,6 +6,8 @@
 #include "soc/smmu.h"
 #include "soc/host1x.h"
 #include "soc/gm20b/gpfifo.h"
+#include "soc/gm20b/gpfifo_capture.h"
+#include "soc/gm20b/gpfifo_scheduler.h"
 
 namespace skyline::soc {
     /**
@@ -16,6 +18,8 @@ namespace skyline::soc {
       public:
         SMMU smmu;
         host1x::Host1x host1x;
+        std::unique_ptr<gm20b::GpfifoCapture> gpfifoCapture; //!< The capture of all GPFIFO submissions, this is only present if it's enabled in the settings
+        std::unique_ptr<gm20b::GpfifoScheduler> gpfifoScheduler; //!< The shared scheduler for all GPFIFO channels, channels use dedicated threads if this isn't present
 
         SOC(const DeviceState &state) : host1x(state) {}
     };
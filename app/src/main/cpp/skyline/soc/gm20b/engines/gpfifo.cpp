@@ -5,6 +5,7 @@
 #include <soc.h>
 #include <soc/gm20b/gmmu.h>
 #include <soc/gm20b/channel.h>
+#include <soc/gm20b/gpfifo_scheduler.h>
 #include "gpfifo.h"
 
 namespace skyline::soc::gm20b::engine {
@@ -26,11 +27,17 @@ namespace skyline::soc::gm20b::engine {
                 } else if (action.operation == Registers::Syncpoint::Operation::Wait) {
                     Logger::Debug("Wait syncpoint: {}, thresh: {}", +action.index, registers.syncpoint->payload);
 
+                    if (skipWaits)
+                        return;
+
                     // Wait forever for another channel to increment
 
                     channelCtx.executor.Submit();
                     channelCtx.Unlock();
-                    syncpoints.at(action.index).host.Wait(registers.syncpoint->payload, std::chrono::steady_clock::duration::max());
+                    {
+                        GpfifoScheduler::BlockingScope blocking;
+                        syncpoints.at(action.index).host.Wait(registers.syncpoint->payload, std::chrono::steady_clock::duration::max());
+                    }
                     channelCtx.Lock();
                 }
             })
@@ -41,11 +48,17 @@ namespace skyline::soc::gm20b::engine {
                 switch (action.operation) {
                     case Registers::Semaphore::Operation::Acquire:
                         Logger::Debug("Acquire semaphore: 0x{:X} payload: {}", address, registers.semaphore->payload);
+                        if (skipWaits)
+                            break;
+
                         channelCtx.executor.Submit();
                         channelCtx.Unlock();
 
-                        while (channelCtx.asCtx->gmmu.Read<u32>(address) != registers.semaphore->payload)
-                            std::this_thread::yield();
+                        {
+                            GpfifoScheduler::BlockingScope blocking;
+                            while (channelCtx.asCtx->gmmu.Read<u32>(address) != registers.semaphore->payload)
+                                std::this_thread::yield();
+                        }
 
                         channelCtx.Lock();
                         break;
@@ -64,11 +77,17 @@ namespace skyline::soc::gm20b::engine {
                         break;
                     case Registers::Semaphore::Operation::AcqGeq    :
                         Logger::Debug("Acquire semaphore: 0x{:X} payload: {}", address, registers.semaphore->payload);
+                        if (skipWaits)
+                            break;
+
                         channelCtx.executor.Submit();
                         channelCtx.Unlock();
 
-                        while (channelCtx.asCtx->gmmu.Read<u32>(address) < registers.semaphore->payload)
-                            std::this_thread::yield();
+                        {
+                            GpfifoScheduler::BlockingScope blocking;
+                            while (channelCtx.asCtx->gmmu.Read<u32>(address) < registers.semaphore->payload)
+                                std::this_thread::yield();
+                        }
 
                         channelCtx.Lock();
                         break;
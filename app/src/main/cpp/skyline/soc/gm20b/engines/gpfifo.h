@@ -17,6 +17,7 @@ namespace skyline::soc::gm20b::engine {
     class GPFIFO {
       public:
         static constexpr u32 RegisterCount{0x40}; //!< The number of GPFIFO registers
+        bool skipWaits{}; //!< If syncpoint waits and semaphore acquires should be skipped, this is used when replaying a GPFIFO trace where the ordering of the trace already satisfies them
 
       private:
         /**
@@ -9,6 +9,7 @@
 #include <soc.h>
 #include <os.h>
 #include "channel.h"
+#include "gpfifo_scheduler.h"
 #include "macro/macro_state.h"
 
 namespace skyline::soc::gm20b {
@@ -87,7 +88,10 @@ namespace skyline::soc::gm20b {
         gpfifoEngine(state.soc->host1x.syncpoints, channelCtx),
         channelCtx(channelCtx),
         gpEntries(numEntries),
-        thread(std::thread(&ChannelGpfifo::Run, this)) {}
+        capture(state.soc->gpfifoCapture.get()),
+        captureChannelId(capture ? capture->RegisterChannel(*channelCtx.asCtx) : 0),
+        scheduler(state.soc->gpfifoScheduler.get()),
+        thread(scheduler ? std::thread{} : std::thread(&ChannelGpfifo::Run, this)) {}
 
     void ChannelGpfifo::SendFull(u32 method, GpfifoArgument argument, SubchannelId subChannel, bool lastCall) {
         if (method < engine::GPFIFO::RegisterCount) {
@@ -356,44 +360,71 @@ namespace skyline::soc::gm20b {
                 }
             }};
 
-            bool hitEnd{[&]() {
+            auto dispatchMethod{[&]() {
                 if (methodHeader.methodSubChannel != SubchannelId::ThreeD) [[unlikely]]
                     channelCtx.maxwell3D.FlushEngineState(); // Flush the 3D engine state when doing any calls to other engines
                 return processMethod();
-            }()};
+            }};
+
+            bool hitEnd;
+            if (subchannelCpuTime) [[unlikely]] {
+                i64 startTime{util::GetTimeNs()};
+                hitEnd = dispatchMethod();
+                (*subchannelCpuTime)[static_cast<u8>(methodHeader.methodSubChannel)] += util::GetTimeNs() - startTime;
+            } else {
+                hitEnd = dispatchMethod();
+            }
 
             if (hitEnd)
                 break;
         }
     }
 
+    void ChannelGpfifo::ProcessEntry(GpEntry gpEntry) {
+        Logger::Debug("Processing pushbuffer: 0x{:X}, Size: 0x{:X}", gpEntry.Address(), +gpEntry.size);
+
+        if (!channelLocked) {
+            channelCtx.Lock();
+            channelLocked = true;
+        }
+
+        if (capture) [[unlikely]] {
+            capture->BeginEntry(captureChannelId, gpEntry);
+            Process(gpEntry);
+            capture->EndEntry();
+        } else {
+            Process(gpEntry);
+        }
+    }
+
+    void ChannelGpfifo::FlushEntries() {
+        Logger::Debug("Finished processing pushbuffer batch");
+        if (channelLocked) {
+            channelCtx.executor.Submit();
+            if (capture) [[unlikely]]
+                capture->RecordFlush(captureChannelId);
+            channelCtx.Unlock();
+            channelLocked = false;
+        }
+    }
+
     void ChannelGpfifo::Run() {
         if (int result{pthread_setname_np(pthread_self(), "GPFIFO")})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
 
+        static std::atomic<i64> threadCount{}; //!< The amount of dedicated GPFIFO threads across all channels
+        TRACE_COUNTER("gpu", "GPFIFO Dedicated Threads", ++threadCount);
+        Logger::Debug("Started dedicated GPFIFO thread, {} thread(s) are running", threadCount.load());
+
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
             signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // We may access NCE trapped memory
 
-            bool channelLocked{};
-
-            gpEntries.Process([this, &channelLocked](GpEntry gpEntry) {
-                Logger::Debug("Processing pushbuffer: 0x{:X}, Size: 0x{:X}", gpEntry.Address(), +gpEntry.size);
-
-                if (!channelLocked) {
-                    channelCtx.Lock();
-                    channelLocked = true;
-                }
-
-                Process(gpEntry);
-            }, [this, &channelLocked]() {
+            gpEntries.Process([this](GpEntry gpEntry) {
+                ProcessEntry(gpEntry);
+            }, [this]() {
                 // If we run out of GpEntries to process ensure we submit any remaining GPU work before waiting for more to arrive
-                Logger::Debug("Finished processing pushbuffer batch");
-                if (channelLocked) {
-                    channelCtx.executor.Submit();
-                    channelCtx.Unlock();
-                    channelLocked = false;
-                }
+                FlushEntries();
             });
         } catch (const signal::SignalException &e) {
             if (e.signal != SIGINT) {
@@ -413,17 +444,35 @@ namespace skyline::soc::gm20b {
             signal::BlockSignal({SIGINT});
             state.process->Kill(false);
         }
+
+        TRACE_COUNTER("gpu", "GPFIFO Dedicated Threads", --threadCount);
     }
 
     void ChannelGpfifo::Push(span<GpEntry> entries) {
-        gpEntries.Append(entries);
+        if (!scheduler) {
+            gpEntries.Append(entries);
+            return;
+        }
+
+        // Pushing blocks when the FIFO is full, entries are pushed in batches that fit into it and the channel is scheduled after each so a worker can make space for the next batch
+        while (!entries.empty()) {
+            auto batch{entries.first(std::max<size_t>(1, std::min(entries.size(), gpEntries.Capacity() - gpEntries.Size())))};
+            gpEntries.Append(batch);
+            scheduler->Schedule(*this);
+            entries = entries.subspan(batch.size());
+        }
     }
 
     void ChannelGpfifo::Push(GpEntry entry) {
         gpEntries.Push(entry);
+        if (scheduler)
+            scheduler->Schedule(*this);
     }
 
     ChannelGpfifo::~ChannelGpfifo() {
+        if (scheduler)
+            scheduler->Unregister(*this);
+
         if (thread.joinable()) {
             pthread_kill(thread.native_handle(), SIGINT);
             thread.join();
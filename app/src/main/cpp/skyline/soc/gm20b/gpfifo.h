@@ -9,6 +9,9 @@
 
 namespace skyline::soc::gm20b {
     struct ChannelContext;
+    class GpfifoCapture;
+    class GpfifoReplayer;
+    class GpfifoScheduler;
 
     /**
      * @brief Mapping of subchannel names to their corresponding subchannel IDs
@@ -129,6 +132,13 @@ namespace skyline::soc::gm20b {
             } state; //!< The type of method to resume
         } resumeState{};
 
+        GpfifoCapture *capture; //!< The capture that processed entries are recorded into, this is null if GPFIFO capture is disabled
+        u32 captureChannelId{}; //!< The ID of this channel in the GPFIFO capture
+        std::array<i64, 8> *subchannelCpuTime{}; //!< If set, the host time spent processing methods is accumulated into this for each subchannel, this is used to profile replays
+
+        GpfifoScheduler *scheduler; //!< The shared scheduler that processes this channel, this is null if the channel has a dedicated thread
+        bool channelLocked{}; //!< If the channel is locked by the thread processing its entries
+
         std::thread thread; //!< The thread that manages processing of pushbuffers
 
         /**
@@ -151,11 +161,24 @@ namespace skyline::soc::gm20b {
          */
         void Process(GpEntry gpEntry);
 
+        /**
+         * @brief Processes a single entry from the FIFO, locking the channel if it isn't already locked
+         */
+        void ProcessEntry(GpEntry gpEntry);
+
+        /**
+         * @brief Submits any GPU work from processed entries and unlocks the channel, this is done whenever the FIFO runs out of entries
+         */
+        void FlushEntries();
+
         /**
          * @brief Executes all pending entries in the FIFO and polls for more
          */
         void Run();
 
+        friend GpfifoReplayer;
+        friend GpfifoScheduler;
+
       public:
         /**
          * @param numEntries The number of gpEntries to allocate space for in the FIFO
@@ -0,0 +1,260 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <tsl/robin_set.h>
+#include <common/utils.h>
+#include "gpfifo_capture.h"
+
+namespace skyline::soc::gm20b {
+    namespace {
+        constexpr size_t UnsizedAccessSize{0x10000}; //!< The amount of memory that is captured for accesses of unknown size, such as shader programs or descriptor pools looked up through LookupBlock
+
+        /**
+         * @brief A page accessed while processing an entry which will be written out with it
+         */
+        struct PendingPage {
+            u32 addressSpaceId;
+            u64 virt;
+            std::array<u8, trace::PageSize> contents;
+        };
+
+        /**
+         * @brief The state of an entry which is being processed on the current thread
+         */
+        struct PendingEntry {
+            GpfifoCapture *capture; //!< The capture that the entry belongs to, this is null if no entry is being processed
+            u32 channelId;
+            GpEntry gpEntry{0, 0};
+            std::vector<u32> pushBuffer;
+            std::vector<PendingPage> pages;
+            tsl::robin_set<u64> pageKeys; //!< The address space ID and VA of all pages in `pages`, this is used to only capture the first access to a page
+        };
+
+        /**
+         * @brief Reads a single page of GPU memory, any parts of it that are unmapped or sparsely mapped are read as zeroes which matches what is read from sparse mappings
+         * @note Pages may straddle multiple GMMU blocks, each of these is read separately
+         */
+        void ReadPage(GMMU &gmmu, u64 page, span<u8> contents) {
+            for (u64 offset{}; offset < trace::PageSize;) {
+                auto [block, blockOffset]{gmmu.LookupBlock(page + offset)};
+                u64 size{std::min<u64>(trace::PageSize - offset, block.size() - blockOffset)};
+                if (!size) [[unlikely]]
+                    size = trace::PageSize - offset; // The VA is past the end of the address space, this can only be hit by the final page
+
+                if (block.valid())
+                    std::memcpy(contents.data() + offset, block.data() + blockOffset, size);
+                else
+                    std::memset(contents.data() + offset, 0, size);
+                offset += size;
+            }
+        }
+
+        thread_local PendingEntry pendingEntry;
+        thread_local bool insideCapture{}; //!< If the current thread is inside the capture, GMMU accesses from this are made by the capture itself and are ignored
+
+        struct CaptureScope {
+            CaptureScope() {
+                insideCapture = true;
+            }
+
+            ~CaptureScope() {
+                insideCapture = false;
+            }
+        };
+    }
+
+    GpfifoCapture::GpfifoCapture(const std::string &path) : stream{path, std::ios::binary | std::ios::trunc}, startTimestamp{util::GetTimeNs()} {
+        if (stream.fail())
+            throw exception("Failed to open GPFIFO capture file: {}", path);
+
+        trace::FileHeader header{
+            .magic = trace::Magic,
+            .version = trace::Version,
+        };
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        Logger::Info("Capturing GPFIFO submissions to {}", path);
+    }
+
+    GpfifoCapture::~GpfifoCapture() {
+        Flush();
+    }
+
+    void GpfifoCapture::WriteRecord(trace::RecordType type, u32 id, span<const u8> payload, span<const u8> extraPayload) {
+        trace::RecordHeader header{
+            .type = type,
+            .id = id,
+            .timestamp = util::GetTimeNs() - startTimestamp,
+            .size = static_cast<u32>(payload.size() + extraPayload.size()),
+        };
+
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (!payload.empty())
+            stream.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!extraPayload.empty())
+            stream.write(reinterpret_cast<const char *>(extraPayload.data()), static_cast<std::streamsize>(extraPayload.size()));
+    }
+
+    void GpfifoCapture::CapturePage(u32 addressSpaceId, u64 virt, span<const u8> contents) {
+        auto &addressSpace{addressSpaces[addressSpaceId]};
+        u64 hash{XXH64(contents.data(), contents.size(), 0)};
+        auto it{addressSpace.pageHashes.find(virt)};
+        if (it != addressSpace.pageHashes.end()) {
+            if (it->second == hash)
+                return;
+            it.value() = hash;
+        } else {
+            addressSpace.pageHashes.emplace(virt, hash);
+        }
+
+        WriteRecord(trace::RecordType::Memory, addressSpaceId, span<const u64>{virt}.cast<const u8>(), contents);
+    }
+
+    void GpfifoCapture::CaptureModifiedPages(u32 addressSpaceId) {
+        CaptureScope scope;
+        auto &addressSpace{addressSpaces[addressSpaceId]};
+
+        std::vector<u64> pages;
+        pages.reserve(addressSpace.pageHashes.size());
+        for (const auto &[page, hash] : addressSpace.pageHashes)
+            pages.push_back(page);
+
+        std::array<u8, trace::PageSize> contents;
+        for (u64 page : pages) {
+            ReadPage(addressSpace.gmmu, page, contents);
+            CapturePage(addressSpaceId, page, contents);
+        }
+    }
+
+    void GpfifoCapture::OnAccess(GMMU &gmmu, u32 addressSpaceId, u64 virt, u64 size) {
+        if (insideCapture)
+            return;
+
+        bool pending{pendingEntry.capture == this};
+        if (pending && virt == pendingEntry.gpEntry.Address() && size == pendingEntry.pushBuffer.size() * sizeof(u32))
+            return; // The pushbuffer of the entry is already recorded alongside it
+
+        CaptureScope scope;
+        if (!size)
+            size = UnsizedAccessSize;
+
+        std::unique_lock lock{mutex, std::defer_lock};
+        if (!pending)
+            lock.lock();
+
+        std::array<u8, trace::PageSize> contents;
+        for (u64 page{util::AlignDown(virt, trace::PageSize)}, end{util::AlignUp(virt + size, trace::PageSize)}; page < end; page += trace::PageSize) {
+            if (pending) {
+                if (pendingEntry.pageKeys.emplace((static_cast<u64>(addressSpaceId) << GmmuAddressSpaceBits) | page).second)
+                    ReadPage(gmmu, page, pendingEntry.pages.emplace_back(PendingPage{addressSpaceId, page}).contents);
+            } else {
+                ReadPage(gmmu, page, contents);
+                CapturePage(addressSpaceId, page, contents);
+            }
+        }
+    }
+
+    void GpfifoCapture::AttachAddressSpace(AddressSpaceContext &asCtx) {
+        std::scoped_lock lock{mutex};
+        auto addressSpaceId{static_cast<u32>(addressSpaces.size())};
+        auto &addressSpace{addressSpaces.emplace_back(AddressSpace{*this, asCtx.gmmu, addressSpaceId})};
+        WriteRecord(trace::RecordType::AddressSpace, addressSpaceId, {});
+
+        asCtx.gmmu.accessObserverContext = &addressSpace;
+        asCtx.gmmu.accessObserver = [](void *context, u64 virt, u64 size) {
+            auto &addressSpace{*static_cast<AddressSpace *>(context)};
+            addressSpace.capture.OnAccess(addressSpace.gmmu, addressSpace.id, virt, size);
+        };
+    }
+
+    u32 GpfifoCapture::RegisterChannel(AddressSpaceContext &asCtx) {
+        std::scoped_lock lock{mutex};
+        for (u32 addressSpaceId{}; addressSpaceId < addressSpaces.size(); addressSpaceId++) {
+            if (&addressSpaces[addressSpaceId].gmmu == &asCtx.gmmu) {
+                auto channelId{static_cast<u32>(channelAddressSpaces.size())};
+                channelAddressSpaces.push_back(addressSpaceId);
+                channelBatchActive.push_back(false);
+                WriteRecord(trace::RecordType::Channel, channelId, span<const u32>{addressSpaceId}.cast<const u8>());
+                return channelId;
+            }
+        }
+
+        throw exception("Channel address space wasn't attached to the GPFIFO capture");
+    }
+
+    void GpfifoCapture::BeginEntry(u32 channelId, GpEntry gpEntry) {
+        GMMU *gmmu;
+        {
+            std::scoped_lock lock{mutex};
+            auto addressSpaceId{channelAddressSpaces.at(channelId)};
+            gmmu = &addressSpaces[addressSpaceId].gmmu;
+
+            // The guest CPU writes to memory between batches of entries, these need to precede the entry as they're not observed through the GMMU
+            if (!channelBatchActive[channelId]) {
+                CaptureModifiedPages(addressSpaceId);
+                channelBatchActive[channelId] = true;
+            }
+        }
+
+        pendingEntry.capture = this;
+        pendingEntry.channelId = channelId;
+        pendingEntry.gpEntry = gpEntry;
+        pendingEntry.pushBuffer.resize(gpEntry.size);
+        if (gpEntry.size) {
+            CaptureScope scope;
+            gmmu->Read<u32>(pendingEntry.pushBuffer, gpEntry.Address());
+        }
+    }
+
+    void GpfifoCapture::EndEntry() {
+        {
+            std::scoped_lock lock{mutex};
+            for (const auto &page : pendingEntry.pages)
+                CapturePage(page.addressSpaceId, page.virt, page.contents);
+
+            WriteRecord(trace::RecordType::Entry, pendingEntry.channelId, span<const GpEntry>{pendingEntry.gpEntry}.cast<const u8>(), span<const u32>{pendingEntry.pushBuffer}.cast<const u8>());
+        }
+
+        pendingEntry.capture = nullptr;
+        pendingEntry.pages.clear();
+        pendingEntry.pageKeys.clear();
+    }
+
+    void GpfifoCapture::RecordFlush(u32 channelId) {
+        std::scoped_lock lock{mutex};
+        channelBatchActive.at(channelId) = false;
+        WriteRecord(trace::RecordType::Flush, channelId, {});
+    }
+
+    void GpfifoCapture::RecordFrame() {
+        std::scoped_lock lock{mutex};
+        WriteRecord(trace::RecordType::Frame, 0, {});
+    }
+
+    void GpfifoCapture::Flush() {
+        std::scoped_lock lock{mutex};
+        stream.flush();
+    }
+
+    GpfifoTraceReader::GpfifoTraceReader(const std::string &path) : stream{path, std::ios::binary} {
+        if (stream.fail())
+            throw exception("Failed to open GPFIFO trace: {}", path);
+
+        trace::FileHeader header{};
+        stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (stream.fail() || header.magic != trace::Magic)
+            throw exception("Invalid GPFIFO trace: {}", path);
+        if (header.version != trace::Version)
+            throw exception("Unsupported GPFIFO trace version: {} (Expected {})", header.version, trace::Version);
+    }
+
+    bool GpfifoTraceReader::Next(trace::RecordHeader &header, std::vector<u8> &payload) {
+        stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (stream.gcount() != sizeof(header))
+            return false; // A partially written record at the end of the trace is treated as the end of it
+
+        payload.resize(header.size);
+        stream.read(reinterpret_cast<char *>(payload.data()), static_cast<std::streamsize>(header.size));
+        return stream.gcount() == header.size;
+    }
+}
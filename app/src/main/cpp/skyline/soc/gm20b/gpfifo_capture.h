@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <fstream>
+#include <deque>
+#include <tsl/robin_map.h>
+#include "gmmu.h"
+#include "gpfifo.h"
+
+namespace skyline::soc::gm20b {
+    /**
+     * @brief The on-disk format of a GPFIFO trace, this is a header followed by a flat sequence of records
+     * @note Records are ordered such that replaying them sequentially reproduces the workload, memory records that an entry depends on always precede the entry
+     */
+    namespace trace {
+        constexpr u32 Magic{util::MakeMagic<u32>("GPFT")};
+        constexpr u32 Version{1}; //!< The version of the trace format, this must be incremented whenever the format changes
+        constexpr size_t PageSize{1 << GmmuSmallPageSizeBits}; //!< The granularity at which GPU memory is captured
+
+        struct FileHeader {
+            u32 magic; //!< The magic of the trace: 'GPFT'
+            u32 version;
+        };
+
+        enum class RecordType : u32 {
+            AddressSpace, //!< A new GPU address space was created, it has no payload
+            Channel, //!< A new channel was created, the payload is the u32 ID of its address space
+            Memory, //!< The contents of a single page of GPU memory, the payload is the u64 GPU VA of the page followed by its contents
+            Entry, //!< A GpEntry that was processed, the payload is the GpEntry followed by the pushbuffer words it references
+            Flush, //!< The channel ran out of entries and submitted all pending work to the host GPU, it has no payload
+            Frame, //!< A frame was presented, it has no payload
+        };
+
+        struct RecordHeader {
+            RecordType type;
+            u32 id; //!< The ID of the address space for AddressSpace/Memory records and the ID of the channel for Channel/Entry/Flush records
+            i64 timestamp; //!< The time relative to the start of the capture at which the record was written in nanoseconds
+            u32 size; //!< The size of the payload following the header
+            u32 _pad_;
+        };
+        static_assert(sizeof(RecordHeader) == 0x18);
+    }
+
+    /**
+     * @brief Captures all GPFIFO entries alongside the pushbuffer words and GPU memory they reference into a trace file which can be replayed by GpfifoReplayer
+     * @note GPU memory is captured at page granularity when it's accessed through the GMMU, pages are only written again when their contents change
+     * @note All pages captured in an address space are checked for modifications at the start of every batch of entries on a channel, this catches CPU writes that don't go through the GMMU
+     * @note Accesses made while processing an entry are buffered until the entry has been processed so that they precede it in the trace regardless of other channels
+     */
+    class GpfifoCapture {
+      private:
+        /**
+         * @brief The state of an address space that is being captured
+         */
+        struct AddressSpace {
+            GpfifoCapture &capture;
+            GMMU &gmmu;
+            u32 id;
+            tsl::robin_map<u64, u64> pageHashes; //!< A map from the GPU VA of every captured page to the XXH64 hash of its last captured contents
+        };
+
+        std::mutex mutex; //!< Synchronizes writing records and all capture state
+        std::ofstream stream;
+        i64 startTimestamp;
+        std::deque<AddressSpace> addressSpaces; //!< All captured address spaces indexed by their ID, a deque is used as references to elements must remain valid
+        std::vector<u32> channelAddressSpaces; //!< The address space ID of every channel, indexed by channel ID
+        std::vector<bool> channelBatchActive; //!< If every channel is in the middle of a batch of entries, indexed by channel ID
+
+        void WriteRecord(trace::RecordType type, u32 id, span<const u8> payload, span<const u8> extraPayload = {});
+
+        /**
+         * @brief Writes a memory record for the page if its contents differ from the last captured contents
+         * @note The mutex must be locked when calling this
+         */
+        void CapturePage(u32 addressSpaceId, u64 virt, span<const u8> contents);
+
+        /**
+         * @brief Recaptures all previously captured pages of an address space which have changed since they were last captured
+         * @note This is required as the interconnect only translates GPU VAs once, any further CPU writes to the memory backing buffers and textures never go through the GMMU
+         * @note The mutex must be locked when calling this
+         */
+        void CaptureModifiedPages(u32 addressSpaceId);
+
+        /**
+         * @brief Captures all pages that overlap the supplied range, this is called by the GMMU on every access
+         */
+        void OnAccess(GMMU &gmmu, u32 addressSpaceId, u64 virt, u64 size);
+
+      public:
+        GpfifoCapture(const std::string &path);
+
+        ~GpfifoCapture();
+
+        /**
+         * @brief Registers a newly created address space with the capture and starts tracking accesses to it
+         * @note This must be called before the address space is used by any channel
+         */
+        void AttachAddressSpace(AddressSpaceContext &asCtx);
+
+        /**
+         * @return The ID of the channel in the trace
+         */
+        u32 RegisterChannel(AddressSpaceContext &asCtx);
+
+        /**
+         * @brief Starts capturing an entry which is about to be processed on the calling thread, the entry is only written out by EndEntry
+         * @note If this is the first entry since the last flush of the channel, any pages modified since they were captured are written out first
+         */
+        void BeginEntry(u32 channelId, GpEntry gpEntry);
+
+        /**
+         * @brief Writes out all memory accessed since BeginEntry followed by the entry itself
+         */
+        void EndEntry();
+
+        void RecordFlush(u32 channelId);
+
+        void RecordFrame();
+
+        /**
+         * @brief Flushes all written records to the trace file
+         */
+        void Flush();
+    };
+
+    /**
+     * @brief A sequential reader for traces written by GpfifoCapture
+     */
+    class GpfifoTraceReader {
+      private:
+        std::ifstream stream;
+
+      public:
+        GpfifoTraceReader(const std::string &path);
+
+        /**
+         * @brief Reads the next record from the trace
+         * @return If a record was read, this is false once the end of the trace has been reached
+         */
+        bool Next(trace::RecordHeader &header, std::vector<u8> &payload);
+    };
+}
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <common/signal.h>
+#include <common/utils.h>
+#include <gpu.h>
+#include <kernel/types/KProcess.h>
+#include <nce.h>
+#include <soc.h>
+#include "gmmu.h"
+#include "gpfifo_replayer.h"
+
+namespace skyline::soc::gm20b {
+    GpfifoReplayer::GpfifoReplayer(const DeviceState &state, std::string pPath) : state{state}, path{std::move(pPath)} {
+        if (state.soc->gpfifoCapture)
+            throw exception("Cannot replay a GPFIFO trace while GPFIFO capture is enabled");
+
+        // All pages that are referenced by the trace are determined upfront so they can be mapped as contiguous regions, the interconnect expects buffers and textures to be contiguous in host memory
+        std::vector<std::vector<u64>> addressSpacePages;
+        std::vector<u32> channelAddressSpaces;
+        {
+            GpfifoTraceReader reader{path};
+            trace::RecordHeader header{};
+            std::vector<u8> payload;
+            while (reader.Next(header, payload)) {
+                switch (header.type) {
+                    case trace::RecordType::AddressSpace:
+                        addressSpacePages.emplace_back();
+                        break;
+                    case trace::RecordType::Channel:
+                        channelAddressSpaces.push_back(span(payload).as<u32>());
+                        break;
+                    case trace::RecordType::Memory:
+                        addressSpacePages.at(header.id).push_back(span(payload).as<u64>());
+                        break;
+                    case trace::RecordType::Entry: {
+                        auto gpEntry{span(payload).as<GpEntry>()};
+                        auto &pages{addressSpacePages.at(channelAddressSpaces.at(header.id))};
+                        for (u64 page{util::AlignDown(gpEntry.Address(), trace::PageSize)}; page < gpEntry.Address() + gpEntry.size * sizeof(u32); page += trace::PageSize)
+                            pages.push_back(page);
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+        }
+
+        // Any heap memory past the size the guest has set is unused as it's never run, this is where all replayed memory is placed
+        auto &memory{state.process->memory};
+        u8 *heapCursor{memory.heap.data() + util::AlignUp(memory.processHeapSize, constant::PageSize)};
+
+        for (auto &pages : addressSpacePages) {
+            std::sort(pages.begin(), pages.end());
+            pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+            auto &addressSpace{addressSpaces.emplace_back(AddressSpace{std::make_shared<AddressSpaceContext>()})};
+            for (auto it{pages.begin()}; it != pages.end();) {
+                auto runEnd{std::next(it)};
+                while (runEnd != pages.end() && *runEnd == *std::prev(runEnd) + trace::PageSize)
+                    runEnd++;
+
+                size_t size{static_cast<size_t>(std::distance(it, runEnd)) * trace::PageSize};
+                span<u8> mapping{heapCursor, util::AlignUp(size, constant::PageSize)};
+                if (!memory.heap.contains(mapping)) [[unlikely]]
+                    throw exception("Out of guest heap memory for replaying 0x{:X} bytes of GPU memory at 0x{:X}", size, *it);
+
+                memory.MapHeapMemory(mapping);
+                heapCursor = mapping.end().base();
+
+                addressSpace.mappings.push_back(mapping);
+                addressSpace.asCtx->gmmu.Map(*it, mapping.data(), size);
+                it = runEnd;
+            }
+        }
+
+        for (auto addressSpaceId : channelAddressSpaces) {
+            auto &channel{channels.emplace_back(Channel{std::make_unique<ChannelContext>(state, addressSpaces.at(addressSpaceId).asCtx, ReplayGpEntryCount), addressSpaceId})};
+            channel.channelCtx->gpfifo.gpfifoEngine.skipWaits = true;
+        }
+
+        Logger::Info("Loaded GPFIFO trace with {} address space(s) and {} channel(s) from {}", addressSpaces.size(), channels.size(), path);
+    }
+
+    GpfifoReplayer::~GpfifoReplayer() {
+        channels.clear();
+        for (auto &addressSpace : addressSpaces)
+            for (auto mapping : addressSpace.mappings)
+                state.process->memory.UnmapMemory(mapping);
+    }
+
+    GpfifoReplayer::Statistics GpfifoReplayer::Replay(bool waitForGpu) {
+        // Replayed memory may be trapped by the interconnect in the same way as guest memory, writes to it need to be handled by NCE
+        signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler);
+
+        Statistics statistics{};
+        for (auto &channel : channels)
+            channel.channelCtx->gpfifo.subchannelCpuTime = &statistics.subchannelCpuTime;
+
+        auto flushChannel{[&](Channel &channel) {
+            if (!channel.locked)
+                return;
+
+            i64 submitStart{util::GetTimeNs()};
+            channel.channelCtx->executor.Submit();
+            statistics.submitCpuTime += util::GetTimeNs() - submitStart;
+
+            channel.channelCtx->Unlock();
+            channel.locked = false;
+        }};
+
+        GpfifoTraceReader reader{path};
+        trace::RecordHeader header{};
+        std::vector<u8> payload;
+        i64 startTime{util::GetTimeNs()}, lastFrameTime{startTime};
+        while (reader.Next(header, payload)) {
+            switch (header.type) {
+                case trace::RecordType::Memory: {
+                    // Memory is written by the guest CPU while channels aren't processing, any channels using the address space are flushed first as trap handlers may need to lock resources they hold
+                    i64 memoryStart{util::GetTimeNs()};
+                    for (auto &channel : channels)
+                        if (channel.addressSpaceId == header.id)
+                            flushChannel(channel);
+
+                    auto contents{span(payload).subspan(sizeof(u64))};
+                    addressSpaces.at(header.id).asCtx->gmmu.Write(span(payload).as<u64>(), contents.data(), contents.size());
+                    statistics.memoryCpuTime += util::GetTimeNs() - memoryStart;
+                    break;
+                }
+
+                case trace::RecordType::Entry: {
+                    auto &channel{channels.at(header.id)};
+                    auto gpEntry{span(payload).as<GpEntry>()};
+                    auto pushBuffer{span(payload).subspan(sizeof(GpEntry))};
+                    if (!pushBuffer.empty())
+                        channel.channelCtx->asCtx->gmmu.Write(gpEntry.Address(), pushBuffer.data(), pushBuffer.size());
+
+                    if (!channel.locked) {
+                        channel.channelCtx->Lock();
+                        channel.locked = true;
+                    }
+
+                    channel.channelCtx->gpfifo.Process(gpEntry);
+                    statistics.entryCount++;
+                    break;
+                }
+
+                case trace::RecordType::Flush:
+                    flushChannel(channels.at(header.id));
+                    break;
+
+                case trace::RecordType::Frame: {
+                    if (waitForGpu)
+                        state.gpu->vkDevice.waitIdle();
+
+                    i64 frameTime{util::GetTimeNs()};
+                    statistics.frameTimes.push_back(frameTime - lastFrameTime);
+                    lastFrameTime = frameTime;
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        for (auto &channel : channels) {
+            flushChannel(channel);
+            channel.channelCtx->gpfifo.subchannelCpuTime = nullptr;
+        }
+        state.gpu->vkDevice.waitIdle();
+
+        statistics.totalTime = util::GetTimeNs() - startTime;
+        return statistics;
+    }
+
+    void GpfifoReplayer::WriteReport(const Statistics &statistics, const std::string &reportPath) {
+        constexpr std::array<std::string_view, 8> SubchannelNames{"3D", "Compute", "Inline2Memory", "2D", "Copy", "Software0", "Software1", "Software2"};
+
+        std::vector<std::string> lines;
+        lines.push_back(fmt::format("Replayed {} entries and {} frames in {}ms", statistics.entryCount, statistics.frameTimes.size(), statistics.totalTime / constant::NsInMillisecond));
+
+        if (!statistics.frameTimes.empty()) {
+            auto frameTimes{statistics.frameTimes};
+            std::sort(frameTimes.begin(), frameTimes.end());
+            auto percentile{[&](size_t percent) {
+                return static_cast<double>(frameTimes[std::min(frameTimes.size() - 1, (frameTimes.size() * percent) / 100)]) / constant::NsInMillisecond;
+            }};
+
+            i64 totalFrameTime{};
+            for (auto frameTime : frameTimes)
+                totalFrameTime += frameTime;
+
+            lines.push_back(fmt::format("Frame time (ms): Average {:.2f}, P50 {:.2f}, P90 {:.2f}, P99 {:.2f}, Max {:.2f}",
+                                        static_cast<double>(totalFrameTime) / static_cast<double>(frameTimes.size()) / constant::NsInMillisecond,
+                                        percentile(50), percentile(90), percentile(99), static_cast<double>(frameTimes.back()) / constant::NsInMillisecond));
+        }
+
+        for (size_t index{}; index < SubchannelNames.size(); index++)
+            if (statistics.subchannelCpuTime[index])
+                lines.push_back(fmt::format("{} engine CPU time: {:.2f}ms", SubchannelNames[index], static_cast<double>(statistics.subchannelCpuTime[index]) / constant::NsInMillisecond));
+
+        lines.push_back(fmt::format("Submission CPU time: {:.2f}ms", static_cast<double>(statistics.submitCpuTime) / constant::NsInMillisecond));
+        lines.push_back(fmt::format("Memory update CPU time: {:.2f}ms", static_cast<double>(statistics.memoryCpuTime) / constant::NsInMillisecond));
+
+        std::ofstream stream{reportPath, std::ios::trunc};
+        if (stream.fail())
+            Logger::Warn("Failed to open GPFIFO replay report: {}", reportPath);
+
+        for (const auto &line : lines) {
+            Logger::Info("{}", line);
+            if (stream)
+                stream << line << '\n';
+        }
+    }
+}
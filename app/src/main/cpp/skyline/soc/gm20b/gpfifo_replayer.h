@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "channel.h"
+#include "gpfifo_capture.h"
+
+namespace skyline::soc::gm20b {
+    /**
+     * @brief Replays a trace written by GpfifoCapture through the regular channel, engine and interconnect implementations, this allows benchmarking GPU emulation deterministically without running the guest
+     * @note Replay happens synchronously on the calling thread, the GPFIFO threads of the replayed channels remain idle throughout
+     * @note Replayed GPU memory is allocated from the heap of the guest process as buffers and textures need to mirror it, the process must be created but must not be running
+     * @note Syncpoint waits and semaphore acquires are skipped as the order of the trace already satisfies them, waiting on them could deadlock on values which were signalled by the guest CPU
+     */
+    class GpfifoReplayer {
+      private:
+        static constexpr size_t ReplayGpEntryCount{0x10}; //!< The amount of GpEntries allocated for the FIFO of every replayed channel, these are never used as entries are processed directly
+
+        struct AddressSpace {
+            std::shared_ptr<AddressSpaceContext> asCtx;
+            std::vector<span<u8>> mappings; //!< The regions of the guest heap backing all pages referenced by the trace
+        };
+
+        struct Channel {
+            std::unique_ptr<ChannelContext> channelCtx;
+            u32 addressSpaceId;
+            bool locked{};
+        };
+
+        const DeviceState &state;
+        std::string path;
+        std::vector<AddressSpace> addressSpaces;
+        std::vector<Channel> channels;
+
+      public:
+        struct Statistics {
+            std::vector<i64> frameTimes; //!< The host time between every pair of consecutive frames in nanoseconds
+            std::array<i64, 8> subchannelCpuTime{}; //!< The host time spent processing methods for every subchannel in nanoseconds
+            i64 submitCpuTime{}; //!< The host time spent submitting work to the host GPU in nanoseconds
+            i64 memoryCpuTime{}; //!< The host time spent applying captured memory contents in nanoseconds, this corresponds to guest CPU writes
+            size_t entryCount{};
+            i64 totalTime{};
+        };
+
+        /**
+         * @brief Maps all GPU memory referenced by the trace into unused guest heap memory and creates all channels in it
+         */
+        GpfifoReplayer(const DeviceState &state, std::string path);
+
+        ~GpfifoReplayer();
+
+        /**
+         * @brief Replays the entire trace
+         * @param waitForGpu If the host GPU should be waited on at every frame boundary, this makes frame times include GPU execution time
+         */
+        Statistics Replay(bool waitForGpu = true);
+
+        /**
+         * @brief Writes a report of frame time percentiles and per-engine CPU cost to the supplied path and logs it
+         */
+        static void WriteReport(const Statistics &statistics, const std::string &reportPath);
+    };
+}
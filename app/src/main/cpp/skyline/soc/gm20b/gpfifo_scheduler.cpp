@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <common/signal.h>
+#include <common/trace.h>
+#include <common/utils.h>
+#include <loader/loader.h>
+#include <kernel/types/KProcess.h>
+#include <nce.h>
+#include "gpfifo.h"
+#include "gpfifo_scheduler.h"
+
+namespace skyline::soc::gm20b {
+    thread_local GpfifoScheduler *currentScheduler{}; //!< The scheduler that the current thread is a worker of, this is null for all other threads
+
+    GpfifoScheduler::BlockingScope::BlockingScope() : scheduler{currentScheduler} {
+        if (scheduler)
+            scheduler->OnBlock();
+    }
+
+    GpfifoScheduler::BlockingScope::~BlockingScope() {
+        if (scheduler)
+            scheduler->OnUnblock();
+    }
+
+    GpfifoScheduler::GpfifoScheduler(const DeviceState &state, size_t workerCount) : state{state}, workerCount{workerCount} {
+        Logger::Info("Processing GPFIFO channels on up to {} shared worker thread(s)", workerCount);
+    }
+
+    GpfifoScheduler::~GpfifoScheduler() {
+        {
+            std::scoped_lock lock{mutex};
+            exiting = true;
+
+            // Workers that are blocked won't observe the exit flag, they're interrupted in the same way as a dedicated channel thread
+            for (const auto &running : runningChannels)
+                if (running.blocked)
+                    pthread_kill(running.worker, SIGINT);
+        }
+        readyCondition.notify_all();
+
+        for (auto &worker : workers)
+            if (worker.joinable())
+                worker.join();
+
+        Logger::Info("GPFIFO scheduler dispatched {} time(s) with an average latency of {}us and a maximum latency of {}us, at most {} worker thread(s) were used",
+                     dispatchCount, dispatchCount ? totalDispatchLatency / static_cast<i64>(dispatchCount) / constant::NsInMicrosecond : 0, maxDispatchLatency / constant::NsInMicrosecond, peakWorkerCount);
+    }
+
+    void GpfifoScheduler::SpawnWorkerIfNeeded() {
+        if (exiting || readyChannels.empty() || idleWorkers || activeWorkers >= workerCount)
+            return;
+
+        // The worker is counted as idle from the moment it's spawned so concurrent calls don't spawn more than one worker for the same channel
+        idleWorkers++;
+        workers.emplace_back(&GpfifoScheduler::Worker, this);
+
+        size_t liveWorkers{idleWorkers + runningChannels.size()};
+        peakWorkerCount = std::max(peakWorkerCount, liveWorkers);
+        TRACE_COUNTER("gpu", "GPFIFO Worker Threads", static_cast<i64>(liveWorkers));
+    }
+
+    void GpfifoScheduler::Worker() {
+        if (int result{pthread_setname_np(pthread_self(), "GPFIFO Worker")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        currentScheduler = this;
+        ChannelGpfifo *channel{}; //!< The channel that is currently being processed by this worker
+
+        try {
+            signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
+            signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // We may access NCE trapped memory
+
+            std::unique_lock lock{mutex};
+            while (true) {
+                readyCondition.wait(lock, [this] { return exiting || (!readyChannels.empty() && activeWorkers < workerCount); });
+                if (exiting)
+                    break;
+
+                // The channel with the most queued entries is dispatched first as it's the most likely to be stalling the guest
+                auto ready{std::max_element(readyChannels.begin(), readyChannels.end(), [](const ReadyChannel &lhs, const ReadyChannel &rhs) {
+                    return lhs.channel->gpEntries.Size() < rhs.channel->gpEntries.Size();
+                })};
+                channel = ready->channel;
+                i64 latency{util::GetTimeNs() - ready->readyTimestamp};
+                readyChannels.erase(ready);
+                runningChannels.push_back(RunningChannel{channel, pthread_self(), false});
+                idleWorkers--;
+                activeWorkers++;
+
+                dispatchCount++;
+                totalDispatchLatency += latency;
+                maxDispatchLatency = std::max(maxDispatchLatency, latency);
+                TRACE_COUNTER("gpu", "GPFIFO Dispatch Latency", latency);
+
+                lock.unlock();
+                {
+                    TRACE_EVENT("gpu", "GpfifoScheduler::Dispatch");
+                    channel->gpEntries.ProcessAvailable([channel](GpEntry gpEntry) {
+                        channel->ProcessEntry(gpEntry);
+                    }, MaxEntriesPerDispatch);
+
+                    // The channel is always unlocked at the end of a dispatch as it may be dispatched to a different worker next time
+                    channel->FlushEntries();
+                }
+                lock.lock();
+
+                std::erase_if(runningChannels, [channel](const RunningChannel &running) { return running.channel == channel; });
+                activeWorkers--;
+                idleWorkers++;
+
+                // Entries pushed during the dispatch didn't schedule the channel as it was running, they need to be picked up here
+                if (channel->gpEntries.Size())
+                    readyChannels.push_back(ReadyChannel{channel, util::GetTimeNs()});
+                channel = nullptr;
+
+                idleCondition.notify_all();
+            }
+        } catch (const signal::SignalException &e) {
+            if (e.signal != SIGINT) {
+                Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
+                Logger::EmulationContext.Flush();
+                signal::BlockSignal({SIGINT});
+                state.process->Kill(false);
+            }
+        } catch (const exception &e) {
+            Logger::ErrorNoPrefix("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
+            Logger::EmulationContext.Flush();
+            signal::BlockSignal({SIGINT});
+            state.process->Kill(false);
+        } catch (const std::exception &e) {
+            Logger::Error(e.what());
+            Logger::EmulationContext.Flush();
+            signal::BlockSignal({SIGINT});
+            state.process->Kill(false);
+        }
+
+        std::scoped_lock lock{mutex};
+        if (channel) {
+            // The worker was interrupted while processing a channel, any blocking scope has already been exited during unwinding
+            std::erase_if(runningChannels, [channel](const RunningChannel &running) { return running.channel == channel; });
+            activeWorkers--;
+        } else {
+            idleWorkers--;
+        }
+
+        TRACE_COUNTER("gpu", "GPFIFO Worker Threads", static_cast<i64>(idleWorkers + runningChannels.size()));
+        idleCondition.notify_all();
+        SpawnWorkerIfNeeded(); // Ready channels may have been relying on this worker
+    }
+
+    void GpfifoScheduler::OnBlock() {
+        std::scoped_lock lock{mutex};
+        for (auto &running : runningChannels)
+            if (pthread_equal(running.worker, pthread_self()))
+                running.blocked = true;
+
+        activeWorkers--;
+        SpawnWorkerIfNeeded();
+        readyCondition.notify_one();
+    }
+
+    void GpfifoScheduler::OnUnblock() {
+        std::scoped_lock lock{mutex};
+        for (auto &running : runningChannels)
+            if (pthread_equal(running.worker, pthread_self()))
+                running.blocked = false;
+
+        activeWorkers++; // This may temporarily exceed the worker count, no new channels will be dispatched until enough workers have finished
+    }
+
+    void GpfifoScheduler::Schedule(ChannelGpfifo &channel) {
+        std::scoped_lock lock{mutex};
+        if (std::any_of(runningChannels.begin(), runningChannels.end(), [&](const RunningChannel &running) { return running.channel == &channel; }) ||
+            std::any_of(readyChannels.begin(), readyChannels.end(), [&](const ReadyChannel &ready) { return ready.channel == &channel; }))
+            return; // The channel will already process the new entries
+
+        readyChannels.push_back(ReadyChannel{&channel, util::GetTimeNs()});
+        SpawnWorkerIfNeeded();
+        readyCondition.notify_one();
+    }
+
+    void GpfifoScheduler::Unregister(ChannelGpfifo &channel) {
+        std::unique_lock lock{mutex};
+        auto isRunning{[&] {
+            return std::any_of(runningChannels.begin(), runningChannels.end(), [&](const RunningChannel &running) { return running.channel == &channel; });
+        }};
+
+        for (const auto &running : runningChannels)
+            if (running.channel == &channel && running.blocked)
+                pthread_kill(running.worker, SIGINT);
+
+        idleCondition.wait(lock, [&] { return !isRunning(); });
+        std::erase_if(readyChannels, [&](const ReadyChannel &ready) { return ready.channel == &channel; });
+    }
+}
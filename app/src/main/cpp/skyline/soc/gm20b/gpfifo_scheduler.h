@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::soc::gm20b {
+    class ChannelGpfifo;
+
+    /**
+     * @brief Processes the GPFIFOs of all channels on a small shared pool of worker threads rather than a dedicated thread per channel
+     * @note Entries of a single channel are always processed in-order by at most one worker at a time, ready channels are dispatched in order of their queue depth
+     * @note Workers are only spawned when there's work for them, a worker that blocks on a syncpoint or semaphore doesn't count towards the limit so other channels can make progress in the meantime
+     */
+    class GpfifoScheduler {
+      private:
+        static constexpr size_t MaxEntriesPerDispatch{0x200}; //!< The maximum amount of entries processed in a single dispatch of a channel before it's requeued, this bounds the latency of other ready channels
+
+        struct ReadyChannel {
+            ChannelGpfifo *channel;
+            i64 readyTimestamp; //!< The time at which the channel became ready, used to measure dispatch latency
+        };
+
+        struct RunningChannel {
+            ChannelGpfifo *channel;
+            pthread_t worker; //!< The worker thread which is processing the channel
+            bool blocked; //!< If the worker is blocked waiting on a syncpoint or semaphore
+        };
+
+        const DeviceState &state;
+        size_t workerCount; //!< The maximum amount of workers that can concurrently process channels without being blocked
+
+        std::mutex mutex; //!< Synchronizes all scheduling state
+        std::condition_variable readyCondition; //!< Signalled when a channel becomes ready or a worker slot becomes available
+        std::condition_variable idleCondition; //!< Signalled when a channel stops running
+        std::vector<ReadyChannel> readyChannels;
+        std::vector<RunningChannel> runningChannels;
+        std::list<std::thread> workers;
+        size_t activeWorkers{}; //!< The amount of workers that are processing a channel and aren't blocked
+        size_t idleWorkers{}; //!< The amount of workers that are waiting for a channel to become ready
+        bool exiting{};
+
+        u64 dispatchCount{};
+        i64 totalDispatchLatency{};
+        i64 maxDispatchLatency{};
+        size_t peakWorkerCount{};
+
+        /**
+         * @brief Spawns an additional worker if there's a ready channel that no existing worker can pick up
+         * @note The mutex must be locked when calling this
+         */
+        void SpawnWorkerIfNeeded();
+
+        /**
+         * @brief Dispatches ready channels until the scheduler is destroyed
+         */
+        void Worker();
+
+        void OnBlock();
+
+        void OnUnblock();
+
+      public:
+        /**
+         * @brief Marks the worker on the calling thread as blocked for the duration of the scope, this has no effect on threads which aren't scheduler workers
+         * @note This must be used around any indefinite waits inside of GPFIFO processing, such as on syncpoints or semaphores
+         */
+        class BlockingScope {
+          private:
+            GpfifoScheduler *scheduler;
+
+          public:
+            BlockingScope();
+
+            ~BlockingScope();
+        };
+
+        /**
+         * @param workerCount The maximum amount of channels which can be processed concurrently
+         */
+        GpfifoScheduler(const DeviceState &state, size_t workerCount);
+
+        ~GpfifoScheduler();
+
+        /**
+         * @brief Marks the channel as ready to be processed, this should be called after entries are pushed to it
+         */
+        void Schedule(ChannelGpfifo &channel);
+
+        /**
+         * @brief Removes a channel from the scheduler, waiting for any worker processing it to finish
+         * @note A worker that is blocked on the channel is interrupted with SIGINT in the same way as a dedicated channel thread would be
+         */
+        void Unregister(ChannelGpfifo &channel);
+    };
+}
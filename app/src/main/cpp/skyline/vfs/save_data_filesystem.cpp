@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <common/trace.h>
+#include "save_data_filesystem.h"
+
+namespace skyline::vfs {
+    SaveDataFileSystem::SaveDataBacking::SaveDataBacking(std::shared_ptr<FileEntry> entry, std::shared_ptr<Statistics> statistics, Mode mode) : Backing(mode), entry(std::move(entry)), statistics(std::move(statistics)) {
+        std::scoped_lock lock{this->entry->mutex};
+        size = this->entry->contents ? this->entry->contents->size() : this->entry->file->size;
+    }
+
+    void SaveDataFileSystem::SaveDataBacking::LoadContents() {
+        if (entry->contents)
+            return;
+
+        // The entire file is read in a single request as it'll be written out as a whole during the commit regardless
+        auto &contents{entry->contents.emplace(entry->file->size)};
+        if (!contents.empty()) {
+            entry->file->Read(span<u8>{contents});
+            statistics->hostSyscallCount++;
+        }
+        entry->file = nullptr;
+    }
+
+    size_t SaveDataFileSystem::SaveDataBacking::ReadImpl(span<u8> output, size_t offset) {
+        std::scoped_lock lock{entry->mutex};
+        if (!entry->contents) {
+            statistics->hostSyscallCount++;
+            return entry->file->ReadUnchecked(output, offset);
+        }
+
+        auto &contents{*entry->contents};
+        size = contents.size(); // Another backing for the same file may have resized it
+        if (offset >= contents.size())
+            return 0;
+
+        auto amount{std::min(output.size(), contents.size() - offset)};
+        std::memcpy(output.data(), contents.data() + offset, amount);
+        return amount;
+    }
+
+    size_t SaveDataFileSystem::SaveDataBacking::WriteImpl(span<u8> input, size_t offset) {
+        std::scoped_lock lock{entry->mutex};
+        LoadContents();
+
+        auto &contents{*entry->contents};
+        if (offset + input.size() > contents.size())
+            contents.resize(offset + input.size());
+
+        std::memcpy(contents.data() + offset, input.data(), input.size());
+        entry->dirty = true;
+        size = contents.size();
+
+        statistics->guestWriteCount++;
+        statistics->guestBytesWritten += input.size();
+        return input.size();
+    }
+
+    void SaveDataFileSystem::SaveDataBacking::ResizeImpl(size_t pSize) {
+        std::scoped_lock lock{entry->mutex};
+        LoadContents();
+
+        entry->contents->resize(pSize);
+        entry->dirty = true;
+        size = pSize;
+    }
+
+    SaveDataFileSystem::SaveDataDirectory::SaveDataDirectory(std::shared_ptr<Directory> directory, std::string path, SaveDataFileSystem &fileSystem) : Directory(directory->listMode), directory(std::move(directory)), path(std::move(path)), fileSystem(fileSystem) {}
+
+    std::vector<Directory::Entry> SaveDataFileSystem::SaveDataDirectory::Read() {
+        auto directoryEntries{directory->Read()};
+
+        std::scoped_lock lock{fileSystem.mutex};
+        for (auto &directoryEntry : directoryEntries) {
+            if (directoryEntry.type != EntryType::File)
+                continue;
+
+            if (auto it{fileSystem.entries.find(path + directoryEntry.name)}; it != fileSystem.entries.end()) {
+                std::scoped_lock entryLock{it->second->mutex};
+                if (it->second->contents)
+                    directoryEntry.size = it->second->contents->size();
+            }
+        }
+
+        return directoryEntries;
+    }
+
+    SaveDataFileSystem::SaveDataFileSystem(const std::string &pBasePath) : base(pBasePath), basePath(pBasePath.ends_with('/') ? pBasePath : pBasePath + '/') {
+        stagingPath = basePath.substr(0, basePath.size() - 1) + std::string{StagingSuffix};
+
+        if (std::filesystem::exists(stagingPath + std::string{JournalName})) {
+            Logger::Info("Completing an interrupted save data commit in '{}'", basePath);
+            ApplyJournal();
+        } else if (std::filesystem::exists(stagingPath)) {
+            // The journal is only published once all staged files are complete, without it the commit never took place
+            Logger::Info("Discarding an incomplete save data commit in '{}'", basePath);
+            std::filesystem::remove_all(stagingPath);
+        }
+    }
+
+    SaveDataFileSystem::~SaveDataFileSystem() {
+        size_t discardedCount{};
+        for (auto &[path, entry] : entries) {
+            std::scoped_lock entryLock{entry->mutex};
+            if (entry->dirty)
+                discardedCount++;
+        }
+
+        if (discardedCount)
+            Logger::Info("Discarding uncommitted writes to {} file(s) in save data '{}'", discardedCount, basePath);
+
+        Logger::Info("Save data in '{}' was committed {} time(s), {} guest write(s) totalling {} bytes were coalesced into {} host syscall(s) writing {} bytes",
+                     basePath, statistics->commitCount.load(), statistics->guestWriteCount.load(), statistics->guestBytesWritten.load(), statistics->hostSyscallCount.load(), statistics->hostBytesWritten.load());
+    }
+
+    void SaveDataFileSystem::WriteFileDurably(const std::string &path, span<const u8> data) {
+        int fd{open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)};
+        if (fd < 0)
+            throw exception("Failed to create staged save data file '{}': {}", path, strerror(errno));
+        statistics->hostSyscallCount++;
+
+        size_t written{};
+        while (written < data.size()) {
+            auto ret{pwrite64(fd, data.data() + written, data.size() - written, static_cast<off64_t>(written))};
+            statistics->hostSyscallCount++;
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                close(fd);
+                throw exception("Failed to write staged save data file '{}': {}", path, strerror(errno));
+            }
+
+            written += static_cast<size_t>(ret);
+        }
+        statistics->hostBytesWritten += written;
+
+        int ret{fsync(fd)};
+        close(fd);
+        statistics->hostSyscallCount += 2;
+        if (ret < 0)
+            throw exception("Failed to sync staged save data file '{}': {}", path, strerror(errno));
+    }
+
+    void SaveDataFileSystem::SyncDirectory(const std::string &path) {
+        int fd{open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+        if (fd < 0)
+            throw exception("Failed to open save data directory '{}': {}", path, strerror(errno));
+
+        int ret{fsync(fd)};
+        close(fd);
+        statistics->hostSyscallCount += 3;
+        if (ret < 0)
+            throw exception("Failed to sync save data directory '{}': {}", path, strerror(errno));
+    }
+
+    void SaveDataFileSystem::ApplyJournal() {
+        std::ifstream journal{stagingPath + std::string{JournalName}};
+        std::vector<std::string> directories;
+        std::string path;
+        for (size_t index{}; std::getline(journal, path); index++) {
+            auto stagedPath{stagingPath + std::to_string(index)};
+            auto fullPath{basePath + path};
+
+            // Renames which were completed prior to an interruption won't have a staged file anymore
+            if (rename(stagedPath.c_str(), fullPath.c_str()) < 0 && errno != ENOENT)
+                throw exception("Failed to move committed save data file into '{}': {}", fullPath, strerror(errno));
+            statistics->hostSyscallCount++;
+
+            auto directory{fullPath.substr(0, fullPath.find_last_of('/') + 1)};
+            if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+                directories.push_back(std::move(directory));
+        }
+
+        for (const auto &directory : directories)
+            SyncDirectory(directory);
+
+        // The staging directory is only removed once all renames are durable, removing it earlier could lose the commit on a crash
+        std::filesystem::remove_all(stagingPath);
+    }
+
+    void SaveDataFileSystem::CommitImpl() {
+        std::scoped_lock lock{mutex};
+
+        std::vector<std::pair<FileEntry *, std::unique_lock<std::mutex>>> dirtyEntries;
+        for (auto &[path, entry] : entries) {
+            std::unique_lock entryLock{entry->mutex};
+            if (entry->dirty)
+                dirtyEntries.emplace_back(entry.get(), std::move(entryLock));
+        }
+
+        if (dirtyEntries.empty())
+            return;
+
+        TRACE_EVENT("service", "SaveDataFileSystem::Commit", "files", dirtyEntries.size());
+
+        std::filesystem::remove_all(stagingPath);
+        std::filesystem::create_directories(stagingPath);
+
+        std::string journal;
+        for (size_t index{}; index < dirtyEntries.size(); index++) {
+            auto entry{dirtyEntries[index].first};
+            WriteFileDurably(stagingPath + std::to_string(index), span<const u8>{*entry->contents});
+            journal += entry->path;
+            journal += '\n';
+        }
+
+        // Publishing the journal is the point at which the commit takes place, it's written to a temporary file first so it's never observed partially written
+        auto journalPath{stagingPath + std::string{JournalName}};
+        auto journalTempPath{journalPath + ".tmp"};
+        WriteFileDurably(journalTempPath, span<const char>{journal}.cast<const u8>());
+        if (rename(journalTempPath.c_str(), journalPath.c_str()) < 0)
+            throw exception("Failed to publish save data journal '{}': {}", journalPath, strerror(errno));
+        statistics->hostSyscallCount++;
+        SyncDirectory(stagingPath);
+
+        ApplyJournal();
+
+        for (auto &[entry, entryLock] : dirtyEntries)
+            entry->dirty = false;
+        statistics->commitCount++;
+    }
+
+    bool SaveDataFileSystem::CreateFileImpl(const std::string &path, size_t size) {
+        std::scoped_lock lock{mutex};
+        entries.erase(path); // Any uncommitted contents of a prior file at the same path are discarded
+        return base.CreateFile(path, size);
+    }
+
+    void SaveDataFileSystem::DeleteFileImpl(const std::string &path) {
+        std::scoped_lock lock{mutex};
+        entries.erase(path);
+        base.DeleteFile(path);
+    }
+
+    void SaveDataFileSystem::DeleteDirectoryImpl(const std::string &path) {
+        // Only entries inside the directory are dropped, siblings that merely share a name prefix (e.g. '/foobar.bin' for '/foo') are left intact
+        std::string directory{path.ends_with('/') ? path : path + '/'};
+        std::string_view directoryPath{directory.data(), directory.size() - 1};
+        std::scoped_lock lock{mutex};
+        std::erase_if(entries, [&](const auto &entry) { return entry.first == directoryPath || entry.first.starts_with(directory); });
+        base.DeleteDirectory(path);
+    }
+
+    bool SaveDataFileSystem::CreateDirectoryImpl(const std::string &path, bool parents) {
+        return base.CreateDirectory(path, parents);
+    }
+
+    std::shared_ptr<Backing> SaveDataFileSystem::OpenFileImpl(const std::string &path, Backing::Mode mode) {
+        std::scoped_lock lock{mutex};
+        auto &entry{entries[path]};
+        if (!entry) {
+            entry = std::make_shared<FileEntry>();
+            entry->path = path;
+        }
+
+        {
+            std::scoped_lock entryLock{entry->mutex};
+            if (!entry->contents && !entry->file)
+                entry->file = base.OpenFile(path, {true, false, false});
+        }
+
+        return std::make_shared<SaveDataBacking>(entry, statistics, mode);
+    }
+
+    std::optional<Directory::EntryType> SaveDataFileSystem::GetEntryTypeImpl(const std::string &path) {
+        return base.GetEntryType(path);
+    }
+
+    std::shared_ptr<Directory> SaveDataFileSystem::OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) {
+        auto directory{base.OpenDirectory(path, listMode)};
+        if (!directory)
+            return nullptr;
+
+        return std::make_shared<SaveDataDirectory>(std::move(directory), path, *this);
+    }
+}
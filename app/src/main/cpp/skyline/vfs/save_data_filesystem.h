@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "os_filesystem.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A write-back filesystem for journaled save data, file contents are buffered in memory after their first write and only written to the host filesystem when the guest commits
+     * @note Commits are atomic across all files: every dirty file is written to a staging directory next to the save directory, a journal listing them is then atomically published and the files are renamed into place
+     * @note An interrupted commit is completed when the filesystem is next opened if its journal was published, otherwise the staged files are discarded
+     * @note Creation and deletion of files and directories are applied to the host filesystem immediately
+     */
+    class SaveDataFileSystem : public FileSystem {
+      public:
+        struct Statistics {
+            std::atomic<u64> guestWriteCount; //!< The amount of writes from the guest which were buffered
+            std::atomic<u64> guestBytesWritten; //!< The amount of bytes written by the guest into buffered files
+            std::atomic<u64> hostSyscallCount; //!< The amount of syscalls issued to the host filesystem for reading, loading and committing file contents
+            std::atomic<u64> hostBytesWritten; //!< The amount of bytes written to the host filesystem by commits
+            std::atomic<u64> commitCount; //!< The amount of commits which wrote any files
+        };
+
+      private:
+        static constexpr std::string_view StagingSuffix{".commit/"}; //!< The suffix appended to the save directory path for the staging directory
+        static constexpr std::string_view JournalName{"journal"}; //!< The name of the journal inside the staging directory, its presence denotes that all staged files are complete
+
+        /**
+         * @brief The state of a single file which is shared between all backings opened for it
+         */
+        struct FileEntry {
+            std::mutex mutex; //!< Synchronizes access to all members
+            std::string path;
+            std::shared_ptr<Backing> file; //!< The backing for the committed file on the host, this is used for reads till the contents are loaded
+            std::optional<std::vector<u8>> contents; //!< The full contents of the file including any uncommitted writes, this is loaded on the first write
+            bool dirty{}; //!< If the contents have been modified since they were last committed
+        };
+
+        /**
+         * @brief A backing for a file in the save data which serves reads and writes from the in-memory contents once they're loaded
+         */
+        class SaveDataBacking : public Backing {
+          private:
+            std::shared_ptr<FileEntry> entry;
+            std::shared_ptr<Statistics> statistics;
+
+            /**
+             * @brief Loads the committed contents of the file into memory if they aren't already
+             * @note The mutex of the entry must be locked when calling this
+             */
+            void LoadContents();
+
+          protected:
+            size_t ReadImpl(span<u8> output, size_t offset) override;
+
+            size_t WriteImpl(span<u8> input, size_t offset) override;
+
+            void ResizeImpl(size_t pSize) override;
+
+          public:
+            SaveDataBacking(std::shared_ptr<FileEntry> entry, std::shared_ptr<Statistics> statistics, Mode mode);
+        };
+
+        /**
+         * @brief A directory in the save data which reports the sizes of files including any uncommitted writes
+         */
+        class SaveDataDirectory : public Directory {
+          private:
+            std::shared_ptr<Directory> directory; //!< The directory on the host
+            std::string path;
+            SaveDataFileSystem &fileSystem;
+
+          public:
+            SaveDataDirectory(std::shared_ptr<Directory> directory, std::string path, SaveDataFileSystem &fileSystem);
+
+            std::vector<Entry> Read() override;
+        };
+
+        OsFileSystem base; //!< The filesystem of the save directory on the host, this is used for all operations on the directory structure
+        std::string basePath;
+        std::string stagingPath; //!< The path to the directory that files are staged in during a commit
+        std::mutex mutex; //!< Synchronizes access to `entries` and commits
+        std::unordered_map<std::string, std::shared_ptr<FileEntry>> entries; //!< The state of all files that have been opened
+        std::shared_ptr<Statistics> statistics{std::make_shared<Statistics>()};
+
+        /**
+         * @brief Writes the supplied data into a new file at the supplied host path and waits for it to reach the disk
+         */
+        void WriteFileDurably(const std::string &path, span<const u8> data);
+
+        /**
+         * @brief Waits for all entries in the directory at the supplied host path to reach the disk
+         */
+        void SyncDirectory(const std::string &path);
+
+        /**
+         * @brief Renames all staged files listed in the journal into place and removes the staging directory
+         */
+        void ApplyJournal();
+
+      protected:
+        bool CreateFileImpl(const std::string &path, size_t size) override;
+
+        void DeleteFileImpl(const std::string &path) override;
+
+        void DeleteDirectoryImpl(const std::string &path) override;
+
+        bool CreateDirectoryImpl(const std::string &path, bool parents) override;
+
+        std::shared_ptr<Backing> OpenFileImpl(const std::string &path, Backing::Mode mode) override;
+
+        std::optional<Directory::EntryType> GetEntryTypeImpl(const std::string &path) override;
+
+        std::shared_ptr<Directory> OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) override;
+
+        void CommitImpl() override;
+
+      public:
+        /**
+         * @note Any interrupted commit of the save directory is recovered from during construction
+         */
+        SaveDataFileSystem(const std::string &basePath);
+
+        /**
+         * @note Any uncommitted writes are discarded on destruction, matching the Switch
+         */
+        ~SaveDataFileSystem();
+
+        const Statistics &GetStatistics() const {
+            return *statistics;
+        }
+    };
+}
@@ -47,11 +47,20 @@ class EmulationSettings private constructor(context : Context, prefName : String
     var gpuDriver by sharedPreferences(context, SYSTEM_GPU_DRIVER, prefName = prefName)
     var forceTripleBuffering by sharedPreferences(context, true, prefName = prefName)
     var disableFrameThrottling by sharedPreferences(context, false, prefName = prefName)
+    var headlessPresentation by sharedPreferences(context, false, prefName = prefName)
     var executorSlotCountScale by sharedPreferences(context, 6, prefName = prefName)
     var executorFlushThreshold by sharedPreferences(context, 256, prefName = prefName)
+    var gpfifoWorkerCount by sharedPreferences(context, 0, prefName = prefName)
     var useDirectMemoryImport by sharedPreferences(context, false, prefName = prefName)
     var forceMaxGpuClocks by sharedPreferences(context, false, prefName = prefName)
     var freeGuestTextureMemory by sharedPreferences(context, true, prefName = prefName)
+    var useDescriptorBuffers by sharedPreferences(context, false, prefName = prefName)
+    var useTimelineSemaphores by sharedPreferences(context, false, prefName = prefName)
+    var useDynamicRendering by sharedPreferences(context, false, prefName = prefName)
+    var useTransferQueue by sharedPreferences(context, false, prefName = prefName)
+    var useSparseBuffers by sharedPreferences(context, false, prefName = prefName)
+    var parallelCommandRecording by sharedPreferences(context, false, prefName = prefName)
+    var enableExecutableCache by sharedPreferences(context, false, prefName = prefName)
     var disableShaderCache by sharedPreferences(context, false, prefName = prefName)
 
     // Hacks
@@ -62,6 +71,11 @@ class EmulationSettings private constructor(context : Context, prefName : String
 
     // Debug
     var validationLayer by sharedPreferences(context, false, prefName = prefName)
+    var enableGuestProfiler by sharedPreferences(context, false, prefName = prefName)
+    var guestProfilerSymbols by sharedPreferences(context, "", prefName = prefName)
+    var writeFrameTimeReport by sharedPreferences(context, false, prefName = prefName)
+    var captureGpfifo by sharedPreferences(context, false, prefName = prefName)
+    var replayGpfifoTrace by sharedPreferences(context, false, prefName = prefName)
 
     /**
      * Copies all settings from the global settings to this instance.
@@ -32,11 +32,20 @@ data class NativeSettings(
     var gpuDriverLibraryName : String,
     var forceTripleBuffering : Boolean,
     var disableFrameThrottling : Boolean,
+    var headlessPresentation : Boolean,
     var executorSlotCountScale : Int,
     var executorFlushThreshold : Int,
+    var gpfifoWorkerCount : Int,
     var useDirectMemoryImport : Boolean,
     var forceMaxGpuClocks : Boolean,
     var freeGuestTextureMemory : Boolean,
+    var useDescriptorBuffers : Boolean,
+    var useTimelineSemaphores : Boolean,
+    var useDynamicRendering : Boolean,
+    var useTransferQueue : Boolean,
+    var useSparseBuffers : Boolean,
+    var parallelCommandRecording : Boolean,
+    var enableExecutableCache : Boolean,
     var disableShaderCache : Boolean,
 
     // Hacks
@@ -46,7 +55,12 @@ data class NativeSettings(
     var disableGetVaRegions : Boolean,
 
     // Debug
-    var validationLayer : Boolean
+    var validationLayer : Boolean,
+    var enableGuestProfiler : Boolean,
+    var guestProfilerSymbols : String,
+    var writeFrameTimeReport : Boolean,
+    var captureGpfifo : Boolean,
+    var replayGpfifoTrace : Boolean
 ) {
     constructor(context : Context, pref : EmulationSettings) : this(
         pref.isDocked,
@@ -60,17 +74,31 @@ data class NativeSettings(
         if (pref.gpuDriver == EmulationSettings.SYSTEM_GPU_DRIVER) "" else GpuDriverHelper.getLibraryName(context, pref.gpuDriver),
         pref.forceTripleBuffering,
         pref.disableFrameThrottling,
+        pref.headlessPresentation,
         pref.executorSlotCountScale,
         pref.executorFlushThreshold,
+        pref.gpfifoWorkerCount,
         pref.useDirectMemoryImport,
         pref.forceMaxGpuClocks,
         pref.freeGuestTextureMemory,
+        pref.useDescriptorBuffers,
+        pref.useTimelineSemaphores,
+        pref.useDynamicRendering,
+        pref.useTransferQueue,
+        pref.useSparseBuffers,
+        pref.parallelCommandRecording,
+        pref.enableExecutableCache,
         pref.disableShaderCache,
         pref.enableFastGpuReadbackHack,
         pref.enableFastReadbackWrites,
         pref.disableSubgroupShuffle,
         pref.disableGetVaRegions,
-        BuildConfig.BUILD_TYPE != "release" && pref.validationLayer
+        BuildConfig.BUILD_TYPE != "release" && pref.validationLayer,
+        pref.enableGuestProfiler,
+        pref.guestProfilerSymbols,
+        pref.writeFrameTimeReport,
+        pref.captureGpfifo,
+        pref.replayGpfifoTrace
     )
 
     /**
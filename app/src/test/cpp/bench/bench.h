@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+/**
+ * @brief Defines a benchmark function and registers it to be run by skyline_bench as '<suite>.<name>'
+ */
+#define BENCHMARK(suite, name)                                                                                \
+    static void suite##_##name();                                                                             \
+    static const skyline::bench::Registration suite##_##name##Registration{#suite "." #name, suite##_##name}; \
+    static void suite##_##name()
+
+namespace skyline::bench {
+    using BenchmarkFunction = void (*)();
+
+    /**
+     * @return All benchmarks registered using BENCHMARK across every translation unit, in the order of their registration
+     */
+    inline std::vector<std::pair<std::string_view, BenchmarkFunction>> &GetBenchmarks() {
+        static std::vector<std::pair<std::string_view, BenchmarkFunction>> benchmarks;
+        return benchmarks;
+    }
+
+    /**
+     * @brief A static object which adds a benchmark to the registry during static initialization
+     */
+    struct Registration {
+        Registration(std::string_view name, BenchmarkFunction function) {
+            GetBenchmarks().emplace_back(name, function);
+        }
+    };
+
+    /**
+     * @brief Accumulates the duration of repeated samples of an operation and reports their distribution
+     */
+    class Samples {
+      private:
+        std::vector<std::chrono::nanoseconds> samples;
+
+      public:
+        /**
+         * @brief Times a single call of the supplied function and adds it as a sample
+         */
+        template<typename Function>
+        void Time(Function &&function) {
+            auto start{std::chrono::steady_clock::now()};
+            function();
+            samples.emplace_back(std::chrono::steady_clock::now() - start);
+        }
+
+        void Add(std::chrono::nanoseconds sample) {
+            samples.emplace_back(sample);
+        }
+
+        /**
+         * @brief Prints the median, minimum and maximum of the samples divided by the supplied amount of operations performed in each sample
+         */
+        void Report(std::string_view name, size_t operationsPerSample = 1) {
+            if (samples.empty())
+                return;
+
+            std::sort(samples.begin(), samples.end());
+            auto perOperation{[operationsPerSample](std::chrono::nanoseconds sample) {
+                return static_cast<double>(sample.count()) / static_cast<double>(operationsPerSample);
+            }};
+            fmt::print("    {:<48} median {:>12.1f}ns  min {:>12.1f}ns  max {:>12.1f}ns  ({} samples of {} ops)\n", name, perOperation(samples[samples.size() / 2]), perOperation(samples.front()), perOperation(samples.back()), samples.size(), operationsPerSample);
+            samples.clear();
+        }
+    };
+
+    /**
+     * @brief Runs the supplied function for a warm-up iteration and then the supplied amount of timed iterations, the result is reported per operation
+     */
+    template<typename Function>
+    void Measure(std::string_view name, size_t iterations, size_t operationsPerIteration, Function &&function) {
+        Samples samples;
+        function();
+        for (size_t i{}; i < iterations; i++)
+            samples.Time(function);
+        samples.Report(name, operationsPerIteration);
+    }
+
+    /**
+     * @brief Prints a value which was counted alongside a benchmark
+     */
+    template<typename T>
+    void ReportCounter(std::string_view name, T value) {
+        fmt::print("    {:<48} {}\n", name, value);
+    }
+}
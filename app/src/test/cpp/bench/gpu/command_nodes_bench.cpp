@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <list>
+#include <gpu/interconnect/command_nodes.h>
+#include "../bench.h"
+
+/**
+ * @brief Recording and replay of command nodes over a node trace, the NodeStream is compared against a list of node variants holding std::function payloads which is how nodes were stored previously
+ * @note The trace is a sequence of node names as emitted by the per-node instant events of CommandRecordThread::RecordNode (e.g. 'FunctionNode' or 'RenderPassNode'), one per line, these can be extracted from a captured Perfetto trace and supplied with the SKYLINE_NODE_TRACE environment variable
+ */
+namespace skyline::gpu::interconnect::node::bench {
+    using namespace skyline::bench;
+
+    constexpr size_t Iterations{200};
+    constexpr size_t FunctionPayloadSize{64}; //!< The size of the state captured by a function node, this is representative of the lambdas recorded by the executor
+    constexpr size_t SubpassFunctionPayloadSize{128}; //!< The size of the state captured by a subpass function node, draws capture more state than other commands
+
+    /**
+     * @return The node trace from SKYLINE_NODE_TRACE or a built-in trace of a frame with a few render passes containing a varying amount of draws if it isn't set
+     */
+    std::vector<NodeType> LoadTrace() {
+        std::vector<NodeType> trace;
+        if (auto path{std::getenv("SKYLINE_NODE_TRACE")}) {
+            constexpr std::array<std::pair<std::string_view, NodeType>, 7> Names{{
+                {"FunctionNode", NodeType::Function},
+                {"CheckpointNode", NodeType::Checkpoint},
+                {"RenderPassNode", NodeType::RenderPass},
+                {"NextSubpassNode", NodeType::NextSubpass},
+                {"SubpassFunctionNode", NodeType::SubpassFunction},
+                {"NextSubpassFunctionNode", NodeType::NextSubpassFunction},
+                {"RenderPassEndNode", NodeType::RenderPassEnd},
+            }};
+
+            std::ifstream stream{path};
+            for (std::string line; std::getline(stream, line);)
+                if (auto it{std::find_if(Names.begin(), Names.end(), [&](const auto &name) { return name.first == line; })}; it != Names.end())
+                    trace.push_back(it->second);
+
+            if (trace.empty())
+                throw std::runtime_error(fmt::format("No nodes in the trace at '{}'", path));
+            return trace;
+        }
+
+        for (size_t drawCount : {4UL, 400UL, 12UL, 1200UL, 2UL, 60UL, 1UL}) {
+            trace.push_back(NodeType::Function); // Uploads and barriers prior to the render pass
+            trace.push_back(NodeType::RenderPass);
+            for (size_t draw{}; draw < drawCount; draw++)
+                trace.push_back(draw && draw % 300 == 0 ? NodeType::NextSubpassFunction : NodeType::SubpassFunction);
+            trace.push_back(NodeType::RenderPassEnd);
+        }
+        return trace;
+    }
+
+    /**
+     * @brief A function payload of the supplied size which has a side effect that can't be optimized out
+     */
+    template<size_t Size>
+    struct Payload {
+        std::array<u8, Size> state{};
+        size_t *counter;
+
+        void operator()(auto &&...) const {
+            *counter += state[0] + 1;
+        }
+    };
+
+    using LegacyFunctionNode = std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)>;
+    using LegacySubpassFunctionNode = std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)>;
+
+    struct LegacyNextSubpassFunctionNode {
+        LegacySubpassFunctionNode function;
+    };
+
+    using LegacyNodeVariant = std::variant<LegacyFunctionNode, CheckpointNode, RenderPassNode, NextSubpassNode, LegacySubpassFunctionNode, LegacyNextSubpassFunctionNode, RenderPassEndNode>;
+
+    /**
+     * @brief The arguments supplied to every node during replay, nothing in the benchmark payloads accesses them
+     */
+    struct ReplayArguments {
+        vk::raii::CommandBuffer commandBuffer{nullptr};
+        std::shared_ptr<FenceCycle> cycle;
+        alignas(GPU) std::array<u8, sizeof(GPU)> gpuStorage; //!< Storage standing in for the GPU, it's never constructed or accessed
+
+        GPU &Gpu() {
+            return *reinterpret_cast<GPU *>(gpuStorage.data());
+        }
+    };
+
+    BENCHMARK(CommandNodes, RecordReplay) {
+        auto trace{LoadTrace()};
+        ReplayArguments arguments;
+        size_t counter{};
+
+        LinearAllocatorState<> allocator;
+        Samples streamRecord, streamReplay, legacyRecord, legacyReplay;
+        for (size_t iteration{}; iteration <= Iterations; iteration++) {
+            // The first iteration is a warm-up which grows the allocator to fit the entire trace
+            bool warmUp{iteration == 0};
+            {
+                NodeStream nodes{allocator};
+                auto recordStart{std::chrono::steady_clock::now()};
+                for (auto type : trace) {
+                    switch (type) {
+                        case NodeType::Function:
+                            nodes.PushBack(nodes.CreateFunction<FunctionNode>(Payload<FunctionPayloadSize>{.counter = &counter}));
+                            break;
+                        case NodeType::Checkpoint:
+                            nodes.EmplaceBack<CheckpointNode>(CheckpointNode{BufferBinding{}, static_cast<u32>(counter)});
+                            break;
+                        case NodeType::RenderPass:
+                            nodes.EmplaceBack<RenderPassNode>(vk::Rect2D{});
+                            break;
+                        case NodeType::NextSubpass:
+                            nodes.EmplaceBack<NextSubpassNode>();
+                            break;
+                        case NodeType::SubpassFunction:
+                            nodes.PushBack(nodes.CreateFunction<SubpassFunctionNode>(Payload<SubpassFunctionPayloadSize>{.counter = &counter}));
+                            break;
+                        case NodeType::NextSubpassFunction:
+                            nodes.PushBack(nodes.CreateFunction<NextSubpassFunctionNode>(Payload<SubpassFunctionPayloadSize>{.counter = &counter}));
+                            break;
+                        case NodeType::RenderPassEnd:
+                            nodes.EmplaceBack<RenderPassEndNode>();
+                            break;
+                    }
+                }
+                auto replayStart{std::chrono::steady_clock::now()};
+
+                // This mirrors the dispatch in CommandRecordThread::RecordNode without recording any Vulkan commands
+                u32 subpassIndex{};
+                for (auto header{nodes.Front()}; header; header = header->next) {
+                    switch (header->type) {
+                        case NodeType::Function:
+                            header->Get<FunctionNode>()(arguments.commandBuffer, arguments.cycle, arguments.Gpu());
+                            break;
+                        case NodeType::Checkpoint:
+                            counter += header->Get<CheckpointNode>().id;
+                            break;
+                        case NodeType::RenderPass:
+                            subpassIndex = 0;
+                            break;
+                        case NodeType::NextSubpass:
+                            subpassIndex++;
+                            break;
+                        case NodeType::SubpassFunction:
+                            header->Get<SubpassFunctionNode>()(arguments.commandBuffer, arguments.cycle, arguments.Gpu(), vk::RenderPass{}, subpassIndex);
+                            break;
+                        case NodeType::NextSubpassFunction:
+                            header->Get<NextSubpassFunctionNode>()(arguments.commandBuffer, arguments.cycle, arguments.Gpu(), vk::RenderPass{}, ++subpassIndex);
+                            break;
+                        case NodeType::RenderPassEnd:
+                            break;
+                    }
+                }
+                nodes.Clear();
+                auto replayEnd{std::chrono::steady_clock::now()};
+
+                if (!warmUp) {
+                    streamRecord.Add(replayStart - recordStart);
+                    streamReplay.Add(replayEnd - replayStart);
+                }
+            }
+            allocator.Reset();
+
+            {
+                std::list<LegacyNodeVariant, LinearAllocator<LegacyNodeVariant>> nodes{allocator};
+                auto recordStart{std::chrono::steady_clock::now()};
+                for (auto type : trace) {
+                    switch (type) {
+                        case NodeType::Function:
+                            nodes.emplace_back(LegacyFunctionNode{Payload<FunctionPayloadSize>{.counter = &counter}});
+                            break;
+                        case NodeType::Checkpoint:
+                            nodes.emplace_back(CheckpointNode{BufferBinding{}, static_cast<u32>(counter)});
+                            break;
+                        case NodeType::RenderPass:
+                            nodes.emplace_back(std::in_place_type_t<RenderPassNode>{}, vk::Rect2D{});
+                            break;
+                        case NodeType::NextSubpass:
+                            nodes.emplace_back(NextSubpassNode{});
+                            break;
+                        case NodeType::SubpassFunction:
+                            nodes.emplace_back(LegacySubpassFunctionNode{Payload<SubpassFunctionPayloadSize>{.counter = &counter}});
+                            break;
+                        case NodeType::NextSubpassFunction:
+                            nodes.emplace_back(LegacyNextSubpassFunctionNode{Payload<SubpassFunctionPayloadSize>{.counter = &counter}});
+                            break;
+                        case NodeType::RenderPassEnd:
+                            nodes.emplace_back(RenderPassEndNode{});
+                            break;
+                    }
+                }
+                auto replayStart{std::chrono::steady_clock::now()};
+
+                u32 subpassIndex{};
+                for (auto &node : nodes) {
+                    std::visit(VariantVisitor{
+                        [&](LegacyFunctionNode &function) { function(arguments.commandBuffer, arguments.cycle, arguments.Gpu()); },
+                        [&](CheckpointNode &checkpoint) { counter += checkpoint.id; },
+                        [&](RenderPassNode &) { subpassIndex = 0; },
+                        [&](NextSubpassNode &) { subpassIndex++; },
+                        [&](LegacySubpassFunctionNode &function) { function(arguments.commandBuffer, arguments.cycle, arguments.Gpu(), vk::RenderPass{}, subpassIndex); },
+                        [&](LegacyNextSubpassFunctionNode &node) { node.function(arguments.commandBuffer, arguments.cycle, arguments.Gpu(), vk::RenderPass{}, ++subpassIndex); },
+                        [&](RenderPassEndNode &) {},
+                    }, node);
+                }
+                nodes.clear();
+                auto replayEnd{std::chrono::steady_clock::now()};
+
+                if (!warmUp) {
+                    legacyRecord.Add(replayStart - recordStart);
+                    legacyReplay.Add(replayEnd - replayStart);
+                }
+            }
+            allocator.Reset();
+        }
+
+        ReportCounter("Nodes", trace.size());
+        streamRecord.Report("NodeStream Record", trace.size());
+        streamReplay.Report("NodeStream Replay", trace.size());
+        legacyRecord.Report("Variant List Record", trace.size());
+        legacyReplay.Report("Variant List Replay", trace.size());
+        ReportCounter("Checksum", counter);
+    }
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <bit>
+#include <random>
+#include <gpu.h>
+#include "../bench.h"
+
+/**
+ * @brief Allocation and deallocation of texture backings through MemoryManager::AllocateImage, small images being suballocated from the small image pools is compared against them being allocated alongside all other resources
+ * @note This requires a Vulkan device, the benchmark creates its own instance and device rather than the GPU as that requires the entire emulator
+ */
+namespace skyline::gpu::bench {
+    using namespace skyline::bench;
+
+    constexpr size_t Iterations{20};
+
+    /**
+     * @brief A GPU that only holds the Vulkan objects required by the memory manager and the memory manager itself
+     * @note Constructing a GPU loads the driver through the emulator and creates every manager, so the object itself is never constructed and only the members accessed by the memory manager are
+     */
+    class MemoryState {
+      private:
+        alignas(GPU) std::array<u8, sizeof(GPU)> storage{};
+
+      public:
+        GPU &gpu{*reinterpret_cast<GPU *>(storage.data())};
+
+        /**
+         * @param enableSmallImagePools If the memory manager should suballocate small images from its small image pools
+         */
+        MemoryState(bool enableSmallImagePools) {
+            std::construct_at(&gpu.vkContext);
+
+            vk::ApplicationInfo applicationInfo{
+                .pApplicationName = "Skyline Benchmarks",
+                .apiVersion = VkApiVersion,
+            };
+            std::construct_at(&gpu.vkInstance, gpu.vkContext, vk::InstanceCreateInfo{
+                .pApplicationInfo = &applicationInfo,
+            });
+            std::construct_at(&gpu.vkPhysicalDevice, std::move(vk::raii::PhysicalDevices{gpu.vkInstance}.front()));
+            std::construct_at(&gpu.traits);
+
+            auto queueFamilies{gpu.vkPhysicalDevice.getQueueFamilyProperties()};
+            gpu.vkQueueFamilyIndex = static_cast<u32>(std::distance(queueFamilies.begin(), std::find_if(queueFamilies.begin(), queueFamilies.end(), [](const vk::QueueFamilyProperties &family) {
+                return static_cast<bool>(family.queueFlags & vk::QueueFlagBits::eGraphics);
+            })));
+            float queuePriority{1.0f};
+            vk::DeviceQueueCreateInfo queueCreateInfo{
+                .queueFamilyIndex = gpu.vkQueueFamilyIndex,
+                .queueCount = 1,
+                .pQueuePriorities = &queuePriority,
+            };
+            std::construct_at(&gpu.vkDevice, gpu.vkPhysicalDevice, vk::DeviceCreateInfo{
+                .queueCreateInfoCount = 1,
+                .pQueueCreateInfos = &queueCreateInfo,
+            });
+
+            std::construct_at(&gpu.memory, gpu, enableSmallImagePools);
+        }
+
+        ~MemoryState() {
+            std::destroy_at(&gpu.memory);
+            std::destroy_at(&gpu.vkDevice);
+            std::destroy_at(&gpu.traits);
+            std::destroy_at(&gpu.vkPhysicalDevice);
+            std::destroy_at(&gpu.vkInstance);
+            std::destroy_at(&gpu.vkContext);
+        }
+    };
+
+    /**
+     * @return The textures of a frame: a set of render targets alongside a larger amount of sampled textures, most of which are small enough to be allocated from the small image pools
+     */
+    std::vector<vk::ImageCreateInfo> CreateTextures() {
+        std::vector<vk::ImageCreateInfo> textures;
+        constexpr vk::ImageUsageFlags SampledUsage{vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled};
+
+        for (size_t i{}; i < 16; i++) {
+            bool depth{i % 4 == 3};
+            textures.push_back(vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = depth ? vk::Format::eD32Sfloat : vk::Format::eR8G8B8A8Unorm,
+                .extent = {1280, 720, 1},
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = SampledUsage | (depth ? vk::ImageUsageFlagBits::eDepthStencilAttachment : vk::ImageUsageFlagBits::eColorAttachment),
+                .initialLayout = vk::ImageLayout::eUndefined,
+            });
+        }
+
+        std::mt19937 random{0};
+        for (size_t i{}; i < 2000; i++) {
+            u32 dimension{16U << (random() % 7)}; // 16x16 to 1024x1024, most of these fit within the small image size limit
+            textures.push_back(vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = random() % 2 ? vk::Format::eR8G8B8A8Unorm : vk::Format::eBc1RgbaUnormBlock,
+                .extent = {dimension, dimension, 1},
+                .mipLevels = static_cast<u32>(std::countr_zero(dimension)) + 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = SampledUsage,
+                .initialLayout = vk::ImageLayout::eUndefined,
+            });
+        }
+        return textures;
+    }
+
+    void AllocateTextures(std::string_view name, bool enableSmallImagePools, const std::vector<vk::ImageCreateInfo> &textures) {
+        MemoryState memoryState{enableSmallImagePools};
+        auto &memory{memoryState.gpu.memory};
+
+        Samples allocate, free;
+        i64 deviceMemoryCount{};
+        std::vector<memory::Image> images;
+        images.reserve(textures.size());
+        for (size_t iteration{}; iteration < Iterations; iteration++) {
+            allocate.Time([&] {
+                for (const auto &createInfo : textures)
+                    images.push_back(memory.AllocateImage(createInfo));
+            });
+            deviceMemoryCount = memory.GetDeviceMemoryCount();
+            free.Time([&] {
+                images.clear();
+            });
+        }
+
+        allocate.Report(fmt::format("{} Allocate", name), textures.size());
+        free.Report(fmt::format("{} Free", name), textures.size());
+        ReportCounter(fmt::format("{} Device Memory Objects", name), deviceMemoryCount);
+    }
+
+    BENCHMARK(TextureAllocation, AllocateFree) {
+        auto textures{CreateTextures()};
+        ReportCounter("Textures", textures.size());
+        AllocateTextures("Small Image Pools", true, textures);
+        AllocateTextures("Default Pools", false, textures);
+    }
+}
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <list>
+#include <random>
+#include <boost/container/small_vector.hpp>
+#include <tsl/robin_map.h>
+#include <common/segment_table.h>
+#include "../bench.h"
+
+/**
+ * @brief Replays the guest mapping lookups of TextureManager::FindOrCreate against the lookup structures of the texture manager, the segment table and address buckets are compared against the end-sorted mapping list that preceded them
+ * @note Creating textures requires a device so only the lookup structures are replayed, every lookup which doesn't find a texture with an identical mapping inserts one as FindOrCreate would
+ * @note The trace is a sequence of 'address size' pairs in hexadecimal, one per line, these correspond to the arguments of the FindOrCreate trace event and can be extracted from a captured Perfetto trace and supplied with the SKYLINE_TEXTURE_TRACE environment variable
+ */
+namespace skyline::gpu::bench {
+    using namespace skyline::bench;
+
+    constexpr size_t Iterations{50};
+
+    struct TraceEntry {
+        u64 address;
+        u64 size;
+
+        span<u8> Span() const {
+            return span<u8>{reinterpret_cast<u8 *>(address), size}; // The addresses are never dereferenced
+        }
+    };
+
+    /**
+     * @return The lookup trace from SKYLINE_TEXTURE_TRACE or a built-in trace if it isn't set, the built-in trace looks up the same set of render targets, sampled textures and views into them over a number of frames
+     */
+    std::vector<TraceEntry> LoadTrace() {
+        std::vector<TraceEntry> trace;
+        if (auto path{std::getenv("SKYLINE_TEXTURE_TRACE")}) {
+            std::ifstream stream{path};
+            TraceEntry entry{};
+            while (stream >> std::hex >> entry.address >> entry.size)
+                trace.push_back(entry);
+
+            if (trace.empty())
+                throw std::runtime_error(fmt::format("No lookups in the trace at '{}'", path));
+            return trace;
+        }
+
+        std::mt19937_64 random{0};
+        std::vector<TraceEntry> textures;
+        u64 address{0x5'0000'0000};
+        for (size_t i{}; i < 24; i++) { // Render targets with views of their individual layers and mips
+            u64 size{0x80'0000};
+            textures.push_back({address, size});
+            for (u64 offset{}; offset < size; offset += size / 4)
+                textures.push_back({address + offset, size / 8});
+            address += size;
+        }
+        for (size_t i{}; i < 2000; i++) { // Sampled textures of varying sizes, these are aligned to 64KiB like guest allocations
+            u64 size{0x1'0000ULL << (random() % 6)};
+            textures.push_back({address, size});
+            address += size;
+        }
+
+        for (size_t frame{}; frame < 16; frame++)
+            for (size_t i{}; i < textures.size() * 2; i++)
+                trace.push_back(textures[random() % textures.size()]);
+        return trace;
+    }
+
+    struct Mapping : span<u8> {
+        size_t id; //!< The index of the lookup in the trace that inserted the mapping
+
+        Mapping(span<u8> mapping, size_t id) : span<u8>{mapping}, id{id} {}
+    };
+
+    /**
+     * @brief The lookup structures of TextureManager: a segment table of mappings that don't overlap others and an index of the mappings overlapping every 1MiB bucket
+     */
+    class BucketIndex {
+      private:
+        static constexpr size_t BucketBits{20};
+        static constexpr size_t L2EntryGranularity{19};
+        std::list<Mapping> mappings;
+        tsl::robin_map<size_t, boost::container::small_vector<Mapping *, 4>> mappingBuckets;
+        SegmentTable<Mapping *, constant::AddressSpaceSize, constant::PageSizeBits, L2EntryGranularity> mappingTable;
+
+      public:
+        Mapping *Find(span<u8> range) {
+            if (auto mapping{mappingTable[reinterpret_cast<size_t>(range.data())]}; mapping && mapping->data() == range.data() && mapping->size() == range.size())
+                return mapping;
+
+            boost::container::small_vector<Mapping *, 8> candidates;
+            if (auto bucketIt{mappingBuckets.find(reinterpret_cast<size_t>(range.data()) >> BucketBits)}; bucketIt != mappingBuckets.end())
+                for (auto mapping : bucketIt->second)
+                    if (mapping->contains(range))
+                        candidates.push_back(mapping);
+
+            std::stable_sort(candidates.begin(), candidates.end(), [](Mapping *lhs, Mapping *rhs) {
+                return lhs->end() < rhs->end();
+            });
+
+            for (auto it{candidates.rbegin()}; it != candidates.rend(); it++)
+                if ((*it)->data() == range.data() && (*it)->size() == range.size())
+                    return *it;
+            return nullptr;
+        }
+
+        void Insert(span<u8> range, size_t id) {
+            size_t rangeStart{reinterpret_cast<size_t>(range.data())}, rangeEnd{rangeStart + std::max<size_t>(range.size(), 1)};
+            size_t firstBucket{rangeStart >> BucketBits}, lastBucket{(rangeEnd - 1) >> BucketBits};
+
+            bool overlapping{};
+            for (size_t bucket{firstBucket}; bucket <= lastBucket; bucket++) {
+                if (auto bucketIt{mappingBuckets.find(bucket)}; bucketIt != mappingBuckets.end()) {
+                    for (auto mapping : bucketIt->second) {
+                        if (std::max(reinterpret_cast<size_t>(mapping->data()) >> BucketBits, firstBucket) == bucket && mapping->data() < range.end().base() && range.data() < mapping->end().base()) {
+                            overlapping = true;
+                            mappingTable.Set(mapping->begin().base(), mapping->end().base(), nullptr);
+                        }
+                    }
+                }
+            }
+
+            auto &mapping{mappings.emplace_back(range, id)};
+            for (size_t bucket{firstBucket}; bucket <= lastBucket; bucket++)
+                mappingBuckets[bucket].push_back(&mapping);
+            mappingTable.Set(range.begin().base(), range.end().base(), overlapping ? nullptr : &mapping);
+        }
+    };
+
+    /**
+     * @brief The lookup structure which preceded BucketIndex: a single list of all mappings sorted by their end address
+     */
+    class SortedListIndex {
+      private:
+        std::list<Mapping> mappings;
+        std::list<Mapping>::iterator lookupEnd; //!< The insertion point found by the last lookup
+
+      public:
+        Mapping *Find(span<u8> range) {
+            // The searches are performed exactly as they were in FindOrCreate, including their comparators
+            lookupEnd = std::upper_bound(mappings.begin(), mappings.end(), range, [range](const auto &value, const auto &element) {
+                return range.end() < element.end();
+            });
+            auto mapping{std::lower_bound(lookupEnd, mappings.end(), range, [range](const auto &value, const auto &element) {
+                return range.begin() < element.end();
+            })};
+
+            while (mapping != mappings.begin() && (--mapping)->end() > range.begin())
+                if (mapping->contains(range) && mapping->data() == range.data() && mapping->size() == range.size())
+                    return &*mapping;
+            return nullptr;
+        }
+
+        /**
+         * @note This must directly follow a call to `Find` with the same range
+         */
+        void Insert(span<u8> range, size_t id) {
+            mappings.emplace(lookupEnd, range, id);
+        }
+    };
+
+    template<typename Index>
+    void Replay(std::string_view name, const std::vector<TraceEntry> &trace) {
+        Samples samples;
+        size_t hits{}, inserts{};
+        for (size_t iteration{}; iteration < Iterations; iteration++) {
+            Index index;
+            hits = inserts = 0;
+            samples.Time([&] {
+                for (size_t i{}; i < trace.size(); i++) {
+                    auto range{trace[i].Span()};
+                    if (index.Find(range)) {
+                        hits++;
+                    } else {
+                        index.Insert(range, i);
+                        inserts++;
+                    }
+                }
+            });
+        }
+
+        samples.Report(name, trace.size());
+        ReportCounter(fmt::format("{} Hits/Inserts", name), fmt::format("{}/{}", hits, inserts));
+    }
+
+    BENCHMARK(TextureLookup, FindOrCreateTrace) {
+        auto trace{LoadTrace()};
+        ReportCounter("Lookups", trace.size());
+        Replay<BucketIndex>("Segment Table + Buckets", trace);
+        Replay<SortedListIndex>("Sorted Mapping List", trace);
+    }
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <barrier>
+#include <mutex>
+#include <thread>
+#include <kernel/scheduler.h>
+#include <kernel/types/KThread.h>
+#include "../bench.h"
+
+namespace skyline::kernel::bench {
+    using namespace skyline::bench;
+
+    constexpr u8 ApplicationCoreCount{3}; //!< The amount of cores that guest threads are scheduled onto, the last core is reserved for the system
+    constexpr i8 GuestThreadPriority{44}; //!< The priority of all guest threads, this is cooperative on every application core and all threads share it so no thread is ever preempted
+
+    /**
+     * @brief A DeviceState that only holds a scheduler, the scheduler and synchronization objects don't access any other member of it
+     * @note Constructing a DeviceState creates the entire emulator, so the object itself is never constructed and only the scheduler member is
+     */
+    class SchedulerState {
+      private:
+        alignas(DeviceState) std::array<u8, sizeof(DeviceState)> storage{};
+
+      public:
+        const DeviceState &state{*reinterpret_cast<DeviceState *>(storage.data())};
+
+        SchedulerState() {
+            std::construct_at(&const_cast<DeviceState &>(state).scheduler, std::make_shared<Scheduler>(state));
+        }
+
+        ~SchedulerState() {
+            std::destroy_at(&const_cast<DeviceState &>(state).scheduler);
+        }
+    };
+
+    /**
+     * @brief Runs the supplied function on a host thread for every guest thread, each guest thread is inserted into the queue of its ideal core and scheduled before the function is called
+     * @param function A function taking the index of the guest thread and its KThread, the thread must be scheduled when it returns
+     * @return The duration from all host threads being ready to run till the last one has exited
+     * @note Guest threads are spread evenly across the application cores, they aren't started as host threads so yielding them with a signal would never complete
+     */
+    template<typename Function>
+    std::chrono::nanoseconds RunGuestThreads(const DeviceState &state, size_t count, Function function) {
+        std::vector<std::shared_ptr<type::KThread>> threads;
+        for (size_t index{}; index < count; index++)
+            threads.push_back(std::make_shared<type::KThread>(state, static_cast<KHandle>(index), nullptr, index, nullptr, 0, nullptr, GuestThreadPriority, static_cast<u8>(index % ApplicationCoreCount)));
+
+        std::chrono::steady_clock::time_point startTime;
+        std::barrier start{static_cast<std::ptrdiff_t>(count), [&startTime]() noexcept {
+            startTime = std::chrono::steady_clock::now();
+        }};
+        std::vector<std::thread> hostThreads;
+        for (size_t index{}; index < count; index++) {
+            hostThreads.emplace_back([&, index] {
+                DeviceState::thread = threads[index];
+                state.scheduler->InsertThread(DeviceState::thread);
+                start.arrive_and_wait();
+
+                state.scheduler->WaitSchedule(false);
+                function(index, *DeviceState::thread);
+                state.scheduler->RemoveThread();
+                DeviceState::thread = nullptr;
+            });
+        }
+
+        for (auto &thread : hostThreads)
+            thread.join();
+        return std::chrono::steady_clock::now() - startTime;
+    }
+
+    /**
+     * @brief Samples which can be added to from multiple threads
+     */
+    class SharedSamples {
+      private:
+        std::mutex mutex;
+        Samples samples;
+
+      public:
+        void Add(const std::vector<std::chrono::nanoseconds> &threadSamples) {
+            std::scoped_lock lock{mutex};
+            for (auto sample : threadSamples)
+                samples.Add(sample);
+        }
+
+        void Report(std::string_view name, size_t operationsPerSample = 1) {
+            std::scoped_lock lock{mutex};
+            samples.Report(name, operationsPerSample);
+        }
+    };
+}
@@ -0,0 +1,311 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <map>
+#include <random>
+#include <kernel/memory.h>
+#include "../bench.h"
+
+/**
+ * @brief Guest memory state tracking of MemoryManager, the page table is compared against the coalesced chunk map which preceded it
+ * @note The MemoryManager itself reserves and reprotects host memory on every mapping, only the state tracking is replayed to keep syscalls out of the measurements, the addresses are never dereferenced
+ */
+namespace skyline::kernel::bench {
+    using namespace skyline::bench;
+
+    constexpr size_t Iterations{20};
+    constexpr size_t HeapGrowthStep{2 * 1024 * 1024}; //!< The granularity of svcSetHeapSize
+    constexpr size_t HeapGrowthSize{1024 * 1024 * 1024}; //!< The size the heap is grown to in steps and then shrunk back from
+    constexpr size_t MapUnmapSlots{256}; //!< The amount of slots in the alias region that are mapped or unmapped at random
+    constexpr size_t MapUnmapOperations{20000};
+    constexpr size_t RandomQueries{100000};
+
+    /**
+     * @brief The region layout of a 39-bit address space as set up by MemoryManager::InitializeRegions
+     */
+    namespace layout {
+        constexpr u64 Code{1ULL << 35};
+        constexpr u64 CodeSize{0x4000000};
+        constexpr u64 Alias{Code + CodeSize};
+        constexpr u64 AliasSize{0x1000000000};
+        constexpr u64 Heap{Alias + AliasSize};
+        constexpr u64 HeapSize{0x180000000};
+        constexpr u64 Stack{Heap + HeapSize};
+        constexpr u64 StackSize{0x80000000};
+        constexpr u64 TlsIo{Stack + StackSize};
+    }
+
+    u8 *Address(u64 address) {
+        return reinterpret_cast<u8 *>(address);
+    }
+
+    /**
+     * @brief The chunk map that preceded the page table, mappings are coalesced with their neighbours as they're made
+     */
+    class ChunkMapIndex {
+      private:
+        struct Chunk {
+            bool isSrcMergeDisallowed;
+            memory::Permission permission;
+            memory::MemoryAttribute attributes;
+            memory::MemoryState state;
+            size_t size;
+
+            constexpr bool IsCompatible(const Chunk &chunk) const noexcept {
+                return chunk.permission == permission && chunk.state.value == state.value && chunk.attributes.value == attributes.value && !isSrcMergeDisallowed;
+            }
+        };
+
+        std::map<u8 *, Chunk> chunks{{Address(0), {.state = memory::states::Unmapped, .size = constant::AddressSpaceSize}}, {Address(UINT64_MAX), {.state = memory::states::Reserved}}};
+
+      public:
+        bool needsReprotection{}; //!< If the last mapping would have reprotected host memory
+
+        /**
+         * @note This is MemoryManager::MapInternal as it was prior to the page table without the host reprotection
+         */
+        void Map(u8 *address, size_t size, memory::MemoryState state, memory::Permission permission, bool isSrcMergeDisallowed) {
+            std::pair<u8 *, Chunk> newDesc{address, Chunk{.isSrcMergeDisallowed = isSrcMergeDisallowed, .permission = permission, .state = state, .size = size}};
+
+            auto firstChunkBase{chunks.lower_bound(newDesc.first)};
+            if (newDesc.first <= firstChunkBase->first)
+                --firstChunkBase;
+
+            auto lastChunkBase{chunks.lower_bound(newDesc.first + newDesc.second.size)};
+            if ((newDesc.first + newDesc.second.size) < lastChunkBase->first)
+                --lastChunkBase;
+
+            Chunk firstChunk{firstChunkBase->second};
+            Chunk lastChunk{lastChunkBase->second};
+
+            needsReprotection = false;
+            bool isUnmapping{newDesc.second.state == memory::states::Unmapped};
+
+            if (firstChunkBase->first == lastChunkBase->first) {
+                if (firstChunk.IsCompatible(newDesc.second)) [[unlikely]]
+                    return;
+
+                if ((firstChunk.state == memory::states::Unmapped) != isUnmapping)
+                    needsReprotection = true;
+
+                firstChunk.size = static_cast<size_t>(newDesc.first - firstChunkBase->first);
+                chunks[firstChunkBase->first] = firstChunk;
+
+                lastChunk.size = static_cast<size_t>((lastChunkBase->first + lastChunk.size) - (newDesc.first + newDesc.second.size));
+                chunks.insert({newDesc.first + newDesc.second.size, lastChunk});
+
+                chunks.insert(newDesc);
+            } else {
+                if ((firstChunkBase->first + firstChunk.size) != lastChunkBase->first) {
+                    auto tempChunkBase{std::next(firstChunkBase)};
+
+                    while (tempChunkBase->first != lastChunkBase->first) {
+                        auto tmp{tempChunkBase++};
+                        if ((tmp->second.state == memory::states::Unmapped) != isUnmapping)
+                            needsReprotection = true;
+                    }
+                    chunks.erase(std::next(firstChunkBase), lastChunkBase);
+                }
+
+                bool shouldInsert{true};
+
+                if (firstChunk.IsCompatible(newDesc.second)) {
+                    shouldInsert = false;
+
+                    firstChunk.size = static_cast<size_t>((newDesc.first + newDesc.second.size) - firstChunkBase->first);
+                    chunks[firstChunkBase->first] = firstChunk;
+                } else if ((firstChunkBase->first + firstChunk.size) != newDesc.first) {
+                    firstChunk.size = static_cast<size_t>(newDesc.first - firstChunkBase->first);
+
+                    chunks[firstChunkBase->first] = firstChunk;
+
+                    if ((firstChunk.state == memory::states::Unmapped) != isUnmapping)
+                        needsReprotection = true;
+                }
+
+                if (lastChunk.IsCompatible(newDesc.second)) {
+                    u8 *oldBase{lastChunkBase->first};
+                    chunks.erase(lastChunkBase);
+
+                    if (shouldInsert) {
+                        shouldInsert = false;
+
+                        lastChunk.size = static_cast<size_t>((lastChunk.size + oldBase) - (newDesc.first));
+
+                        chunks[newDesc.first] = lastChunk;
+                    } else {
+                        firstChunk.size = static_cast<size_t>((lastChunk.size + oldBase) - firstChunkBase->first);
+                        chunks[firstChunkBase->first] = firstChunk;
+                    }
+                } else if ((newDesc.first + newDesc.second.size) != lastChunkBase->first) {
+                    lastChunk.size = static_cast<size_t>((lastChunk.size + lastChunkBase->first) - (newDesc.first + newDesc.second.size));
+
+                    chunks.erase(lastChunkBase);
+                    chunks[newDesc.first + newDesc.second.size] = lastChunk;
+
+                    if ((lastChunk.state == memory::states::Unmapped) != isUnmapping)
+                        needsReprotection = true;
+                }
+
+                if (shouldInsert)
+                    chunks.insert(newDesc);
+            }
+        }
+
+        std::pair<u8 *, size_t> Query(u8 *address) {
+            auto chunkBase{chunks.lower_bound(address)};
+            if (address < chunkBase->first)
+                --chunkBase;
+            return {chunkBase->first, chunkBase->second.size};
+        }
+    };
+
+    /**
+     * @brief The page table of MemoryManager, mappings only set the state of their pages and chunks are coalesced by queries
+     */
+    class PageTableIndex {
+      private:
+        SegmentTable<PageDescriptor, constant::AddressSpaceSize, constant::PageSizeBits, 21> pageTable;
+
+      public:
+        bool needsReprotection{}; //!< If the last mapping would have reprotected host memory
+
+        PageTableIndex() {
+            pageTable.Set(Address(0), Address(constant::AddressSpaceSize), PageDescriptor{});
+        }
+
+        /**
+         * @note This is MemoryManager::MapInternal without the host reprotection
+         */
+        void Map(u8 *address, size_t size, memory::MemoryState state, memory::Permission permission, bool) {
+            u8 *end{address + size};
+            bool isUnmapping{state == memory::states::Unmapped};
+
+            needsReprotection = false;
+            for (u8 *page{address}; page < end && !needsReprotection; page = pageTable.GetRange(page, page, end).second)
+                needsReprotection = (pageTable[page].GetState() == memory::states::Unmapped) != isUnmapping;
+
+            pageTable.Set(address, end, PageDescriptor{ChunkDescriptor{.permission = permission, .state = state, .size = size}});
+        }
+
+        std::pair<u8 *, size_t> Query(u8 *address) {
+            auto [start, end]{pageTable.GetRange(address, Address(0), Address(constant::AddressSpaceSize))};
+            return {start, static_cast<size_t>(end - start)};
+        }
+    };
+
+    /**
+     * @brief Maps the code, main thread stack and TLS pages of a typical application with a few shared memory mappings in the alias region
+     */
+    template<typename Index>
+    void MapApplication(Index &index) {
+        u64 code{layout::Code};
+        for (auto [size, permission] : {std::pair{0x1200000UL, memory::Permission{true, false, true}}, std::pair{0x400000UL, memory::Permission{true, false, false}}, std::pair{0x800000UL, memory::Permission{true, true, false}}}) {
+            index.Map(Address(code), size, memory::states::Code, permission, false);
+            code += size;
+        }
+
+        index.Map(Address(layout::Stack), 0x100000, memory::states::Stack, {true, true, false}, true);
+        for (u64 page{}; page < 64; page++)
+            index.Map(Address(layout::TlsIo + page * 2 * constant::PageSize), constant::PageSize, memory::states::ThreadLocal, {true, true, false}, false);
+        for (u64 mapping{}; mapping < 16; mapping++)
+            index.Map(Address(layout::Alias + mapping * 0x1000000), 0x40000, memory::states::SharedMemory, {true, mapping % 2 == 0, false}, true);
+    }
+
+    template<typename Index>
+    void HeapGrowth(std::string_view name) {
+        Samples samples;
+        for (size_t iteration{}; iteration < Iterations; iteration++) {
+            Index index;
+            MapApplication(index);
+            samples.Time([&] {
+                for (u64 size{}; size < HeapGrowthSize; size += HeapGrowthStep)
+                    index.Map(Address(layout::Heap + size), HeapGrowthStep, memory::states::Heap, {true, true, false}, false);
+                for (u64 size{HeapGrowthSize}; size; size -= HeapGrowthStep)
+                    index.Map(Address(layout::Heap + size - HeapGrowthStep), HeapGrowthStep, memory::states::Unmapped, {}, false);
+            });
+        }
+        samples.Report(name, 2 * (HeapGrowthSize / HeapGrowthStep));
+    }
+
+    template<typename Index>
+    void MapUnmap(std::string_view name) {
+        Samples samples;
+        size_t reprotections{};
+        for (size_t iteration{}; iteration < Iterations; iteration++) {
+            Index index;
+            MapApplication(index);
+            std::mt19937_64 random{iteration};
+            reprotections = 0;
+            samples.Time([&] {
+                // Slots are 1MiB apart and mappings are up to 1MiB large, adjacent mappings are common
+                for (size_t operation{}; operation < MapUnmapOperations; operation++) {
+                    auto slot{Address(layout::Alias + 0x10000000 + (random() % MapUnmapSlots) * 0x100000)};
+                    size_t size{(random() % 16 + 1) * 0x10000};
+                    switch (random() % 3) {
+                        case 0:
+                            index.Map(slot, size, memory::states::SharedMemory, {true, true, false}, true);
+                            break;
+                        case 1:
+                            index.Map(slot, size, memory::states::TransferMemory, {true, false, false}, true);
+                            break;
+                        default:
+                            index.Map(slot, size, memory::states::Unmapped, {}, false);
+                            break;
+                    }
+                    reprotections += index.needsReprotection;
+                }
+            });
+        }
+        samples.Report(name, MapUnmapOperations);
+        ReportCounter(fmt::format("{} Reprotections", name), reprotections);
+    }
+
+    template<typename Index>
+    void QueryMemory(std::string_view name) {
+        Samples walkSamples, randomSamples;
+        size_t walkQueries{};
+        u64 checksum{};
+        for (size_t iteration{}; iteration < Iterations; iteration++) {
+            Index index;
+            MapApplication(index);
+            index.Map(Address(layout::Heap), 0x20000000, memory::states::Heap, {true, true, false}, false);
+
+            // Applications walk the entire address space with svcQueryMemory to find the regions they can use
+            walkQueries = 0;
+            walkSamples.Time([&] {
+                for (u8 *address{}; address < Address(constant::AddressSpaceSize); walkQueries++) {
+                    auto [base, size]{index.Query(address)};
+                    address = base + size;
+                }
+            });
+
+            std::mt19937_64 random{iteration};
+            std::vector<u8 *> addresses(RandomQueries);
+            for (auto &address : addresses)
+                address = Address(layout::Code + random() % (layout::TlsIo + 64 * 2 * constant::PageSize - layout::Code));
+            randomSamples.Time([&] {
+                for (auto address : addresses)
+                    checksum += index.Query(address).second;
+            });
+        }
+        walkSamples.Report(fmt::format("{} Address Space Walk", name), walkQueries);
+        randomSamples.Report(fmt::format("{} Random Address", name), RandomQueries);
+        ReportCounter(fmt::format("{} Checksum", name), checksum);
+    }
+
+    BENCHMARK(MemoryManager, HeapGrowth) {
+        HeapGrowth<PageTableIndex>("Page Table");
+        HeapGrowth<ChunkMapIndex>("Chunk Map");
+    }
+
+    BENCHMARK(MemoryManager, MapUnmap) {
+        MapUnmap<PageTableIndex>("Page Table");
+        MapUnmap<ChunkMapIndex>("Chunk Map");
+    }
+
+    BENCHMARK(MemoryManager, QueryMemory) {
+        QueryMemory<PageTableIndex>("Page Table");
+        QueryMemory<ChunkMapIndex>("Chunk Map");
+    }
+}
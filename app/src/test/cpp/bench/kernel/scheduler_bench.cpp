@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "guest_threads.h"
+
+/**
+ * @brief Cooperative yields and core migrations of a large amount of guest threads contending for the application cores of the scheduler
+ * @note All guest threads share the same priority so every yield rotates the calling thread to the back of its core's queue and schedules the next thread
+ */
+namespace skyline::kernel::bench {
+    constexpr std::array<size_t, 2> ThreadCounts{64, 128};
+    constexpr size_t Yields{200}; //!< The amount of yields performed by every thread
+    constexpr size_t Migrations{50}; //!< The amount of migrations performed by every thread
+
+    BENCHMARK(Scheduler, Yield) {
+        for (size_t threadCount : ThreadCounts) {
+            SchedulerState schedulerState;
+            auto &state{schedulerState.state};
+
+            std::array<std::atomic<std::chrono::steady_clock::rep>, ApplicationCoreCount> yieldTimes{}; //!< The time at which the last thread on each core yielded, this is consumed by the thread which is scheduled after it
+            SharedSamples handoffSamples, rotateSamples;
+            auto duration{RunGuestThreads(state, threadCount, [&](size_t, type::KThread &thread) {
+                std::vector<std::chrono::nanoseconds> handoffs, rotates;
+                for (size_t yield{}; yield < Yields; yield++) {
+                    auto yieldTime{std::chrono::steady_clock::now()};
+                    yieldTimes[thread.coreId] = yieldTime.time_since_epoch().count();
+                    state.scheduler->Rotate();
+                    rotates.push_back(std::chrono::steady_clock::now() - yieldTime);
+
+                    state.scheduler->WaitSchedule(false);
+                    if (auto previousYield{yieldTimes[thread.coreId].exchange(0)})
+                        handoffs.push_back(std::chrono::steady_clock::now() - std::chrono::steady_clock::time_point{std::chrono::steady_clock::duration{previousYield}});
+                }
+                handoffSamples.Add(handoffs);
+                rotateSamples.Add(rotates);
+            })};
+
+            rotateSamples.Report(fmt::format("{} Threads Rotate", threadCount));
+            handoffSamples.Report(fmt::format("{} Threads Yield Handoff", threadCount));
+            ReportCounter(fmt::format("{} Threads Throughput", threadCount), fmt::format("{:.0f} yields/s", static_cast<double>(threadCount * Yields) / std::chrono::duration<double>(duration).count()));
+        }
+    }
+
+    BENCHMARK(Scheduler, Migration) {
+        for (size_t threadCount : ThreadCounts) {
+            SchedulerState schedulerState;
+            auto &state{schedulerState.state};
+
+            SharedSamples migrationSamples;
+            auto duration{RunGuestThreads(state, threadCount, [&](size_t, type::KThread &thread) {
+                std::vector<std::chrono::nanoseconds> migrations;
+                for (size_t migration{}; migration < Migrations; migration++) {
+                    auto targetCore{static_cast<u8>((thread.coreId + 1) % ApplicationCoreCount)};
+                    auto start{std::chrono::steady_clock::now()};
+                    {
+                        // This mirrors svcSetThreadCoreMask migrating the calling thread to a core outside its new affinity mask, the latency includes waiting to be scheduled on the new core
+                        std::scoped_lock guard{thread.coreMigrationMutex};
+                        thread.idealCore = targetCore;
+                        thread.affinityMask.reset();
+                        thread.affinityMask.set(targetCore);
+
+                        state.scheduler->RemoveThread();
+                        thread.coreId = targetCore;
+                        state.scheduler->InsertThread(DeviceState::thread);
+                        state.scheduler->WaitSchedule(false);
+                    }
+                    migrations.push_back(std::chrono::steady_clock::now() - start);
+                }
+                migrationSamples.Add(migrations);
+            })};
+
+            migrationSamples.Report(fmt::format("{} Threads Migration", threadCount));
+            ReportCounter(fmt::format("{} Threads Throughput", threadCount), fmt::format("{:.0f} migrations/s", static_cast<double>(threadCount * Migrations) / std::chrono::duration<double>(duration).count()));
+        }
+    }
+}
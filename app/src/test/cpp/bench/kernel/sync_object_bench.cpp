@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <kernel/types/KEvent.h>
+#include "guest_threads.h"
+
+/**
+ * @brief Signal and wait round-trips between pairs of guest threads through KSyncObject::WaitForAny, which is the implementation of svcWaitSynchronization, with an increasing amount of pairs contending for the application cores
+ * @note Every pair is split across two cores, a round-trip is the first thread signalling its partner and waiting till it's signalled back
+ */
+namespace skyline::kernel::bench {
+    constexpr size_t RoundTrips{2000}; //!< The amount of round-trips performed by every pair
+    constexpr size_t RoundTripsPerSample{50};
+    constexpr std::array<size_t, 6> PairCounts{1, 2, 4, 8, 16, 32}; //!< The amount of pairs in each run, the last run has 64 guest threads
+
+    /**
+     * @brief Waits on the supplied event alongside the shared object if there is one and resets the event
+     */
+    void WaitForEvent(const DeviceState &state, type::KEvent &event, type::KEvent *shared) {
+        std::array<type::KSyncObject *, 2> objects{&event, shared};
+        auto result{type::KSyncObject::WaitForAny(state, span<type::KSyncObject *>{objects.data(), shared ? 2UL : 1UL}, -1)};
+        if (!result || *result != 0)
+            throw exception("Wait on the event returned 0x{:X}", static_cast<Result>(result).raw);
+        event.ResetSignal();
+    }
+
+    /**
+     * @param shared If every wait should include a common object which is never signalled, this measures contention on the waiter queue of a single object
+     */
+    void PingPong(std::string_view name, bool shared) {
+        for (size_t pairCount : PairCounts) {
+            SchedulerState schedulerState;
+            auto &state{schedulerState.state};
+
+            std::vector<std::shared_ptr<type::KEvent>> events;
+            for (size_t index{}; index < pairCount * 2; index++)
+                events.push_back(std::make_shared<type::KEvent>(state, false));
+            auto sharedEvent{shared ? std::make_shared<type::KEvent>(state, false) : nullptr};
+
+            SharedSamples samples;
+            auto duration{RunGuestThreads(state, pairCount * 2, [&](size_t index, type::KThread &) {
+                // Both threads of a pair are on different cores as their indices are adjacent, the even thread initiates every round-trip
+                auto &signalEvent{*events[index ^ 1]}, &waitEvent{*events[index]};
+                if (index % 2 == 0) {
+                    std::vector<std::chrono::nanoseconds> threadSamples;
+                    for (size_t sample{}; sample < RoundTrips / RoundTripsPerSample; sample++) {
+                        auto start{std::chrono::steady_clock::now()};
+                        for (size_t roundTrip{}; roundTrip < RoundTripsPerSample; roundTrip++) {
+                            signalEvent.Signal();
+                            WaitForEvent(state, waitEvent, sharedEvent.get());
+                        }
+                        threadSamples.push_back(std::chrono::steady_clock::now() - start);
+                    }
+                    samples.Add(threadSamples);
+                } else {
+                    for (size_t roundTrip{}; roundTrip < RoundTrips; roundTrip++) {
+                        WaitForEvent(state, waitEvent, sharedEvent.get());
+                        signalEvent.Signal();
+                    }
+                }
+            })};
+
+            samples.Report(fmt::format("{} {} Pairs Round-Trip", name, pairCount), RoundTripsPerSample);
+            auto seconds{std::chrono::duration<double>(duration).count()};
+            ReportCounter(fmt::format("{} {} Pairs Throughput", name, pairCount), fmt::format("{:.0f} round-trips/s", static_cast<double>(pairCount * RoundTrips) / seconds));
+        }
+    }
+
+    BENCHMARK(KSyncObject, SignalWaitScaling) {
+        PingPong("Independent", false);
+        PingPong("Shared Object", true);
+    }
+}
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <cstdlib>
+#include <string>
+#include "test.h"
+
+int main(int argc, char **argv) {
+    // An optional argument restricts the run to a single suite
+    std::string filter{argc > 1 ? fmt::format("{}.", argv[1]) : ""};
+
+    int failures{};
+    for (const auto &[name, test] : skyline::test::GetTests()) {
+        if (!name.starts_with(filter))
+            continue;
+
+        try {
+            test();
+            fmt::print("[PASS] {}\n", name);
+        } catch (const std::exception &e) {
+            fmt::print("[FAIL] {}: {}\n", name, e.what());
+            failures++;
+        }
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
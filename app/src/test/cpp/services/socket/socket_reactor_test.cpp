@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <netinet/in.h>
+#include <unistd.h>
+#include <future>
+#include <services/socket/bsd/socket_reactor.h>
+#include "../../test.h"
+
+/**
+ * @brief Tests for SocketReactor over loopback sockets, these cover the waiting done by bsd:u on behalf of blocking guest sockets
+ */
+namespace skyline::service::socket::test {
+    using namespace std::chrono_literals;
+
+    constexpr auto ShortTimeout{50ms}; //!< A timeout which is expected to expire during a test
+    constexpr auto LongTimeout{5s}; //!< A timeout which is only expected to expire if the reactor fails to wake a waiter
+
+    /**
+     * @brief A pair of connected sockets which are closed once the test is done
+     */
+    struct SocketPair {
+        std::array<int, 2> fds{-1, -1};
+
+        /**
+         * @param tcp If the pair should be a TCP connection over the loopback interface rather than a UNIX domain socket pair
+         */
+        SocketPair(bool tcp = false) {
+            if (!tcp) {
+                EXPECT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) == 0);
+                return;
+            }
+
+            int listener{::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+            EXPECT(listener >= 0);
+            sockaddr_in address{.sin_family = AF_INET, .sin_port = 0, .sin_addr = {.s_addr = htonl(INADDR_LOOPBACK)}};
+            socklen_t addressLength{sizeof(address)};
+            EXPECT(bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+            EXPECT(listen(listener, 1) == 0);
+            EXPECT(getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength) == 0);
+
+            fds[0] = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            EXPECT(connect(fds[0], reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+            fds[1] = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            close(listener);
+            EXPECT(fds[1] >= 0);
+        }
+
+        ~SocketPair() {
+            for (int fd : fds)
+                if (fd >= 0)
+                    close(fd);
+        }
+
+        void SetTimeout(int option, std::chrono::microseconds timeout) const {
+            timeval value{.tv_sec = static_cast<time_t>(timeout.count() / 1000000), .tv_usec = static_cast<suseconds_t>(timeout.count() % 1000000)};
+            EXPECT(setsockopt(fds[0], SOL_SOCKET, option, &value, sizeof(value)) == 0);
+        }
+    };
+
+    /**
+     * @return A non-blocking receive on the supplied socket, this is how bsd:u performs every receive
+     */
+    auto Receive(int fd, std::string &buffer) {
+        return [fd, &buffer] {
+            std::array<char, 16> data;
+            ssize_t result{recv(fd, data.data(), data.size(), MSG_DONTWAIT)};
+            if (result > 0)
+                buffer.append(data.data(), static_cast<size_t>(result));
+            return result;
+        };
+    }
+
+    /**
+     * @brief Writes to the supplied socket after a delay on another thread, this gives the caller time to start waiting on the reactor
+     */
+    std::future<void> DelayedWrite(int fd, std::string_view data, std::chrono::milliseconds delay = 20ms) {
+        return std::async(std::launch::async, [fd, data, delay] {
+            std::this_thread::sleep_for(delay);
+            EXPECT(write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+        });
+    }
+
+    TEST_CASE(SocketReactor, ReadinessBeforeWaitIsObserved) {
+        SocketReactor reactor;
+        SocketPair pair;
+        EXPECT(write(pair.fds[1], "a", 1) == 1);
+
+        pollfd fd{.fd = pair.fds[0], .events = POLLIN};
+        auto start{SocketReactor::Clock::now()};
+        EXPECT(reactor.Wait(span<pollfd>{fd}, start + LongTimeout));
+        EXPECT(SocketReactor::Clock::now() - start < LongTimeout);
+    }
+
+    TEST_CASE(SocketReactor, OneShotRegistrationIsRearmed) {
+        SocketReactor reactor;
+        SocketPair pair;
+        pollfd fd{.fd = pair.fds[0], .events = POLLIN};
+
+        for (char value : {'a', 'b', 'c'}) {
+            auto writer{DelayedWrite(pair.fds[1], std::string_view{&value, 1})};
+            EXPECT(reactor.Wait(span<pollfd>{fd}, SocketReactor::Clock::now() + LongTimeout));
+            writer.get();
+
+            char received{};
+            EXPECT(recv(pair.fds[0], &received, 1, MSG_DONTWAIT) == 1);
+            EXPECT(received == value);
+
+            // The registration was disarmed by the wake-up and must not wake the next waiter while the socket isn't ready
+            EXPECT(!reactor.Wait(span<pollfd>{fd}, SocketReactor::Clock::now() + ShortTimeout));
+        }
+    }
+
+    TEST_CASE(SocketReactor, ReceiveWaitsForData) {
+        SocketReactor reactor;
+        SocketPair pair{true};
+        std::string buffer;
+
+        auto writer{DelayedWrite(pair.fds[1], "data")};
+        EXPECT(reactor.PerformOperation(pair.fds[0], POLLIN, false, Receive(pair.fds[0], buffer)) == 4);
+        writer.get();
+        EXPECT(buffer == "data");
+    }
+
+    TEST_CASE(SocketReactor, NonBlockingReceiveDoesNotWait) {
+        SocketReactor reactor;
+        SocketPair pair;
+        pair.SetTimeout(SO_RCVTIMEO, LongTimeout);
+        std::string buffer;
+
+        auto start{SocketReactor::Clock::now()};
+        EXPECT(reactor.PerformOperation(pair.fds[0], POLLIN, true, Receive(pair.fds[0], buffer)) == -1);
+        EXPECT(errno == EAGAIN || errno == EWOULDBLOCK);
+        EXPECT(SocketReactor::Clock::now() - start < LongTimeout);
+    }
+
+    TEST_CASE(SocketReactor, ReceiveTimeoutExpires) {
+        SocketReactor reactor;
+        SocketPair pair{true};
+        pair.SetTimeout(SO_RCVTIMEO, ShortTimeout);
+        std::string buffer;
+
+        auto start{SocketReactor::Clock::now()};
+        EXPECT(reactor.PerformOperation(pair.fds[0], POLLIN, false, Receive(pair.fds[0], buffer)) == -1);
+        auto elapsed{SocketReactor::Clock::now() - start};
+        EXPECT(errno == EAGAIN);
+        EXPECT(elapsed >= ShortTimeout && elapsed < LongTimeout);
+    }
+
+    TEST_CASE(SocketReactor, SendTimeoutExpires) {
+        SocketReactor reactor;
+        SocketPair pair;
+        pair.SetTimeout(SO_SNDTIMEO, ShortTimeout);
+
+        // The send buffer is filled up without the peer receiving anything so that the next send would block
+        std::array<u8, 4096> data{};
+        while (send(pair.fds[0], data.data(), data.size(), MSG_DONTWAIT) > 0);
+        EXPECT(errno == EAGAIN || errno == EWOULDBLOCK);
+
+        auto start{SocketReactor::Clock::now()};
+        ssize_t result{reactor.PerformOperation(pair.fds[0], POLLOUT, false, [&] {
+            return send(pair.fds[0], data.data(), data.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        })};
+        auto elapsed{SocketReactor::Clock::now() - start};
+        EXPECT(result == -1 && errno == EAGAIN);
+        EXPECT(elapsed >= ShortTimeout && elapsed < LongTimeout);
+    }
+
+    TEST_CASE(SocketReactor, PollWithZeroTimeoutDoesNotWait) {
+        SocketReactor reactor;
+        SocketPair pair;
+        pollfd fd{.fd = pair.fds[0], .events = POLLIN};
+
+        auto start{SocketReactor::Clock::now()};
+        EXPECT(reactor.Poll(span<pollfd>{fd}, 0) == 0);
+        EXPECT(SocketReactor::Clock::now() - start < ShortTimeout);
+
+        EXPECT(write(pair.fds[1], "a", 1) == 1);
+        EXPECT(reactor.Poll(span<pollfd>{fd}, 0) == 1);
+        EXPECT(fd.revents & POLLIN);
+    }
+
+    TEST_CASE(SocketReactor, PollWithFiniteTimeout) {
+        SocketReactor reactor;
+        SocketPair pair{true};
+        pollfd fd{.fd = pair.fds[0], .events = POLLIN};
+
+        auto start{SocketReactor::Clock::now()};
+        EXPECT(reactor.Poll(span<pollfd>{fd}, static_cast<int>(ShortTimeout.count())) == 0);
+        EXPECT(SocketReactor::Clock::now() - start >= ShortTimeout);
+
+        auto writer{DelayedWrite(pair.fds[1], "a")};
+        EXPECT(reactor.Poll(span<pollfd>{fd}, static_cast<int>(std::chrono::milliseconds{LongTimeout}.count())) == 1);
+        EXPECT(fd.revents & POLLIN);
+        writer.get();
+    }
+
+    TEST_CASE(SocketReactor, PollWithInfiniteTimeout) {
+        SocketReactor reactor;
+        SocketPair pair;
+        SocketPair otherPair;
+        std::array<pollfd, 2> fds{pollfd{.fd = otherPair.fds[0], .events = POLLIN}, pollfd{.fd = pair.fds[0], .events = POLLIN}};
+
+        auto writer{DelayedWrite(pair.fds[1], "a")};
+        EXPECT(reactor.Poll(fds, -1) == 1);
+        EXPECT(!(fds[0].revents & POLLIN) && (fds[1].revents & POLLIN));
+        writer.get();
+    }
+
+    TEST_CASE(SocketReactor, CancelWakesParkedWaiters) {
+        SocketReactor reactor;
+        SocketPair pair;
+        int fd{pair.fds[0]};
+
+        std::array<std::future<bool>, 2> waiters{};
+        for (auto &waiter : waiters)
+            waiter = std::async(std::launch::async, [&reactor, fd] {
+                pollfd pollFd{.fd = fd, .events = POLLIN};
+                return reactor.Wait(span<pollfd>{pollFd}, std::nullopt);
+            });
+
+        std::this_thread::sleep_for(ShortTimeout);
+        for (auto &waiter : waiters)
+            EXPECT(waiter.wait_for(0s) == std::future_status::timeout);
+
+        // This is the sequence that bsd:u performs on Close, closing the socket alone doesn't wake epoll waiters
+        close(fd);
+        pair.fds[0] = -1;
+        reactor.Cancel(fd);
+
+        for (auto &waiter : waiters) {
+            EXPECT(waiter.wait_for(LongTimeout) == std::future_status::ready);
+            EXPECT(waiter.get());
+        }
+    }
+}
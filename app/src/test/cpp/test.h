@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+/**
+ * @brief Fails the current test with the location and text of the condition if it doesn't hold
+ */
+#define EXPECT(condition) if (!(condition)) throw skyline::test::TestFailure(fmt::format("{}:{}: Expected '{}'", __FILE__, __LINE__, #condition))
+
+/**
+ * @brief Defines a test function and registers it to be run by skyline_tests as '<suite>.<name>'
+ */
+#define TEST_CASE(suite, name)                                                                               \
+    static void suite##_##name();                                                                            \
+    static const skyline::test::Registration suite##_##name##Registration{#suite "." #name, suite##_##name}; \
+    static void suite##_##name()
+
+namespace skyline::test {
+    struct TestFailure : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    using TestFunction = void (*)();
+
+    /**
+     * @return All tests registered using TEST_CASE across every translation unit, in the order of their registration
+     */
+    inline std::vector<std::pair<std::string_view, TestFunction>> &GetTests() {
+        static std::vector<std::pair<std::string_view, TestFunction>> tests;
+        return tests;
+    }
+
+    /**
+     * @brief A static object which adds a test to the registry during static initialization
+     */
+    struct Registration {
+        Registration(std::string_view name, TestFunction function) {
+            GetTests().emplace_back(name, function);
+        }
+    };
+}
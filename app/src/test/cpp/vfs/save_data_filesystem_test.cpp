@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <unistd.h>
+#include <fstream>
+#include <functional>
+#include <vfs/save_data_filesystem.h>
+#include "../test.h"
+
+/**
+ * @brief Crash recovery tests for SaveDataFileSystem, interrupted commits are simulated by laying out the staging directory as a commit would have left it
+ */
+namespace skyline::vfs::test {
+    /**
+     * @brief A temporary save directory which is removed alongside its staging directory once the test is done
+     */
+    struct SaveDirectory {
+        std::string path;
+        std::string stagingPath;
+
+        SaveDirectory(std::string_view name) : path{fmt::format("{}/skyline_save_test_{}_{}", std::filesystem::temp_directory_path().string(), getpid(), name)}, stagingPath{path + ".commit/"} {
+            std::filesystem::remove_all(path);
+            std::filesystem::remove_all(stagingPath);
+            std::filesystem::create_directories(path);
+        }
+
+        ~SaveDirectory() {
+            std::filesystem::remove_all(path);
+            std::filesystem::remove_all(stagingPath);
+        }
+
+        void WriteHostFile(const std::string &hostPath, std::string_view contents) const {
+            std::ofstream stream{hostPath, std::ios::binary | std::ios::trunc};
+            stream << contents;
+        }
+
+        std::string ReadHostFile(const std::string &hostPath) const {
+            std::ifstream stream{hostPath, std::ios::binary};
+            return {std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+        }
+    };
+
+    std::string ReadFile(FileSystem &fileSystem, const std::string &path) {
+        auto file{fileSystem.OpenFile(path)};
+        std::string contents(file->size, '\0');
+        file->Read(span<char>{contents}.cast<u8>());
+        return contents;
+    }
+
+    void WriteFile(FileSystem &fileSystem, const std::string &path, std::string contents) {
+        if (!fileSystem.GetEntryType(path))
+            fileSystem.CreateFile(path, 0);
+
+        auto file{fileSystem.OpenFile(path, {true, true, true})};
+        file->Resize(contents.size());
+        file->Write(span<char>{contents}.cast<u8>());
+    }
+
+    TEST_CASE(SaveDataFileSystem, CommittedWritesPersist) {
+        SaveDirectory directory{"committed"};
+        {
+            SaveDataFileSystem fileSystem{directory.path};
+            WriteFile(fileSystem, "/save.bin", "committed");
+            fileSystem.Commit();
+        }
+
+        SaveDataFileSystem fileSystem{directory.path};
+        EXPECT(ReadFile(fileSystem, "/save.bin") == "committed");
+        EXPECT(!std::filesystem::exists(directory.stagingPath));
+    }
+
+    TEST_CASE(SaveDataFileSystem, UncommittedWritesAreDiscardedOnClose) {
+        SaveDirectory directory{"uncommitted"};
+        {
+            SaveDataFileSystem fileSystem{directory.path};
+            WriteFile(fileSystem, "/save.bin", "committed");
+            fileSystem.Commit();
+            WriteFile(fileSystem, "/save.bin", "uncommitted");
+            EXPECT(ReadFile(fileSystem, "/save.bin") == "uncommitted");
+        }
+
+        SaveDataFileSystem fileSystem{directory.path};
+        EXPECT(ReadFile(fileSystem, "/save.bin") == "committed");
+    }
+
+    TEST_CASE(SaveDataFileSystem, UnpublishedCommitIsDiscarded) {
+        SaveDirectory directory{"unpublished"};
+        directory.WriteHostFile(directory.path + "/save.bin", "old");
+
+        // The process died while staging files, before the journal was published
+        std::filesystem::create_directories(directory.stagingPath);
+        directory.WriteHostFile(directory.stagingPath + "0", "new");
+        directory.WriteHostFile(directory.stagingPath + "journal.tmp", "/save.bin\n");
+
+        SaveDataFileSystem fileSystem{directory.path};
+        EXPECT(ReadFile(fileSystem, "/save.bin") == "old");
+        EXPECT(!std::filesystem::exists(directory.stagingPath));
+    }
+
+    TEST_CASE(SaveDataFileSystem, PublishedCommitIsCompleted) {
+        SaveDirectory directory{"published"};
+        directory.WriteHostFile(directory.path + "/first.bin", "old");
+        directory.WriteHostFile(directory.path + "/second.bin", "old");
+
+        // The process died after the journal was published but before any staged file was moved into place
+        std::filesystem::create_directories(directory.stagingPath);
+        directory.WriteHostFile(directory.stagingPath + "0", "new first");
+        directory.WriteHostFile(directory.stagingPath + "1", "new second");
+        directory.WriteHostFile(directory.stagingPath + "journal", "/first.bin\n/second.bin\n");
+
+        SaveDataFileSystem fileSystem{directory.path};
+        EXPECT(ReadFile(fileSystem, "/first.bin") == "new first");
+        EXPECT(ReadFile(fileSystem, "/second.bin") == "new second");
+        EXPECT(!std::filesystem::exists(directory.stagingPath));
+    }
+
+    TEST_CASE(SaveDataFileSystem, PartiallyAppliedCommitIsCompleted) {
+        SaveDirectory directory{"partial"};
+        directory.WriteHostFile(directory.path + "/first.bin", "new first");
+        directory.WriteHostFile(directory.path + "/second.bin", "old");
+
+        // The process died after the first staged file was moved into place, it's no longer present in the staging directory
+        std::filesystem::create_directories(directory.stagingPath);
+        directory.WriteHostFile(directory.stagingPath + "1", "new second");
+        directory.WriteHostFile(directory.stagingPath + "journal", "/first.bin\n/second.bin\n");
+
+        SaveDataFileSystem fileSystem{directory.path};
+        EXPECT(ReadFile(fileSystem, "/first.bin") == "new first");
+        EXPECT(ReadFile(fileSystem, "/second.bin") == "new second");
+        EXPECT(!std::filesystem::exists(directory.stagingPath));
+    }
+
+    TEST_CASE(SaveDataFileSystem, StaleStagingIsReplacedByCommit) {
+        SaveDirectory directory{"stale"};
+        SaveDataFileSystem fileSystem{directory.path};
+
+        // Leftovers of a prior commit attempt in the same session mustn't leak into the next commit
+        std::filesystem::create_directories(directory.stagingPath);
+        directory.WriteHostFile(directory.stagingPath + "1", "stale");
+
+        WriteFile(fileSystem, "/save.bin", "new");
+        fileSystem.Commit();
+        EXPECT(directory.ReadHostFile(directory.path + "/save.bin") == "new");
+        EXPECT(!std::filesystem::exists(directory.stagingPath));
+    }
+
+    TEST_CASE(SaveDataFileSystem, DeletingDirectoryKeepsPrefixedSiblings) {
+        SaveDirectory directory{"delete_directory"};
+        {
+            SaveDataFileSystem fileSystem{directory.path};
+            fileSystem.CreateDirectory("/foo", false);
+            WriteFile(fileSystem, "/foo/a.bin", "inside");
+            WriteFile(fileSystem, "/foobar.bin", "sibling");
+            fileSystem.DeleteDirectory("/foo");
+            EXPECT(!fileSystem.GetEntryType("/foo/a.bin"));
+            EXPECT(ReadFile(fileSystem, "/foobar.bin") == "sibling");
+            fileSystem.Commit();
+        }
+
+        SaveDataFileSystem fileSystem{directory.path};
+        EXPECT(ReadFile(fileSystem, "/foobar.bin") == "sibling");
+        EXPECT(!fileSystem.GetEntryType("/foo"));
+    }
+}